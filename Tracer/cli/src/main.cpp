@@ -32,11 +32,19 @@
 #include <cstdio>
 #include <cstdlib>
 
+#include <algorithm>
+#include <string>
+
 #include "rt/Camera/FrustumCamera.h"
 #include "rt/Camera/SimpleCamera.h"
+#include "rt/Loader/SceneCache.h"
 #include "rt/Loader/SceneLoader.h"
+#include "rt/Renderer/BidirectionalRenderer.h"
 #include "rt/Renderer/DirectLightingRenderer.h"
+#include "rt/Renderer/IrradianceCachingRenderer.h"
+#include "rt/Renderer/PathGuidingRenderer.h"
 #include "rt/Renderer/PathTracingRenderer.h"
+#include "rt/Renderer/PhotonMappingRenderer.h"
 #include "rt/Renderer/WhittedRenderer.h"
 #include "rt/Sampler/SimpleSampler.h"
 #include "rt/Scene/Scene.h"
@@ -59,15 +67,69 @@ constexpr rt::size_t numSamples = 64;
 constexpr rt::size_t  width = 1000;
 constexpr rt::size_t height = 1000;
 
-int main(int /*argc*/, char ** /*argv*/)
+void usage(const char *argv0)
+{
+  fprintf(stderr, "Usage: %s [-k checkpoint.rtc] [-i intervalSec] [-r]\n"
+          "          [-w x0 y0 x1 y1] [-s samples] [scene.xml]\n", argv0);
+}
+
+// NOTE: Parses the crop window [x0,x1) x [y0,y1) from 'argv'.
+bool parseWindow(rt::RenderBlock *window, char **argv)
+{
+  int v[4];
+  for(int i = 0; i < 4; i++) {
+    v[i] = atoi(argv[i]);
+    if( v[i] < 0 ) {
+      return false;
+    }
+  }
+  *window = rt::RenderBlock(rt::size_t(v[0]), rt::size_t(v[1]), rt::size_t(v[2]), rt::size_t(v[3]));
+  return !window->isEmpty()  &&  window->x1 <= width  &&  window->y1 <= height;
+}
+
+int main(int argc, char **argv)
 {
   const char *filename = FILE_1;
+  std::string checkpoint;
+  unsigned int interval = 60;
+  bool resume = false;
+  rt::RenderBlock window;
+  rt::size_t windowSamples = numSamples*4;
+
+  for(int i = 1; i < argc; i++) {
+    const std::string arg(argv[i]);
+    if(        arg == "-k"  &&  i + 1 < argc ) {
+      checkpoint = argv[++i];
+    } else if( arg == "-i"  &&  i + 1 < argc ) {
+      interval = unsigned(atoi(argv[++i]));
+    } else if( arg == "-r" ) {
+      resume = true;
+    } else if( arg == "-w"  &&  i + 4 < argc ) {
+      if( !parseWindow(&window, argv + i + 1) ) {
+        fprintf(stderr, "ERROR: Invalid crop window!\n");
+        return EXIT_FAILURE;
+      }
+      i += 4;
+    } else if( arg == "-s"  &&  i + 1 < argc ) {
+      windowSamples = rt::size_t(std::max(1, atoi(argv[++i])));
+    } else if( arg.empty()  ||  arg[0] == '-' ) {
+      usage(argv[0]);
+      return EXIT_FAILURE;
+    } else {
+      filename = argv[i];
+    }
+  }
+
+  if( resume  &&  checkpoint.empty() ) {
+    fprintf(stderr, "ERROR: Resuming requires a checkpoint!\n");
+    return EXIT_FAILURE;
+  }
 
   rt::RenderContext rc;
   rc.scene = rt::Scene::create();
 
   rt::RenderOptions options;
-  if( !rt::loadScene(rt::SCENE(rc.scene), &options, filename) ) {
+  if( !rt::loadSceneCached(rt::SCENE(rc.scene), &options, filename) ) {
     return EXIT_FAILURE;
   }
   //rc.scene.setUseCastShadow(true);
@@ -75,6 +137,10 @@ int main(int /*argc*/, char ** /*argv*/)
   rc.renderer = rt::DirectLightingRenderer::create(options);
   //rc.renderer = rt::PathTracingRenderer::create(options);
   //rc.renderer = rt::WhittedRenderer::create(options);
+  //rc.renderer = rt::BidirectionalRenderer::create(options);
+  //rc.renderer = rt::PhotonMappingRenderer::create(options);
+  //rc.renderer = rt::IrradianceCachingRenderer::create(options);
+  //rc.renderer = rt::PathGuidingRenderer::create(options);
 
 #if 0
   {
@@ -96,9 +162,38 @@ int main(int /*argc*/, char ** /*argv*/)
 #endif
 
   rc.sampler = rt::SimpleSampler::create(numSamples);
+  // Reproducible samples; partials of distinct seeds or sample ranges merge using Tracer-Merge...
+  //rc.sampler = rt::SimpleSampler::create(numSamples, 1, 0*numSamples);
 
   Worker worker;
-  const Image image = worker.execute(rc);
+  //worker.setDenoise(true);
+  //worker.setPartialFilename("output.rtp");
+  if( !checkpoint.empty() ) {
+    // NOTE: A checkpoint is only resumed for the same scene file.
+    bool ok = false;
+    worker.setSceneHash(rt::hashSceneFile(filename, &ok));
+    if( !ok ) {
+      fprintf(stderr, "ERROR: Unable to hash scene \"%s\"!\n", filename);
+      return EXIT_FAILURE;
+    }
+    worker.setCheckpointFilename(checkpoint, interval);
+    worker.setResume(resume);
+  }
+  Image image = worker.execute(rc);
+  if( image.isEmpty() ) {
+    return EXIT_FAILURE;
+  }
+
+  // NOTE: The crop window is re-rendered using more samples & composited into the image.
+  if( !window.isEmpty() ) {
+    rc.window  = window;
+    rc.sampler = rt::SimpleSampler::create(windowSamples);
+    if( !Worker().execute(&image, rc) ) {
+      fprintf(stderr, "ERROR: Unable to render crop window!\n");
+      return EXIT_FAILURE;
+    }
+  }
+
   image.saveAsPNG("output.png");
 
   return EXIT_SUCCESS;
@@ -0,0 +1,97 @@
+/****************************************************************************
+** Copyright (c) 2021, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "Protocol.h"
+
+class Image;
+
+/*
+ * NOTE:
+ * Distributes the tiles of a frame among render daemons ("workers"), one tile per connection.
+ * Every worker pulls the next pending tile as soon as it delivered its previous one; the
+ * tile of a worker that died is re-issued to the remaining ones. Ordering the tiles by their
+ * measured cost, most expensive first, keeps workers from idling at the end of a frame.
+ * Tiles are rendered independently; renderers that develop the entire frame, e.g.
+ * BidirectionalRenderer's light tracing, do not distribute.
+ */
+
+class Coordinator {
+public:
+  struct Tile {
+    Tile() noexcept = default;
+
+    Tile(const rt::RenderBlock& block) noexcept
+      : block{block}
+    {
+    }
+
+    rt::RenderBlock block{};
+    long long msec{-1};
+  };
+
+  using Tiles = std::vector<Tile>;
+
+  struct WorkerStats {
+    WorkerStats() noexcept = default;
+
+    std::string socketName{};
+    std::size_t numTiles{0};
+    long long msec{0};
+    bool is_alive{true};
+  };
+
+  Coordinator(const std::vector<std::string>& workers) noexcept;
+  ~Coordinator() noexcept = default;
+
+  std::size_t numAlive() const;
+  const std::vector<WorkerStats>& workers() const;
+
+  // NOTE: Renders 'tiles' of 'job' into 'image'; each tile's measured cost is stored in 'tiles'.
+  bool render(Image *image, const RenderJob& job, Tiles *tiles);
+
+  static void sortByCost(Tiles *tiles);
+
+private:
+  enum Result {
+    Done = 0,
+    Failed,
+    Lost
+  };
+
+  Result renderTile(WorkerStats *worker, Image *image, const RenderJob& job, Tile *tile);
+
+  std::vector<WorkerStats> _workers{};
+};
@@ -0,0 +1,79 @@
+/****************************************************************************
+** Copyright (c) 2021, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#pragma once
+
+#include <string>
+
+#include "rt/Renderer/RenderBlock.h"
+
+class Image;
+
+#define DAEMON_SOCKET  "/tmp/Tracer-Daemon.sock"
+
+/*
+ * NOTE:
+ * A client submits one job per connection as lines of "key value" pairs, terminated by "end".
+ * The daemon replies with any number of "tile x y width height" lines, each followed
+ * by width*height RGBA pixels, and finishes with either "done msec" or "error message";
+ * 'msec' is the time spent rendering, excluding loading the scene.
+ * Tiles may overlap previously sent ones; later tiles replace earlier ones.
+ */
+
+struct RenderJob {
+  RenderJob() = default;
+
+  bool isValid() const;
+
+  bool read(const int fd);
+  bool write(const int fd) const;
+
+  std::string   scene{};
+  std::string  method{"DirectLighting"};
+  std::string  camera{"Frustum"};
+  rt::size_t    width{640};
+  rt::size_t   height{480};
+  rt::size_t  samples{1};
+  rt::size_t tileSize{32};
+  rt::RenderBlock window{};
+};
+
+// NOTE: Return a socket's file descriptor, or -1 on error.
+int connectTo(const std::string& socketName);
+// NOTE: A stale socket at 'socketName' is replaced; any other file is an error.
+int listenTo(const std::string& socketName);
+
+bool readLine(const int fd, std::string *line);
+bool writeLine(const int fd, const std::string& line);
+
+bool readTile(const int fd, const std::string& header, rt::size_t *x, rt::size_t *y, Image *tile);
+bool readTile(const int fd, const std::string& header, Image *image);
+bool writeTile(const int fd, const rt::size_t x, const rt::size_t y, const Image& tile);
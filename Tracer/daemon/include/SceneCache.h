@@ -0,0 +1,80 @@
+/****************************************************************************
+** Copyright (c) 2021, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#pragma once
+
+#include <condition_variable>
+#include <filesystem>
+#include <map>
+#include <mutex>
+#include <string>
+
+#include "rt/Renderer/RenderOptions.h"
+#include "rt/Scene/IScene.h"
+
+/*
+ * NOTE:
+ * Loaded scenes are kept keyed by their canonical path; a scene is loaded again
+ * once its file's modification time changed. Scenes are NOT thread-safe, hence
+ * a scene is checked out by one job at a time using acquire() and release().
+ * acquire() returns the scene's key, which is passed to release(); the scene's
+ * file may hence be renamed or deleted during the job.
+ */
+
+class SceneCache {
+public:
+  SceneCache() = default;
+  ~SceneCache() = default;
+
+  bool acquire(std::string *key, rt::ScenePtr *scene, rt::RenderOptions *options,
+               const std::string& filename, bool *is_loaded = nullptr);
+  void release(const std::string& key, rt::ScenePtr&& scene);
+
+  std::size_t size() const;
+
+private:
+  using file_time = std::filesystem::file_time_type;
+
+  struct Entry {
+    Entry() = default;
+
+    file_time modified{};
+    rt::RenderOptions options{};
+    rt::ScenePtr scene{};
+    bool is_busy{false};
+  };
+
+  static bool load(rt::ScenePtr *scene, rt::RenderOptions *options, const std::string& path);
+
+  std::map<std::string,Entry> _entries{};
+  mutable std::mutex _mutex{};
+  std::condition_variable _released{};
+};
@@ -0,0 +1,85 @@
+/****************************************************************************
+** Copyright (c) 2021, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#pragma once
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "rt/Renderer/RenderContext.h"
+
+/*
+ * NOTE:
+ * A fixed set of threads renders the tiles of all running jobs; jobs are visited
+ * round-robin, one tile at a time, so that small jobs are not stuck behind large ones.
+ */
+
+class TileScheduler {
+public:
+  // NOTE: Called for each rendered tile; returning false cancels the job.
+  using DeliverFunc = std::function<bool(const rt::RenderBlock&,const Image&)>;
+
+  TileScheduler(const std::size_t numThreads) noexcept;
+  ~TileScheduler() noexcept;
+
+  std::size_t numThreads() const;
+
+  // NOTE: Blocks until all 'tiles' are delivered; 'deliver' is never called concurrently.
+  bool run(const rt::RenderContext& rc, const std::vector<rt::RenderBlock>& tiles,
+           const DeliverFunc& deliver);
+
+private:
+  struct Job {
+    Job(const rt::RenderContext& rc, const std::vector<rt::RenderBlock>& tiles,
+        const DeliverFunc& deliver) noexcept;
+
+    const rt::RenderContext& rc;
+    const std::vector<rt::RenderBlock>& tiles;
+    const DeliverFunc& deliver;
+    std::size_t next{0};
+    std::size_t numDone{0};
+    std::mutex mutex{};
+    std::condition_variable done{};
+  };
+
+  bool fetch(Job **job, std::size_t *index);
+  void work();
+
+  std::vector<Job*> _jobs{};
+  std::size_t _round{0};
+  bool _is_quit{false};
+  std::mutex _mutex{};
+  std::condition_variable _pending{};
+  std::vector<std::thread> _threads{};
+};
@@ -0,0 +1,195 @@
+/****************************************************************************
+** Copyright (c) 2021, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#include <cstdio>
+#include <cstdlib>
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+#include <unistd.h>
+
+#include "Coordinator.h"
+
+#include "Image.h"
+
+////// public ////////////////////////////////////////////////////////////////
+
+Coordinator::Coordinator(const std::vector<std::string>& workers) noexcept
+{
+  for(const std::string& socketName : workers) {
+    WorkerStats worker;
+    worker.socketName = socketName;
+    _workers.push_back(worker);
+  }
+}
+
+std::size_t Coordinator::numAlive() const
+{
+  return std::count_if(_workers.begin(), _workers.end(), [](const WorkerStats& worker) -> bool {
+    return worker.is_alive;
+  });
+}
+
+const std::vector<Coordinator::WorkerStats>& Coordinator::workers() const
+{
+  return _workers;
+}
+
+bool Coordinator::render(Image *image, const RenderJob& job, Tiles *tiles)
+{
+  if( image->width() != job.width  ||  image->height() != job.height ) {
+    if( !image->resize(job.width, job.height) ) {
+      return false;
+    }
+  }
+
+  std::deque<std::size_t> pending;
+  for(std::size_t i = 0; i < tiles->size(); i++) {
+    pending.push_back(i);
+  }
+
+  std::size_t numDone = 0;
+  bool is_failed = false;
+  std::mutex mutex;
+  std::condition_variable changed;
+
+  const auto work = [&](WorkerStats *worker) -> void {
+    std::unique_lock<std::mutex> lock(mutex);
+    for(;;) {
+      changed.wait(lock, [&]() -> bool {
+        return !pending.empty()  ||  numDone == tiles->size()  ||  is_failed;
+      });
+      if( numDone == tiles->size()  ||  is_failed ) {
+        return;
+      }
+
+      const std::size_t index = pending.front();
+      pending.pop_front();
+
+      lock.unlock();
+      const Result result = renderTile(worker, image, job, &(*tiles)[index]);
+      lock.lock();
+
+      if(        result == Done ) {
+        numDone++;
+      } else if( result == Failed ) {
+        is_failed = true;
+      } else {
+        // NOTE: Re-issue the tile to the remaining workers & retire this one.
+        pending.push_front(index);
+        worker->is_alive = false;
+        fprintf(stderr, "WARNING: Lost worker \"%s\"!\n", worker->socketName.data());
+      }
+      changed.notify_all();
+
+      if( !worker->is_alive ) {
+        return;
+      }
+    }
+  };
+
+  std::vector<std::thread> threads;
+  for(WorkerStats& worker : _workers) {
+    if( worker.is_alive ) {
+      threads.emplace_back(work, &worker);
+    }
+  }
+  for(std::thread& thread : threads) {
+    thread.join();
+  }
+
+  return numDone == tiles->size();
+}
+
+void Coordinator::sortByCost(Tiles *tiles)
+{
+  std::stable_sort(tiles->begin(), tiles->end(), [](const Tile& a, const Tile& b) -> bool {
+    return a.msec > b.msec;
+  });
+}
+
+////// private ///////////////////////////////////////////////////////////////
+
+Coordinator::Result Coordinator::renderTile(WorkerStats *worker, Image *image,
+                                            const RenderJob& job, Tile *tile)
+{
+  RenderJob tileJob = job;
+  tileJob.window = tile->block;
+
+  const int fd = connectTo(worker->socketName);
+  if( fd < 0 ) {
+    return Lost;
+  }
+  if( !tileJob.write(fd) ) {
+    ::close(fd);
+    return Lost;
+  }
+
+  // NOTE: The tile is composited once it is complete; a lost worker leaves 'image' untouched.
+  Image frame;
+  std::string line;
+  while( readLine(fd, &line) ) {
+    if(        line.compare(0, 5, "tile ") == 0 ) {
+      rt::size_t x = 0, y = 0;
+      Image slice;
+      if( !readTile(fd, line, &x, &y, &slice) ) {
+        break;
+      }
+      if( frame.isEmpty()  &&  !frame.resize(tile->block.width(), tile->block.height()) ) {
+        break;
+      }
+      frame.copy(x - tile->block.x0, y - tile->block.y0, slice);
+
+    } else if( line.compare(0, 5, "done ") == 0 ) {
+      ::close(fd);
+      tile->msec = std::atoll(line.data() + 5);
+      worker->numTiles++;
+      worker->msec += tile->msec;
+      return image->copy(tile->block.x0, tile->block.y0, frame)
+          ? Done
+          : Failed;
+
+    } else {
+      ::close(fd);
+      fprintf(stderr, "ERROR: \"%s\": %s\n", worker->socketName.data(), line.data());
+      return line.compare(0, 6, "error ") == 0
+          ? Failed
+          : Lost;
+    }
+  }
+  ::close(fd);
+
+  return Lost;
+}
@@ -0,0 +1,290 @@
+/****************************************************************************
+** Copyright (c) 2021, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+
+#include <sstream>
+
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "Protocol.h"
+
+#include "Image.h"
+
+namespace priv {
+
+  inline constexpr std::size_t MAX_LINE = 4096;
+
+  bool readBytes(const int fd, void *data, const std::size_t size)
+  {
+    uint8_t *ptr = reinterpret_cast<uint8_t*>(data);
+    for(std::size_t done = 0; done < size; ) {
+      const ssize_t n = ::read(fd, ptr + done, size - done);
+      if( n < 0  &&  errno == EINTR ) {
+        continue;
+      }
+      if( n <= 0 ) {
+        return false;
+      }
+      done += std::size_t(n);
+    }
+    return true;
+  }
+
+  bool makeAddress(sockaddr_un *address, const std::string& socketName)
+  {
+    memset(address, 0, sizeof(sockaddr_un));
+    address->sun_family = AF_UNIX;
+    if( socketName.empty()  ||  socketName.size() >= sizeof(address->sun_path) ) {
+      return false;
+    }
+    strncpy(address->sun_path, socketName.data(), sizeof(address->sun_path) - 1);
+    return true;
+  }
+
+  // NOTE: MSG_NOSIGNAL avoids SIGPIPE when the peer has gone away.
+  bool writeBytes(const int fd, const void *data, const std::size_t size)
+  {
+    const uint8_t *ptr = reinterpret_cast<const uint8_t*>(data);
+    for(std::size_t done = 0; done < size; ) {
+      const ssize_t n = ::send(fd, ptr + done, size - done, MSG_NOSIGNAL);
+      if( n < 0  &&  errno == EINTR ) {
+        continue;
+      }
+      if( n <= 0 ) {
+        return false;
+      }
+      done += std::size_t(n);
+    }
+    return true;
+  }
+
+} // namespace priv
+
+////// RenderJob - public ////////////////////////////////////////////////////
+
+bool RenderJob::isValid() const
+{
+  return !scene.empty()  &&  width > 0  &&  height > 0  &&  samples > 0  &&  tileSize > 0;
+}
+
+bool RenderJob::read(const int fd)
+{
+  *this = RenderJob();
+
+  std::string line;
+  while( readLine(fd, &line) ) {
+    if( line == "end" ) {
+      return isValid();
+    }
+
+    std::istringstream stream(line);
+    std::string key;
+    stream >> key;
+    stream >> std::ws;
+
+    if(        key == "scene" ) {
+      std::getline(stream, scene);
+    } else if( key == "method" ) {
+      stream >> method;
+    } else if( key == "camera" ) {
+      stream >> camera;
+    } else if( key == "width" ) {
+      stream >> width;
+    } else if( key == "height" ) {
+      stream >> height;
+    } else if( key == "samples" ) {
+      stream >> samples;
+    } else if( key == "tileSize" ) {
+      stream >> tileSize;
+    } else if( key == "window" ) {
+      stream >> window.x0 >> window.y0 >> window.x1 >> window.y1;
+    } else {
+      return false;
+    }
+
+    if( stream.fail() ) {
+      return false;
+    }
+  }
+
+  return false;
+}
+
+bool RenderJob::write(const int fd) const
+{
+  std::ostringstream stream;
+  stream << "scene "    << scene    << "\n";
+  stream << "method "   << method   << "\n";
+  stream << "camera "   << camera   << "\n";
+  stream << "width "    << width    << "\n";
+  stream << "height "   << height   << "\n";
+  stream << "samples "  << samples  << "\n";
+  stream << "tileSize " << tileSize << "\n";
+  if( !window.isEmpty() ) {
+    stream << "window "
+           << window.x0 << " " << window.y0 << " "
+           << window.x1 << " " << window.y1 << "\n";
+  }
+  stream << "end";
+  return writeLine(fd, stream.str());
+}
+
+////// Public ////////////////////////////////////////////////////////////////
+
+int connectTo(const std::string& socketName)
+{
+  sockaddr_un address;
+  if( !priv::makeAddress(&address, socketName) ) {
+    return -1;
+  }
+
+  const int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+  if( fd < 0 ) {
+    return -1;
+  }
+  if( ::connect(fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0 ) {
+    ::close(fd);
+    return -1;
+  }
+
+  return fd;
+}
+
+int listenTo(const std::string& socketName)
+{
+  sockaddr_un address;
+  if( !priv::makeAddress(&address, socketName) ) {
+    return -1;
+  }
+
+  // NOTE: Only a (stale) socket is replaced; e.g. a mistyped path must not delete a file.
+  struct stat info;
+  if( ::lstat(socketName.data(), &info) == 0 ) {
+    if( !S_ISSOCK(info.st_mode) ) {
+      fprintf(stderr, "ERROR: \"%s\" exists and is not a socket!\n", socketName.data());
+      return -1;
+    }
+    if( ::unlink(socketName.data()) != 0 ) {
+      return -1;
+    }
+  }
+
+  const int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+  if( fd < 0 ) {
+    return -1;
+  }
+
+  if( ::bind(fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0  ||
+      ::listen(fd, SOMAXCONN) != 0 ) {
+    ::close(fd);
+    return -1;
+  }
+
+  return fd;
+}
+
+bool readLine(const int fd, std::string *line)
+{
+  line->clear();
+  for(char c = 0; line->size() < priv::MAX_LINE; ) {
+    if( !priv::readBytes(fd, &c, 1) ) {
+      return false;
+    }
+    if( c == '\n' ) {
+      return true;
+    }
+    line->push_back(c);
+  }
+  return false;
+}
+
+bool writeLine(const int fd, const std::string& line)
+{
+  const std::string data = line + "\n";
+  return priv::writeBytes(fd, data.data(), data.size());
+}
+
+bool readTile(const int fd, const std::string& header, rt::size_t *x, rt::size_t *y, Image *tile)
+{
+  std::size_t x0 = 0, y0 = 0, w = 0, h = 0;
+  if( std::sscanf(header.data(), "tile %zu %zu %zu %zu", &x0, &y0, &w, &h) != 4 ) {
+    return false;
+  }
+
+  if( !tile->resize(w, h) ) {
+    return false;
+  }
+  for(std::size_t i = 0; i < h; i++) {
+    if( !priv::readBytes(fd, tile->row(i), w*4) ) {
+      return false;
+    }
+  }
+
+  *x = x0;
+  *y = y0;
+
+  return true;
+}
+
+bool readTile(const int fd, const std::string& header, Image *image)
+{
+  rt::size_t x = 0, y = 0;
+  Image tile;
+  return readTile(fd, header, &x, &y, &tile)  &&  image->copy(x, y, tile);
+}
+
+bool writeTile(const int fd, const rt::size_t x, const rt::size_t y, const Image& tile)
+{
+  if( tile.isEmpty() ) {
+    return false;
+  }
+
+  char header[128];
+  std::snprintf(header, sizeof(header), "tile %zu %zu %zu %zu",
+                std::size_t(x), std::size_t(y), tile.width(), tile.height());
+  if( !writeLine(fd, header) ) {
+    return false;
+  }
+
+  for(std::size_t i = 0; i < tile.height(); i++) {
+    if( !priv::writeBytes(fd, tile.row(i), tile.width()*4) ) {
+      return false;
+    }
+  }
+
+  return true;
+}
@@ -0,0 +1,138 @@
+/****************************************************************************
+** Copyright (c) 2021, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#include "SceneCache.h"
+
+#include "pt/Scene/Scene.h"
+#include "rt/Loader/SceneLoader.h"
+#include "rt/Scene/Scene.h"
+
+namespace priv {
+
+  std::string canonicalPath(const std::string& filename)
+  {
+    std::error_code ec;
+    const std::filesystem::path path = std::filesystem::canonical(filename, ec);
+    return ec
+        ? std::string()
+        : path.string();
+  }
+
+} // namespace priv
+
+////// public ////////////////////////////////////////////////////////////////
+
+bool SceneCache::acquire(std::string *key, rt::ScenePtr *scene, rt::RenderOptions *options,
+                         const std::string& filename, bool *is_loaded)
+{
+  const std::string path = priv::canonicalPath(filename);
+  if( path.empty() ) {
+    return false;
+  }
+
+  std::unique_lock<std::mutex> lock(_mutex);
+  _released.wait(lock, [&]() -> bool {
+    return _entries.count(path) == 0  ||  !_entries[path].is_busy;
+  });
+
+  std::error_code ec;
+  const file_time modified = std::filesystem::last_write_time(path, ec);
+  if( ec ) {
+    return false;
+  }
+
+  Entry& entry = _entries[path];
+  entry.is_busy = true;
+
+  const bool is_stale = !entry.scene  ||  entry.modified != modified;
+  if( is_loaded != nullptr ) {
+    *is_loaded = is_stale;
+  }
+
+  // NOTE: Other scenes may be acquired while loading; this entry is busy meanwhile.
+  if( is_stale ) {
+    entry.scene.reset();
+    lock.unlock();
+
+    rt::ScenePtr loaded;
+    rt::RenderOptions loadedOptions;
+    const bool ok = load(&loaded, &loadedOptions, path);
+
+    lock.lock();
+    if( !ok ) {
+      _entries.erase(path);
+      _released.notify_all();
+      return false;
+    }
+
+    entry.modified = modified;
+    entry.options  = loadedOptions;
+    entry.scene    = std::move(loaded);
+  }
+
+  *key     = path;
+  *scene   = std::move(entry.scene);
+  *options = entry.options;
+
+  return true;
+}
+
+void SceneCache::release(const std::string& key, rt::ScenePtr&& scene)
+{
+  std::lock_guard<std::mutex> lock(_mutex);
+  if( _entries.count(key) == 0 ) {
+    return;
+  }
+
+  Entry& entry = _entries[key];
+  entry.scene   = std::move(scene);
+  entry.is_busy = false;
+  _released.notify_all();
+}
+
+std::size_t SceneCache::size() const
+{
+  std::lock_guard<std::mutex> lock(_mutex);
+  return _entries.size();
+}
+
+////// private ///////////////////////////////////////////////////////////////
+
+bool SceneCache::load(rt::ScenePtr *scene, rt::RenderOptions *options, const std::string& path)
+{
+  if( pt::Scene::isScene(path.data()) ) {
+    *scene = pt::Scene::create();
+    return pt::Scene::load(pt::SCENE(*scene), options, path.data());
+  }
+
+  *scene = rt::Scene::create();
+  return rt::loadSceneCached(rt::SCENE(*scene), options, path.data());
+}
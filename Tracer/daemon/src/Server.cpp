@@ -0,0 +1,205 @@
+/****************************************************************************
+** Copyright (c) 2021, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#include <cstdio>
+
+#include <chrono>
+#include <functional>
+#include <string>
+#include <thread>
+
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "pt/Renderer/PathTracer.h"
+#include "pt/Scene/Scene.h"
+#include "rt/Camera/FrustumCamera.h"
+#include "rt/Camera/SimpleCamera.h"
+#include "rt/Renderer/BidirectionalRenderer.h"
+#include "rt/Renderer/DirectLightingRenderer.h"
+#include "rt/Renderer/IrradianceCachingRenderer.h"
+#include "rt/Renderer/PathGuidingRenderer.h"
+#include "rt/Renderer/PathTracingRenderer.h"
+#include "rt/Renderer/PhotonMappingRenderer.h"
+#include "rt/Renderer/WhittedRenderer.h"
+#include "rt/Sampler/SimpleSampler.h"
+
+#include "Server.h"
+
+#include "Image.h"
+#include "Protocol.h"
+#include "SceneCache.h"
+#include "TileScheduler.h"
+
+namespace priv {
+
+  rt::CameraPtr createCamera(const RenderJob& job, const rt::RenderOptions& options)
+  {
+    if(        job.camera == "Frustum" ) {
+      return rt::FrustumCamera::create(job.width, job.height, options);
+    } else if( job.camera == "Simple" ) {
+      return rt::SimpleCamera::create(job.width, job.height, options);
+    }
+    return rt::CameraPtr();
+  }
+
+  rt::RendererPtr createRenderer(const RenderJob& job, const bool is_pathtracer,
+                                 const rt::RenderOptions& options)
+  {
+    if(        is_pathtracer ) {
+      return pt::PathTracer::create(options);
+    } else if( job.method == "DirectLighting" ) {
+      return rt::DirectLightingRenderer::create(options);
+    } else if( job.method == "PathTracing" ) {
+      return rt::PathTracingRenderer::create(options);
+    } else if( job.method == "Whitted" ) {
+      return rt::WhittedRenderer::create(options);
+    } else if( job.method == "Bidirectional" ) {
+      return rt::BidirectionalRenderer::create(options);
+    } else if( job.method == "PhotonMapping" ) {
+      return rt::PhotonMappingRenderer::create(options);
+    } else if( job.method == "IrradianceCaching" ) {
+      return rt::IrradianceCachingRenderer::create(options);
+    } else if( job.method == "PathGuiding" ) {
+      return rt::PathGuidingRenderer::create(options);
+    }
+    return rt::RendererPtr();
+  }
+
+  bool render(const int fd, const RenderJob& job, rt::RenderContext& rc, TileScheduler& scheduler,
+              const rt::RenderOptions& options)
+  {
+    // (1) Renderer, Camera & Sampler ////////////////////////////////////////
+
+    const bool is_pathtracer = dynamic_cast<pt::Scene*>(rc.scene.get()) != nullptr;
+    rc.renderer = createRenderer(job, is_pathtracer, options);
+    if( !rc.renderer ) {
+      writeLine(fd, "error Invalid method!");
+      return false;
+    }
+
+    rc.camera = createCamera(job, rc.renderer->options());
+    if( !rc.camera ) {
+      writeLine(fd, "error Invalid camera!");
+      return false;
+    }
+
+    rc.sampler = rt::SimpleSampler::create(job.samples);
+    rc.window  = job.window;
+
+    // (2) Tiles /////////////////////////////////////////////////////////////
+
+    const rt::RenderBlock window = rc.renderWindow();
+    rt::RenderBlocks blocks = rt::makeRenderTiles(window, job.tileSize);
+    rt::prioritizeRenderBlocks(&blocks, rt::real_t(window.x0 + window.x1)/2,
+                               rt::real_t(window.y0 + window.y1)/2);
+    const std::vector<rt::RenderBlock> tiles(blocks.begin(), blocks.end());
+
+    // (3) Render & Stream Tiles /////////////////////////////////////////////
+
+    Image frame(job.width, job.height);
+    const bool ok = scheduler.run(rc, tiles,
+                                  [&](const rt::RenderBlock& tile, const Image& slice) -> bool {
+      frame.copy(tile.x0, tile.y0, slice);
+      return writeTile(fd, tile.x0, tile.y0, slice);
+    });
+    if( !ok ) {
+      writeLine(fd, "error Cancelled!");
+      return false;
+    }
+
+    // NOTE: A renderer (re)developing the frame replaces all tiles sent so far.
+    if( rc.endFrame(&frame) ) {
+      if( !writeTile(fd, window.x0, window.y0,
+                     frame.crop(window.x0, window.y0, window.width(), window.height())) ) {
+        return false;
+      }
+    }
+
+    return true;
+  }
+
+  void serve(const int fd, SceneCache& cache, TileScheduler& scheduler)
+  {
+    using clock = std::chrono::steady_clock;
+
+    RenderJob job;
+    if( !job.read(fd) ) {
+      writeLine(fd, "error Invalid job!");
+      ::close(fd);
+      return;
+    }
+
+    rt::RenderContext rc;
+    rt::RenderOptions options;
+    std::string key;
+    bool is_loaded = false;
+    if( !cache.acquire(&key, &rc.scene, &options, job.scene, &is_loaded) ) {
+      writeLine(fd, "error Unable to load scene!");
+      ::close(fd);
+      return;
+    }
+
+    const clock::time_point tim_begin = clock::now();
+    const bool ok = render(fd, job, rc, scheduler, options);
+    cache.release(key, std::move(rc.scene));
+
+    const long long msec =
+        std::chrono::duration_cast<std::chrono::milliseconds>(clock::now() - tim_begin).count();
+    if( ok ) {
+      writeLine(fd, "done " + std::to_string(msec));
+    }
+    ::close(fd);
+
+    printf("%s: %s (%s), %dx%d @ %d spp, %lldms\n",
+           ok ? "Done" : "Failed", job.scene.data(), is_loaded ? "loaded" : "cached",
+           int(job.width), int(job.height), int(job.samples), msec);
+    fflush(stdout);
+  }
+
+} // namespace priv
+
+////// Public ////////////////////////////////////////////////////////////////
+
+void runServer(const int server, const std::size_t numThreads)
+{
+  SceneCache cache;
+  TileScheduler scheduler(numThreads);
+
+  // NOTE: Each connection is served by its own thread; tiles are rendered by the scheduler.
+  for(;;) {
+    const int client = ::accept(server, nullptr, nullptr);
+    if( client < 0 ) {
+      continue;
+    }
+    std::thread(priv::serve, client, std::ref(cache), std::ref(scheduler)).detach();
+  }
+}
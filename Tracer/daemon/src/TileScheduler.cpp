@@ -0,0 +1,142 @@
+/****************************************************************************
+** Copyright (c) 2021, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#include <algorithm>
+
+#include "TileScheduler.h"
+
+////// public ////////////////////////////////////////////////////////////////
+
+TileScheduler::TileScheduler(const std::size_t numThreads) noexcept
+{
+  for(std::size_t i = 0; i < std::max<std::size_t>(1, numThreads); i++) {
+    _threads.emplace_back(&TileScheduler::work, this);
+  }
+}
+
+TileScheduler::~TileScheduler() noexcept
+{
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _is_quit = true;
+  }
+  _pending.notify_all();
+
+  for(std::thread& thread : _threads) {
+    thread.join();
+  }
+}
+
+std::size_t TileScheduler::numThreads() const
+{
+  return _threads.size();
+}
+
+bool TileScheduler::run(const rt::RenderContext& rc, const std::vector<rt::RenderBlock>& tiles,
+                        const DeliverFunc& deliver)
+{
+  if( tiles.empty() ) {
+    return false;
+  }
+
+  Job job(rc, tiles, deliver);
+
+  rc.beginFrame();
+
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _jobs.push_back(&job);
+  }
+  _pending.notify_all();
+
+  std::unique_lock<std::mutex> lock(job.mutex);
+  job.done.wait(lock, [&]() -> bool {
+    return job.numDone == job.tiles.size();
+  });
+
+  return !rc.isCancelled();
+}
+
+////// private ///////////////////////////////////////////////////////////////
+
+TileScheduler::Job::Job(const rt::RenderContext& rc, const std::vector<rt::RenderBlock>& tiles,
+                        const DeliverFunc& deliver) noexcept
+  : rc{rc}
+  , tiles{tiles}
+  , deliver{deliver}
+{
+}
+
+bool TileScheduler::fetch(Job **job, std::size_t *index)
+{
+  std::unique_lock<std::mutex> lock(_mutex);
+  _pending.wait(lock, [&]() -> bool {
+    return _is_quit  ||  !_jobs.empty();
+  });
+  if( _is_quit ) {
+    return false;
+  }
+
+  _round %= _jobs.size();
+  *job   = _jobs[_round];
+  *index = (*job)->next++;
+
+  // NOTE: A job is retired once its last tile was handed out; it completes in run().
+  if( (*job)->next >= (*job)->tiles.size() ) {
+    _jobs.erase(_jobs.begin() + _round);
+  } else {
+    _round++;
+  }
+
+  return true;
+}
+
+void TileScheduler::work()
+{
+  Job *job = nullptr;
+  std::size_t index = 0;
+  while( fetch(&job, &index) ) {
+    const rt::RenderBlock& tile = job->tiles[index];
+
+    // NOTE: Tiles of a cancelled job are skipped, but still counted as done.
+    const Image slice = !job->rc.isCancelled()
+        ? job->rc.render(tile)
+        : Image();
+
+    std::lock_guard<std::mutex> lock(job->mutex);
+    if( !slice.isEmpty()  &&  !job->rc.isCancelled()  &&  !job->deliver(tile, slice) ) {
+      job->rc.cancel();
+    }
+    if( ++job->numDone == job->tiles.size() ) {
+      job->done.notify_all();
+    }
+  }
+}
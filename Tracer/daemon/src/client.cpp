@@ -0,0 +1,140 @@
+/****************************************************************************
+** Copyright (c) 2021, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#include <cstdio>
+#include <cstdlib>
+
+#include <string>
+
+#include <unistd.h>
+
+#include "Image.h"
+#include "Protocol.h"
+
+void usage(const char *argv0)
+{
+  fprintf(stderr, "Usage: %s [-s socket] [-m method] [-c camera] [-w width] [-h height]\n"
+          "          [-n samples] [-t tileSize] [-r x0,y0,x1,y1] [-o output.png] scene.xml\n",
+          argv0);
+}
+
+int main(int argc, char **argv)
+{
+  std::string socketName = DAEMON_SOCKET;
+  std::string output = "output.png";
+
+  RenderJob job;
+
+  int opt = 0;
+  while( (opt = getopt(argc, argv, "s:m:c:w:h:n:t:r:o:")) != -1 ) {
+    if(        opt == 's' ) {
+      socketName = optarg;
+    } else if( opt == 'm' ) {
+      job.method = optarg;
+    } else if( opt == 'c' ) {
+      job.camera = optarg;
+    } else if( opt == 'w' ) {
+      job.width = rt::size_t(atoi(optarg));
+    } else if( opt == 'h' ) {
+      job.height = rt::size_t(atoi(optarg));
+    } else if( opt == 'n' ) {
+      job.samples = rt::size_t(atoi(optarg));
+    } else if( opt == 't' ) {
+      job.tileSize = rt::size_t(atoi(optarg));
+    } else if( opt == 'r' ) {
+      int x0 = 0, y0 = 0, x1 = 0, y1 = 0;
+      if( sscanf(optarg, "%d,%d,%d,%d", &x0, &y0, &x1, &y1) != 4  ||
+          x0 < 0  ||  y0 < 0  ||  x1 < 0  ||  y1 < 0 ) {
+        usage(argv[0]);
+        return EXIT_FAILURE;
+      }
+      job.window = rt::RenderBlock(x0, y0, x1, y1);
+    } else if( opt == 'o' ) {
+      output = optarg;
+    } else {
+      usage(argv[0]);
+      return EXIT_FAILURE;
+    }
+  }
+
+  if( optind + 1 != argc ) {
+    usage(argv[0]);
+    return EXIT_FAILURE;
+  }
+  job.scene = argv[optind];
+
+  // NOTE: The daemon resolves the scene's path relative to its own working directory.
+  char *path = realpath(job.scene.data(), nullptr);
+  if( path != nullptr ) {
+    job.scene = path;
+    free(path);
+  }
+
+  const int fd = connectTo(socketName);
+  if( fd < 0 ) {
+    fprintf(stderr, "ERROR: Unable to connect to \"%s\"!\n", socketName.data());
+    return EXIT_FAILURE;
+  }
+
+  if( !job.write(fd) ) {
+    fprintf(stderr, "ERROR: Unable to submit job!\n");
+    ::close(fd);
+    return EXIT_FAILURE;
+  }
+
+  Image image(job.width, job.height);
+  std::size_t numTiles = 0;
+
+  std::string line;
+  while( readLine(fd, &line) ) {
+    if(        line.compare(0, 5, "tile ") == 0 ) {
+      if( !readTile(fd, line, &image) ) {
+        break;
+      }
+      numTiles++;
+    } else if( line.compare(0, 5, "done ") == 0 ) {
+      ::close(fd);
+      printf("Received %d tiles in %sms.\n", int(numTiles), line.data() + 5);
+      return image.saveAsPNG(output.data())
+          ? EXIT_SUCCESS
+          : EXIT_FAILURE;
+    } else {
+      break;
+    }
+  }
+  ::close(fd);
+
+  fprintf(stderr, "ERROR: %s\n", line.compare(0, 6, "error ") == 0
+          ? line.data() + 6
+          : "Connection lost!");
+
+  return EXIT_FAILURE;
+}
@@ -0,0 +1,78 @@
+/****************************************************************************
+** Copyright (c) 2021, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#include <cstdio>
+#include <cstdlib>
+
+#include <algorithm>
+#include <string>
+#include <thread>
+
+#include <unistd.h>
+
+#include "Protocol.h"
+#include "Server.h"
+
+void usage(const char *argv0)
+{
+  fprintf(stderr, "Usage: %s [-s socket] [-t threads]\n", argv0);
+}
+
+int main(int argc, char **argv)
+{
+  std::string socketName = DAEMON_SOCKET;
+  std::size_t numThreads = std::max(1u, std::thread::hardware_concurrency());
+
+  int opt = 0;
+  while( (opt = getopt(argc, argv, "s:t:")) != -1 ) {
+    if(        opt == 's' ) {
+      socketName = optarg;
+    } else if( opt == 't' ) {
+      numThreads = std::size_t(std::max(1, atoi(optarg)));
+    } else {
+      usage(argv[0]);
+      return EXIT_FAILURE;
+    }
+  }
+
+  const int server = listenTo(socketName);
+  if( server < 0 ) {
+    fprintf(stderr, "ERROR: Unable to listen on \"%s\"!\n", socketName.data());
+    return EXIT_FAILURE;
+  }
+
+  printf("Listening on \"%s\" using %d threads...\n", socketName.data(), int(numThreads));
+  fflush(stdout);
+
+  runServer(server, numThreads);
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,215 @@
+/****************************************************************************
+** Copyright (c) 2021, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "rt/Renderer/RenderContext.h"
+
+#include "Coordinator.h"
+#include "Protocol.h"
+#include "Server.h"
+
+#include "Image.h"
+
+void usage(const char *argv0)
+{
+  fprintf(stderr, "Usage: %s [-l numLocalWorkers] [-j threadsPerLocalWorker] [-s socket]...\n"
+          "          [-m method] [-c camera] [-w width] [-h height] [-n samples] [-t tileSize]\n"
+          "          [-p probeSamples] [-o output.png] scene.xml\n",
+          argv0);
+}
+
+int main(int argc, char **argv)
+{
+  std::vector<std::string> sockets;
+  std::string output = "output.png";
+  int numLocal = 0;
+  int numLocalThreads = 1;
+  rt::size_t probeSamples = 1;
+
+  RenderJob job;
+
+  int opt = 0;
+  while( (opt = getopt(argc, argv, "l:j:s:m:c:w:h:n:t:p:o:")) != -1 ) {
+    if(        opt == 'l' ) {
+      numLocal = std::max(0, atoi(optarg));
+    } else if( opt == 'j' ) {
+      numLocalThreads = std::max(1, atoi(optarg));
+    } else if( opt == 's' ) {
+      sockets.push_back(optarg);
+    } else if( opt == 'm' ) {
+      job.method = optarg;
+    } else if( opt == 'c' ) {
+      job.camera = optarg;
+    } else if( opt == 'w' ) {
+      job.width = rt::size_t(atoi(optarg));
+    } else if( opt == 'h' ) {
+      job.height = rt::size_t(atoi(optarg));
+    } else if( opt == 'n' ) {
+      job.samples = rt::size_t(atoi(optarg));
+    } else if( opt == 't' ) {
+      job.tileSize = rt::size_t(atoi(optarg));
+    } else if( opt == 'p' ) {
+      probeSamples = rt::size_t(std::max(0, atoi(optarg)));
+    } else if( opt == 'o' ) {
+      output = optarg;
+    } else {
+      usage(argv[0]);
+      return EXIT_FAILURE;
+    }
+  }
+
+  if( optind + 1 != argc ) {
+    usage(argv[0]);
+    return EXIT_FAILURE;
+  }
+  job.scene = argv[optind];
+
+  char *path = realpath(job.scene.data(), nullptr);
+  if( path != nullptr ) {
+    job.scene = path;
+    free(path);
+  }
+
+  if( !job.isValid() ) {
+    usage(argv[0]);
+    return EXIT_FAILURE;
+  }
+
+  // (1) Local Workers ///////////////////////////////////////////////////////
+
+  /*
+   * NOTE:
+   * Local workers are forked prior to creating any threads, and listen
+   * on sockets created by the coordinator; hence no connection races.
+   */
+  std::vector<pid_t> children;
+  for(int i = 0; i < numLocal; i++) {
+    const std::string socketName = "/tmp/Tracer-Farm-" + std::to_string(getpid()) +
+        "-" + std::to_string(i) + ".sock";
+
+    const int server = listenTo(socketName);
+    if( server < 0 ) {
+      fprintf(stderr, "ERROR: Unable to listen on \"%s\"!\n", socketName.data());
+      continue;
+    }
+
+    fflush(stdout);
+    const pid_t child = fork();
+    if( child == 0 ) {
+      if( freopen("/dev/null", "w", stdout) == nullptr ) {
+        _exit(EXIT_FAILURE);
+      }
+      runServer(server, std::size_t(numLocalThreads));
+      _exit(EXIT_SUCCESS);
+    }
+    ::close(server);
+
+    if( child < 0 ) {
+      ::unlink(socketName.data());
+      continue;
+    }
+
+    children.push_back(child);
+    sockets.push_back(socketName);
+    printf("Worker %d: \"%s\"\n", int(child), socketName.data());
+  }
+  fflush(stdout);
+
+  if( sockets.empty() ) {
+    fprintf(stderr, "ERROR: No workers!\n");
+    return EXIT_FAILURE;
+  }
+
+  // (2) Tiles ///////////////////////////////////////////////////////////////
+
+  Coordinator::Tiles tiles;
+  for(const rt::RenderBlock& block : rt::makeRenderTiles(rt::RenderBlock(0, 0, job.width, job.height),
+                                                         job.tileSize)) {
+    tiles.emplace_back(block);
+  }
+
+  // (3) Render //////////////////////////////////////////////////////////////
+
+  using clock = std::chrono::steady_clock;
+  const clock::time_point tim_begin = clock::now();
+
+  Coordinator coordinator(sockets);
+  Image image;
+  bool ok = true;
+
+  // NOTE: A probe pass measures each tile's cost; the most expensive tiles are issued first.
+  if( probeSamples > 0  &&  probeSamples < job.samples ) {
+    RenderJob probe = job;
+    probe.samples = probeSamples;
+    ok = coordinator.render(&image, probe, &tiles);
+    Coordinator::sortByCost(&tiles);
+  }
+
+  ok = ok  &&  coordinator.render(&image, job, &tiles);
+
+  const long long msec =
+      std::chrono::duration_cast<std::chrono::milliseconds>(clock::now() - tim_begin).count();
+
+  for(const Coordinator::WorkerStats& worker : coordinator.workers()) {
+    printf("\"%s\": %4d tiles, %8lldms%s\n", worker.socketName.data(),
+           int(worker.numTiles), worker.msec, worker.is_alive ? "" : " (lost)");
+  }
+  printf("Duration: %lldms\n", msec);
+  fflush(stdout);
+
+  // (4) Clean Up ////////////////////////////////////////////////////////////
+
+  for(std::size_t i = 0; i < children.size(); i++) {
+    kill(children[i], SIGTERM);
+    waitpid(children[i], nullptr, 0);
+    ::unlink(sockets[sockets.size() - children.size() + i].data());
+  }
+
+  if( !ok ) {
+    fprintf(stderr, "ERROR: Unable to render \"%s\"!\n", job.scene.data());
+    return EXIT_FAILURE;
+  }
+
+  return image.saveAsPNG(output.data())
+      ? EXIT_SUCCESS
+      : EXIT_FAILURE;
+}
@@ -49,14 +49,40 @@ public:
   QImage image() const;
   void setImage(const QImage& image);
 
-  bool insert(const std::size_t y0, const Image& src);
+  bool insert(const std::size_t x0, const std::size_t y0, const Image& src);
 
   bool saveAs(const QString& filename, const int quality = -1) const;
 
+  int scale() const;
+  void setScale(const int scale);
+
+  QRect selection() const;
+  void clearSelection();
+
+  bool cursorPosition(QPointF *pos) const;
+
+signals:
+  void dragged(const QPoint& delta, const Qt::MouseButtons buttons);
+  void keyPressed(const int key);
+  void wheelTurned(const int degrees);
+
 protected:
+  void keyPressEvent(QKeyEvent *event);
+  void mouseMoveEvent(QMouseEvent *event);
+  void mousePressEvent(QMouseEvent *event);
+  void mouseReleaseEvent(QMouseEvent *event);
   void paintEvent(QPaintEvent *event);
+  void wheelEvent(QWheelEvent *event);
 
 private:
+  QRect imageRect() const;
+  QPoint toImage(const QPoint& pos) const;
+
   QBrush _backgroundBrush{};
   QImage _image{};
+  QPoint _lastPos{};
+  int _scale{1};
+  bool _is_selecting{false};
+  QPoint _selectionOrigin{};
+  QRect _selection{};
 };
@@ -31,9 +31,12 @@
 
 #pragma once
 
+#include <QtCore/QDateTime>
+#include <QtCore/QFileSystemWatcher>
 #include <QtCore/QFutureWatcher>
 #include <QtWidgets/QMainWindow>
 
+#include "rt/Loader/SceneIndex.h"
 #include "rt/Renderer/RenderContext.h"
 
 namespace Ui {
@@ -47,14 +50,41 @@ public:
   ~WMainWindow();
 
 private:
+  struct Interactive {
+    bool is_active{false};
+    bool is_preview{false};
+    bool is_restart{false};
+    bool is_reload{false};
+    rt::size_t numSamples{0}; // Accumulated at full resolution
+    rt::size_t numPassSamples{0};
+    rt::size_t width{0};
+    rt::size_t height{0};
+    rt::RenderOptions options{};
+    rt::Film accum{};
+    rt::Film pass{};
+  };
+
+  rt::CameraPtr createCamera(const rt::size_t width, const rt::size_t height,
+                             const rt::RenderOptions& options) const;
+  void finishPass();
+  void finishWork();
+  void initializeBlocks();
   void initializeImage();
   void initializeProgress();
   void initializeRender();
   bool initializeRenderContext();
   void initializeScene();
   void initializeWork();
+  void navigateDrag(const QPoint& delta, const Qt::MouseButtons buttons);
+  void navigateKey(const int key);
+  void navigateWheel(const int degrees);
   void openScene();
+  bool reloadScene();
+  void restartPass();
   void saveAs();
+  void sceneChanged(const QString& filename);
+  void startBlocks(rt::Film *film);
+  void startPass();
   void startWork();
   void updateResult(int index);
 
@@ -63,4 +93,10 @@ private:
   rt::RenderBlocks blocks;
   QFuture<Image> future;
   QFutureWatcher<Image> watcher;
+  QString sceneFilename;
+  QDateTime sceneModified;
+  rt::RenderOptions sceneOptions;
+  rt::SceneIndex sceneIndex;
+  QFileSystemWatcher sceneWatcher;
+  Interactive interactive;
 };
@@ -32,8 +32,12 @@
 #include <cstring>
 
 #include <QtGui/QClipboard>
+#include <QtGui/QCursor>
 #include <QtGui/QGuiApplication>
+#include <QtGui/QKeyEvent>
+#include <QtGui/QMouseEvent>
 #include <QtGui/QPainter>
+#include <QtGui/QWheelEvent>
 
 #include "WImage.h"
 
@@ -46,6 +50,7 @@ WImage::WImage(QWidget *parent, Qt::WindowFlags f)
   , _backgroundBrush(Qt::white, Qt::SolidPattern)
 {
   setAutoFillBackground(false);
+  setFocusPolicy(Qt::ClickFocus);
 }
 
 WImage::~WImage()
@@ -82,22 +87,24 @@ void WImage::setImage(const QImage& image)
   update();
 }
 
-bool WImage::insert(const Image::size_type y0, const Image& src)
+bool WImage::insert(const Image::size_type x0, const Image::size_type y0, const Image& src)
 {
   if( _image.isNull()  ||  src.isEmpty() ) {
     return false;
   }
 
-  const int  srcBytes  = int(src.stride());
   const int  srcWidth  = int(src.width());
   const int  srcHeight = int(src.height());
+  const int destX0     = int(x0);
   const int destY0     = int(y0);
-  if( srcWidth != _image.width()  ||  destY0 + srcHeight > _image.height()  ||
-      srcBytes != _image.bytesPerLine() ) {
+  if( destX0 + srcWidth > _image.width()  ||  destY0 + srcHeight > _image.height()  ||
+      _image.format() != QImage::Format_RGBA8888 ) {
     return false;
   }
 
-  std::memcpy(_image.scanLine(destY0), src.row(0), src.height()*src.stride());
+  for(int y = 0; y < srcHeight; y++) {
+    std::memcpy(_image.scanLine(destY0 + y) + destX0*4, src.row(y), src.stride());
+  }
 
   update();
 
@@ -112,8 +119,84 @@ bool WImage::saveAs(const QString& filename, const int quality) const
   return _image.save(filename, nullptr, quality);
 }
 
+int WImage::scale() const
+{
+  return _scale;
+}
+
+void WImage::setScale(const int scale)
+{
+  _scale = qMax(1, scale);
+  update();
+}
+
+QRect WImage::selection() const
+{
+  return _selection;
+}
+
+void WImage::clearSelection()
+{
+  _selection = QRect();
+  update();
+}
+
+// NOTE: Position of the mouse cursor relative to the image's extent, if located over the image.
+bool WImage::cursorPosition(QPointF *pos) const
+{
+  const QRect  rect = imageRect();
+  const QPoint    p = mapFromGlobal(QCursor::pos()) - rect.topLeft();
+  if( _image.isNull()  ||  !rect.contains(p + rect.topLeft()) ) {
+    return false;
+  }
+  *pos = QPointF(qreal(p.x())/qreal(rect.width()), qreal(p.y())/qreal(rect.height()));
+  return true;
+}
+
 ////// protected /////////////////////////////////////////////////////////////
 
+void WImage::keyPressEvent(QKeyEvent *event)
+{
+  emit keyPressed(event->key());
+  QWidget::keyPressEvent(event);
+}
+
+void WImage::mouseMoveEvent(QMouseEvent *event)
+{
+  if( _is_selecting ) {
+    const QRect bounds(QPoint(0, 0), _image.size());
+    _selection = QRect(_selectionOrigin, toImage(event->pos())).normalized() & bounds;
+    update();
+    return;
+  }
+
+  const QPoint delta = event->pos() - _lastPos;
+  _lastPos = event->pos();
+  if( event->buttons() != Qt::NoButton  &&  !delta.isNull() ) {
+    emit dragged(delta, event->buttons());
+  }
+}
+
+void WImage::mousePressEvent(QMouseEvent *event)
+{
+  _lastPos = event->pos();
+
+  // NOTE: Shift + Drag selects a region (e.g. a crop window); Shift + Click clears it.
+  if( event->button() == Qt::LeftButton  &&  (event->modifiers() & Qt::ShiftModifier) != 0 ) {
+    _is_selecting    = true;
+    _selectionOrigin = toImage(event->pos());
+    clearSelection();
+  }
+}
+
+void WImage::mouseReleaseEvent(QMouseEvent * /*event*/)
+{
+  _is_selecting = false;
+  if( _selection.width() < 2  ||  _selection.height() < 2 ) {
+    clearSelection();
+  }
+}
+
 void WImage::paintEvent(QPaintEvent * /*event*/)
 {
   QPainter painter(this);
@@ -124,8 +207,48 @@ void WImage::paintEvent(QPaintEvent * /*event*/)
     return;
   }
 
-  const int ox = (width()  - _image.width() )/2;
-  const int oy = (height() - _image.height())/2;
+  // NOTE: Reduced resolution previews are magnified by 'scale'.
+  const int w = _image.width()*_scale;
+  const int h = _image.height()*_scale;
+
+  const int ox = (width()  - w)/2;
+  const int oy = (height() - h)/2;
 
-  painter.drawImage(ox, oy, _image);
+  if( _scale > 1 ) {
+    painter.drawImage(QRect(ox, oy, w, h), _image);
+  } else {
+    painter.drawImage(ox, oy, _image);
+  }
+
+  if( !_selection.isEmpty() ) {
+    painter.setPen(QPen(Qt::white, 1, Qt::DashLine));
+    painter.setBrush(Qt::NoBrush);
+    painter.drawRect(QRect(imageRect().topLeft() + _selection.topLeft()*_scale,
+                           _selection.size()*_scale).adjusted(0, 0, -1, -1));
+  }
+}
+
+void WImage::wheelEvent(QWheelEvent *event)
+{
+  const int degrees = event->angleDelta().y()/8;
+  if( degrees != 0 ) {
+    emit wheelTurned(degrees);
+  }
+  event->accept();
+}
+
+////// private ///////////////////////////////////////////////////////////////
+
+QRect WImage::imageRect() const
+{
+  const int w = _image.width()*_scale;
+  const int h = _image.height()*_scale;
+  return QRect((width() - w)/2, (height() - h)/2, w, h);
+}
+
+// NOTE: Maps widget coordinates to (unclipped) image coordinates.
+QPoint WImage::toImage(const QPoint& pos) const
+{
+  const QPoint p = pos - imageRect().topLeft();
+  return QPoint(p.x()/_scale, p.y()/_scale);
 }
@@ -29,6 +29,8 @@
 ** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 *****************************************************************************/
 
+#include <algorithm>
+#include <cmath>
 #include <functional>
 
 #include <QtConcurrent/QtConcurrentMap>
@@ -42,10 +44,15 @@
 #include "pt/Renderer/PathTracer.h"
 #include "pt/Scene/Scene.h"
 #include "rt/Camera/FrustumCamera.h"
+#include "rt/Camera/Navigation.h"
 #include "rt/Camera/SimpleCamera.h"
 #include "rt/Loader/SceneLoader.h"
+#include "rt/Renderer/BidirectionalRenderer.h"
 #include "rt/Renderer/DirectLightingRenderer.h"
+#include "rt/Renderer/IrradianceCachingRenderer.h"
+#include "rt/Renderer/PathGuidingRenderer.h"
 #include "rt/Renderer/PathTracingRenderer.h"
+#include "rt/Renderer/PhotonMappingRenderer.h"
 #include "rt/Renderer/WhittedRenderer.h"
 #include "rt/Sampler/SimpleSampler.h"
 #include "rt/Scene/Scene.h"
@@ -58,10 +65,23 @@
 #define CAM_FRUSTUM  QStringLiteral("Frustum")
 #define CAM_SIMPLE   QStringLiteral("Simple")
 
+#define METH_BIDIR    QStringLiteral("Bidirectional")
 #define METH_DIRECT   QStringLiteral("DirectLighting")
+#define METH_GUIDING  QStringLiteral("PathGuiding")
+#define METH_IRRAD    QStringLiteral("IrradianceCaching")
 #define METH_PATH     QStringLiteral("PathTracing")
+#define METH_PHOTON   QStringLiteral("PhotonMapping")
 #define METH_WHITTED  QStringLiteral("Whitted")
 
+////// Constants /////////////////////////////////////////////////////////////
+
+constexpr rt::size_t MAX_PASS_SAMPLES = 16; // Bounds the latency of cancelling a refinement pass
+constexpr rt::size_t    PREVIEW_SCALE = 4;
+
+constexpr rt::real_t ORBIT_STEP = 0.005; // Radians per pixel dragged
+constexpr rt::real_t  WALK_STEP = 0.05;  // Relative to the distance of eye to look-at
+constexpr rt::real_t WHEEL_STEP = 0.9;   // Dolly scale per 15 degrees turned
+
 ////// public ////////////////////////////////////////////////////////////////
 
 WMainWindow::WMainWindow(QWidget *parent, Qt::WindowFlags flags)
@@ -81,6 +101,10 @@ WMainWindow::WMainWindow(QWidget *parent, Qt::WindowFlags flags)
   // Signals & Slots /////////////////////////////////////////////////////////
 
   connect(ui->quitAction, &QAction::triggered, this, &WMainWindow::close);
+
+  connect(ui->imageWidget, &WImage::dragged, this, &WMainWindow::navigateDrag);
+  connect(ui->imageWidget, &WImage::keyPressed, this, &WMainWindow::navigateKey);
+  connect(ui->imageWidget, &WImage::wheelTurned, this, &WMainWindow::navigateWheel);
 }
 
 WMainWindow::~WMainWindow()
@@ -90,6 +114,96 @@ WMainWindow::~WMainWindow()
 
 ////// private ///////////////////////////////////////////////////////////////
 
+rt::CameraPtr WMainWindow::createCamera(const rt::size_t width, const rt::size_t height,
+                                        const rt::RenderOptions& options) const
+{
+  if(        ui->cameraCombo->currentText() == CAM_FRUSTUM ) {
+    return rt::FrustumCamera::create(width, height, options);
+  } else if( ui->cameraCombo->currentText() == CAM_SIMPLE ) {
+    return rt::SimpleCamera::create(width, height, options);
+  }
+  return rt::CameraPtr();
+}
+
+void WMainWindow::finishPass()
+{
+  initializeProgress();
+
+  if( interactive.is_restart ) {
+    interactive.is_restart = false;
+    startPass();
+    return;
+  }
+
+  if( watcher.isCanceled()  ||  !interactive.is_active ) {
+    return;
+  }
+
+  // NOTE: endFrame() completes the pass' film, e.g. with light tracing splats.
+  Image image;
+  const bool have_image = rc.endFrame(&image, &interactive.pass);
+
+  if( interactive.is_preview ) {
+    if( have_image ) {
+      ui->imageWidget->insert(0, 0, image);
+    }
+    interactive.is_preview = false;
+
+  } else {
+    interactive.numSamples += interactive.numPassSamples;
+    if( interactive.numSamples == interactive.numPassSamples ) {
+      interactive.accum.resize(interactive.width, interactive.height);
+    }
+
+    const rt::real_t weight = rt::real_t(interactive.numPassSamples)/rt::real_t(interactive.numSamples);
+    if( interactive.accum.accumulate(interactive.pass, weight) ) {
+      ui->imageWidget->insert(0, 0, interactive.accum.develop(rt::ZERO, interactive.options.gamma));
+    }
+
+    if( interactive.numSamples >= rt::size_t(ui->samplesPerPixelCombo->value()) ) {
+      return;
+    }
+  }
+
+  startPass();
+}
+
+void WMainWindow::finishWork()
+{
+  if( interactive.is_active ) {
+    finishPass();
+    return;
+  }
+
+  if( !watcher.isCanceled() ) {
+    Image image;
+    if( rc.endFrame(&image) ) {
+      const rt::RenderBlock window = rc.renderWindow();
+      ui->imageWidget->insert(window.x0, window.y0,
+                              image.crop(window.x0, window.y0, window.width(), window.height()));
+    }
+  }
+  initializeProgress();
+}
+
+void WMainWindow::initializeBlocks()
+{
+  const rt::RenderBlock window = rc.renderWindow();
+  blocks = rt::makeRenderTiles(window, ui->blockSizeSpin->value());
+
+  // NOTE: Tiles are delivered nearest to the mouse cursor first, else the window's center.
+  QPointF cursor;
+  if( ui->imageWidget->cursorPosition(&cursor) ) {
+    rt::prioritizeRenderBlocks(&blocks,
+                               rt::real_t(cursor.x())*rt::real_t(rc.camera->width()),
+                               rt::real_t(cursor.y())*rt::real_t(rc.camera->height()));
+  } else {
+    rt::prioritizeRenderBlocks(&blocks,
+                               rt::real_t(window.x0 + window.x1)/2,
+                               rt::real_t(window.y0 + window.y1)/2);
+  }
+}
+
 void WMainWindow::initializeImage()
 {
   ui->saveAsAction->setShortcut(QKeySequence::SaveAs);
@@ -108,13 +222,15 @@ void WMainWindow::initializeProgress()
   ui->progressBar->setRange(0, 100);
   ui->progressBar->setValue(0);
 
-  ui->startButton->setText(tr("Start"));
+  ui->startButton->setText(interactive.is_active
+                           ? tr("Stop")
+                           : tr("Start"));
 }
 
 void WMainWindow::initializeRender()
 {
   ui->methodCombo->clear();
-  ui->methodCombo->addItems({METH_DIRECT, METH_PATH, METH_WHITTED});
+  ui->methodCombo->addItems({METH_DIRECT, METH_PATH, METH_WHITTED, METH_BIDIR, METH_PHOTON, METH_IRRAD, METH_GUIDING});
 
   ui->cameraCombo->clear();
   ui->cameraCombo->addItems({CAM_FRUSTUM, CAM_SIMPLE});
@@ -138,6 +254,7 @@ void WMainWindow::initializeRender()
 
 bool WMainWindow::initializeRenderContext()
 {
+  rt::ScenePtr loaded = std::move(rc.scene);
   rc.clear();
 
   if( ui->sceneEdit->text().isEmpty() ) {
@@ -151,29 +268,67 @@ bool WMainWindow::initializeRenderContext()
 
   // (1) Scene & RenderOptions ///////////////////////////////////////////////
 
-  rt::RenderOptions options;
-
-  bool ok = false;
-  if( is_pathtracer ) {
-    rc.scene = pt::Scene::create();
-    pt::Scene *scene = pt::SCENE(rc.scene);
-    ok = pt::Scene::load(scene, &options, filename.toUtf8().constData());
+  /*
+   * NOTE:
+   * An unmodified scene is not loaded again; this keeps its acceleration
+   * structures and primary-visibility G-buffer alive across re-renders.
+   * A modified scene of the same file is reloaded incrementally.
+   */
+  const QDateTime modified = QFileInfo(filename).lastModified();
+  if( loaded  &&  filename == sceneFilename  &&  modified == sceneModified ) {
+    rc.scene = std::move(loaded);
+  } else if( loaded  &&  filename == sceneFilename  &&  !is_pathtracer ) {
+    rc.scene = std::move(loaded);
+    if( !reloadScene() ) {
+      return false;
+    }
   } else {
-    rc.scene = rt::Scene::create();
-    rt::Scene *scene = rt::SCENE(rc.scene);
-    ok = rt::loadScene(scene, &options, filename.toUtf8().constData());
-    if( ok ) {
-      scene->setUseCastShadow(ui->castShadowCheck->isChecked());
+    loaded.reset();
+    sceneFilename.clear();
+    sceneOptions = rt::RenderOptions();
+    sceneIndex.clear();
+
+    bool ok = false;
+    if( is_pathtracer ) {
+      rc.scene = pt::Scene::create();
+      pt::Scene *scene = pt::SCENE(rc.scene);
+      ok = pt::Scene::load(scene, &sceneOptions, filename.toUtf8().constData());
+    } else {
+      rc.scene = rt::Scene::create();
+      rt::Scene *scene = rt::SCENE(rc.scene);
+      ok = rt::loadSceneCached(scene, &sceneOptions, filename.toUtf8().constData(), &sceneIndex);
     }
+
+    if( !ok ) {
+      rc.scene.reset();
+      QMessageBox::critical(this, tr("Error"),
+                            tr("Unable to load scene!"),
+                            QMessageBox::Ok, QMessageBox::NoButton);
+      return false;
+    }
+
+    sceneFilename = filename;
+    sceneModified = modified;
+
+    if( !sceneWatcher.files().isEmpty() ) {
+      sceneWatcher.removePaths(sceneWatcher.files());
+    }
+    sceneWatcher.addPath(sceneFilename);
   }
 
-  if( !ok ) {
-    QMessageBox::critical(this, tr("Error"),
-                          tr("Unable to load scene!"),
-                          QMessageBox::Ok, QMessageBox::NoButton);
-    return false;
+  /*
+   * NOTE:
+   * Progressive passes must not reuse the (jittered) primary hits of previous passes;
+   * hence the G-buffer is disabled in interactive mode.
+   */
+  if( !is_pathtracer ) {
+    rt::Scene *scene = rt::SCENE(rc.scene);
+    scene->setUseCastShadow(ui->castShadowCheck->isChecked());
+    scene->setUseGBuffer(!ui->interactiveCheck->isChecked());
   }
 
+  rt::RenderOptions options = sceneOptions;
+
   options.gamma    = ui->gammaSpin->value();
   options.maxDepth = ui->maxDepthSpin->value();
 
@@ -188,6 +343,14 @@ bool WMainWindow::initializeRenderContext()
     rc.renderer = rt::PathTracingRenderer::create(options);
   } else if( ui->methodCombo->currentText() == METH_WHITTED ) {
     rc.renderer = rt::WhittedRenderer::create(options);
+  } else if( ui->methodCombo->currentText() == METH_BIDIR ) {
+    rc.renderer = rt::BidirectionalRenderer::create(options);
+  } else if( ui->methodCombo->currentText() == METH_PHOTON ) {
+    rc.renderer = rt::PhotonMappingRenderer::create(options);
+  } else if( ui->methodCombo->currentText() == METH_IRRAD ) {
+    rc.renderer = rt::IrradianceCachingRenderer::create(options);
+  } else if( ui->methodCombo->currentText() == METH_GUIDING ) {
+    rc.renderer = rt::PathGuidingRenderer::create(options);
   } else {
     QMessageBox::critical(this, tr("Error"),
                           tr("Invalid method!"),
@@ -199,11 +362,8 @@ bool WMainWindow::initializeRenderContext()
 
   const rt::size_t  width = ui->widthSpin->value();
   const rt::size_t height = ui->heightSpin->value();
-  if(        ui->cameraCombo->currentText() == CAM_FRUSTUM ) {
-    rc.camera = rt::FrustumCamera::create(width, height, rc.renderer->options());
-  } else if( ui->cameraCombo->currentText() == CAM_SIMPLE ) {
-    rc.camera = rt::SimpleCamera::create(width, height, rc.renderer->options());
-  } else {
+  rc.camera = createCamera(width, height, rc.renderer->options());
+  if( !rc.camera ) {
     QMessageBox::critical(this, tr("Error"),
                           tr("Invalid camera!"),
                           QMessageBox::Ok, QMessageBox::NoButton);
@@ -214,15 +374,26 @@ bool WMainWindow::initializeRenderContext()
 
   rc.sampler = rt::SimpleSampler::create(ui->samplesPerPixelCombo->value());
 
-  // (5) Blocks //////////////////////////////////////////////////////////////
+  // (5) Crop Window & Blocks ///////////////////////////////////////////////
+
+  // NOTE: A crop window is composited into the previous image of the same size.
+  const QRect selection = ui->imageWidget->selection();
+  const bool is_crop = ui->cropCheck->isChecked()  &&  !ui->interactiveCheck->isChecked()  &&
+      !selection.isEmpty()  &&  ui->imageWidget->image().size() == QSize(int(width), int(height));
+  if( is_crop ) {
+    rc.window = rt::RenderBlock(selection.left(), selection.top(),
+                                selection.right() + 1, selection.bottom() + 1);
+  }
 
-  blocks = rt::makeRenderBlocks(height, ui->blockSizeSpin->value());
+  initializeBlocks();
 
   // (6) Rendered Image //////////////////////////////////////////////////////
 
-  QImage image(int(width), int(height), QImage::Format_RGBA8888);
-  image.fill(Qt::black);
-  ui->imageWidget->setImage(image);
+  if( !is_crop ) {
+    QImage image(int(width), int(height), QImage::Format_RGBA8888);
+    image.fill(Qt::black);
+    ui->imageWidget->setImage(image);
+  }
 
   // (7) Final Check /////////////////////////////////////////////////////////
 
@@ -240,6 +411,8 @@ void WMainWindow::initializeScene()
 {
   connect(ui->openButton, &QPushButton::clicked, this, &WMainWindow::openScene);
 
+  connect(&sceneWatcher, &QFileSystemWatcher::fileChanged, this, &WMainWindow::sceneChanged);
+
   ui->castShadowCheck->setChecked(false);
 }
 
@@ -251,7 +424,81 @@ void WMainWindow::initializeWork()
   ui->numThreadsSpin->setValue(QThread::idealThreadCount());
 
   ui->blockSizeSpin->setRange(1, 128);
-  ui->blockSizeSpin->setValue(8);
+  ui->blockSizeSpin->setValue(32);
+
+  ui->interactiveCheck->setChecked(false);
+  ui->cropCheck->setChecked(false);
+}
+
+void WMainWindow::navigateDrag(const QPoint& delta, const Qt::MouseButtons buttons)
+{
+  if( !interactive.is_active ) {
+    return;
+  }
+
+  rt::RenderOptions& options = interactive.options;
+  if(        (buttons & Qt::LeftButton) != 0 ) {
+    options = rt::orbitView(options, -ORBIT_STEP*delta.x(), ORBIT_STEP*delta.y());
+  } else if( (buttons & (Qt::MiddleButton | Qt::RightButton)) != 0 ) {
+    // NOTE: Pan by the extent of one pixel on the plane of 'lookAt'.
+    const rt::real_t step = 2*std::tan(options.fov_rad/2)/rt::real_t(interactive.height);
+    options = rt::panView(options, -step*delta.x(), step*delta.y());
+  } else {
+    return;
+  }
+
+  restartPass();
+}
+
+void WMainWindow::navigateKey(const int key)
+{
+  if( !interactive.is_active ) {
+    return;
+  }
+
+  rt::real_t forward = 0, right = 0, up = 0;
+  switch( key ) {
+  case Qt::Key_W:
+  case Qt::Key_Up:
+    forward = WALK_STEP;
+    break;
+  case Qt::Key_S:
+  case Qt::Key_Down:
+    forward = -WALK_STEP;
+    break;
+  case Qt::Key_D:
+  case Qt::Key_Right:
+    right = WALK_STEP;
+    break;
+  case Qt::Key_A:
+  case Qt::Key_Left:
+    right = -WALK_STEP;
+    break;
+  case Qt::Key_E:
+  case Qt::Key_PageUp:
+    up = WALK_STEP;
+    break;
+  case Qt::Key_Q:
+  case Qt::Key_PageDown:
+    up = -WALK_STEP;
+    break;
+  default:
+    return;
+  }
+
+  interactive.options = rt::walkView(interactive.options, forward, right, up);
+  restartPass();
+}
+
+void WMainWindow::navigateWheel(const int degrees)
+{
+  if( !interactive.is_active ) {
+    return;
+  }
+
+  interactive.options = rt::dollyView(interactive.options,
+                                      std::pow(WHEEL_STEP, rt::real_t(degrees)/15));
+  restartPass();
 }
 
 void WMainWindow::openScene()
@@ -266,6 +513,42 @@ void WMainWindow::openScene()
   QDir::setCurrent(QFileInfo(filename).absolutePath());
 }
 
+// NOTE: The scene must not be rendered meanwhile.
+bool WMainWindow::reloadScene()
+{
+  rt::Scene *scene = rt::SCENE(rc.scene);
+  if( scene == nullptr ) {
+    return false;
+  }
+
+  const QDateTime modified = QFileInfo(sceneFilename).lastModified();
+  if( !rt::reloadScene(scene, &sceneOptions, sceneFilename.toUtf8().constData(), &sceneIndex) ) {
+    QMessageBox::critical(this, tr("Error"),
+                          tr("Unable to reload scene!"),
+                          QMessageBox::Ok, QMessageBox::NoButton);
+    return false;
+  }
+  sceneModified = modified;
+
+  return true;
+}
+
+void WMainWindow::restartPass()
+{
+  interactive.is_preview = true;
+  interactive.numSamples = 0;
+
+  // NOTE: Pending blocks are dropped; finishPass() restarts once the running ones are done.
+  if( watcher.isRunning() ) {
+    interactive.is_restart = true;
+    rc.cancel();
+    watcher.cancel();
+    return;
+  }
+
+  startPass();
+}
+
 void WMainWindow::saveAs()
 {
   const QString filename = QFileDialog::getSaveFileName(this, tr("Save as"),
@@ -278,13 +561,111 @@ void WMainWindow::saveAs()
   QDir::setCurrent(QFileInfo(filename).absolutePath());
 }
 
+void WMainWindow::sceneChanged(const QString& filename)
+{
+  // NOTE: Editors may save by replacing the file, which ends watching it.
+  if( !sceneWatcher.files().contains(filename)  &&  QFileInfo::exists(filename) ) {
+    sceneWatcher.addPath(filename);
+  }
+
+  /*
+   * NOTE:
+   * In interactive mode, the scene is reloaded once the running pass finished &
+   * rendered progressively anew; otherwise it is reloaded when rendering starts.
+   */
+  if( filename != sceneFilename  ||  !interactive.is_active  ||  rt::SCENE(rc.scene) == nullptr ) {
+    return;
+  }
+
+  interactive.is_reload = true;
+  restartPass();
+}
+
+void WMainWindow::startBlocks(rt::Film *film)
+{
+#ifdef HAVE_MANUAL_PROGRESS
+  ui->progressBar->setRange(0, int(blocks.size()));
+  ui->progressBar->setValue(0);
+#endif
+
+  using Watcher = QFutureWatcher<Image>;
+  connect(&watcher, &Watcher::finished,
+          this, &WMainWindow::finishWork);
+#ifndef HAVE_MANUAL_PROGRESS
+  connect(&watcher, &Watcher::progressRangeChanged,
+          ui->progressBar, &QProgressBar::setRange);
+  connect(&watcher, &Watcher::progressValueChanged,
+          ui->progressBar, &QProgressBar::setValue);
+#endif
+  connect(&watcher, &Watcher::resultReadyAt,
+          this, &WMainWindow::updateResult);
+
+  // NOTE: No Lambdas with captures for QtConcurrent::mapped() !!!
+  using RenderFunc = std::function<Image(const rt::RenderBlock&)>;
+  RenderFunc render = [&, film](const rt::RenderBlock& block) -> Image {
+    return rc.render(block, film);
+  };
+
+  rc.beginFrame();
+  future = QtConcurrent::mapped(blocks, render);
+  watcher.setFuture(future);
+}
+
+void WMainWindow::startPass()
+{
+  if( interactive.is_reload ) {
+    interactive.is_reload = false;
+    reloadScene();
+  }
+
+  /*
+   * NOTE:
+   * A pass either previews the current view at reduced resolution using one sample per pixel,
+   * or refines the full resolution image by doubling its number of samples per pixel.
+   */
+  const rt::size_t scale = interactive.is_preview
+      ? PREVIEW_SCALE
+      : 1;
+  const rt::size_t  width = std::max<rt::size_t>(1, interactive.width/scale);
+  const rt::size_t height = std::max<rt::size_t>(1, interactive.height/scale);
+
+  const rt::size_t numRemain = rt::size_t(ui->samplesPerPixelCombo->value()) - interactive.numSamples;
+  interactive.numPassSamples = interactive.is_preview
+      ? 1
+      : std::clamp<rt::size_t>(interactive.numSamples, 1, std::min(numRemain, MAX_PASS_SAMPLES));
+
+  rc.renderer->setOptions(interactive.options);
+  rc.camera  = createCamera(width, height, rc.renderer->options());
+  rc.sampler = rt::SimpleSampler::create(interactive.numPassSamples);
+
+  interactive.pass.resize(width, height);
+
+  initializeBlocks();
+
+  // Show the previous image until the pass' blocks arrive...
+  if( interactive.is_preview  ||  interactive.numSamples == 0 ) {
+    const QImage previous = ui->imageWidget->image();
+    ui->imageWidget->setImage(previous.scaled(int(width), int(height)));
+    ui->imageWidget->setScale(int(scale));
+  }
+
+  startBlocks(&interactive.pass);
+}
+
 void WMainWindow::startWork()
 {
-  if( watcher.isRunning() ) {
+  if( watcher.isRunning()  ||  interactive.is_active ) {
+    interactive.is_active  = false;
+    interactive.is_restart = false;
+    interactive.is_reload  = false;
+
+    rc.cancel();
     watcher.cancel();
     watcher.waitForFinished();
     initializeProgress();
 
+    ui->imageWidget->setScale(1);
+
   } else {
     if( !initializeRenderContext() ) {
       return;
@@ -292,31 +673,20 @@ void WMainWindow::startWork()
 
     QThreadPool::globalInstance()->setMaxThreadCount(ui->numThreadsSpin->value());
 
-#ifdef HAVE_MANUAL_PROGRESS
-    ui->progressBar->setRange(0, int(blocks.size()));
-    ui->progressBar->setValue(0);
-#endif
+    if( ui->interactiveCheck->isChecked() ) {
+      interactive.is_active = true;
+      interactive.width     = ui->widthSpin->value();
+      interactive.height    = ui->heightSpin->value();
+      interactive.options   = rc.renderer->options();
 
-    using Watcher = QFutureWatcher<Image>;
-    connect(&watcher, &Watcher::finished,
-            this, &WMainWindow::initializeProgress);
-#ifndef HAVE_MANUAL_PROGRESS
-    connect(&watcher, &Watcher::progressRangeChanged,
-            ui->progressBar, &QProgressBar::setRange);
-    connect(&watcher, &Watcher::progressValueChanged,
-            ui->progressBar, &QProgressBar::setValue);
-#endif
-    connect(&watcher, &Watcher::resultReadyAt,
-            this, &WMainWindow::updateResult);
-
-    // NOTE: No Lambdas with captures for QtConcurrent::mapped() !!!
-    using RenderFunc = std::function<Image(const rt::RenderBlock&)>;
-    RenderFunc render = [&](const rt::RenderBlock& block) -> Image {
-      return rc.render(block);
-    };
+      restartPass();
+      ui->startButton->setText(tr("Stop"));
+      ui->imageWidget->setFocus();
+      return;
+    }
 
-    future = QtConcurrent::mapped(blocks, render);
-    watcher.setFuture(future);
+    ui->imageWidget->setScale(1);
+    startBlocks(nullptr);
 
     ui->startButton->setText(tr("Cancel"));
   }
@@ -324,9 +694,16 @@ void WMainWindow::startWork()
 
 void WMainWindow::updateResult(int index)
 {
+  // NOTE: Refinement passes are shown once they are accumulated.
+  if( interactive.is_active  &&  !interactive.is_preview  &&  interactive.numSamples > 0 ) {
+#ifdef HAVE_MANUAL_PROGRESS
+    ui->progressBar->setValue(ui->progressBar->value() + 1);
+#endif
+    return;
+  }
+
   const rt::RenderBlocks::const_iterator it = std::next(blocks.begin(), index);
-  const rt::size_t y0 = std::get<0>(*it);
-  ui->imageWidget->insert(y0, watcher.resultAt(index));
+  ui->imageWidget->insert(it->x0, it->y0, watcher.resultAt(index));
 #ifdef HAVE_MANUAL_PROGRESS
   ui->progressBar->setValue(ui->progressBar->value() + 1);
 #endif
@@ -31,23 +31,44 @@
 
 #pragma once
 
+#include <vector>
+
 #include "pt/BSDF/IBSDF.h"
 #include "pt/Shape/IShape.h"
+#include "rt/Base/Registry.h"
 #include "rt/Texture/ITexture.h"
 
 namespace pt {
 
   using ObjectPtr = std::unique_ptr<class Object>;
 
+  /*
+   * NOTE:
+   * An instance owns no faces, but places a shared prototype in world space;
+   * intersections report the prototype as their object, i.e. its BSDF,
+   * textures & emittance are shared by all of its instances.
+   */
   class Object {
   public:
+    using PrototypePtr = std::shared_ptr<const Object>;
+
     Object(const rt::Transform& objectToWorld) noexcept;
     ~Object() noexcept;
 
+    Object(Object&&) noexcept;
+    Object& operator=(Object&&) noexcept;
+
     void add(ShapePtr& shape);
 
     bool intersect(IntersectionInfo *info, const rt::Ray& ray) const;
 
+    const rt::Bounds& bounds() const;
+
+    // NOTE: Moves all faces in world space & updates the bounds; cf. pt::Scene.
+    void moveObject(const rt::Transform& objectToWorld);
+    const rt::Transform& objectToWorld() const;
+    void setObjectToWorld(const rt::Transform& objectToWorld);
+
     rt::Color emittance() const;
     void setEmissiveColor(const rt::Color& c);
     void setEmissiveScale(const rt::real_t s);
@@ -57,12 +78,18 @@ namespace pt {
     bool setBSDF(BSDFPtr& bsdf);
 
     bool haveTexture() const;
-    bool setTexture(const rt::size_t id, rt::TexturePtr& texture);
+    bool setTexture(const rt::size_t id, const rt::TextureRef& texture);
 
     void preprocess();
 
+    // NOTE: Copies all faces' shapes into 'arena', which henceforth owns them; cf. pt::Scene.
+    void storeShapes(ShapeArena *arena);
+
     static ObjectPtr create(const rt::Transform& objectToWorld);
 
+    static ObjectPtr createInstance(const rt::Transform& objectToWorld,
+                                    const PrototypePtr& prototype);
+
     static ObjectPtr createBox(const rt::Transform& objectToWorld,
                                const rt::real_t dimx,
                                const rt::real_t dimy,
@@ -78,25 +105,32 @@ namespace pt {
                                   const rt::real_t radius);
 
     static bool isObject(const tinyxml2::XMLElement *elem);
-    static ObjectPtr load(const tinyxml2::XMLElement *elem);
+    // NOTE: Equal textures are shared by all objects loaded with the same 'textures'.
+    static ObjectPtr load(const tinyxml2::XMLElement *elem,
+                          rt::Registry<rt::ITexture> *textures);
 
   private:
     struct ObjectFace {
       ObjectFace(ShapePtr& _shape) noexcept
-        : shape(std::move(_shape))
+        : owned(std::move(_shape))
+        , shape(owned.get())
       {
       }
 
-      ShapePtr       shape;
-      rt::TexturePtr texture;
+      ShapePtr       owned; // NOTE: Empty, if 'shape' is stored in a scene's arena.
+      IShape        *shape{nullptr};
+      rt::TextureRef texture;
 
     private:
       ObjectFace() noexcept = delete;
     };
 
-    using ObjectFaces = std::list<ObjectFace>;
+    // NOTE: Faces are stored contiguously; face 'id' is at index 'id - 1'.
+    using ObjectFaces = std::vector<ObjectFace>;
 
     Object() noexcept = delete;
+    Object(const Object&) = delete;
+    Object& operator=(const Object&) = delete;
 
     static bool isBox(const tinyxml2::XMLElement *elem);
     static bool isInvertedBox(const tinyxml2::XMLElement *elem);
@@ -116,10 +150,10 @@ namespace pt {
     rt::Color      _emitColor{0, 0, 0};
     rt::real_t     _emitScale{1};
     ObjectFaces    _faces;
-    rt::TexturePtr _texture;
+    PrototypePtr   _prototype;
+    rt::TextureRef _texture;
+    rt::Transform  _xformOW{}; // World -> Object
     rt::Transform  _xformWO{}; // Object -> World
   };
 
-  using Objects = std::list<ObjectPtr>;
-
 } // namespace pt
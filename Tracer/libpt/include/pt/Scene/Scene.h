@@ -31,9 +31,13 @@
 
 #pragma once
 
+#include "rt/Base/Arena.h"
+#include "rt/Base/Registry.h"
 #include "rt/Base/Types.h"
+#include "rt/Scene/BVH.h"
 #include "rt/Scene/IScene.h"
 #include "pt/Scene/Object.h"
+#include "pt/Shape/ShapeArena.h"
 
 namespace rt {
   struct RenderOptions;
@@ -46,15 +50,35 @@ namespace pt {
     Scene() noexcept;
     ~Scene() noexcept;
 
+    // NOTE: Frees all objects & their shapes at once; cf. rt::Arena.
     void clear();
 
+    // NOTE: Moves 'object' & its shapes into the scene's arenas, in order of insertion.
     void add(ObjectPtr& object);
 
+    bool aov(rt::AOV *aov, const rt::Ray& ray) const;
+
+    void beginFrame(const rt::CameraPtr& camera, const rt::SamplerPtr& sampler,
+                    const rt::RenderOptions& options);
+
     rt::Color backgroundColor() const;
     void setBackgroundColor(const rt::Color& c);
 
     bool intersect(IntersectionInfo *info, const rt::Ray& ray) const;
 
+    // NOTE: Moves 'object' of this scene in place; its node in the BVH is refitted.
+    void moveObject(Object *object, const rt::Transform& objectToWorld);
+    void setObjectToWorld(Object *object, const rt::Transform& objectToWorld);
+
+    // NOTE: cf. rt::Scene; the BVH is (re)built by beginFrame() after objects were added.
+    const rt::BVH& bvh() const;
+    void buildBVH();
+    void updateBVH(const bool wait = false);
+    void setBVHRebuildThreshold(const rt::real_t ratio);
+
+    // NOTE: The shared textures of this scene's objects; cf. Object::load().
+    rt::Registry<rt::ITexture> *textures();
+
     static rt::ScenePtr create();
 
     static bool isScene(const tinyxml2::XMLElement *elem);
@@ -63,8 +87,17 @@ namespace pt {
     static bool load(Scene *scene, rt::RenderOptions *options, const char *filename);
 
   private:
+    template<typename VisitorT>
+    void traverse(const rt::Ray& ray, VisitorT&& visit) const;
+
+    void refitBVH(const Object *object);
+
     rt::Color _background;
-    Objects _objects;
+    rt::Arena<Object> _objects; // NOTE: Indexed by the BVH's primitives.
+    ShapeArena _shapes;
+    rt::BVH _bvh;
+    bool _bvh_dirty{true};
+    rt::Registry<rt::ITexture> _textures;
   };
 
   inline Scene *SCENE(const rt::ScenePtr& p)
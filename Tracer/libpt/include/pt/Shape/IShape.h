@@ -43,6 +43,7 @@ namespace tinyxml2 {
 namespace pt {
 
   struct IntersectionInfo;
+  struct ShapeArena;
 
   using ShapePtr = std::unique_ptr<class IShape>;
 
@@ -54,6 +55,9 @@ namespace pt {
     // NOTE: All arguments passed to/returned from this method are in WORLD coordinates!
     virtual bool intersect(IntersectionInfo *info, const rt::Ray& ray) const = 0;
 
+    // NOTE: Returns a copy of this shape stored in 'arena'; cf. pt::Scene.
+    virtual IShape *copyTo(ShapeArena *arena) const = 0;
+
     void moveShape(const rt::Transform& shapeToWorld);
     void setShapeToWorld(const rt::Transform& shapeToWorld);
 
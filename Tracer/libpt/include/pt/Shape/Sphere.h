@@ -43,6 +43,8 @@ namespace pt {
 
     bool intersect(IntersectionInfo *info, const rt::Ray& ray) const final;
 
+    IShape *copyTo(ShapeArena *arena) const final;
+
     rt::Bounds shapeBounds() const;
 
     static ShapePtr create(const rt::Transform& objectToWorld,
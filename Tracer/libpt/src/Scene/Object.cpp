@@ -38,7 +38,8 @@ namespace pt {
   ////// public //////////////////////////////////////////////////////////////
 
   Object::Object(const rt::Transform& objectToWorld) noexcept
-    : _xformWO(objectToWorld)
+    : _xformOW(objectToWorld.inverse())
+    , _xformWO(objectToWorld)
   {
   }
 
@@ -46,6 +47,10 @@ namespace pt {
   {
   }
 
+  Object::Object(Object&&) noexcept = default;
+
+  Object& Object::operator=(Object&&) noexcept = default;
+
   void Object::add(ShapePtr& shape)
   {
     if( !shape ) {
@@ -65,6 +70,20 @@ namespace pt {
       return false;
     }
 
+    // NOTE: Transforms are rigid, hence 't' is the same in both coordinate systems.
+    if( _prototype ) {
+      if( !_prototype->intersect(info, _xformOW*ray) ) {
+        return false;
+      }
+
+      info->N = _xformWO*info->N;
+      info->P = _xformWO*info->P;
+
+      info->initializeShading(ray);
+
+      return true;
+    }
+
     *info = IntersectionInfo();
 
     for(const ObjectFace& face : _faces) {
@@ -87,6 +106,33 @@ namespace pt {
     return info->isHit();
   }
 
+  const rt::Bounds& Object::bounds() const
+  {
+    return _bounds;
+  }
+
+  void Object::moveObject(const rt::Transform& objectToWorld)
+  {
+    for(ObjectFace& face : _faces) {
+      face.shape->moveShape(objectToWorld);
+    }
+    _xformWO = objectToWorld*_xformWO;
+    _xformOW = _xformWO.inverse();
+    preprocess();
+  }
+
+  const rt::Transform& Object::objectToWorld() const
+  {
+    return _xformWO;
+  }
+
+  void Object::setObjectToWorld(const rt::Transform& objectToWorld)
+  {
+    moveObject(objectToWorld*_xformOW);
+    _xformOW = objectToWorld.inverse();
+    _xformWO = objectToWorld;
+  }
+
   rt::Color Object::emittance() const
   {
     return _emitColor*_emitScale;
@@ -123,22 +169,27 @@ namespace pt {
     return bool(_texture);
   }
 
-  bool Object::setTexture(const rt::size_t id, rt::TexturePtr& texture)
+  bool Object::setTexture(const rt::size_t id, const rt::TextureRef& texture)
   {
     if( id == 0 ) {
-      _texture = std::move(texture);
+      _texture = texture;
       return haveTexture();
     }
     if( id < 1  ||  id > _faces.size() ) {
       return false;
     }
-    ObjectFaces::iterator face = std::next(_faces.begin(), id - 1);
-    face->texture = std::move(texture);
-    return bool(face->texture);
+    ObjectFace& face = _faces[id - 1];
+    face.texture = texture;
+    return bool(face.texture);
   }
 
   void Object::preprocess()
   {
+    if( _prototype ) {
+      _bounds = _xformWO*_prototype->bounds();
+      return;
+    }
+
     _bounds = rt::Bounds();
     for(const ObjectFace& face : _faces) {
       const rt::Bounds wb = face.shape->worldBounds();
@@ -147,6 +198,16 @@ namespace pt {
     }
   }
 
+  void Object::storeShapes(ShapeArena *arena)
+  {
+    for(ObjectFace& face : _faces) {
+      if( face.owned ) {
+        face.shape = face.owned->copyTo(arena);
+        face.owned.reset();
+      }
+    }
+  }
+
   ////// public static ///////////////////////////////////////////////////////
 
   ObjectPtr Object::create(const rt::Transform& objectToWorld)
@@ -154,4 +215,18 @@ namespace pt {
     return std::make_unique<Object>(objectToWorld);
   }
 
+  ObjectPtr Object::createInstance(const rt::Transform& objectToWorld,
+                                   const PrototypePtr& prototype)
+  {
+    if( !prototype ) {
+      return ObjectPtr();
+    }
+
+    ObjectPtr object = create(objectToWorld);
+    object->_prototype = prototype;
+    object->preprocess();
+
+    return object;
+  }
+
 } // namespace pt
@@ -45,7 +45,8 @@ namespace pt {
     return elem != nullptr  &&  rt::priv::compare(elem->Value(), "Object");
   }
 
-  ObjectPtr Object::load(const tinyxml2::XMLElement *elem)
+  ObjectPtr Object::load(const tinyxml2::XMLElement *elem,
+                         rt::Registry<rt::ITexture> *textures)
   {
     if( !isObject(elem) ) {
       return ObjectPtr();
@@ -96,7 +97,7 @@ namespace pt {
       if( !rt::ITexture::isTexture(xml_Texture) ) { // Superfluous!
         continue;
       }
-      rt::TexturePtr texture = rt::ITexture::load(xml_Texture);
+      const rt::TextureRef texture = textures->add(rt::ITexture::load(xml_Texture));
       if( !texture ) {
         return ObjectPtr();
       }
@@ -29,12 +29,26 @@
 ** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 *****************************************************************************/
 
+#include <vector>
+
 #include "pt/Scene/Scene.h"
 
 #include "pt/Shape/IntersectionInfo.h"
 
 namespace pt {
 
+  namespace priv {
+
+    // NOTE: Ties are resolved in order of insertion, independent of the traversal.
+    inline bool isCloser(const IntersectionInfo& hit, const rt::size_t index,
+                         const IntersectionInfo& closest, const rt::size_t closestIndex)
+    {
+      return !closest.isHit()  ||  hit.t < closest.t  ||
+          (hit.t == closest.t  &&  index < closestIndex);
+    }
+
+  } // namespace priv
+
   ////// public //////////////////////////////////////////////////////////////
 
   Scene::Scene() noexcept
@@ -50,6 +64,10 @@ namespace pt {
   {
     _background = rt::Color(0);
     _objects.clear();
+    _shapes.clear();
+    _bvh.clear();
+    _bvh_dirty = true;
+    _textures.clear();
   }
 
   void Scene::add(ObjectPtr& object)
@@ -57,8 +75,11 @@ namespace pt {
     if( !object ) {
       return;
     }
-    _objects.push_back(std::move(object));
-    _objects.back()->preprocess();
+    Object *myObject = _objects.emplace(std::move(*object));
+    object.reset();
+    myObject->storeShapes(&_shapes);
+    myObject->preprocess();
+    _bvh_dirty = true;
   }
 
   rt::Color Scene::backgroundColor() const
@@ -71,6 +92,51 @@ namespace pt {
     _background = n4::clamp(c, 0, 1);
   }
 
+  bool Scene::aov(rt::AOV *aov, const rt::Ray& ray) const
+  {
+    *aov = rt::AOV();
+    if( !ray.isValid() ) {
+      return false;
+    }
+
+    IntersectionInfo info;
+    rt::size_t closest = 0;
+    traverse(ray, [&](const rt::size_t index, const Object *object, rt::real_t *tMax) -> bool {
+      IntersectionInfo hit;
+      if( object->intersect(&hit, ray)  &&  priv::isCloser(hit, index, info, closest) ) {
+        info = hit;
+        closest = index;
+        *tMax = hit.t;
+      }
+      return true;
+    });
+    aov->objectId = info.isHit()
+        ? rt::uint_t(closest + 1)
+        : 0;
+    if( !info.isHit() ) {
+      return false;
+    }
+
+    const rt::Color color = info.object->haveBSDF()
+        ? info.object->bsdf()->color()
+        : rt::Color();
+    aov->albedo = info.texture != nullptr
+        ? color*info.textureColor()
+        : color;
+    aov->N      = geom::isSameHemisphere(info.N, info.wo)
+        ? info.N
+        : -info.N;
+    aov->depth  = info.t;
+
+    return true;
+  }
+
+  void Scene::beginFrame(const rt::CameraPtr& /*camera*/, const rt::SamplerPtr& /*sampler*/,
+                         const rt::RenderOptions& /*options*/)
+  {
+    updateBVH();
+  }
+
   bool Scene::intersect(IntersectionInfo *info, const rt::Ray& ray) const
   {
     if( !ray.isValid() ) {
@@ -79,19 +145,72 @@ namespace pt {
 
     *info = IntersectionInfo();
 
-    for(const ObjectPtr& object : _objects) {
+    rt::size_t closest = 0;
+    traverse(ray, [&](const rt::size_t index, const Object *object, rt::real_t *tMax) -> bool {
       IntersectionInfo hit;
-      if( !object->intersect(&hit, ray) ) {
-        continue;
-      }
-      if( !info->isHit()  ||  hit.t < info->t ) {
+      if( object->intersect(&hit, ray)  &&  priv::isCloser(hit, index, *info, closest) ) {
         *info = hit;
+        closest = index;
+        *tMax = hit.t;
       }
-    }
+      return true;
+    });
 
     return info->isHit();
   }
 
+  void Scene::moveObject(Object *object, const rt::Transform& objectToWorld)
+  {
+    if( object != nullptr ) {
+      object->moveObject(objectToWorld);
+      refitBVH(object);
+    }
+  }
+
+  void Scene::setObjectToWorld(Object *object, const rt::Transform& objectToWorld)
+  {
+    if( object != nullptr ) {
+      object->setObjectToWorld(objectToWorld);
+      refitBVH(object);
+    }
+  }
+
+  const rt::BVH& Scene::bvh() const
+  {
+    return _bvh;
+  }
+
+  void Scene::buildBVH()
+  {
+    std::vector<rt::Bounds> bounds;
+    bounds.reserve(_objects.size());
+    for(rt::size_t i = 0; i < _objects.size(); i++) {
+      bounds.push_back(_objects[i].bounds());
+    }
+
+    _bvh.build(bounds);
+    _bvh_dirty = false;
+  }
+
+  void Scene::updateBVH(const bool wait)
+  {
+    if( _bvh_dirty ) {
+      buildBVH();
+    } else {
+      _bvh.update(wait);
+    }
+  }
+
+  void Scene::setBVHRebuildThreshold(const rt::real_t ratio)
+  {
+    _bvh.setRebuildThreshold(ratio);
+  }
+
+  rt::Registry<rt::ITexture> *Scene::textures()
+  {
+    return &_textures;
+  }
+
   ////// public static ///////////////////////////////////////////////////////
 
   rt::ScenePtr Scene::create()
@@ -99,4 +218,36 @@ namespace pt {
     return std::make_unique<Scene>();
   }
 
+  ////// private /////////////////////////////////////////////////////////////
+
+  // NOTE: 'visit(index, object, &tMax)'; cf. rt::BVH::traverse().
+  template<typename VisitorT>
+  void Scene::traverse(const rt::Ray& ray, VisitorT&& visit) const
+  {
+    if( _bvh_dirty ) {
+      rt::real_t tMax = ray.tMax();
+      for(rt::size_t i = 0; i < _objects.size(); i++) {
+        if( !visit(i, &_objects[i], &tMax) ) {
+          return;
+        }
+      }
+      return;
+    }
+
+    _bvh.traverse(ray, [&](const rt::size_t index, rt::real_t *tMax) -> bool {
+      return visit(index, &_objects[index], tMax);
+    });
+  }
+
+  void Scene::refitBVH(const Object *object)
+  {
+    if( _bvh_dirty ) {
+      return;
+    }
+
+    if( rt::size_t index = 0; _objects.indexOf(&index, object) ) {
+      _bvh.refit(index, object->bounds());
+    }
+  }
+
 } // namespace pt
@@ -29,16 +29,75 @@
 ** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 *****************************************************************************/
 
+#include <algorithm>
+#include <execution>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
 #include <tinyxml2.h>
 
 #include "pt/Scene/Scene.h"
 
 #include "rt/Loader/SceneLoaderBase.h"
+#include "rt/Loader/SceneLoaderStream.h"
 #include "rt/Loader/SceneLoaderStringUtil.h"
 #include "rt/Renderer/RenderOptions.h"
 
 namespace pt {
 
+  namespace priv {
+
+    // NOTE: Objects are streamed & loaded in batches of this size.
+    inline constexpr rt::size_t OBJECT_BATCH_SIZE = 256;
+
+    // NOTE: An <Object>, a <Prototype> of objects or an <Instance> thereof.
+    struct ObjectElement {
+      ObjectElement()
+        : doc{std::make_unique<tinyxml2::XMLDocument>()}
+      {
+      }
+
+      std::unique_ptr<tinyxml2::XMLDocument> doc{};
+      const tinyxml2::XMLElement *elem{nullptr};
+      rt::priv::XMLRange range{};
+      std::vector<ObjectPtr> objects{};
+      std::vector<rt::Transform> instances{};
+      bool ok{false};
+    };
+
+    using Prototypes = std::unordered_map<std::string,std::vector<Object::PrototypePtr>>;
+
+    bool isObjectElement(const char *name)
+    {
+      return rt::priv::compare(name, "Object")  ||  rt::priv::compare(name, "Prototype")  ||
+          rt::priv::compare(name, "Instance");
+    }
+
+    void loadObjectElement(ObjectElement *child, rt::Registry<rt::ITexture> *textures)
+    {
+      const tinyxml2::XMLElement *elem = child->elem;
+      if(        rt::priv::compare(elem->Name(), "Object") ) {
+        child->objects.push_back(Object::load(elem, textures));
+        child->ok = bool(child->objects.back());
+      } else if( rt::priv::compare(elem->Name(), "Prototype") ) {
+        child->ok = rt::priv::length(elem->Attribute("name")) > 0;
+        for(const tinyxml2::XMLElement *xml_Object = elem->FirstChildElement("Object");
+            child->ok  &&  xml_Object != nullptr;
+            xml_Object = xml_Object->NextSiblingElement("Object")) {
+          child->objects.push_back(Object::load(xml_Object, textures));
+          child->ok = bool(child->objects.back());
+        }
+        child->ok = child->ok  &&  !child->objects.empty();
+      } else if( rt::priv::compare(elem->Name(), "Instance") ) {
+        child->instances = rt::priv::parseInstanceTransforms(elem, &child->ok);
+        child->ok = child->ok  &&  rt::priv::length(elem->Attribute("ref")) > 0;
+      }
+    }
+
+  } // namespace priv
+
   bool Scene::isScene(const tinyxml2::XMLElement *elem)
   {
     return elem != nullptr  &&  rt::priv::compare(elem->Value(), "PathTracerScene");
@@ -46,11 +105,8 @@ namespace pt {
 
   bool Scene::isScene(const char *filename)
   {
-    tinyxml2::XMLDocument doc;
-    if( doc.LoadFile(filename) != tinyxml2::XML_SUCCESS ) {
-      return false;
-    }
-    return isScene(doc.FirstChildElement("PathTracerScene"));
+    rt::priv::XMLStream stream;
+    return stream.open(filename)  &&  rt::priv::compare(stream.rootName(), "PathTracerScene");
   }
 
   bool Scene::load(Scene *scene, rt::RenderOptions *options, const char *filename)
@@ -60,18 +116,109 @@ namespace pt {
     scene->clear();
     *options = rt::RenderOptions();
 
-    tinyxml2::XMLDocument doc;
-    if( doc.LoadFile(filename) != tinyxml2::XML_SUCCESS ) {
+    rt::priv::XMLStream stream;
+    if( !stream.open(filename) ) {
       fprintf(stderr, "Unable to load XML scene \"%s\"!\n", filename);
       return false;
     }
 
-    const MyElem *xml_PathTracerScene = doc.FirstChildElement("PathTracerScene");
-    if( !isScene(xml_PathTracerScene) ) {
+    if( !rt::priv::compare(stream.rootName(), "PathTracerScene") ) {
       fprintf(stderr, "Invalid XML scene \"%s\"!\n", filename);
       return false;
     }
 
+    /*
+     * NOTE:
+     * Objects are loaded in parallel batches & added in document order; instances
+     * refer to the prototypes defined before them.
+     */
+    priv::Prototypes prototypes;
+    const auto load_objects = [&](std::vector<priv::ObjectElement>& children) -> bool {
+      std::for_each(std::execution::par, children.begin(), children.end(),
+                    [&](priv::ObjectElement& child) -> void {
+        priv::loadObjectElement(&child, scene->textures());
+      });
+
+      for(priv::ObjectElement& child : children) {
+        const MyElem *elem = child.elem;
+        if( !child.ok ) {
+          fprintf(stderr, "Unable to load <%s> at line \"%d\"!\n",
+                  elem->Name(), rt::priv::XMLStream::lineNum(elem, child.range));
+          return false;
+        }
+
+        if(        rt::priv::compare(elem->Name(), "Object") ) {
+          scene->add(child.objects.front());
+        } else if( rt::priv::compare(elem->Name(), "Prototype") ) {
+          std::vector<Object::PrototypePtr>& prototype = prototypes[elem->Attribute("name")];
+          prototype.clear();
+          for(ObjectPtr& object : child.objects) {
+            object->preprocess();
+            prototype.push_back(std::move(object));
+          }
+        } else if( rt::priv::compare(elem->Name(), "Instance") ) {
+          const auto it = prototypes.find(elem->Attribute("ref"));
+          if( it == prototypes.end() ) {
+            fprintf(stderr, "Unable to find <Prototype> \"%s\" at line \"%d\"!\n",
+                    elem->Attribute("ref"), rt::priv::XMLStream::lineNum(elem, child.range));
+            return false;
+          }
+
+          for(const rt::Transform& xform : child.instances) {
+            for(const Object::PrototypePtr& prototype : it->second) {
+              ObjectPtr object = Object::createInstance(xform, prototype);
+              scene->add(object);
+            }
+          }
+        }
+      }
+
+      children.clear();
+
+      return true;
+    };
+
+    // NOTE: All children other than objects are gathered in 'doc'.
+    tinyxml2::XMLDocument doc;
+    MyElem *xml_PathTracerScene = doc.NewElement("PathTracerScene");
+    doc.InsertEndChild(xml_PathTracerScene);
+
+    std::vector<priv::ObjectElement> children;
+    while( const char *name = stream.nextName() ) {
+      if( priv::isObjectElement(name) ) {
+        priv::ObjectElement& child = children.emplace_back();
+        child.elem = stream.read(child.doc.get(), &child.range);
+        if( child.elem == nullptr ) {
+          break;
+        }
+
+        if( children.size() >= priv::OBJECT_BATCH_SIZE  &&  !load_objects(children) ) {
+          return false;
+        }
+      } else {
+        tinyxml2::XMLDocument child;
+        const MyElem *elem = stream.read(&child);
+        if( elem == nullptr ) {
+          break;
+        }
+        xml_PathTracerScene->InsertEndChild(elem->DeepClone(&doc));
+      }
+    }
+
+    if( stream.isError() ) {
+      fprintf(stderr, "Unable to load XML scene \"%s\"!\n", filename);
+      return false;
+    }
+
+    if( !load_objects(children) ) {
+      return false;
+    }
+
+    if( !stream.leave() ) {
+      fprintf(stderr, "Unable to load XML scene \"%s\"!\n", filename);
+      return false;
+    }
+
     bool ok = false;
 
     *options = rt::RenderOptions::load(xml_PathTracerScene, &ok);
@@ -87,19 +234,6 @@ namespace pt {
     }
     scene->setBackgroundColor(backgroundColor);
 
-    for(const MyElem *child = xml_PathTracerScene->FirstChildElement("Object");
-        child != nullptr; child = child->NextSiblingElement("Object")) {
-      if( !Object::isObject(child) ) {
-        continue;
-      }
-      ObjectPtr object = Object::load(child);
-      if( !object ) {
-        fprintf(stderr, "Unable to load <Object> at line \"%d\"!\n", child->GetLineNum());
-        return false;
-      }
-      scene->add(object);
-    }
-
     return true;
   }
 
@@ -33,6 +33,7 @@
 
 #include "geom/Intersect.h"
 #include "pt/Shape/IntersectionInfo.h"
+#include "pt/Shape/ShapeArena.h"
 
 namespace pt {
 
@@ -84,6 +85,11 @@ namespace pt {
     return true;
   }
 
+  IShape *Cylinder::copyTo(ShapeArena *arena) const
+  {
+    return arena->cylinders.emplace(*this);
+  }
+
   rt::Bounds Cylinder::shapeBounds() const
   {
     const rt::real_t rz = _height/rt::TWO;
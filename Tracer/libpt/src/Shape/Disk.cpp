@@ -33,6 +33,7 @@
 
 #include "geom/Intersect.h"
 #include "pt/Shape/IntersectionInfo.h"
+#include "pt/Shape/ShapeArena.h"
 
 namespace pt {
 
@@ -82,6 +83,11 @@ namespace pt {
     return true;
   }
 
+  IShape *Disk::copyTo(ShapeArena *arena) const
+  {
+    return arena->disks.emplace(*this);
+  }
+
   rt::Bounds Disk::shapeBounds() const
   {
     return rt::Bounds(rt::Vertex{_radius, _radius, 0}, rt::Vertex{-_radius, -_radius, 0});
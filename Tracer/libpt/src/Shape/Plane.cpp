@@ -33,6 +33,7 @@
 
 #include "geom/Intersect.h"
 #include "pt/Shape/IntersectionInfo.h"
+#include "pt/Shape/ShapeArena.h"
 
 namespace pt {
 
@@ -96,6 +97,11 @@ namespace pt {
     return true;
   }
 
+  IShape *Plane::copyTo(ShapeArena *arena) const
+  {
+    return arena->planes.emplace(*this);
+  }
+
   rt::Bounds Plane::shapeBounds() const
   {
     const rt::real_t hx = _width /rt::TWO;
@@ -33,6 +33,7 @@
 
 #include "geom/Intersect.h"
 #include "pt/Shape/IntersectionInfo.h"
+#include "pt/Shape/ShapeArena.h"
 
 namespace pt {
 
@@ -79,6 +80,11 @@ namespace pt {
     return true;
   }
 
+  IShape *Sphere::copyTo(ShapeArena *arena) const
+  {
+    return arena->spheres.emplace(*this);
+  }
+
   rt::Bounds Sphere::shapeBounds() const
   {
     return rt::Bounds(rt::Vertex(_radius), rt::Vertex(-_radius));
@@ -42,10 +42,17 @@ namespace rt {
     DiffuseAreaLight(const IObject *object, const Color& Lemit) noexcept;
     ~DiffuseAreaLight() noexcept;
 
+    Color emittance() const;
+    const IObject *object() const;
+
     real_t pdfLi(const SurfaceInfo& ref, const Direction& wi) const;
     Color sampleLi(const SurfaceInfo& ref, Direction *wi,
                    const Sample2D& xi, real_t *pdf, Ray *vis) const;
 
+    void pdfLe(const Ray& ray, const Normal& N, real_t *pdfPos, real_t *pdfDir) const;
+    Color sampleLe(const Sample2D& xiPos, const Sample2D& xiDir,
+                   Ray *ray, Normal *N, real_t *pdfPos, real_t *pdfDir) const;
+
     Color radiance(const SurfaceInfo& surface, const Direction& wo) const;
 
     static LightPtr create(const IObject *object, const Color& Lemit);
@@ -40,10 +40,18 @@ namespace rt {
     DirectionalLight(const Transform& lightToWorld, const Color& L, const Direction& wiL) noexcept;
     ~DirectionalLight() noexcept;
 
+    // NOTE: The direction is in WORLD coordinates.
+    Direction direction() const;
+    Color radiance() const;
+
     real_t pdfLi(const SurfaceInfo& ref, const Direction& wi) const;
     Color sampleLi(const SurfaceInfo& ref, Direction *wi,
                    const Sample2D& xi, real_t *pdf, Ray *vis) const;
 
+    void pdfLe(const Ray& ray, const Normal& N, real_t *pdfPos, real_t *pdfDir) const;
+    Color sampleLe(const Sample2D& xiPos, const Sample2D& xiDir,
+                   Ray *ray, Normal *N, real_t *pdfPos, real_t *pdfDir) const;
+
     static LightPtr create(const Transform& lightToWorld, const Color& L, const Direction& wiL);
 
   private:
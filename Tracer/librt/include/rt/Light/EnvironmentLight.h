@@ -0,0 +1,89 @@
+/****************************************************************************
+** Copyright (c) 2021, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "rt/Light/ILight.h"
+#include "rt/Sampler/Distribution.h"
+
+namespace rt {
+
+  /*
+   * NOTE:
+   * An infinitely distant light surrounding the scene, whose radiance is given
+   * by a latitude-longitude map in light space (i.e. +z is up, the top row of
+   * the map corresponds to theta = 0); cf. to PBR3 Chapter "12.6 Infinite Area Lights".
+   * Directions are importance sampled according to the luminance of the map.
+   */
+  class EnvironmentLight : public ILight {
+  public:
+    EnvironmentLight(const Transform& lightToWorld, const Color& L,
+                     const size_t width, const size_t height, std::vector<Color> texels) noexcept;
+    ~EnvironmentLight() noexcept;
+
+    size_t width() const;
+    size_t height() const;
+
+    Color radiance() const;
+    const std::vector<Color>& texels() const;
+
+    // NOTE: The map's file, if loaded from one; otherwise empty.
+    const std::string& filename() const;
+
+    Color Le(const Ray& ray) const;
+
+    real_t pdfLi(const SurfaceInfo& ref, const Direction& wi) const;
+    Color sampleLi(const SurfaceInfo& ref, Direction *wi,
+                   const Sample2D& xi, real_t *pdf, Ray *vis) const;
+
+    void pdfLe(const Ray& ray, const Normal& N, real_t *pdfPos, real_t *pdfDir) const;
+    Color sampleLe(const Sample2D& xiPos, const Sample2D& xiDir,
+                   Ray *ray, Normal *N, real_t *pdfPos, real_t *pdfDir) const;
+
+    static LightPtr create(const Transform& lightToWorld, const Color& L,
+                           const size_t width, const size_t height, std::vector<Color> texels);
+    static LightPtr create(const Transform& lightToWorld, const Color& L, const char *filename);
+
+  private:
+    Color lookup(const real_t u, const real_t v) const;
+
+    Distribution2D     _distribution{};
+    Color              _L{};
+    std::vector<Color> _texels{};
+    std::string        _filename{};
+    size_t             _width{0};
+    size_t             _height{0};
+  };
+
+} // namespace rt
@@ -46,13 +46,15 @@ namespace rt {
       Invalid        = 0,
       Area           = 1,
       DeltaDirection = 2,
-      DeltaPosition  = 3
+      DeltaPosition  = 3,
+      Infinite       = 4
     };
 
     ILight(const Type type, const Transform& lightToWorld) noexcept;
     virtual ~ILight() noexcept;
 
     bool isDeltaLight() const;
+    bool isInfiniteLight() const;
 
     size_t numSamples() const;
     void setNumSamples(const size_t numSamples);
@@ -62,10 +64,23 @@ namespace rt {
 
     Type type() const;
 
+    const Transform& lightToWorld() const;
+
+    // NOTE: Radiance carried along a ray escaping the scene; zero for finite lights.
+    virtual Color Le(const Ray& ray) const;
+
     virtual real_t pdfLi(const SurfaceInfo& ref, const Direction& wi) const = 0;
     virtual Color sampleLi(const SurfaceInfo& ref, Direction *wi,
                            const Sample2D& xi, real_t *pdf, Ray *vis) const = 0;
 
+    /*
+     * Cf. to PBR3 Chapter "16.1.2 Sampling Light Rays"
+     * for an explanation of the following functions.
+     */
+    virtual void pdfLe(const Ray& ray, const Normal& N, real_t *pdfPos, real_t *pdfDir) const = 0;
+    virtual Color sampleLe(const Sample2D& xiPos, const Sample2D& xiDir,
+                           Ray *ray, Normal *N, real_t *pdfPos, real_t *pdfDir) const = 0;
+
     template<typename VecT>
     inline VecT toLight(const VecT& v) const
     {
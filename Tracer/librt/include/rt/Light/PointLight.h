@@ -40,10 +40,16 @@ namespace rt {
     PointLight(const Transform& lightToWorld, const Color& I) noexcept;
     ~PointLight() noexcept;
 
+    Color intensity() const;
+
     real_t pdfLi(const SurfaceInfo& ref, const Direction& wi) const;
     Color sampleLi(const SurfaceInfo& ref, Direction *wi,
                    const Sample2D& xi, real_t *pdf, Ray *vis) const;
 
+    void pdfLe(const Ray& ray, const Normal& N, real_t *pdfPos, real_t *pdfDir) const;
+    Color sampleLe(const Sample2D& xiPos, const Sample2D& xiDir,
+                   Ray *ray, Normal *N, real_t *pdfPos, real_t *pdfDir) const;
+
     static LightPtr create(const Transform& lightToWorld, const Color& I);
 
   private:
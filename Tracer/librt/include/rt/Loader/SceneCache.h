@@ -0,0 +1,68 @@
+/****************************************************************************
+** Copyright (c) 2021, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#pragma once
+
+#include <cstdint>
+
+#include <string>
+
+#include "rt/Loader/SceneIndex.h"
+
+namespace rt {
+
+  struct RenderOptions;
+  class Scene;
+
+  /*
+   * NOTE:
+   * The binary scene cache holds the flattened objects, materials, textures & lights
+   * of a scene loaded from XML, including the texels of environment maps. Its sections
+   * are referenced by offsets relative to the start of the file, hence it may be read
+   * or mapped to any address; readSceneCache() maps it and reads the records in place.
+   * A cache is current, if its version & record layout match this build, it was compiled
+   * from an XML file having the same hash, and the external files it was compiled from
+   * (e.g. environment maps) have the same path, size & modification time.
+   * The cache may also record the scene's index; cf. reloadScene().
+   */
+
+  uint64_t hashSceneFile(const char *filename, bool *ok = nullptr);
+
+  // NOTE: The cache is stored next to its XML file, e.g. "scene.xml.rtc".
+  std::string sceneCacheName(const char *filename);
+
+  bool readSceneCache(Scene *scene, RenderOptions *options, const char *cacheName,
+                      const uint64_t hash, SceneIndex *index = nullptr);
+
+  bool writeSceneCache(const Scene& scene, const RenderOptions& options, const char *cacheName,
+                       const uint64_t hash, const SceneIndex *index = nullptr);
+
+} // namespace rt
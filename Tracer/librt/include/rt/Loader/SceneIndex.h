@@ -0,0 +1,65 @@
+/****************************************************************************
+** Copyright (c) 2021, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#pragma once
+
+#include <cstdint>
+
+#include <vector>
+
+namespace rt {
+
+  class ILight;
+  class IObject;
+
+  /*
+   * NOTE:
+   * What one child of <Scene> contributed to a scene; cf. reloadScene().
+   * - 'key' identifies the element across edits of its file: its tag, "type" &
+   *   "id" attribute; lacking an "id", its position among the elements of same
+   *   tag & type.
+   * - 'hash' covers the element's content, 'shape' all of it except <Material>
+   *   & 'material' its <Material>; neither covers whitespace nor comments.
+   * The objects & light are owned by the scene.
+   */
+  struct SceneIndexElement {
+    uint64_t key{0};
+    uint64_t hash{0};
+    uint64_t shape{0};
+    uint64_t material{0};
+    ILight  *light{nullptr};
+    std::vector<IObject*> objects{};
+  };
+
+  // NOTE: In document order.
+  using SceneIndex = std::vector<SceneIndexElement>;
+
+} // namespace rt
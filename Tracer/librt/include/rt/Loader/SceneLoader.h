@@ -31,11 +31,45 @@
 
 #pragma once
 
+#include "rt/Loader/SceneIndex.h"
+
 namespace rt {
 
+  class Animation;
   struct RenderOptions;
   class Scene;
 
-  bool loadScene(Scene *scene, RenderOptions *options, const char *filename);
+  /*
+   * NOTE:
+   * If 'animation' is not null, it receives the scene's keyframes;
+   * if 'index' is not null, it receives the index required by reloadScene().
+   */
+  bool loadScene(Scene *scene, RenderOptions *options, const char *filename,
+                 Animation *animation = nullptr, SceneIndex *index = nullptr);
+
+  /*
+   * NOTE:
+   * Loads the binary cache of 'filename' if it is current; otherwise the XML is loaded
+   * and the cache is (re)written. Failing to write the cache is NOT an error.
+   */
+  bool loadSceneCached(Scene *scene, RenderOptions *options, const char *filename,
+                       SceneIndex *index = nullptr);
+
+  /*
+   * NOTE:
+   * Updates 'scene' loaded from 'filename' with 'index' to the file's current content:
+   * - Elements of unchanged content keep their objects & lights, wherever they moved.
+   * - A changed element replaces the one of same key in place, i.e. its objects take
+   *   over their nodes in the BVH, which are refitted; an object of which only the
+   *   <Material> changed receives the new material instead.
+   * - Elements added are appended to the scene, those removed are removed from it.
+   * - Prototypes & their instances are always rebuilt.
+   * - Named materials are always defined anew; elements referring to a changed
+   *   definition are changed themselves.
+   * Animations are not reloaded. If the file fails to parse, 'scene' is left as is;
+   * lacking an index, the scene is loaded anew.
+   */
+  bool reloadScene(Scene *scene, RenderOptions *options, const char *filename,
+                   SceneIndex *index);
 
 } // namespace rt
@@ -0,0 +1,156 @@
+/****************************************************************************
+** Copyright (c) 2021, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#pragma once
+
+#include <cstdint>
+
+#include <algorithm>
+#include <execution>
+#include <filesystem>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <tinyxml2.h>
+
+#include "rt/Light/ILight.h"
+#include "rt/Loader/SceneIndex.h"
+#include "rt/Loader/SceneLoaderStream.h"
+#include "rt/Material/MaterialRegistry.h"
+#include "rt/Object/IObject.h"
+#include "rt/Object/Instance.h"
+#include "rt/Scene/GeometryCache.h"
+
+namespace rt {
+
+  namespace priv {
+
+    // NOTE: Children of <Scene> are streamed & parsed in batches of this size.
+    inline constexpr size_t SCENE_BATCH_SIZE = 256;
+
+    // NOTE: The result of parsing one child of <Scene>; cf. loadScene().
+    struct SceneElement {
+      SceneElement()
+        : doc{std::make_unique<tinyxml2::XMLDocument>()}
+      {
+      }
+
+      std::unique_ptr<tinyxml2::XMLDocument> doc{};
+      const tinyxml2::XMLElement *node{nullptr};
+      XMLRange range{};
+      SceneIndexElement index{};
+      Color    background{};
+      LightPtr light{};
+      Objects  objects{};
+      std::vector<Transform> instances{};
+      bool     ok{false};
+    };
+
+    using SceneElements = std::vector<SceneElement>;
+
+    // NOTE: Prototypes by name; cf. instantiateSceneElement().
+    using Prototypes = std::unordered_map<std::string,Instance::PrototypePtr>;
+
+    void parseSceneElement(SceneElement *element, const std::filesystem::path& sceneDir,
+                           const std::string& sceneFile, const GeometryCachePtr& cache,
+                           const MaterialRegistryPtr& materials);
+
+    // NOTE: A named <Material>, which is referred to by <Material ref="..."/>.
+    bool isMaterialDefinition(const tinyxml2::XMLElement *node);
+
+    /*
+     * NOTE:
+     * Applies 'func' to the elements in [first,last) in parallel; material definitions
+     * are applied in document order, i.e. after all preceding & before all subsequent
+     * elements.
+     */
+    template<typename ForwardIt, typename IsDefinition, typename Func>
+    void forEachSceneElement(ForwardIt first, ForwardIt last,
+                             IsDefinition is_definition, Func func)
+    {
+      while( first != last ) {
+        const ForwardIt definition = std::find_if(first, last, is_definition);
+        std::for_each(std::execution::par, first, definition, func);
+        if( definition == last ) {
+          break;
+        }
+        func(*definition);
+        first = std::next(definition);
+      }
+    }
+
+    // NOTE: Prints the error of an element which failed to parse.
+    bool isValidSceneElement(const SceneElement& element);
+
+    /*
+     * NOTE:
+     * Registers the objects of a <Prototype> & creates the objects of an <Instance>;
+     * elements must be instantiated in document order.
+     */
+    bool instantiateSceneElement(SceneElement *element, Prototypes *prototypes);
+
+    /*
+     * NOTE:
+     * Streams the children of <Scene> in batches to 'load_elements'; all other children
+     * of <Tracer>, e.g. <Options>, are gathered in 'xml_Tracer'.
+     */
+    using SceneElementsConsumer = std::function<bool(SceneElements&)>;
+
+    bool streamScene(bool *has_scene, tinyxml2::XMLElement *xml_Tracer, const char *filename,
+                     const SceneElementsConsumer& load_elements);
+
+    // Index /////////////////////////////////////////////////////////////////
+
+    // NOTE: Computes the hashes of 'element->index'; cf. SceneIndexElement.
+    void hashSceneElement(SceneElement *element);
+
+    /*
+     * NOTE:
+     * Assigns the keys of elements in document order; the hashes of elements referring
+     * to named materials additionally cover their definitions.
+     */
+    class SceneIndexer {
+    public:
+      void setKey(SceneIndexElement *element, const tinyxml2::XMLElement *node);
+      void hashReferences(SceneIndexElement *element, const tinyxml2::XMLElement *node);
+
+    private:
+      std::unordered_map<uint64_t,uint64_t> _count{};
+      std::unordered_map<std::string,uint64_t> _definitions{};
+    };
+
+  } // namespace priv
+
+} // namespace rt
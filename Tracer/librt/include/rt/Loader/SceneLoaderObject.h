@@ -32,16 +32,36 @@
 #pragma once
 
 #include <functional>
+#include <string>
 
 #include <tinyxml2.h>
 
+#include "rt/Loader/SceneLoaderStream.h"
+#include "rt/Material/MaterialRegistry.h"
 #include "rt/Object/IObject.h"
+#include "rt/Object/LazyObject.h"
+#include "rt/Scene/GeometryCache.h"
 
 namespace rt {
 
   namespace priv {
 
-    ObjectPtr parseObject(const tinyxml2::XMLElement *node, const bool mat_is_opt = false);
+    ObjectPtr parseObject(const tinyxml2::XMLElement *node, const MaterialRegistryPtr& materials,
+                          const bool mat_is_opt = false);
+
+    bool isLazyObject(const tinyxml2::XMLElement *node);
+
+    /*
+     * NOTE:
+     * Returns a LazyObject reloading 'node' from 'range' of 'filename' on demand.
+     * Its world bounds are given by <Bounds>; otherwise 'node' is parsed once.
+     */
+    ObjectPtr parseLazyObject(const tinyxml2::XMLElement *node, const std::string& filename,
+                              const XMLRange& range, const GeometryCachePtr& cache,
+                              const MaterialRegistryPtr& materials);
+
+    LazyObject::Loader lazyObjectLoader(const std::string& filename, const XMLRange& range,
+                                        const MaterialRegistryPtr& materials);
 
     using ObjectConsumer = std::function<void(ObjectPtr&)>;
 
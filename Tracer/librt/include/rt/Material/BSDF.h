@@ -54,6 +54,9 @@ namespace rt {
 
     const IBxDF *operator[](const size_t i) const;
 
+    // NOTE: The average color of all (textured) BxDFs.
+    Color albedo(const SurfaceInfo& surface) const;
+
     /*
      * Cf. to PBR3 Chapter "9.1 BSDFs" and Chapter "14.1.6 Sampling BSDFs"
      * for an explanation of the following functions.
@@ -47,6 +47,10 @@ namespace rt {
 
     virtual std::unique_ptr<IMaterial> copy() const = 0;
 
+    // NOTE: Materials of equal parameters may be shared; cf. MaterialRegistry.
+    virtual size_t hash() const = 0;
+    virtual bool isEqual(const IMaterial& other) const = 0;
+
     virtual bool haveTexture(const size_t i) const;
 
     virtual Color textureLookup(const size_t i, const TexCoord2D& tex) const;
@@ -58,5 +62,6 @@ namespace rt {
   };
 
   using MaterialPtr = std::unique_ptr<IMaterial>;
+  using MaterialRef = std::shared_ptr<const IMaterial>;
 
 } // namespace rt
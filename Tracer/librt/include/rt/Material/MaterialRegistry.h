@@ -0,0 +1,85 @@
+/****************************************************************************
+** Copyright (c) 2021, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "rt/Base/Registry.h"
+#include "rt/Material/IMaterial.h"
+#include "rt/Texture/ITexture.h"
+
+namespace rt {
+
+  using MaterialRegistryPtr = std::shared_ptr<class MaterialRegistry>;
+
+  /*
+   * NOTE:
+   * The materials & textures of a scene; objects of equal materials share one
+   * instance, cf. Registry. Named materials are defined by <Material name="...">
+   * & referred to by <Material ref="..."/>; a redefinition applies to all
+   * subsequent references.
+   */
+  class MaterialRegistry {
+  public:
+    MaterialRegistry() noexcept;
+    ~MaterialRegistry() noexcept;
+
+    MaterialRef add(MaterialPtr& material);
+    MaterialRef add(MaterialPtr&& material);
+    TextureRef add(TexturePtr& texture);
+    TextureRef add(TexturePtr&& texture);
+
+    MaterialRef find(const std::string& name) const;
+    void setName(const std::string& name, const MaterialRef& material);
+
+    void clear();
+    void clearNames();
+
+    size_t numMaterials() const;
+    size_t numTextures() const;
+
+    static MaterialRegistryPtr create();
+
+  private:
+    MaterialRegistry(const MaterialRegistry&) = delete;
+    MaterialRegistry& operator=(const MaterialRegistry&) = delete;
+
+    Registry<IMaterial> _materials;
+    Registry<ITexture>  _textures;
+    mutable std::mutex _mutex; // NOTE: Guards '_names'.
+    std::unordered_map<std::string,MaterialRef> _names;
+  };
+
+} // namespace rt
@@ -42,16 +42,20 @@ namespace rt {
     ~MatteMaterial() noexcept;
 
     MaterialPtr copy() const;
+    size_t hash() const;
+    bool isEqual(const IMaterial& other) const;
     bool haveTexture(const size_t i) const;
     Color textureLookup(const size_t i, const TexCoord2D& tex) const;
 
+    const ITexture *texture() const;
     void setTexture(TexturePtr& texture);
     void setTexture(TexturePtr&& texture);
+    void setTexture(const TextureRef& texture);
 
     static MaterialPtr create();
 
   private:
-    TexturePtr _texture{};
+    TextureRef _texture{};
   };
 
   inline MatteMaterial *MATTE(const MaterialPtr& p)
@@ -41,6 +41,8 @@ namespace rt {
     ~MirrorMaterial() noexcept;
 
     MaterialPtr copy() const;
+    size_t hash() const;
+    bool isEqual(const IMaterial& other) const;
 
     void setReflectance(const real_t r);
     real_t reflectance() const;
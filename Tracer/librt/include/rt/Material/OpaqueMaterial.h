@@ -42,6 +42,8 @@ namespace rt {
     ~OpaqueMaterial() noexcept;
 
     MaterialPtr copy() const;
+    size_t hash() const;
+    bool isEqual(const IMaterial& other) const;
 
     bool haveTexture(const size_t i) const;
 
@@ -49,20 +51,24 @@ namespace rt {
 
     bool isSpecular() const;
 
+    const ITexture *diffuse() const;
     void setDiffuse(TexturePtr& tex);
     void setDiffuse(TexturePtr&& tex);
+    void setDiffuse(const TextureRef& tex);
 
     void setShininess(const real_t spec);
     real_t shininess() const;
 
+    const ITexture *specular() const;
     void setSpecular(TexturePtr& tex);
     void setSpecular(TexturePtr&& tex);
+    void setSpecular(const TextureRef& tex);
 
     static MaterialPtr create();
 
   private:
-    TexturePtr _diffTex{};
-    TexturePtr _specTex{};
+    TextureRef _diffTex{};
+    TextureRef _specTex{};
   };
 
   inline OpaqueMaterial *OPAQUE(const MaterialPtr& p)
@@ -41,6 +41,8 @@ namespace rt {
     ~TransparentMaterial() noexcept;
 
     MaterialPtr copy() const;
+    size_t hash() const;
+    bool isEqual(const IMaterial& other) const;
 
     bool isShadowCaster() const;
 
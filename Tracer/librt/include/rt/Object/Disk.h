@@ -43,7 +43,10 @@ namespace rt {
 
     bool intersect(SurfaceInfo *surface, const Ray& ray) const;
 
+    real_t radius() const;
+
     real_t area() const;
+    Bounds objectBounds() const;
     SurfaceInfo sample(const Sample2D& xi, real_t *pdf) const;
 
     static ObjectPtr create(const Transform& objectToWorld,
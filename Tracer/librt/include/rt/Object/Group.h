@@ -31,18 +31,32 @@
 
 #pragma once
 
+#include <vector>
+
 #include "rt/Object/IObject.h"
 
 namespace rt {
 
+  /*
+   * NOTE:
+   * Each child's transform relative to the group is kept; the children's WORLD
+   * transforms are recomputed from these whenever the group is moved, so that
+   * e.g. long animations do not accumulate errors.
+   */
   class Group : public IObject {
   public:
     Group(const Transform& objectToWorld) noexcept;
     ~Group() noexcept;
 
     void add(ObjectPtr& object);
+    // NOTE: Adds 'object' as is, i.e. its transform already maps to WORLD coordinates.
+    void addInWorld(ObjectPtr& object);
     void clear();
 
+    const Objects& objects() const;
+
+    void setObjectToWorld(const Transform& objectToWorld);
+
     bool castShadow(const Ray &ray) const;
 
     bool intersect(SurfaceInfo *surface, const Ray& ray) const;
@@ -53,11 +67,17 @@ namespace rt {
      * due to intersect() returning a non-aggregate IObject or FALSE!
      */
     real_t area() const;
+    Bounds objectBounds() const;
     SurfaceInfo sample(const Sample2D &xi, real_t *pdf) const;
 
+    Bounds worldBounds() const;
+
+    size_t memory() const;
+
     static ObjectPtr create(const Transform& objectToWorld);
 
   private:
+    std::vector<Transform> _locals{}; // NOTE: Child -> Group, in order of '_objects'.
     Objects _objects{};
   };
 
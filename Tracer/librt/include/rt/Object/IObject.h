@@ -55,14 +55,16 @@ namespace rt {
     const IAreaLight *areaLight() const;
     void setAreaLight(IAreaLight *light);
 
-    IMaterial *material();
+    // NOTE: Materials are immutable & may be shared among objects; cf. MaterialRegistry.
     const IMaterial *material() const;
     void setMaterial(MaterialPtr& material);
     void setMaterial(MaterialPtr&& material);
+    void setMaterial(const MaterialRef& material);
 
+    // NOTE: Aggregates also move their children; cf. Group.
     void moveObject(const Transform& objectToWorld);
     const Transform& objectToWorld() const;
-    void setObjectToWorld(const Transform& objectToWorld);
+    virtual void setObjectToWorld(const Transform& objectToWorld);
 
     template<typename T>
     inline T toObject(const T& x) const
@@ -81,6 +83,11 @@ namespace rt {
      * for an explanation of the following functions.
      */
     virtual real_t area() const = 0;
+    // NOTE: Bounds in OBJECT coordinates; aggregates bound their children in worldBounds().
+    virtual Bounds objectBounds() const = 0;
+    virtual Bounds worldBounds() const;
+    // NOTE: The approximate size of the geometry in bytes, excluding materials; cf. GeometryCache.
+    virtual size_t memory() const;
     virtual SurfaceInfo sample(const Sample2D& xi, real_t *pdf) const = 0;
     virtual real_t pdf(const SurfaceInfo& surface) const;
     // NOTE: The following functions compute the PDF with respect to solid angle!
@@ -93,7 +100,7 @@ namespace rt {
     Transform   _xfrmWO{}; // Object -> World
     Transform   _xfrmOW{}; // World -> Object
     IAreaLight *_areaLight{nullptr};
-    MaterialPtr _material{};
+    MaterialRef _material{};
   };
 
   using ObjectPtr = std::unique_ptr<IObject>;
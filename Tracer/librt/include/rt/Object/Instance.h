@@ -0,0 +1,69 @@
+/****************************************************************************
+** Copyright (c) 2021, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#pragma once
+
+#include "rt/Object/IObject.h"
+
+namespace rt {
+
+  /*
+   * NOTE:
+   * A placement of a shared prototype, e.g. an object or a group thereof.
+   * The prototype's transform maps to its own prototype coordinates, which
+   * this instance maps to WORLD coordinates. Surfaces returned by intersect()
+   * refer to the prototype's (leaf) objects & thus share their materials.
+   */
+  class Instance : public IObject {
+  public:
+    using PrototypePtr = std::shared_ptr<const IObject>;
+
+    Instance(const Transform& objectToWorld, const PrototypePtr& prototype) noexcept;
+    ~Instance() noexcept;
+
+    const PrototypePtr& prototype() const;
+
+    bool castShadow(const Ray& ray) const;
+
+    bool intersect(SurfaceInfo *surface, const Ray& ray) const;
+
+    real_t area() const;
+    Bounds objectBounds() const;
+    size_t memory() const;
+    SurfaceInfo sample(const Sample2D& xi, real_t *pdf) const;
+
+    static ObjectPtr create(const Transform& objectToWorld, const PrototypePtr& prototype);
+
+  private:
+    PrototypePtr _prototype{};
+  };
+
+} // namespace rt
@@ -0,0 +1,104 @@
+/****************************************************************************
+** Copyright (c) 2021, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#pragma once
+
+#include <cstdint>
+
+#include <atomic>
+#include <functional>
+#include <mutex>
+
+#include "rt/Object/IObject.h"
+#include "rt/Scene/GeometryCache.h"
+
+namespace rt {
+
+  /*
+   * NOTE:
+   * A placeholder for heavy geometry, holding only its world bounds and a loader for
+   * its source (e.g. an XML element). The geometry is loaded when a ray first reaches
+   * the bounds & may be evicted by the GeometryCache afterwards; it is reloaded on
+   * demand. Surfaces returned by intersect() refer to the loaded geometry.
+   */
+  class LazyObject : public IObject {
+  public:
+    using Loader = std::function<ObjectPtr()>;
+
+    LazyObject(const Bounds& bounds, const Loader& loader, const GeometryCachePtr& cache) noexcept;
+    ~LazyObject() noexcept;
+
+    bool isResident() const;
+
+    // NOTE: E.g. once the source moved within its file; a failed load is retried.
+    void setLoader(const Loader& loader);
+
+    void setObjectToWorld(const Transform& objectToWorld);
+
+    bool castShadow(const Ray& ray) const;
+
+    bool intersect(SurfaceInfo *surface, const Ray& ray) const;
+
+    real_t area() const;
+    Bounds objectBounds() const;
+    SurfaceInfo sample(const Sample2D& xi, real_t *pdf) const;
+
+    Bounds worldBounds() const;
+
+    static ObjectPtr create(const Bounds& bounds, const Loader& loader, const GeometryCachePtr& cache);
+
+  private:
+    friend class GeometryCache;
+
+    const IObject *acquire() const;
+    bool isPinned(const uint64_t frame, const uint64_t block) const;
+    bool unload(const uint64_t frame, const uint64_t block) const;
+
+    Bounds _bounds{};
+    GeometryCachePtr _cache{};
+    Loader _loader{};
+    Bounds _worldBounds{};
+    mutable std::atomic<uint64_t> _block{0}; // NOTE: The latest block using this object.
+    mutable std::atomic<uint64_t> _frame{0}; // NOTE: The latest frame using this object outside of blocks.
+    mutable ObjectPtr _geometry{}; // NOTE: Guarded by '_mutex'.
+    mutable Transform _geometryToObject{}; // NOTE: The geometry's transform as loaded.
+    mutable std::atomic<bool> _is_failed{false};
+    bool _is_moved{false};
+    mutable std::mutex _mutex;
+    mutable std::atomic<const IObject*> _resident{nullptr};
+  };
+
+  inline LazyObject *LAZY(const ObjectPtr& p)
+  {
+    return dynamic_cast<LazyObject*>(p.get());
+  }
+
+} // namespace rt
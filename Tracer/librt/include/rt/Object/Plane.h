@@ -43,7 +43,11 @@ namespace rt {
 
     bool intersect(SurfaceInfo *surface, const Ray& ray) const final;
 
+    real_t height() const;
+    real_t width() const;
+
     real_t area() const;
+    Bounds objectBounds() const;
     SurfaceInfo sample(const Sample2D& xi, real_t *pdf) const;
 
     static ObjectPtr create(const Transform& objectToWorld,
@@ -43,7 +43,10 @@ namespace rt {
 
     bool intersect(SurfaceInfo *surface, const Ray& ray) const final;
 
+    real_t radius() const;
+
     real_t area() const;
+    Bounds objectBounds() const;
     SurfaceInfo sample(const Sample2D& xi, real_t *pdf) const;
     SurfaceInfo sample(const SurfaceInfo& ref, const Sample2D& xi, real_t *pdf) const;
     real_t pdf(const SurfaceInfo& ref, const Direction& wi) const;
@@ -43,6 +43,16 @@ namespace rt {
     ~BaseRenderer() noexcept;
 
   protected:
+    Color primaryRadiance(Ray *ray, const size_t x, const size_t y, const size_t s,
+                          const ScenePtr& scene, const CameraPtr& camera,
+                          const SamplerPtr& sampler) const;
+    Color radiance(const Ray& ray, const ScenePtr& scene, const SamplerPtr& sampler,
+                   const uint_t depth, const Color& throughput) const;
+
+    // NOTE: Radiance along 'ray' leaving its first hit 'ref', which may be a miss.
+    virtual Color shade(const Ray& ray, const SurfaceInfo& ref, const ScenePtr& scene,
+                        const SamplerPtr& sampler, const uint_t depth) const = 0;
+
     Color specularReflectOrTransmit(const SurfaceInfo& ref, const ScenePtr& scene,
                                     const SamplerPtr& sampler, const uint_t depth,
                                     const bool is_transmit) const;
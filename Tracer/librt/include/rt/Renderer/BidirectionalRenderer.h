@@ -0,0 +1,74 @@
+/****************************************************************************
+** Copyright (c) 2021, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#pragma once
+
+#include <atomic>
+
+#include "rt/Renderer/Film.h"
+#include "rt/Renderer/IRenderer.h"
+
+namespace rt {
+
+  /*
+   * NOTE:
+   * Cf. to PBR3 Chapter "16.3 Bidirectional Path Tracing" for an explanation
+   * of this renderer. Contributions of the light tracing strategies (i.e. paths
+   * connecting to the camera) are splatted onto a Film shared by all blocks;
+   * the final image is developed by endFrame().
+   * The radiance along a single ray is NOT supported; cf. to IRenderer::radiance().
+   */
+  class BidirectionalRenderer : public IRenderer {
+  public:
+    BidirectionalRenderer(const RenderOptions& options) noexcept;
+    ~BidirectionalRenderer() noexcept;
+
+    bool isResumable() const;
+
+    void beginFrame(const ScenePtr& scene, const CameraPtr& camera, const SamplerPtr& sampler);
+    bool endFrame(Image *image, Film *film) const;
+
+    Image render(RenderBlock block, const ScenePtr& scene,
+                 const CameraPtr& camera, const SamplerPtr& sampler,
+                 Film *film) const;
+
+    static RendererPtr create(const RenderOptions& options);
+
+  private:
+    Color radiance(const Ray& ray, const ScenePtr& scene, const SamplerPtr& sampler,
+                   const uint_t depth, const Color& throughput) const;
+    real_t splatScale() const;
+
+    mutable Film _film{};
+    mutable std::atomic<size_t> _numLightPaths{0};
+  };
+
+} // namespace rt
@@ -48,8 +48,8 @@ namespace rt {
   private:
     bool _sample_one_light{false};
 
-    Color radiance(const Ray& ray, const ScenePtr& scene, const SamplerPtr& sampler,
-                   const uint_t depth, const Color& throughput) const;
+    Color shade(const Ray& ray, const SurfaceInfo& ref, const ScenePtr& scene,
+                const SamplerPtr& sampler, const uint_t depth) const;
   };
 
   inline DirectLightingRenderer *DIRECT_LIGHTING(const RendererPtr& renderer)
@@ -0,0 +1,107 @@
+/****************************************************************************
+** Copyright (c) 2021, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#pragma once
+
+#include <array>
+#include <memory>
+#include <shared_mutex>
+#include <vector>
+
+#include "rt/Base/Types.h"
+
+namespace rt {
+
+  struct IrradianceRecord {
+    IrradianceRecord() noexcept = default;
+
+    Vertex P{};
+    Normal N{}; // Facing the hemisphere the irradiance was gathered over
+    Color  E{};
+    real_t R{0}; // Harmonic mean distance to the surrounding geometry
+  };
+
+  /*
+   * NOTE:
+   * Cf. to Ward et al., "A Ray Tracing Solution for Diffuse Interreflection".
+   * Records are kept in an octree, which grows on demand since the scene's
+   * bounds are unknown. A record is stored in the smallest node containing its
+   * position whose half size still covers the record's radius of influence;
+   * hence a lookup only needs to visit nodes whose bounds, enlarged by their
+   * half size, contain the lookup's position.
+   * Lookups may run concurrently; insertions are serialized.
+   */
+  class IrradianceCache {
+  public:
+    IrradianceCache() noexcept;
+    ~IrradianceCache() noexcept;
+
+    real_t accuracy() const;
+    void setAccuracy(const real_t a);
+
+    void clear();
+    void insert(const IrradianceRecord& record);
+    bool interpolate(Color *E, const Vertex& P, const Normal& N) const;
+
+    bool isEmpty() const;
+    size_t size() const;
+
+  private:
+    IrradianceCache(const IrradianceCache&) noexcept = delete;
+    IrradianceCache& operator=(const IrradianceCache&) noexcept = delete;
+
+    IrradianceCache(IrradianceCache&&) noexcept = delete;
+    IrradianceCache& operator=(IrradianceCache&&) noexcept = delete;
+
+    struct Node {
+      Node(const Vertex& center, const real_t halfSize) noexcept;
+
+      bool contains(const Vertex& P, const real_t margin = 0) const;
+      size_t octant(const Vertex& P) const;
+
+      Vertex center{};
+      real_t halfSize{0};
+      std::array<std::unique_ptr<Node>,8> children{};
+      std::vector<IrradianceRecord> records{};
+    };
+
+    void grow(const Vertex& P, const real_t radius);
+    void interpolate(const Node *node, const Vertex& P, const Normal& N,
+                     Color *sumE, real_t *sumW) const;
+    real_t weight(const IrradianceRecord& record, const Vertex& P, const Normal& N) const;
+
+    real_t _accuracy{0.35};
+    mutable std::shared_mutex _mutex{};
+    std::unique_ptr<Node> _root{};
+    size_t _size{0};
+  };
+
+} // namespace rt
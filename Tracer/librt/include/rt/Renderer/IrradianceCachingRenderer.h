@@ -0,0 +1,108 @@
+/****************************************************************************
+** Copyright (c) 2021, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#pragma once
+
+#include <atomic>
+
+#include "rt/Renderer/BaseRenderer.h"
+#include "rt/Renderer/IrradianceCache.h"
+
+namespace rt {
+
+  class Scene;
+
+  struct IrradianceStats {
+    IrradianceStats() noexcept = default;
+
+    size_t numRecords{0};
+    size_t numLookups{0};
+    size_t numInterpolated{0};
+  };
+
+  /*
+   * NOTE:
+   * Direct lighting and specular bounces are computed like DirectLightingRenderer;
+   * diffuse interreflection at Lambertian surfaces is interpolated from an
+   * irradiance cache, which is filled lazily while rendering.
+   * A missing record is computed by path tracing a cosine-weighted set of
+   * gather rays; other non-specular surfaces path trace a single sample.
+   * The irradiance's gradients are NOT computed, trading bias for simplicity.
+   */
+  class IrradianceCachingRenderer : public BaseRenderer {
+  public:
+    IrradianceCachingRenderer(const RenderOptions& options) noexcept;
+    ~IrradianceCachingRenderer() noexcept;
+
+    real_t accuracy() const;
+    void setAccuracy(const real_t a);
+
+    real_t minSpacing() const;
+    real_t maxSpacing() const;
+    void setSpacing(const real_t minSpacing, const real_t maxSpacing);
+
+    size_t numGatherRays() const;
+    void setNumGatherRays(const size_t numRays);
+
+    void beginFrame(const ScenePtr& scene, const CameraPtr& camera, const SamplerPtr& sampler);
+
+    const IrradianceCache& cache() const;
+
+    IrradianceStats stats() const;
+    RenderStats statistics() const;
+
+    static RendererPtr create(const RenderOptions& options);
+
+  private:
+    IrradianceRecord computeRecord(const SurfaceInfo& ref, const Normal& N, const Scene& scene,
+                                   const SamplerPtr& sampler, const uint_t maxDepth) const;
+    Color gather(const Ray& ray, const Scene& scene, const SamplerPtr& sampler,
+                 const uint_t maxDepth, real_t *t) const;
+    Color indirect(const SurfaceInfo& ref, const Scene& scene, const SamplerPtr& sampler,
+                   const uint_t depth) const;
+    Color shade(const Ray& ray, const SurfaceInfo& ref, const ScenePtr& scene,
+                const SamplerPtr& sampler, const uint_t depth) const;
+
+    real_t _minSpacing{0.05};
+    real_t _maxSpacing{1};
+    size_t _numGatherRays{128};
+
+    mutable IrradianceCache _cache{};
+    mutable std::atomic<size_t> _numLookups{0};
+    mutable std::atomic<size_t> _numInterpolated{0};
+  };
+
+  inline IrradianceCachingRenderer *IRRADIANCE_CACHING(const RendererPtr& renderer)
+  {
+    return dynamic_cast<IrradianceCachingRenderer*>(renderer.get());
+  }
+
+} // namespace rt
@@ -0,0 +1,120 @@
+/****************************************************************************
+** Copyright (c) 2021, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#pragma once
+
+#include <vector>
+
+#include "rt/Renderer/IRenderer.h"
+#include "rt/Renderer/SDTree.h"
+
+namespace rt {
+
+  class Scene;
+  struct SurfaceInfo;
+
+  struct GuidingStats {
+    GuidingStats() noexcept = default;
+
+    size_t numLeaves{0};
+    size_t memory{0};
+    real_t msecTraining{0};
+  };
+
+  /*
+   * NOTE:
+   * A path tracer guided by an SD-tree learning the incident radiance; cf. to
+   * Mueller et al., "Practical Path Guiding for Efficient Light-Transport Simulation".
+   * beginFrame() trains the SD-tree in passes of doubling samples per pixel,
+   * refining it in between; the sampling distributions are frozen while rendering.
+   * At non-specular vertices, either the BSDF or the guiding distribution is
+   * sampled; both are combined using one-sample MIS (i.e. the balance heuristic).
+   */
+  class PathGuidingRenderer : public IRenderer {
+  public:
+    PathGuidingRenderer(const RenderOptions& options) noexcept;
+    ~PathGuidingRenderer() noexcept;
+
+    real_t bsdfSamplingFraction() const;
+    void setBsdfSamplingFraction(const real_t fraction);
+
+    size_t maxMemory() const;
+    void setMaxMemory(const size_t numBytes);
+
+    size_t numTrainingPasses() const;
+    void setNumTrainingPasses(const size_t numPasses);
+
+    size_t spatialThreshold() const;
+    void setSpatialThreshold(const size_t numSamples);
+
+    void beginFrame(const ScenePtr& scene, const CameraPtr& camera, const SamplerPtr& sampler);
+
+    GuidingStats stats() const;
+    RenderStats statistics() const;
+
+    static RendererPtr create(const RenderOptions& options);
+
+  private:
+    struct GuideVertex {
+      Vertex      P{};
+      Direction  wi{};
+      real_t    pdf{0};
+      Color    beta{}; // Throughput AFTER the bounce at this vertex
+      Color      Li{}; // Incident radiance along 'wi'
+      size_t   leaf{0};
+    };
+
+    using GuidePath = std::vector<GuideVertex>;
+
+    Color primaryRadiance(Ray *ray, const size_t x, const size_t y, const size_t s,
+                          const ScenePtr& scene, const CameraPtr& camera,
+                          const SamplerPtr& sampler) const;
+    Color radiance(const Ray& ray, const ScenePtr& scene, const SamplerPtr& sampler,
+                   const uint_t depth, const Color& throughput) const;
+    Color trace(const Ray& ray, const SurfaceInfo *primary, const Scene& scene,
+                const SamplerPtr& sampler, GuidePath *path) const;
+    void train(const Scene& scene, const CameraPtr& camera, const SamplerPtr& sampler);
+
+    real_t _bsdfSamplingFraction{0.5};
+    size_t _maxMemory{size_t{64} << 20};
+    size_t _numTrainingPasses{4};
+    size_t _spatialThreshold{12000};
+
+    SDTree _sdtree{};
+    real_t _msecTraining{0};
+  };
+
+  inline PathGuidingRenderer *PATH_GUIDING(const RendererPtr& renderer)
+  {
+    return dynamic_cast<PathGuidingRenderer*>(renderer.get());
+  }
+
+} // namespace rt
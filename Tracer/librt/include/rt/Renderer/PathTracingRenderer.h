@@ -31,20 +31,111 @@
 
 #pragma once
 
+#include <vector>
+
 #include "rt/Renderer/IRenderer.h"
+#include "rt/Renderer/RadianceCache.h"
 
 namespace rt {
 
+  class Scene;
+  struct SurfaceInfo;
+
+  struct AdaptiveStats {
+    AdaptiveStats() noexcept = default;
+
+    size_t numCells{0};
+    size_t numRecords{0};
+    real_t imageCost{0};
+    real_t imageVariance{0};
+    real_t msecPrePass{0};
+  };
+
+  /*
+   * NOTE:
+   * If adaptive Russian roulette is enabled, beginFrame() traces a sparse
+   * pre-pass estimating the image's variance and cost per sample, and recording
+   * the moments and cost of the radiance leaving each path vertex in a
+   * RadianceCache; cf. to Rath et al., "EARS: Efficiency-Aware Russian Roulette
+   * and Splitting". While rendering, each vertex is continued by the number of
+   * paths maximizing the image's efficiency (i.e. the inverse of the product of
+   * variance and cost), as estimated from the vertex' throughput and cached
+   * statistics: below one, the path is terminated by Russian roulette; above
+   * one, it is split. Splitting is limited by maxSplit() per vertex and by
+   * maxPathSplit() along a path, i.e. no depth of a primary sample's tree of
+   * paths exceeds maxPathSplit() branches. Vertices lacking statistics fall back
+   * to the classic Russian roulette.
+   * NOTE: All variances are relative to the pixel's estimate, i.e. the cached
+   * radiance leaving the primary vertex, hence dark pixels are not neglected.
+   * Russian roulette is driven by the second moment of a vertex' radiance,
+   * splitting by its variance at a single vertex; cf. RadianceCache.
+   */
   class PathTracingRenderer : public IRenderer {
   public:
     PathTracingRenderer(const RenderOptions& options) noexcept;
     ~PathTracingRenderer() noexcept;
 
+    bool isAdaptiveRoulette() const;
+    void setAdaptiveRoulette(const bool on);
+
+    size_t maxSplit() const;
+    void setMaxSplit(const size_t n);
+
+    size_t maxPathSplit() const;
+    void setMaxPathSplit(const size_t n);
+
+    size_t numPrePassSamples() const;
+    void setNumPrePassSamples(const size_t numSamples);
+
+    void beginFrame(const ScenePtr& scene, const CameraPtr& camera, const SamplerPtr& sampler);
+
+    AdaptiveStats stats() const;
+    RenderStats statistics() const;
+
     static RendererPtr create(const RenderOptions& options);
 
   private:
+    struct CacheVertex {
+      Vertex    P{};
+      Color  beta{}; // Throughput BEFORE the bounce at this vertex
+      Color    Lo{}; // Radiance leaving this vertex towards the previous one
+      Color  twin{}; // A second estimate of 'Lo', independent of it
+    };
+
+    using CachePath = std::vector<CacheVertex>;
+
+    Color primaryRadiance(Ray *ray, const size_t x, const size_t y, const size_t s,
+                          const ScenePtr& scene, const CameraPtr& camera,
+                          const SamplerPtr& sampler) const;
     Color radiance(const Ray& ray, const ScenePtr& scene, const SamplerPtr& sampler,
                    const uint_t depth, const Color& throughput) const;
+    Color radiance(const Ray& ray, const SurfaceInfo *primary, const Scene& scene,
+                   const SamplerPtr& sampler) const;
+    Color trace(const Ray& ray, const SurfaceInfo *primary, const Scene& scene,
+                const SamplerPtr& sampler, CachePath *path, const uint_t firstBounce = 0,
+                const bool is_specular = false) const;
+    Color traceAdaptive(const Ray& ray, const SurfaceInfo *primary, const Scene& scene,
+                        const SamplerPtr& sampler, const uint_t bounces, const Color& beta,
+                        const bool is_specular_bounce, real_t estimate,
+                        const real_t numPaths) const;
+    Color twin(const SurfaceInfo& ref, const Scene& scene, const SamplerPtr& sampler,
+               const uint_t bounces) const;
+    void prePass(const Scene& scene, const CameraPtr& camera, const SamplerPtr& sampler);
+
+    bool _adaptiveRoulette{false};
+    size_t _maxSplit{8};
+    size_t _maxPathSplit{32};
+    size_t _numPrePassSamples{2};
+
+    RadianceCache _cache{};
+    real_t _imageCost{0};
+    real_t _imageVariance{0};
+    real_t _msecPrePass{0};
   };
 
+  inline PathTracingRenderer *PATH_TRACING(const RendererPtr& renderer)
+  {
+    return dynamic_cast<PathTracingRenderer*>(renderer.get());
+  }
+
 } // namespace rt
@@ -0,0 +1,89 @@
+/****************************************************************************
+** Copyright (c) 2021, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#pragma once
+
+#include <functional>
+#include <vector>
+
+#include "rt/Base/Types.h"
+
+namespace rt {
+
+  struct Photon {
+    Photon() noexcept = default;
+
+    Vertex      P{};
+    Direction  wi{}; // Towards the photon's origin
+    Normal      N{};
+    Color   power{};
+    uint_t   axis{0}; // Splitting axis of the kd-tree
+  };
+
+  using Photons = std::vector<Photon>;
+
+  /*
+   * NOTE:
+   * The photons are stored in a left-balanced kd-tree, which is implicitly
+   * given by the median of each (sub-)range; hence no pointers are required and
+   * the photons are kept contiguous in memory.
+   */
+  class PhotonMap {
+  public:
+    using Callback = std::function<void(const Photon&, const real_t distanceSquared)>;
+
+    PhotonMap() noexcept = default;
+    ~PhotonMap() noexcept = default;
+
+    PhotonMap(PhotonMap&&) noexcept = default;
+    PhotonMap& operator=(PhotonMap&&) noexcept = default;
+
+    void build(Photons&& photons);
+    void clear();
+
+    bool isEmpty() const;
+    size_t memory() const;
+    size_t size() const;
+
+    void query(const Vertex& P, const real_t radius, const Callback& callback) const;
+
+  private:
+    PhotonMap(const PhotonMap&) noexcept = delete;
+    PhotonMap& operator=(const PhotonMap&) noexcept = delete;
+
+    void build(const size_t lo, const size_t hi);
+    void query(const size_t lo, const size_t hi, const Vertex& P, const real_t radius2,
+               const Callback& callback) const;
+
+    Photons _photons{};
+  };
+
+} // namespace rt
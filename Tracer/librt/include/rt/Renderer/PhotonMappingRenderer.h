@@ -0,0 +1,122 @@
+/****************************************************************************
+** Copyright (c) 2021, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#pragma once
+
+#include <atomic>
+#include <vector>
+
+#include "rt/Renderer/IRenderer.h"
+#include "rt/Renderer/PhotonMap.h"
+
+namespace rt {
+
+  class Scene;
+  struct SurfaceInfo;
+
+  struct PhotonStats {
+    PhotonStats() noexcept = default;
+
+    size_t numEmitted{0};
+    size_t numStored{0};
+    size_t memory{0};
+    size_t numQueries{0};
+    real_t msecShoot{0};
+    real_t msecBuild{0};
+    real_t msecQueries{0};
+  };
+
+  /*
+   * NOTE:
+   * Cf. to PBR3 Chapter "16.2 Stochastic Progressive Photon Mapping".
+   * Caustics (i.e. paths L S+ D) are resolved by density estimation using
+   * a photon map shot by beginFrame(); all other transport is path traced.
+   * Each pass owns a photon map with a radius shrinking according to
+   * Knaus & Zwicker, "Progressive Photon Mapping: A Probabilistic Approach";
+   * each sample estimates one randomly chosen pass.
+   */
+  class PhotonMappingRenderer : public IRenderer {
+  public:
+    PhotonMappingRenderer(const RenderOptions& options) noexcept;
+    ~PhotonMappingRenderer() noexcept;
+
+    size_t maxMemory() const;
+    void setMaxMemory(const size_t numBytes);
+
+    size_t numPasses() const;
+    void setNumPasses(const size_t numPasses);
+
+    size_t numPhotons() const;
+    void setNumPhotons(const size_t numPhotons);
+
+    real_t radius() const;
+    void setRadius(const real_t r);
+
+    void beginFrame(const ScenePtr& scene, const CameraPtr& camera, const SamplerPtr& sampler);
+
+    PhotonStats stats() const;
+    RenderStats statistics() const;
+
+    static RendererPtr create(const RenderOptions& options);
+
+  private:
+    struct Pass {
+      PhotonMap map{};
+      real_t radius{0};
+    };
+
+    Color estimateCaustics(const SurfaceInfo& surface, const Pass& pass) const;
+    Color primaryRadiance(Ray *ray, const size_t x, const size_t y, const size_t s,
+                          const ScenePtr& scene, const CameraPtr& camera,
+                          const SamplerPtr& sampler) const;
+    Color radiance(const Ray& ray, const ScenePtr& scene, const SamplerPtr& sampler,
+                   const uint_t depth, const Color& throughput) const;
+    void shootPhotons(const ScenePtr& scene, const SamplerPtr& sampler);
+    Color trace(const Ray& ray, const SurfaceInfo *primary, const Scene& scene,
+                const SamplerPtr& sampler) const;
+
+    size_t _maxMemory{size_t{256} << 20};
+    size_t _numPasses{4};
+    size_t _numPhotons{200000};
+    real_t _radius{0.05};
+
+    std::vector<Pass> _passes{};
+    PhotonStats _stats{};
+    mutable std::atomic<size_t> _numQueries{0};
+    mutable std::atomic<size_t> _nsecQueries{0};
+  };
+
+  inline PhotonMappingRenderer *PHOTON_MAPPING(const RendererPtr& renderer)
+  {
+    return dynamic_cast<PhotonMappingRenderer*>(renderer.get());
+  }
+
+} // namespace rt
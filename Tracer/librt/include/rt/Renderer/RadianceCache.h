@@ -0,0 +1,99 @@
+/****************************************************************************
+** Copyright (c) 2021, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#pragma once
+
+#include <atomic>
+#include <vector>
+
+#include "rt/Base/Types.h"
+
+namespace rt {
+
+  struct RadianceStats {
+    RadianceStats() noexcept = default;
+
+    real_t     mean{0}; // Mean of the radiance's luminance
+    real_t  moment2{0}; // Second moment of the radiance's luminance
+    real_t variance{0}; // Mean variance of the radiance's luminance at a single vertex
+    real_t     cost{0}; // Mean number of path vertices traced to estimate the radiance
+  };
+
+  /*
+   * NOTE:
+   * Statistics of (the luminance of) the radiance leaving the scene's surfaces,
+   * averaged over all directions and binned in a uniform grid spanning 'bounds';
+   * positions outside of 'bounds' are neither recorded nor looked up.
+   * Unlike the cell's variance, a vertex' variance excludes the variation of
+   * the radiance within the cell; it is estimated by the squared difference of
+   * two independent estimates of the radiance leaving the same vertex.
+   * Records may be added concurrently.
+   */
+  class RadianceCache {
+  public:
+    RadianceCache() noexcept;
+    ~RadianceCache() noexcept;
+
+    void clear();
+    void reset(const Bounds& bounds, const size_t resolution);
+
+    void record(const Vertex& P, const real_t L, const real_t cost, const real_t L2);
+    bool lookup(RadianceStats *stats, const Vertex& P, const size_t minRecords = 1) const;
+
+    bool isEmpty() const;
+    size_t numCells() const;
+    size_t numRecords() const;
+
+  private:
+    RadianceCache(const RadianceCache&) noexcept = delete;
+    RadianceCache& operator=(const RadianceCache&) noexcept = delete;
+
+    RadianceCache(RadianceCache&&) noexcept = delete;
+    RadianceCache& operator=(RadianceCache&&) noexcept = delete;
+
+    struct Cell {
+      Cell() noexcept;
+
+      std::atomic<real_t>  sum;
+      std::atomic<real_t> sum2;
+      std::atomic<real_t> sumVar;
+      std::atomic<real_t> cost;
+      std::atomic<size_t> count;
+    };
+
+    bool cellIndex(size_t *index, const Vertex& P) const;
+
+    Bounds _bounds{};
+    size_t _res[3] = {0, 0, 0};
+    std::vector<Cell> _cells{};
+  };
+
+} // namespace rt
@@ -31,6 +31,7 @@
 
 #pragma once
 
+#include "rt/BxDF/IBxDF.h"
 #include "rt/Light/ILight.h"
 #include "rt/Sampler/ISampler.h"
 
@@ -39,6 +40,13 @@ namespace rt {
   class Scene;
   struct SurfaceInfo;
 
+  /*
+   * NOTE:
+   * SpecularTransmissionBTDF scales the transported radiance by eta^2;
+   * importance is NOT scaled, hence paths traced from the lights undo the scaling.
+   */
+  real_t adjointScale(const SurfaceInfo& surface, const IBxDF::Flags sampled_flags);
+
   Color estimateDirectLighting(const SurfaceInfo& ref, const Sample2D& xiRef,
                                const LightPtr& light, const Sample2D& xiLight,
                                const Scene& scene, const bool do_specular = false);
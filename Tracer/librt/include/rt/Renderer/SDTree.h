@@ -0,0 +1,141 @@
+/****************************************************************************
+** Copyright (c) 2021, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <vector>
+
+#include "rt/Base/Types.h"
+#include "rt/Sampler/Sample.h"
+
+namespace rt {
+
+  /*
+   * NOTE:
+   * A quadtree over the cylindrical mapping (cos(theta), phi) of the sphere of
+   * directions; the mapping preserves area, hence the quadtree's sums are
+   * proportional to the solid angle density of the recorded radiance.
+   * Each node stores the sums of its four quadrants; records are added
+   * atomically along the whole path from the root to the leaf.
+   */
+  class DTree {
+  public:
+    DTree() noexcept;
+    ~DTree() noexcept;
+
+    DTree(const DTree& other) noexcept;
+    DTree& operator=(const DTree& other) noexcept;
+
+    bool isEmpty() const;
+    size_t numNodes() const;
+    size_t numSamples() const;
+    void setNumSamples(const size_t numSamples);
+
+    real_t pdf(const Direction& wi) const;
+    Direction sample(const Sample2D& xi, real_t *pdf) const;
+
+    void record(const Direction& wi, const real_t value);
+    void refine(const real_t threshold, const uint_t maxDepth, const size_t maxNodes);
+
+    static size_t nodeSize();
+
+  private:
+    struct Node {
+      Node() noexcept;
+      Node(const Node& other) noexcept;
+      Node& operator=(const Node& other) noexcept;
+
+      real_t sum(const size_t i) const;
+      real_t total() const;
+
+      std::array<std::atomic<real_t>,4> sums;
+      std::array<uint32_t,4> children; // Zero denotes a leaf
+    };
+
+    real_t total() const;
+
+    std::vector<Node> _nodes;
+    std::atomic<size_t> _numSamples{0};
+  };
+
+  /*
+   * NOTE:
+   * Cf. to Mueller et al., "Practical Path Guiding for Efficient Light-Transport
+   * Simulation". A binary kd-tree partitions space; each leaf holds a DTree for
+   * sampling, which is frozen while rendering, and a DTree for building, which
+   * records concurrently during training. refine() is called between passes.
+   */
+  class SDTree {
+  public:
+    SDTree() noexcept;
+    ~SDTree() noexcept;
+
+    void clear();
+    void reset();
+
+    // NOTE: Only valid as long as the root has not been split!
+    void setBounds(const Bounds& bounds);
+
+    bool isEmpty() const;
+    size_t memory() const;
+    size_t numLeaves() const;
+
+    size_t leafIndex(const Vertex& P) const;
+    const DTree *samplingTree(const size_t leaf) const;
+
+    void record(const size_t leaf, const Direction& wi, const real_t value);
+    void refine(const size_t threshold, const size_t maxMemory);
+
+  private:
+    SDTree(const SDTree&) noexcept = delete;
+    SDTree& operator=(const SDTree&) noexcept = delete;
+
+    struct Leaf {
+      DTree sampling{};
+      DTree building{};
+    };
+
+    struct Node {
+      Bounds bounds{};
+      uint_t axis{0};
+      std::array<uint32_t,2> children{}; // Zero denotes a leaf
+      size_t leaf{0};
+    };
+
+    void split(const size_t index);
+
+    std::vector<Leaf> _leaves{};
+    std::vector<Node> _nodes{};
+  };
+
+} // namespace rt
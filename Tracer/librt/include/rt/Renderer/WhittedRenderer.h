@@ -43,8 +43,8 @@ namespace rt {
     static RendererPtr create(const RenderOptions& options);
 
   private:
-    Color radiance(const Ray& ray, const ScenePtr& scene, const SamplerPtr& sampler,
-                   const uint_t depth, const Color& throughput) const;
+    Color shade(const Ray& ray, const SurfaceInfo& ref, const ScenePtr& scene,
+                const SamplerPtr& sampler, const uint_t depth) const;
   };
 
 } // namespace rt
@@ -0,0 +1,116 @@
+/****************************************************************************
+** Copyright (c) 2021, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#pragma once
+
+#include <vector>
+
+#include "rt/Renderer/RenderOptions.h"
+
+namespace rt {
+
+  class IObject;
+  class Scene;
+
+  struct CameraKey {
+    CameraKey() noexcept = default;
+
+    real_t       frame{};
+    Vertex         eye{};
+    Vertex      lookAt{};
+    Direction cameraUp{};
+  };
+
+  // NOTE: The parameters of a <Transform>; angles in radians about the x-, y- & z-axis.
+  struct TransformKey {
+    TransformKey() noexcept = default;
+
+    Transform transform() const;
+
+    real_t     frame{};
+    Vertex translate{};
+    Vertex    rotate{};
+  };
+
+  /*
+   * NOTE:
+   * Keyframed camera & object transforms; parameters are interpolated linearly
+   * between keyframes & held constant before the first and after the last one.
+   * Objects are referenced by address, hence the animation is only valid as long
+   * as the scene it was loaded with.
+   */
+  class Animation {
+  public:
+    Animation() noexcept;
+    ~Animation() noexcept;
+
+    Animation(Animation&&) noexcept;
+    Animation& operator=(Animation&&) noexcept;
+
+    void clear();
+
+    bool isEmpty() const;
+
+    real_t firstFrame() const;
+    real_t lastFrame() const;
+
+    void addCameraKey(const CameraKey& key);
+    void addObjectKey(IObject *object, const TransformKey& key);
+
+    /*
+     * NOTE:
+     * Moves the camera (in 'options') & all animated objects to 'frame'.
+     * Only objects whose transform changed since the last apply() are updated;
+     * returns the number of objects updated.
+     */
+    size_t apply(Scene *scene, RenderOptions *options, const real_t frame);
+
+  private:
+    Animation(const Animation&) = delete;
+    Animation& operator=(const Animation&) = delete;
+
+    struct Track {
+      Track(IObject *_object) noexcept
+        : object{_object}
+      {
+      }
+
+      IObject                  *object{nullptr};
+      std::vector<TransformKey> keys{};
+      TransformKey              last{};
+      bool                      have_last{false};
+    };
+
+    std::vector<CameraKey> _camera{};
+    std::vector<Track>     _tracks{};
+  };
+
+} // namespace rt
@@ -0,0 +1,105 @@
+/****************************************************************************
+** Copyright (c) 2021, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#pragma once
+
+#include <cstdint>
+
+#include <string>
+#include <vector>
+
+#include "rt/Camera/ICamera.h"
+#include "rt/Object/SurfaceInfo.h"
+#include "rt/Renderer/RenderOptions.h"
+
+namespace rt {
+
+  /*
+   * NOTE:
+   * Caches the primary ray & its first hit per pixel sample, allowing re-renders
+   * of an unchanged view to skip primary visibility. begin() invalidates all
+   * records whenever the camera, its options, the sampling rate or seed changed;
+   * records are stored as they are traced, hence a cancelled frame leaves a
+   * partially filled cache. The cache is disabled if it would exceed maxMemory().
+   * Records of distinct pixel samples may be stored & looked up concurrently.
+   */
+  class GBuffer {
+  public:
+    GBuffer() noexcept;
+    ~GBuffer() noexcept;
+
+    GBuffer(GBuffer&&) noexcept;
+    GBuffer& operator=(GBuffer&&) noexcept;
+
+    size_t maxMemory() const;
+    void setMaxMemory(const size_t numBytes);
+
+    void begin(const CameraPtr& camera, const SamplerPtr& sampler, const RenderOptions& options);
+    void clear();
+
+    bool isEmpty() const;
+    size_t memory() const;
+
+    bool lookup(SurfaceInfo *surface, Ray *ray,
+                const size_t x, const size_t y, const size_t s) const;
+    void store(const size_t x, const size_t y, const size_t s,
+               const Ray& ray, const SurfaceInfo& surface);
+
+  private:
+    GBuffer(const GBuffer&) noexcept = delete;
+    GBuffer& operator=(const GBuffer&) noexcept = delete;
+
+    struct Record {
+      Record() noexcept = default;
+
+      Ray               ray{};
+      Vertex              P{};
+      Normal              N{};
+      real_t              t{geom::intersect::NO_INTERSECTION};
+      real_t           u{0}, v{0};
+      const IObject *object{nullptr};
+      bool         is_valid{false};
+    };
+
+    bool index(size_t *i, const size_t x, const size_t y, const size_t s) const;
+
+    size_t _maxMemory{size_t{1} << 30};
+
+    std::string   _camera{};
+    size_t         _width{0};
+    size_t        _height{0};
+    size_t    _numSamples{0};
+    uint64_t        _seed{0};
+    RenderOptions _options{};
+    std::vector<Record> _records{};
+  };
+
+} // namespace rt
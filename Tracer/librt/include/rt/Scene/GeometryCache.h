@@ -0,0 +1,115 @@
+/****************************************************************************
+** Copyright (c) 2021, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#pragma once
+
+#include <cstdint>
+
+#include <atomic>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <unordered_map>
+
+#include "rt/Base/Types.h"
+
+namespace rt {
+
+  class LazyObject;
+
+  using GeometryCachePtr = std::shared_ptr<class GeometryCache>;
+
+  /*
+   * NOTE:
+   * Bookkeeping of the resident geometry of all LazyObjects of a scene. Geometry is
+   * evicted in least recently used order, whenever the resident geometry exceeds
+   * maxMemory(). Hits may still refer to geometry after it was used; hence geometry
+   * used within a block is pinned until that block ends (cf. beginBlock()), whereas
+   * geometry used outside of any block is pinned until the next frame. maxMemory()
+   * is exceeded only while the geometry used by the blocks in flight exceeds it.
+   */
+  class GeometryCache {
+  public:
+    GeometryCache() noexcept;
+    ~GeometryCache() noexcept;
+
+    size_t maxMemory() const;
+    void setMaxMemory(const size_t numBytes);
+
+    size_t memory() const;
+    size_t numObjects() const;
+    size_t numResident() const;
+
+    // NOTE: Called between frames; cf. IScene::beginFrame().
+    void beginFrame();
+    uint64_t frame() const;
+
+    // NOTE: Called by the thread rendering a block; cf. IScene::beginBlock().
+    void beginBlock();
+    void endBlock();
+
+    static GeometryCachePtr create();
+
+  private:
+    friend class LazyObject;
+
+    GeometryCache(const GeometryCache&) = delete;
+    GeometryCache& operator=(const GeometryCache&) = delete;
+
+    void attach(const LazyObject *object);
+    void detach(const LazyObject *object);
+
+    // NOTE: The calling thread's current block; 0 if outside of any block.
+    uint64_t block() const;
+
+    void evict();
+    void insert(const LazyObject *object, const size_t numBytes, const bool may_evict = true);
+
+    using List = std::list<const LazyObject*>;
+
+    struct Entry {
+      List::iterator lru{};
+      size_t numBytes{0};
+    };
+
+    mutable std::mutex _mutex;
+    uint64_t _block{0};
+    std::set<uint64_t> _blocks; // NOTE: Blocks in flight.
+    std::unordered_map<const LazyObject*,Entry> _entries;
+    std::atomic<uint64_t> _frame{1};
+    List _lru; // NOTE: Most recently used first.
+    size_t _maxMemory{size_t{1} << 30};
+    size_t _memory{0};
+    size_t _numObjects{0};
+  };
+
+} // namespace rt
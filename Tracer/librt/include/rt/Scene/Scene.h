@@ -31,8 +31,15 @@
 
 #pragma once
 
+#include <unordered_map>
+#include <vector>
+
 #include "rt/Light/ILight.h"
+#include "rt/Material/MaterialRegistry.h"
 #include "rt/Object/IObject.h"
+#include "rt/Scene/BVH.h"
+#include "rt/Scene/GBuffer.h"
+#include "rt/Scene/GeometryCache.h"
 #include "rt/Scene/IScene.h"
 
 namespace rt {
@@ -48,6 +55,14 @@ namespace rt {
     void add(LightPtr& light);
     void add(ObjectPtr& object);
 
+    bool aov(AOV *aov, const Ray& ray) const;
+
+    void beginFrame(const CameraPtr& camera, const SamplerPtr& sampler,
+                    const RenderOptions& options);
+
+    void beginBlock() const;
+    void endBlock() const;
+
     Color backgroundColor() const;
     void setBackgroundColor(const Color& color);
 
@@ -56,21 +71,92 @@ namespace rt {
     bool intersect(SurfaceInfo *surface, const Ray& ray) const;
     bool intersect(const Ray& ray) const;
 
+    /*
+     * NOTE:
+     * Intersect the primary ray of sample 's' of pixel (x,y), which is returned in 'ray';
+     * if enabled, the primary hit is looked up in or stored to the G-buffer.
+     */
+    bool intersectPrimary(SurfaceInfo *surface, Ray *ray,
+                          const size_t x, const size_t y, const size_t s,
+                          const Transform& view, const CameraPtr& camera,
+                          const SamplerPtr& sampler) const;
+
+    // NOTE: Radiance of the background & all infinite lights along an escaped ray.
+    Color Le(const Ray& ray) const;
+
     const Lights& lights() const;
+    const Objects& objects() const;
+
+    /*
+     * NOTE:
+     * Moves 'object' of this scene in place; its node in the BVH is refitted
+     * and cached primary hits are discarded.
+     */
+    void moveObject(IObject *object, const Transform& objectToWorld);
+    void setObjectToWorld(IObject *object, const Transform& objectToWorld);
+
+    /*
+     * NOTE:
+     * Replaces 'object' of this scene in place by 'other', which takes over its node
+     * in the BVH; the node is refitted. Removing objects requires a rebuild of the BVH.
+     */
+    void remove(const ILight *light);
+    void remove(const IObject *object);
+    void replace(const ILight *light, LightPtr& other);
+    void replace(const IObject *object, ObjectPtr& other);
+
+    /*
+     * NOTE:
+     * The BVH is (re)built by beginFrame() after objects were added; until then,
+     * all objects are intersected in turn. Between frames, updateBVH() swaps in
+     * a finished background rebuild & starts one if the BVH's quality degraded.
+     */
+    const BVH& bvh() const;
+    void buildBVH();
+    void updateBVH(const bool wait = false);
+    void setBVHRebuildThreshold(const real_t ratio);
 
     bool useCastShadow() const;
     void setUseCastShadow(const bool on);
 
+    /*
+     * NOTE:
+     * Cached primary hits may refer to geometry evicted from the geometry cache,
+     * hence the G-buffer is not used while the scene has LazyObjects.
+     */
+    const GBuffer& gbuffer() const;
+    bool useGBuffer() const;
+    void setUseGBuffer(const bool on);
+
+    // NOTE: The geometry of all LazyObjects of this scene; cf. GeometryCache::setMaxMemory().
+    const GeometryCachePtr& geometryCache() const;
+
+    // NOTE: The shared materials & textures of this scene's objects.
+    const MaterialRegistryPtr& materials() const;
+
     static ScenePtr create();
 
   private:
     Scene(const Scene&) = delete;
     Scene& operator=(const Scene&) = delete;
 
+    template<typename VisitorT>
+    void traverse(const Ray& ray, VisitorT&& visit) const;
+
+    void refitBVH(const IObject *object);
+
     Color _backgroundColor;
+    GeometryCachePtr _geometryCache{GeometryCache::create()};
     Lights _lights;
+    MaterialRegistryPtr _materials{MaterialRegistry::create()};
     Objects _objects;
+    BVH _bvh;
+    bool _bvh_dirty{true};
+    std::unordered_map<const IObject*,size_t> _bvhIndex;
+    std::vector<const IObject*> _bvhObjects;
     bool _use_cast_shadow{false};
+    mutable GBuffer _gbuffer;
+    bool _use_gbuffer{false};
   };
 
   inline Scene *SCENE(const ScenePtr& p)
@@ -31,8 +31,10 @@
 
 #include "rt/Light/DiffuseAreaLight.h"
 
+#include "geom/Shading.h"
 #include "rt/Object/IObject.h"
 #include "rt/Object/SurfaceInfo.h"
+#include "rt/Sampler/Sampling.h"
 
 namespace rt {
 
@@ -47,6 +49,16 @@ namespace rt {
   {
   }
 
+  Color DiffuseAreaLight::emittance() const
+  {
+    return _Lemit;
+  }
+
+  const IObject *DiffuseAreaLight::object() const
+  {
+    return _object;
+  }
+
   real_t DiffuseAreaLight::pdfLi(const SurfaceInfo& ref, const Direction& wi) const
   {
     return _object->pdf(ref, wi);
@@ -63,6 +75,38 @@ namespace rt {
     return radiance(surface, -(*wi));
   }
 
+  void DiffuseAreaLight::pdfLe(const Ray& ray, const Normal& N,
+                               real_t *pdfPos, real_t *pdfDir) const
+  {
+    const real_t cosTheta = n4::dot(N, geom::to_normal(ray.direction()));
+    *pdfPos = ONE/_object->area();
+    *pdfDir = cosTheta > ZERO
+        ? CosineHemisphere::pdf(cosTheta)
+        : 0;
+  }
+
+  Color DiffuseAreaLight::sampleLe(const Sample2D& xiPos, const Sample2D& xiDir,
+                                   Ray *ray, Normal *N, real_t *pdfPos, real_t *pdfDir) const
+  {
+    // (1) Sample Point on Area Light ////////////////////////////////////////
+
+    SurfaceInfo surface = _object->sample(xiPos, pdfPos);
+    surface.xfrmWS = n4::util::frameFromZ(surface.N);
+
+    // (2) Sample Cosine-Weighted Outgoing Direction /////////////////////////
+
+    const Direction wS = CosineHemisphere::sample(xiDir);
+    const Direction  w = surface.toWorld(wS);
+    *pdfDir = CosineHemisphere::pdf(geom::shading::cosTheta(wS));
+
+    // Done! /////////////////////////////////////////////////////////////////
+
+    *ray = Ray(surface.P, w);
+    *N   = surface.N;
+
+    return radiance(surface, w);
+  }
+
   Color DiffuseAreaLight::radiance(const SurfaceInfo& surface, const Direction& wo) const
   {
     return n4::dot(surface.N, geom::to_normal(wo)) > ZERO
@@ -47,6 +47,16 @@ namespace rt {
   {
   }
 
+  Direction DirectionalLight::direction() const
+  {
+    return _wiW;
+  }
+
+  Color DirectionalLight::radiance() const
+  {
+    return _L;
+  }
+
   real_t DirectionalLight::pdfLi(const SurfaceInfo& /*ref*/, const Direction& /*wi*/) const
   {
     return 0;
@@ -65,6 +75,27 @@ namespace rt {
     return _L*scale();
   }
 
+  /*
+   * NOTE:
+   * Emitting rays from a directional light requires the bounds of the scene,
+   * which are not available for unbounded objects (e.g. planes)!
+   */
+  void DirectionalLight::pdfLe(const Ray& /*ray*/, const Normal& /*N*/,
+                               real_t *pdfPos, real_t *pdfDir) const
+  {
+    *pdfPos = 0;
+    *pdfDir = 0;
+  }
+
+  Color DirectionalLight::sampleLe(const Sample2D& /*xiPos*/, const Sample2D& /*xiDir*/,
+                                   Ray * /*ray*/, Normal * /*N*/,
+                                   real_t *pdfPos, real_t *pdfDir) const
+  {
+    *pdfPos = 0;
+    *pdfDir = 0;
+    return Color();
+  }
+
   LightPtr DirectionalLight::create(const Transform& lightToWorld,
                                           const Color& L, const Direction& wiL)
   {
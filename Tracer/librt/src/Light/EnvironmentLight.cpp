@@ -0,0 +1,319 @@
+/****************************************************************************
+** Copyright (c) 2021, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+
+#include <algorithm>
+#include <bit>
+#include <memory>
+
+#include "rt/Light/EnvironmentLight.h"
+
+#include "rt/Object/SurfaceInfo.h"
+
+namespace rt {
+
+  namespace priv {
+
+    using FilePtr = std::unique_ptr<FILE,decltype(&fclose)>;
+
+    inline size_t texelIndex(const real_t x, const size_t n)
+    {
+      return x > ZERO
+          ? std::min<size_t>(size_t(x*real_t(n)), n - 1)
+          : 0;
+    }
+
+    // Map direction in light space to the unit square...
+    inline std::tuple<real_t,real_t> toLatLong(const Direction& w)
+    {
+      const real_t theta = Math::acos(std::clamp<real_t>(w.z, -1, 1));
+      real_t         phi = std::atan2(w.y, w.x);
+      if( phi < ZERO ) {
+        phi += TWO_PI;
+      }
+      return std::tuple<real_t,real_t>{phi/TWO_PI, theta/PI};
+    }
+
+    // Change of variables from the unit square to solid angle.
+    inline real_t toSolidAngle(const real_t sinTheta)
+    {
+      return TWO*PI*PI*sinTheta;
+    }
+
+    inline float readFloat(const unsigned char *bytes, const bool do_swap)
+    {
+      uint32_t bits;
+      std::memcpy(&bits, bytes, sizeof(bits));
+      if( do_swap ) {
+        bits = ((bits & 0x000000FFu) << 24) | ((bits & 0x0000FF00u) <<  8) |
+               ((bits & 0x00FF0000u) >>  8) | ((bits & 0xFF000000u) >> 24);
+      }
+      float f;
+      std::memcpy(&f, &bits, sizeof(f));
+      return std::isfinite(f)  &&  f > 0
+          ? f
+          : 0;
+    }
+
+    /*
+     * NOTE:
+     * Portable Float Map (PFM); a negative scale denotes little-endian data.
+     * Scanlines are stored bottom-to-top!
+     */
+    bool readPFM(const char *filename, size_t *width, size_t *height, std::vector<Color> *texels)
+    {
+      FilePtr file(fopen(filename, "rb"), &fclose);
+      if( !file ) {
+        return false;
+      }
+
+      char     magic[3] = {0, 0, 0};
+      unsigned long w{0}, h{0};
+      float    scale{0};
+      if( fscanf(file.get(), "%2s %lu %lu %f", magic, &w, &h, &scale) != 4  ||
+          fgetc(file.get()) == EOF  ||  w < 1  ||  h < 1  ||  scale == 0 ) {
+        return false;
+      }
+
+      const size_t numChannels = magic[0] == 'P'  &&  magic[1] == 'F'
+          ? 3
+          : magic[0] == 'P'  &&  magic[1] == 'f'
+            ? 1
+            : 0;
+      if( numChannels == 0 ) {
+        return false;
+      }
+
+      // NOTE: Bound the dimensions by the size of the payload before allocating anything!
+      const long offset = ftell(file.get());
+      if( offset < 0  ||  fseek(file.get(), 0, SEEK_END) != 0 ) {
+        return false;
+      }
+      const long end = ftell(file.get());
+      if( end < offset  ||  fseek(file.get(), offset, SEEK_SET) != 0 ) {
+        return false;
+      }
+      const size_t numTexels = size_t(end - offset)/(numChannels*sizeof(float));
+      if( size_t(w) > numTexels  ||  size_t(h) > numTexels/size_t(w) ) {
+        return false;
+      }
+
+      const size_t stride = size_t(w)*numChannels*sizeof(float);
+
+      const bool is_little = scale < 0;
+      const bool   do_swap = is_little != (std::endian::native == std::endian::little);
+
+      std::vector<unsigned char> line;
+      try {
+        line.resize(stride);
+        texels->resize(size_t(w)*size_t(h));
+      } catch(...) {
+        texels->clear();
+        return false;
+      }
+      for(size_t y = 0; y < size_t(h); y++) {
+        if( fread(line.data(), 1, stride, file.get()) != stride ) {
+          return false;
+        }
+
+        Color *row = texels->data() + (size_t(h) - 1 - y)*size_t(w);
+        for(size_t x = 0; x < size_t(w); x++) {
+          const unsigned char *texel = line.data() + x*numChannels*sizeof(float);
+          if( numChannels == 3 ) {
+            row[x] = Color(readFloat(texel, do_swap),
+                           readFloat(texel + sizeof(float), do_swap),
+                           readFloat(texel + 2*sizeof(float), do_swap));
+          } else {
+            row[x] = Color(readFloat(texel, do_swap));
+          }
+        }
+      }
+
+      *width  = size_t(w);
+      *height = size_t(h);
+
+      return true;
+    }
+
+  } // namespace priv
+
+  ////// public //////////////////////////////////////////////////////////////
+
+  EnvironmentLight::EnvironmentLight(const Transform& lightToWorld, const Color& L,
+                                     const size_t width, const size_t height,
+                                     std::vector<Color> texels) noexcept
+    : ILight(Infinite, lightToWorld)
+    , _L{L}
+    , _texels{std::move(texels)}
+    , _width{width}
+    , _height{height}
+  {
+    if( _width < 1  ||  _height < 1  ||  _texels.size() != _width*_height ) {
+      _texels.assign(1, Color(1));
+      _width = _height = 1;
+    }
+
+    // NOTE: The sine accounts for the distortion of the lat-long parameterization.
+    std::vector<real_t> func(_width*_height);
+    for(size_t y = 0; y < _height; y++) {
+      const real_t sinTheta = Math::sin(PI*(real_t(y) + ONE_HALF)/real_t(_height));
+      for(size_t x = 0; x < _width; x++) {
+        func[y*_width + x] = _texels[y*_width + x].luminance()*sinTheta;
+      }
+    }
+    _distribution = Distribution2D(func.data(), _width, _height);
+  }
+
+  EnvironmentLight::~EnvironmentLight() noexcept
+  {
+  }
+
+  size_t EnvironmentLight::width() const
+  {
+    return _width;
+  }
+
+  size_t EnvironmentLight::height() const
+  {
+    return _height;
+  }
+
+  Color EnvironmentLight::radiance() const
+  {
+    return _L;
+  }
+
+  const std::vector<Color>& EnvironmentLight::texels() const
+  {
+    return _texels;
+  }
+
+  const std::string& EnvironmentLight::filename() const
+  {
+    return _filename;
+  }
+
+  Color EnvironmentLight::Le(const Ray& ray) const
+  {
+    const auto [u, v] = priv::toLatLong(n4::normalize(toLight(ray.direction())));
+    return lookup(u, v);
+  }
+
+  real_t EnvironmentLight::pdfLi(const SurfaceInfo& /*ref*/, const Direction& wi) const
+  {
+    const auto [u, v] = priv::toLatLong(n4::normalize(toLight(wi)));
+    const real_t sinTheta = Math::sin(v*PI);
+    if( sinTheta <= ZERO ) {
+      return 0;
+    }
+    return _distribution.pdf(u, v)/priv::toSolidAngle(sinTheta);
+  }
+
+  Color EnvironmentLight::sampleLi(const SurfaceInfo& ref, Direction *wi,
+                                   const Sample2D& xi, real_t *pdf, Ray *vis) const
+  {
+    real_t mapPdf{0};
+    const auto [u, v] = _distribution.sample(xi, &mapPdf);
+
+    const real_t sinTheta = Math::sin(v*PI);
+    const real_t cosTheta = Math::cos(v*PI);
+    if( mapPdf <= ZERO  ||  sinTheta <= ZERO ) {
+      if( pdf != nullptr ) {
+        *pdf = 0;
+      }
+      return Color();
+    }
+
+    *wi = n4::normalize(toWorld(geom::spherical(sinTheta, cosTheta, u*TWO_PI)));
+    if( pdf != nullptr ) {
+      *pdf = mapPdf/priv::toSolidAngle(sinTheta);
+    }
+    if( vis != nullptr ) {
+      *vis = ref.ray(*wi);
+    }
+    return lookup(u, v);
+  }
+
+  /*
+   * NOTE:
+   * Like a directional light, emitting rays requires the bounds of the scene!
+   */
+  void EnvironmentLight::pdfLe(const Ray& /*ray*/, const Normal& /*N*/,
+                               real_t *pdfPos, real_t *pdfDir) const
+  {
+    *pdfPos = 0;
+    *pdfDir = 0;
+  }
+
+  Color EnvironmentLight::sampleLe(const Sample2D& /*xiPos*/, const Sample2D& /*xiDir*/,
+                                   Ray * /*ray*/, Normal * /*N*/,
+                                   real_t *pdfPos, real_t *pdfDir) const
+  {
+    *pdfPos = 0;
+    *pdfDir = 0;
+    return Color();
+  }
+
+  LightPtr EnvironmentLight::create(const Transform& lightToWorld, const Color& L,
+                                    const size_t width, const size_t height,
+                                    std::vector<Color> texels)
+  {
+    return std::make_unique<EnvironmentLight>(lightToWorld, L, width, height, std::move(texels));
+  }
+
+  LightPtr EnvironmentLight::create(const Transform& lightToWorld, const Color& L,
+                                    const char *filename)
+  {
+    size_t width{0}, height{0};
+    std::vector<Color> texels;
+    if( !priv::readPFM(filename, &width, &height, &texels) ) {
+      fprintf(stderr, "Unable to load environment map \"%s\"!\n", filename);
+      return LightPtr();
+    }
+    auto light = std::make_unique<EnvironmentLight>(lightToWorld, L, width, height, std::move(texels));
+    light->_filename = filename;
+    return light;
+  }
+
+  ////// private /////////////////////////////////////////////////////////////
+
+  Color EnvironmentLight::lookup(const real_t u, const real_t v) const
+  {
+    const size_t x = priv::texelIndex(u, _width);
+    const size_t y = priv::texelIndex(v, _height);
+    return _L*_texels[y*_width + x]*scale();
+  }
+
+} // namespace rt
@@ -51,6 +51,11 @@ namespace rt {
     return _type == DeltaDirection  ||  _type == DeltaPosition;
   }
 
+  bool ILight::isInfiniteLight() const
+  {
+    return _type == Infinite;
+  }
+
   size_t ILight::numSamples() const
   {
     return _numSamples;
@@ -80,4 +85,14 @@ namespace rt {
     return _type;
   }
 
+  const Transform& ILight::lightToWorld() const
+  {
+    return _xfrmWL;
+  }
+
+  Color ILight::Le(const Ray& /*ray*/) const
+  {
+    return Color();
+  }
+
 } // namespace rt
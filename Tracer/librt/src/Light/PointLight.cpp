@@ -32,6 +32,7 @@
 #include "rt/Light/PointLight.h"
 
 #include "rt/Object/SurfaceInfo.h"
+#include "rt/Sampler/Sampling.h"
 
 namespace rt {
 
@@ -48,6 +49,11 @@ namespace rt {
   {
   }
 
+  Color PointLight::intensity() const
+  {
+    return _I;
+  }
+
   real_t PointLight::pdfLi(const SurfaceInfo& /*ref*/, const Direction& /*wi*/) const
   {
     return 0;
@@ -67,6 +73,28 @@ namespace rt {
     return _I*attenuation(r)*scale();
   }
 
+  void PointLight::pdfLe(const Ray& /*ray*/, const Normal& /*N*/,
+                         real_t *pdfPos, real_t *pdfDir) const
+  {
+    *pdfPos = 0;
+    *pdfDir = UniformSphere::pdf();
+  }
+
+  /*
+   * NOTE:
+   * Light rays are NOT subject to attenuation(); the fall-off is accounted for
+   * by the geometry term of the path instead.
+   */
+  Color PointLight::sampleLe(const Sample2D& /*xiPos*/, const Sample2D& xiDir,
+                             Ray *ray, Normal *N, real_t *pdfPos, real_t *pdfDir) const
+  {
+    *ray    = Ray(_pW, UniformSphere::sample(xiDir));
+    *N      = Normal();
+    *pdfPos = 1;
+    *pdfDir = UniformSphere::pdf();
+    return _I*scale();
+  }
+
   LightPtr PointLight::create(const Transform& lightToWorld, const Color& I)
   {
     return std::make_unique<PointLight>(lightToWorld, I);
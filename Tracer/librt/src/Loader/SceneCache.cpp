@@ -0,0 +1,1009 @@
+/****************************************************************************
+** Copyright (c) 2021, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#include <cstdio>
+#include <cstring>
+
+#include <filesystem>
+#include <memory>
+#include <span>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+#ifdef _WIN32
+# define NOMINMAX
+# define WIN32_LEAN_AND_MEAN
+# include <Windows.h>
+#else
+# include <fcntl.h>
+# include <sys/mman.h>
+# include <sys/stat.h>
+# include <unistd.h>
+#endif
+
+#include "rt/Loader/SceneCache.h"
+
+#include "rt/Light/DiffuseAreaLight.h"
+#include "rt/Light/DirectionalLight.h"
+#include "rt/Light/EnvironmentLight.h"
+#include "rt/Light/PointLight.h"
+#include "rt/Material/MaterialRegistry.h"
+#include "rt/Material/MatteMaterial.h"
+#include "rt/Material/MirrorMaterial.h"
+#include "rt/Material/OpaqueMaterial.h"
+#include "rt/Material/TransparentMaterial.h"
+#include "rt/Object/Cylinder.h"
+#include "rt/Object/Disk.h"
+#include "rt/Object/Group.h"
+#include "rt/Object/Plane.h"
+#include "rt/Object/Sphere.h"
+#include "rt/Renderer/RenderOptions.h"
+#include "rt/Scene/Scene.h"
+#include "rt/Texture/CheckedTexture.h"
+#include "rt/Texture/FlatTexture.h"
+
+namespace rt {
+
+  namespace priv {
+
+    using FilePtr = std::unique_ptr<FILE,decltype(&fclose)>;
+
+    // Format ////////////////////////////////////////////////////////////////
+
+    inline constexpr char      CACHE_MAGIC[8] = {'R', 'T', 'S', 'C', 'E', 'N', 'E', '\0'};
+    inline constexpr uint32_t CACHE_VERSION   = 3;
+    // NOTE: Sections are aligned suitably for all (SIMD) types, when mapped.
+    inline constexpr uint64_t CACHE_ALIGNMENT = 64;
+
+    inline constexpr int32_t NO_INDEX = -1;
+
+    enum class CacheType : uint32_t {
+      Invalid = 0,
+      // Objects
+      Cylinder = 1,
+      Disk,
+      Group,
+      Plane,
+      Sphere,
+      // Materials
+      Matte = 16,
+      Mirror,
+      Opaque,
+      Transparent,
+      // Textures
+      Checked = 32,
+      Flat,
+      // Lights
+      DiffuseArea = 48,
+      Directional,
+      Environment,
+      Point
+    };
+
+    struct SceneRecord {
+      RenderOptions options;
+      Color         background;
+    };
+
+    // NOTE: Children follow their Group; transforms map to WORLD coordinates.
+    struct ObjectRecord {
+      Matrix    objectToWorld;
+      real_t    param[2];
+      int32_t   parent;
+      int32_t   material;
+      CacheType type;
+    };
+
+    struct MaterialRecord {
+      real_t    param;
+      int32_t   texture[2];
+      CacheType type;
+    };
+
+    struct TextureRecord {
+      Color     color[2];
+      real_t    scale[2];
+      CacheType type;
+    };
+
+    struct LightRecord {
+      Matrix    lightToWorld;
+      Color     L;
+      Direction wiL;
+      real_t    scale;
+      uint64_t  numSamples;
+      uint64_t  firstTexel;
+      uint64_t  width;
+      uint64_t  height;
+      int32_t   object;
+      CacheType type;
+    };
+
+    // NOTE: The element's top level objects are listed in section 'elementObjects'.
+    struct ElementRecord {
+      uint64_t key;
+      uint64_t hash;
+      uint64_t shape;
+      uint64_t material;
+      uint64_t firstObject;
+      uint64_t numObjects;
+      int32_t  light;
+    };
+
+    // NOTE: An external file, e.g. an environment map; cf. to 'fileStamp()'.
+    struct DependencyRecord {
+      uint64_t stamp;
+      uint64_t firstChar;
+      uint64_t numChars;
+    };
+
+    struct CacheSection {
+      uint64_t offset;
+      uint64_t count;
+    };
+
+    struct CacheHeader {
+      char         magic[8];
+      uint32_t     version;
+      uint32_t     sizes[9];
+      uint64_t     hash;
+      CacheSection scene;
+      CacheSection objects;
+      CacheSection materials;
+      CacheSection textures;
+      CacheSection lights;
+      CacheSection texels;
+      CacheSection elements;
+      CacheSection elementObjects;
+      CacheSection dependencies;
+      CacheSection paths;
+    };
+
+    static_assert(std::is_trivially_copyable_v<SceneRecord>);
+    static_assert(std::is_trivially_copyable_v<ObjectRecord>);
+    static_assert(std::is_trivially_copyable_v<MaterialRecord>);
+    static_assert(std::is_trivially_copyable_v<TextureRecord>);
+    static_assert(std::is_trivially_copyable_v<LightRecord>);
+    static_assert(std::is_trivially_copyable_v<ElementRecord>);
+    static_assert(std::is_trivially_copyable_v<DependencyRecord>);
+
+    // NOTE: The layout of the records depends on the build (e.g. 'real_t').
+    inline void cacheSizes(uint32_t *sizes)
+    {
+      sizes[0] = uint32_t(sizeof(real_t));
+      sizes[1] = uint32_t(sizeof(SceneRecord));
+      sizes[2] = uint32_t(sizeof(ObjectRecord));
+      sizes[3] = uint32_t(sizeof(MaterialRecord));
+      sizes[4] = uint32_t(sizeof(TextureRecord));
+      sizes[5] = uint32_t(sizeof(LightRecord));
+      sizes[6] = uint32_t(sizeof(Color));
+      sizes[7] = uint32_t(sizeof(ElementRecord));
+      sizes[8] = uint32_t(sizeof(DependencyRecord));
+    }
+
+    // NOTE: 64bit FNV-1a
+    inline constexpr uint64_t FNV_BASIS = 0xcbf29ce484222325;
+
+    inline uint64_t fnv1a(uint64_t hash, const void *data, const size_t size)
+    {
+      const unsigned char *bytes = reinterpret_cast<const unsigned char*>(data);
+      for(size_t i = 0; i < size; i++) {
+        hash ^= bytes[i];
+        hash *= 0x100000001b3;
+      }
+      return hash;
+    }
+
+    /*
+     * NOTE:
+     * External files are not hashed by content, as they may be large;
+     * their path, size and modification time are hashed instead.
+     */
+    inline bool fileStamp(uint64_t *stamp, const std::string& path)
+    {
+      std::error_code error;
+      const uint64_t size = std::filesystem::file_size(path, error);
+      if( error ) {
+        return false;
+      }
+      const auto mtime = std::filesystem::last_write_time(path, error).time_since_epoch().count();
+      if( error ) {
+        return false;
+      }
+
+      *stamp = fnv1a(FNV_BASIS, path.data(), path.size());
+      *stamp = fnv1a(*stamp, &size, sizeof(size));
+      *stamp = fnv1a(*stamp, &mtime, sizeof(mtime));
+
+      return true;
+    }
+
+    // Compilation ///////////////////////////////////////////////////////////
+
+    struct CacheData {
+      std::vector<ObjectRecord>   objects;
+      std::vector<MaterialRecord> materials;
+      std::vector<TextureRecord>  textures;
+      std::vector<LightRecord>    lights;
+      std::vector<Color>          texels;
+      std::vector<ElementRecord>  elements;
+      std::vector<int32_t>        elementObjects;
+      std::vector<DependencyRecord> dependencies;
+      std::vector<char>             paths;
+      std::unordered_map<const IObject*,int32_t> objectIndex;
+      std::unordered_map<const ILight*,int32_t>  lightIndex;
+      // NOTE: Shared materials & textures are recorded once.
+      std::unordered_map<const IMaterial*,int32_t> materialIndex;
+      std::unordered_map<const ITexture*,int32_t>  textureIndex;
+    };
+
+    bool compileTexture(CacheData *data, int32_t *index, const ITexture *texture)
+    {
+      *index = NO_INDEX;
+      if( texture == nullptr ) {
+        return true;
+      }
+
+      if( const auto it = data->textureIndex.find(texture); it != data->textureIndex.end() ) {
+        *index = it->second;
+        return true;
+      }
+
+      TextureRecord record{};
+      if( const auto *checked = dynamic_cast<const CheckedTexture*>(texture); checked != nullptr ) {
+        record.type     = CacheType::Checked;
+        record.color[0] = checked->colorA();
+        record.color[1] = checked->colorB();
+        record.scale[0] = checked->scaleS();
+        record.scale[1] = checked->scaleT();
+      } else if( const auto *flat = dynamic_cast<const FlatTexture*>(texture); flat != nullptr ) {
+        record.type     = CacheType::Flat;
+        record.color[0] = flat->color();
+      } else {
+        return false;
+      }
+
+      *index = int32_t(data->textures.size());
+      data->textureIndex[texture] = *index;
+      data->textures.push_back(record);
+
+      return true;
+    }
+
+    bool compileMaterial(CacheData *data, int32_t *index, const IMaterial *material)
+    {
+      *index = NO_INDEX;
+      if( material == nullptr ) {
+        return true;
+      }
+
+      if( const auto it = data->materialIndex.find(material); it != data->materialIndex.end() ) {
+        *index = it->second;
+        return true;
+      }
+
+      MaterialRecord record{};
+      record.texture[0] = record.texture[1] = NO_INDEX;
+      if( const auto *matte = dynamic_cast<const MatteMaterial*>(material); matte != nullptr ) {
+        record.type = CacheType::Matte;
+        if( !compileTexture(data, &record.texture[0], matte->texture()) ) {
+          return false;
+        }
+      } else if( const auto *mirror = dynamic_cast<const MirrorMaterial*>(material); mirror != nullptr ) {
+        record.type  = CacheType::Mirror;
+        record.param = mirror->reflectance();
+      } else if( const auto *opaque = dynamic_cast<const OpaqueMaterial*>(material); opaque != nullptr ) {
+        record.type  = CacheType::Opaque;
+        record.param = opaque->shininess();
+        if( !compileTexture(data, &record.texture[0], opaque->diffuse())  ||
+            !compileTexture(data, &record.texture[1], opaque->specular()) ) {
+          return false;
+        }
+      } else if( const auto *transparent = dynamic_cast<const TransparentMaterial*>(material); transparent != nullptr ) {
+        record.type  = CacheType::Transparent;
+        record.param = transparent->refraction();
+      } else {
+        return false;
+      }
+
+      *index = int32_t(data->materials.size());
+      data->materialIndex[material] = *index;
+      data->materials.push_back(record);
+
+      return true;
+    }
+
+    bool compileObject(CacheData *data, const IObject *object, const int32_t parent)
+    {
+      ObjectRecord record{};
+      record.objectToWorld = object->objectToWorld().matrix();
+      record.parent        = parent;
+
+      const Group *group = dynamic_cast<const Group*>(object);
+      if( group != nullptr ) {
+        record.type     = CacheType::Group;
+      } else if( const auto *cylinder = dynamic_cast<const Cylinder*>(object); cylinder != nullptr ) {
+        record.type     = CacheType::Cylinder;
+        record.param[0] = cylinder->height();
+        record.param[1] = cylinder->radius();
+      } else if( const auto *disk = dynamic_cast<const Disk*>(object); disk != nullptr ) {
+        record.type     = CacheType::Disk;
+        record.param[0] = disk->radius();
+      } else if( const auto *plane = dynamic_cast<const Plane*>(object); plane != nullptr ) {
+        record.type     = CacheType::Plane;
+        record.param[0] = plane->width();
+        record.param[1] = plane->height();
+      } else if( const auto *sphere = dynamic_cast<const Sphere*>(object); sphere != nullptr ) {
+        record.type     = CacheType::Sphere;
+        record.param[0] = sphere->radius();
+      } else {
+        return false;
+      }
+
+      if( !compileMaterial(data, &record.material, object->material()) ) {
+        return false;
+      }
+
+      const int32_t index = int32_t(data->objects.size());
+      data->objectIndex[object] = index;
+      data->objects.push_back(record);
+
+      if( group != nullptr ) {
+        for(const ObjectPtr& child : group->objects()) {
+          if( !compileObject(data, child.get(), index) ) {
+            return false;
+          }
+        }
+      }
+
+      return true;
+    }
+
+    bool compileDependency(CacheData *data, const std::string& filename)
+    {
+      std::error_code error;
+      const std::string path = std::filesystem::absolute(filename, error).string();
+      if( error ) {
+        return false;
+      }
+
+      DependencyRecord record{};
+      if( !fileStamp(&record.stamp, path) ) {
+        return false;
+      }
+      record.firstChar = data->paths.size();
+      record.numChars  = path.size();
+
+      data->paths.insert(data->paths.end(), path.begin(), path.end());
+      data->dependencies.push_back(record);
+
+      return true;
+    }
+
+    bool compileLight(CacheData *data, const ILight *light)
+    {
+      LightRecord record{};
+      record.lightToWorld = light->lightToWorld().matrix();
+      record.scale        = light->scale();
+      record.numSamples   = light->numSamples();
+      record.object       = NO_INDEX;
+
+      if( const auto *area = dynamic_cast<const DiffuseAreaLight*>(light); area != nullptr ) {
+        const auto it = data->objectIndex.find(area->object());
+        if( it == data->objectIndex.end() ) {
+          return false;
+        }
+        record.type   = CacheType::DiffuseArea;
+        record.L      = area->emittance();
+        record.object = it->second;
+      } else if( const auto *directional = dynamic_cast<const DirectionalLight*>(light); directional != nullptr ) {
+        record.type = CacheType::Directional;
+        record.L    = directional->radiance();
+        record.wiL  = light->toLight(directional->direction());
+      } else if( const auto *environment = dynamic_cast<const EnvironmentLight*>(light); environment != nullptr ) {
+        record.type       = CacheType::Environment;
+        record.L          = environment->radiance();
+        record.firstTexel = data->texels.size();
+        record.width      = environment->width();
+        record.height     = environment->height();
+        data->texels.insert(data->texels.end(),
+                            environment->texels().begin(), environment->texels().end());
+        if( !environment->filename().empty()  &&
+            !compileDependency(data, environment->filename()) ) {
+          return false;
+        }
+      } else if( const auto *point = dynamic_cast<const PointLight*>(light); point != nullptr ) {
+        record.type = CacheType::Point;
+        record.L    = point->intensity();
+      } else {
+        return false;
+      }
+
+      data->lightIndex[light] = int32_t(data->lights.size());
+      data->lights.push_back(record);
+
+      return true;
+    }
+
+    bool compileElement(CacheData *data, const SceneIndexElement& element)
+    {
+      ElementRecord record{};
+      record.key         = element.key;
+      record.hash        = element.hash;
+      record.shape       = element.shape;
+      record.material    = element.material;
+      record.firstObject = data->elementObjects.size();
+      record.numObjects  = element.objects.size();
+      record.light       = NO_INDEX;
+
+      if( element.light != nullptr ) {
+        const auto it = data->lightIndex.find(element.light);
+        if( it == data->lightIndex.end() ) {
+          return false;
+        }
+        record.light = it->second;
+      }
+
+      for(const IObject *object : element.objects) {
+        const auto it = data->objectIndex.find(object);
+        if( it == data->objectIndex.end() ) {
+          return false;
+        }
+        data->elementObjects.push_back(it->second);
+      }
+
+      data->elements.push_back(record);
+
+      return true;
+    }
+
+    // Construction //////////////////////////////////////////////////////////
+
+    TexturePtr createTexture(const std::span<const TextureRecord>& textures, const int32_t index)
+    {
+      if( index < 0  ||  size_t(index) >= textures.size() ) {
+        return TexturePtr();
+      }
+
+      const TextureRecord& record = textures[index];
+      if(        record.type == CacheType::Checked ) {
+        return CheckedTexture::create(record.color[0], record.color[1],
+                                      record.scale[0], record.scale[1]);
+      } else if( record.type == CacheType::Flat ) {
+        return FlatTexture::create(record.color[0]);
+      }
+
+      return TexturePtr();
+    }
+
+    MaterialPtr createMaterial(const std::span<const MaterialRecord>& materials,
+                               const std::span<const TextureRecord>& textures, const int32_t index,
+                               const MaterialRegistryPtr& registry)
+    {
+      if( index < 0  ||  size_t(index) >= materials.size() ) {
+        return MaterialPtr();
+      }
+
+      const MaterialRecord& record = materials[index];
+      if(        record.type == CacheType::Matte ) {
+        MaterialPtr result = MatteMaterial::create();
+        if( record.texture[0] != NO_INDEX ) {
+          const TextureRef texture = registry->add(createTexture(textures, record.texture[0]));
+          if( !texture ) {
+            return MaterialPtr();
+          }
+          MATTE(result)->setTexture(texture);
+        }
+        return result;
+      } else if( record.type == CacheType::Mirror ) {
+        MaterialPtr result = MirrorMaterial::create();
+        MIRROR(result)->setReflectance(record.param);
+        return result;
+      } else if( record.type == CacheType::Opaque ) {
+        const TextureRef diffuse = registry->add(createTexture(textures, record.texture[0]));
+        TextureRef specular;
+        if( !diffuse  ||
+            (record.texture[1] != NO_INDEX  &&
+             !(specular = registry->add(createTexture(textures, record.texture[1])))) ) {
+          return MaterialPtr();
+        }
+        MaterialPtr result = OpaqueMaterial::create();
+        OpaqueMaterial *opaque = OPAQUE(result);
+        opaque->setDiffuse(diffuse);
+        opaque->setShininess(record.param);
+        opaque->setSpecular(specular);
+        return result;
+      } else if( record.type == CacheType::Transparent ) {
+        MaterialPtr result = TransparentMaterial::create();
+        TRANSPARENT(result)->setRefraction(record.param);
+        return result;
+      }
+
+      return MaterialPtr();
+    }
+
+    ObjectPtr createObject(const ObjectRecord& record)
+    {
+      const Transform objectToWorld(record.objectToWorld);
+      if(        record.type == CacheType::Cylinder ) {
+        return Cylinder::create(objectToWorld, record.param[0], record.param[1]);
+      } else if( record.type == CacheType::Disk ) {
+        return Disk::create(objectToWorld, record.param[0]);
+      } else if( record.type == CacheType::Group ) {
+        return Group::create(objectToWorld);
+      } else if( record.type == CacheType::Plane ) {
+        return Plane::create(objectToWorld, record.param[0], record.param[1]);
+      } else if( record.type == CacheType::Sphere ) {
+        return Sphere::create(objectToWorld, record.param[0]);
+      }
+      return ObjectPtr();
+    }
+
+    LightPtr createLight(const LightRecord& record, const std::span<const Color>& texels,
+                         const std::vector<IObject*>& objects)
+    {
+      const Transform lightToWorld(record.lightToWorld);
+
+      LightPtr light;
+      if(        record.type == CacheType::DiffuseArea ) {
+        if( record.object < 0  ||  size_t(record.object) >= objects.size() ) {
+          return LightPtr();
+        }
+        light = DiffuseAreaLight::create(objects[record.object], record.L);
+        if( light ) {
+          objects[record.object]->setAreaLight(IAREALIGHT(light));
+        }
+      } else if( record.type == CacheType::Directional ) {
+        light = DirectionalLight::create(lightToWorld, record.L, record.wiL);
+      } else if( record.type == CacheType::Environment ) {
+        if( record.firstTexel > texels.size()  ||
+            record.width*record.height > texels.size() - record.firstTexel ) {
+          return LightPtr();
+        }
+        const auto map = texels.subspan(record.firstTexel, record.width*record.height);
+        light = EnvironmentLight::create(lightToWorld, record.L, record.width, record.height,
+                                         std::vector<Color>(map.begin(), map.end()));
+      } else if( record.type == CacheType::Point ) {
+        light = PointLight::create(lightToWorld, record.L);
+      }
+
+      if( light ) {
+        light->setNumSamples(record.numSamples);
+        light->setScale(record.scale);
+      }
+
+      return light;
+    }
+
+    // File I/O //////////////////////////////////////////////////////////////
+
+    /*
+     * NOTE:
+     * The cache is mapped read-only and its records are accessed in place;
+     * the mapping is page aligned, hence so are the sections.
+     */
+    class MappedFile {
+    public:
+#ifdef _WIN32
+      MappedFile(const char *filename) noexcept
+      {
+        const HANDLE file = CreateFileA(filename, GENERIC_READ, FILE_SHARE_READ, nullptr,
+                                        OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if( file == INVALID_HANDLE_VALUE ) {
+          return;
+        }
+        LARGE_INTEGER size;
+        if( GetFileSizeEx(file, &size) != 0  &&  size.QuadPart > 0 ) {
+          // NOTE: The view keeps the mapping alive.
+          const HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+          if( mapping != nullptr ) {
+            const void *data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+            if( data != nullptr ) {
+              _data = reinterpret_cast<const unsigned char*>(data);
+              _size = size_t(size.QuadPart);
+            }
+            CloseHandle(mapping);
+          }
+        }
+        CloseHandle(file);
+      }
+
+      ~MappedFile() noexcept
+      {
+        if( _data != nullptr ) {
+          UnmapViewOfFile(_data);
+        }
+      }
+#else
+      MappedFile(const char *filename) noexcept
+      {
+        const int fd = open(filename, O_RDONLY);
+        if( fd < 0 ) {
+          return;
+        }
+        struct stat info;
+        if( fstat(fd, &info) == 0  &&  info.st_size > 0 ) {
+          void *data = mmap(nullptr, size_t(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+          if( data != MAP_FAILED ) {
+            _data = reinterpret_cast<const unsigned char*>(data);
+            _size = size_t(info.st_size);
+          }
+        }
+        close(fd);
+      }
+
+      ~MappedFile() noexcept
+      {
+        if( _data != nullptr ) {
+          munmap(const_cast<unsigned char*>(_data), _size);
+        }
+      }
+#endif
+
+      MappedFile(const MappedFile&) = delete;
+      MappedFile& operator=(const MappedFile&) = delete;
+
+      const unsigned char *data() const
+      {
+        return _data;
+      }
+
+      size_t size() const
+      {
+        return _size;
+      }
+
+    private:
+      const unsigned char *_data{nullptr};
+      size_t               _size{0};
+    };
+
+    template<typename T>
+    bool readSection(std::span<const T> *records, const MappedFile& file,
+                     const CacheSection& section)
+    {
+      if( section.offset > file.size()  ||  section.offset % alignof(T) != 0  ||
+          section.count > (file.size() - section.offset)/sizeof(T) ) {
+        return false;
+      }
+      *records = std::span<const T>(reinterpret_cast<const T*>(file.data() + section.offset),
+                                    section.count);
+      return true;
+    }
+
+    bool isCurrent(const std::span<const DependencyRecord>& dependencies,
+                   const std::span<const char>& paths)
+    {
+      for(const DependencyRecord& record : dependencies) {
+        if( record.firstChar > paths.size()  ||
+            record.numChars > paths.size() - record.firstChar ) {
+          return false;
+        }
+        const std::string path(paths.data() + record.firstChar, record.numChars);
+        uint64_t stamp = 0;
+        if( !fileStamp(&stamp, path)  ||  stamp != record.stamp ) {
+          return false;
+        }
+      }
+      return true;
+    }
+
+    template<typename T>
+    bool writeSection(FILE *file, CacheSection *section, uint64_t *offset, const T *records,
+                      const size_t count)
+    {
+      static const unsigned char zeros[CACHE_ALIGNMENT] = {};
+
+      const uint64_t padding = (CACHE_ALIGNMENT - *offset % CACHE_ALIGNMENT) % CACHE_ALIGNMENT;
+      if( padding > 0  &&  fwrite(zeros, 1, padding, file) != padding ) {
+        return false;
+      }
+      *offset += padding;
+
+      section->offset = *offset;
+      section->count  = count;
+      if( count > 0  &&  fwrite(records, sizeof(T), count, file) != count ) {
+        return false;
+      }
+      *offset += count*sizeof(T);
+
+      return true;
+    }
+
+  } // namespace priv
+
+  ////// public //////////////////////////////////////////////////////////////
+
+  uint64_t hashSceneFile(const char *filename, bool *ok)
+  {
+    if( ok != nullptr ) {
+      *ok = false;
+    }
+
+    priv::FilePtr file(fopen(filename, "rb"), &fclose);
+    if( !file ) {
+      return 0;
+    }
+
+    uint64_t hash = priv::FNV_BASIS;
+    unsigned char buffer[4096];
+    size_t numRead = 0;
+    while( (numRead = fread(buffer, 1, sizeof(buffer), file.get())) > 0 ) {
+      hash = priv::fnv1a(hash, buffer, numRead);
+    }
+
+    if( ok != nullptr ) {
+      *ok = ferror(file.get()) == 0;
+    }
+
+    return hash;
+  }
+
+  std::string sceneCacheName(const char *filename)
+  {
+    return std::string(filename) + ".rtc";
+  }
+
+  bool readSceneCache(Scene *scene, RenderOptions *options, const char *cacheName,
+                      const uint64_t hash, SceneIndex *index)
+  {
+    scene->clear();
+    *options = RenderOptions();
+
+    // (1) Map File //////////////////////////////////////////////////////////
+
+    const priv::MappedFile file(cacheName);
+    if( file.size() < sizeof(priv::CacheHeader) ) {
+      return false;
+    }
+
+    // (2) Validate Header ///////////////////////////////////////////////////
+
+    const priv::CacheHeader& header = *reinterpret_cast<const priv::CacheHeader*>(file.data());
+
+    uint32_t sizes[9];
+    priv::cacheSizes(sizes);
+    if( std::memcmp(header.magic, priv::CACHE_MAGIC, sizeof(header.magic)) != 0  ||
+        header.version != priv::CACHE_VERSION  ||
+        std::memcmp(header.sizes, sizes, sizeof(sizes)) != 0  ||
+        header.hash != hash ) {
+      return false;
+    }
+
+    std::span<const priv::SceneRecord>      sceneRecords;
+    std::span<const priv::ObjectRecord>     objectRecords;
+    std::span<const priv::MaterialRecord>   materialRecords;
+    std::span<const priv::TextureRecord>    textureRecords;
+    std::span<const priv::LightRecord>      lightRecords;
+    std::span<const Color>                  texels;
+    std::span<const priv::ElementRecord>    elementRecords;
+    std::span<const int32_t>                elementObjects;
+    std::span<const priv::DependencyRecord> dependencies;
+    std::span<const char>                   paths;
+    if( !priv::readSection(&dependencies, file, header.dependencies)  ||
+        !priv::readSection(&paths, file, header.paths)  ||
+        !priv::isCurrent(dependencies, paths) ) {
+      return false;
+    }
+    if( !priv::readSection(&sceneRecords, file, header.scene)  ||  sceneRecords.size() != 1  ||
+        !priv::readSection(&objectRecords, file, header.objects)  ||
+        !priv::readSection(&materialRecords, file, header.materials)  ||
+        !priv::readSection(&textureRecords, file, header.textures)  ||
+        !priv::readSection(&lightRecords, file, header.lights)  ||
+        !priv::readSection(&texels, file, header.texels)  ||
+        !priv::readSection(&elementRecords, file, header.elements)  ||
+        !priv::readSection(&elementObjects, file, header.elementObjects) ) {
+      return false;
+    }
+
+    // (3) Objects ///////////////////////////////////////////////////////////
+
+    std::vector<ObjectPtr> objects;
+    std::vector<IObject*>  pointers;
+    objects.reserve(objectRecords.size());
+    pointers.reserve(objectRecords.size());
+    for(const priv::ObjectRecord& record : objectRecords) {
+      ObjectPtr object = priv::createObject(record);
+      if( !object ) {
+        return false;
+      }
+      if( record.material != priv::NO_INDEX ) {
+        const MaterialRef material = scene->materials()->add(
+            priv::createMaterial(materialRecords, textureRecords, record.material, scene->materials()));
+        if( !material ) {
+          return false;
+        }
+        object->setMaterial(material);
+      }
+      pointers.push_back(object.get());
+      objects.push_back(std::move(object));
+    }
+
+    // NOTE: Children follow their parent, which hence is still owned by 'objects'.
+    for(size_t i = 0; i < objects.size(); i++) {
+      const int32_t parent = objectRecords[i].parent;
+      if( parent == priv::NO_INDEX ) {
+        continue;
+      }
+      if( parent < 0  ||  size_t(parent) >= i  ||  !objects[parent] ) {
+        return false;
+      }
+      Group *group = GROUP(objects[parent]);
+      if( group == nullptr ) {
+        return false;
+      }
+      group->addInWorld(objects[i]);
+    }
+
+    // (4) Lights ////////////////////////////////////////////////////////////
+
+    Lights lights;
+    std::vector<ILight*> lightPointers;
+    for(const priv::LightRecord& record : lightRecords) {
+      LightPtr light = priv::createLight(record, texels, pointers);
+      if( !light ) {
+        return false;
+      }
+      lightPointers.push_back(light.get());
+      lights.push_back(std::move(light));
+    }
+
+    // (5) Index /////////////////////////////////////////////////////////////
+
+    SceneIndex myIndex;
+    for(const priv::ElementRecord& record : elementRecords) {
+      if( record.firstObject > elementObjects.size()  ||
+          record.numObjects > elementObjects.size() - record.firstObject  ||
+          (record.light != priv::NO_INDEX  &&
+           (record.light < 0  ||  size_t(record.light) >= lightPointers.size())) ) {
+        return false;
+      }
+
+      SceneIndexElement& element = myIndex.emplace_back();
+      element.key      = record.key;
+      element.hash     = record.hash;
+      element.shape    = record.shape;
+      element.material = record.material;
+      element.light    = record.light != priv::NO_INDEX
+          ? lightPointers[record.light]
+          : nullptr;
+      for(uint64_t i = 0; i < record.numObjects; i++) {
+        const int32_t object = elementObjects[record.firstObject + i];
+        if( object < 0  ||  size_t(object) >= pointers.size()  ||
+            objectRecords[object].parent != priv::NO_INDEX ) {
+          return false;
+        }
+        element.objects.push_back(pointers[object]);
+      }
+    }
+
+    // (6) Scene /////////////////////////////////////////////////////////////
+
+    for(ObjectPtr& object : objects) {
+      if( object ) {
+        scene->add(object);
+      }
+    }
+    for(LightPtr& light : lights) {
+      scene->add(light);
+    }
+    scene->setBackgroundColor(sceneRecords.front().background);
+
+    *options = sceneRecords.front().options;
+
+    if( index != nullptr ) {
+      *index = std::move(myIndex);
+    }
+
+    return true;
+  }
+
+  bool writeSceneCache(const Scene& scene, const RenderOptions& options, const char *cacheName,
+                       const uint64_t hash, const SceneIndex *index)
+  {
+    // (1) Compile Scene /////////////////////////////////////////////////////
+
+    priv::SceneRecord sceneRecord{};
+    sceneRecord.options    = options;
+    sceneRecord.background = scene.backgroundColor();
+
+    priv::CacheData data;
+    for(const ObjectPtr& object : scene.objects()) {
+      if( !priv::compileObject(&data, object.get(), priv::NO_INDEX) ) {
+        return false;
+      }
+    }
+    for(const LightPtr& light : scene.lights()) {
+      if( !priv::compileLight(&data, light.get()) ) {
+        return false;
+      }
+    }
+    if( index != nullptr ) {
+      for(const SceneIndexElement& element : *index) {
+        if( !priv::compileElement(&data, element) ) {
+          return false;
+        }
+      }
+    }
+
+    // (2) Write File ////////////////////////////////////////////////////////
+
+    const std::string temporary = std::string(cacheName) + ".tmp";
+
+    {
+      priv::FilePtr file(fopen(temporary.data(), "wb"), &fclose);
+      if( !file ) {
+        return false;
+      }
+
+      priv::CacheHeader header{};
+      std::memcpy(header.magic, priv::CACHE_MAGIC, sizeof(header.magic));
+      header.version = priv::CACHE_VERSION;
+      priv::cacheSizes(header.sizes);
+      header.hash    = hash;
+
+      // NOTE: The header is written again, once the sections' offsets are known.
+      uint64_t offset = sizeof(header);
+      if( fwrite(&header, sizeof(header), 1, file.get()) != 1  ||
+          !priv::writeSection(file.get(), &header.scene, &offset, &sceneRecord, 1)  ||
+          !priv::writeSection(file.get(), &header.objects, &offset,
+                              data.objects.data(), data.objects.size())  ||
+          !priv::writeSection(file.get(), &header.materials, &offset,
+                              data.materials.data(), data.materials.size())  ||
+          !priv::writeSection(file.get(), &header.textures, &offset,
+                              data.textures.data(), data.textures.size())  ||
+          !priv::writeSection(file.get(), &header.lights, &offset,
+                              data.lights.data(), data.lights.size())  ||
+          !priv::writeSection(file.get(), &header.texels, &offset,
+                              data.texels.data(), data.texels.size())  ||
+          !priv::writeSection(file.get(), &header.elements, &offset,
+                              data.elements.data(), data.elements.size())  ||
+          !priv::writeSection(file.get(), &header.elementObjects, &offset,
+                              data.elementObjects.data(), data.elementObjects.size())  ||
+          !priv::writeSection(file.get(), &header.dependencies, &offset,
+                              data.dependencies.data(), data.dependencies.size())  ||
+          !priv::writeSection(file.get(), &header.paths, &offset,
+                              data.paths.data(), data.paths.size()) ) {
+        return false;
+      }
+
+      if( fseek(file.get(), 0, SEEK_SET) != 0  ||
+          fwrite(&header, sizeof(header), 1, file.get()) != 1  ||
+          fflush(file.get()) != 0 ) {
+        return false;
+      }
+    }
+
+    return std::rename(temporary.data(), cacheName) == 0;
+  }
+
+} // namespace rt
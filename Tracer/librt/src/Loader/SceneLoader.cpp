@@ -34,17 +34,26 @@
 
 #include <algorithm>
 #include <charconv>
+#include <filesystem>
 #include <limits>
+#include <memory>
+#include <string>
+#include <vector>
 
 #include <tinyxml2.h>
 
 #include "rt/Loader/SceneLoader.h"
 
 #include "rt/Light/ILight.h"
+#include "rt/Loader/SceneCache.h"
 #include "rt/Loader/SceneLoaderBase.h"
+#include "rt/Loader/SceneLoaderElement.h"
 #include "rt/Loader/SceneLoaderObject.h"
+#include "rt/Loader/SceneLoaderStream.h"
 #include "rt/Loader/SceneLoaderStringUtil.h"
+#include "rt/Object/Group.h"
 #include "rt/Renderer/IRenderer.h"
+#include "rt/Scene/Animation.h"
 #include "rt/Scene/Scene.h"
 
 namespace rt {
@@ -53,29 +62,325 @@ namespace rt {
 
     // Imports ///////////////////////////////////////////////////////////////
 
-    LightPtr parseLight(const tinyxml2::XMLElement *node, const ObjectConsumer& add_object);
+    bool parseCameraAnimation(Animation *animation, const tinyxml2::XMLElement *parent,
+                              const RenderOptions& options);
 
-    Objects parseText(const tinyxml2::XMLElement *node);
+    LightPtr parseLight(const tinyxml2::XMLElement *node, const ObjectConsumer& add_object,
+                        const std::filesystem::path& sceneDir, const MaterialRegistryPtr& materials);
+
+    MaterialRef parseMaterial(const tinyxml2::XMLElement *node, const MaterialRegistryPtr& materials);
+
+    bool parseObjectAnimation(Animation *animation, const tinyxml2::XMLElement *parent,
+                              IObject *object);
+
+    Objects parseText(const tinyxml2::XMLElement *node, const MaterialRegistryPtr& materials);
+
+    // Implementation ////////////////////////////////////////////////////////
+
+    void parseSceneElement(SceneElement *element, const std::filesystem::path& sceneDir,
+                           const std::string& sceneFile, const GeometryCachePtr& cache,
+                           const MaterialRegistryPtr& materials)
+    {
+      const tinyxml2::XMLElement *node = element->node;
+      if(        compare(node->Name(), "BackgroundColor") ) {
+        element->background = parseColor(node, &element->ok);
+      } else if( compare(node->Name(), "Light") ) {
+        const ObjectConsumer add_object = [&](ObjectPtr& o) -> void {
+          element->objects.push_back(std::move(o));
+        };
+        element->light = parseLight(node, add_object, sceneDir, materials);
+        element->ok    = bool(element->light);
+      } else if( compare(node->Name(), "Object") ) {
+        ObjectPtr object = isLazyObject(node)
+            ? parseLazyObject(node, sceneFile, element->range, cache, materials)
+            : parseObject(node, materials);
+        element->ok = bool(object);
+        if( element->ok ) {
+          element->objects.push_back(std::move(object));
+        }
+      } else if( compare(node->Name(), "Text") ) {
+        element->objects = parseText(node, materials);
+        element->ok      = !element->objects.empty();
+      } else if( compare(node->Name(), "Prototype") ) {
+        element->ok = length(node->Attribute("name")) > 0;
+        for(const tinyxml2::XMLElement *child = node->FirstChildElement();
+            element->ok  &&  child != nullptr; child = child->NextSiblingElement()) {
+          if(        compare(child->Name(), "Object") ) {
+            ObjectPtr object = parseObject(child, materials);
+            element->ok = bool(object);
+            if( element->ok ) {
+              element->objects.push_back(std::move(object));
+            }
+          } else if( compare(child->Name(), "Text") ) {
+            Objects objects = parseText(child, materials);
+            element->ok = !objects.empty();
+            element->objects.splice(element->objects.end(), objects);
+          }
+        }
+        element->ok = element->ok  &&  !element->objects.empty();
+      } else if( compare(node->Name(), "Instance") ) {
+        element->instances = parseInstanceTransforms(node, &element->ok);
+        element->ok = element->ok  &&  length(node->Attribute("ref")) > 0;
+      } else if( compare(node->Name(), "Material") ) {
+        // NOTE: A redefinition applies to all subsequent references.
+        const MaterialRef material = parseMaterial(node, materials);
+        element->ok = length(node->Attribute("name")) > 0  &&  bool(material);
+        if( element->ok ) {
+          materials->setName(node->Attribute("name"), material);
+        }
+      } else {
+        element->ok = true;
+      }
+    }
+
+    bool isValidSceneElement(const SceneElement& element)
+    {
+      if( element.ok ) {
+        return true;
+      }
+
+      const tinyxml2::XMLElement *node = element.node;
+      if(        compare(node->Name(), "BackgroundColor") ) {
+        fprintf(stderr, "Unable to parse background color!");
+      } else if( compare(node->Name(), "Light") ) {
+        fprintf(stderr, "Unable to add light of type \"%s\"!\n", node->Attribute("type"));
+      } else if( compare(node->Name(), "Object") ) {
+        fprintf(stderr, "Unable to add object of type \"%s\"!\n", node->Attribute("type"));
+      } else if( compare(node->Name(), "Text") ) {
+        fprintf(stderr, "Unable to add text!\n");
+      } else if( compare(node->Name(), "Prototype") ) {
+        fprintf(stderr, "Unable to add prototype \"%s\"!\n", node->Attribute("name"));
+      } else if( compare(node->Name(), "Instance") ) {
+        fprintf(stderr, "Unable to add instance of \"%s\"!\n", node->Attribute("ref"));
+      } else if( compare(node->Name(), "Material") ) {
+        fprintf(stderr, "Unable to add material \"%s\"!\n", node->Attribute("name"));
+      }
+
+      return false;
+    }
+
+    bool isMaterialDefinition(const tinyxml2::XMLElement *node)
+    {
+      return compare(node->Name(), "Material");
+    }
+
+    bool instantiateSceneElement(SceneElement *element, Prototypes *prototypes)
+    {
+      const tinyxml2::XMLElement *node = element->node;
+      if(        compare(node->Name(), "Prototype") ) {
+        // NOTE: A prototype of several objects is shared as a whole.
+        Instance::PrototypePtr prototype;
+        if( element->objects.size() == 1 ) {
+          prototype = std::move(element->objects.front());
+        } else {
+          ObjectPtr group = Group::create(Transform());
+          for(ObjectPtr& object : element->objects) {
+            GROUP(group)->addInWorld(object);
+          }
+          prototype = std::move(group);
+        }
+        element->objects.clear();
+
+        // NOTE: A redefinition applies to all subsequent instances.
+        (*prototypes)[node->Attribute("name")] = prototype;
+
+      } else if( compare(node->Name(), "Instance") ) {
+        const auto it = prototypes->find(node->Attribute("ref"));
+        if( it == prototypes->end() ) {
+          fprintf(stderr, "Unable to find prototype \"%s\"!\n", node->Attribute("ref"));
+          return false;
+        }
+
+        for(const Transform& xform : element->instances) {
+          element->objects.push_back(Instance::create(xform, it->second));
+        }
+        element->instances.clear();
+      }
+
+      return true;
+    }
+
+    bool streamScene(bool *has_scene, tinyxml2::XMLElement *xml_Tracer, const char *filename,
+                     const SceneElementsConsumer& load_elements)
+    {
+      *has_scene = false;
+
+      XMLStream stream;
+      if( !stream.open(filename) ) {
+        fprintf(stderr, "Unable to load XML scene \"%s\"!\n", filename);
+        return false;
+      }
+
+      if( !compare(stream.rootName(), "Tracer") ) {
+        fprintf(stderr, "Invalid XML scene!\n");
+        return false;
+      }
+
+      /*
+       * NOTE:
+       * The children of <Scene> are parsed in parallel batches & added in document order;
+       * their XML is released afterwards.
+       */
+      tinyxml2::XMLDocument *doc = xml_Tracer->GetDocument();
+      while( const char *name = stream.nextName() ) {
+        if( !*has_scene  &&  compare(name, "Scene") ) {
+          *has_scene = true;
+          if( !stream.enter() ) {
+            break;
+          }
+
+          SceneElements elements;
+          while( stream.nextName() != nullptr ) {
+            SceneElement& element = elements.emplace_back();
+            element.node = stream.read(element.doc.get(), &element.range);
+            if( element.node == nullptr ) {
+              break;
+            }
+
+            if( elements.size() >= SCENE_BATCH_SIZE  &&  !load_elements(elements) ) {
+              return false;
+            }
+          }
+
+          if( stream.isError() ) {
+            break;
+          }
+
+          if( !load_elements(elements) ) {
+            return false;
+          }
+
+          stream.leave();
+        } else {
+          tinyxml2::XMLDocument child;
+          const tinyxml2::XMLElement *node = stream.read(&child);
+          if( node == nullptr ) {
+            break;
+          }
+          xml_Tracer->InsertEndChild(node->DeepClone(doc));
+        }
+      }
+
+      if( !stream.leave() ) {
+        fprintf(stderr, "Unable to load XML scene \"%s\"!\n", filename);
+        return false;
+      }
+
+      return true;
+    }
 
   } // namespace priv
 
-  bool loadScene(Scene *scene, RenderOptions *options, const char *filename)
+  bool loadScene(Scene *scene, RenderOptions *options, const char *filename,
+                 Animation *animation, SceneIndex *index)
   {
     scene->clear();
     *options = RenderOptions();
+    if( animation != nullptr ) {
+      animation->clear();
+    }
+    if( index != nullptr ) {
+      index->clear();
+    }
+
+    const std::filesystem::path sceneDir = std::filesystem::path(filename).parent_path();
+    // NOTE: LazyObjects reload their geometry from this file.
+    const std::string sceneFile = std::filesystem::absolute(filename).string();
+
+    // NOTE: Objects are moved into the scene; keep track of the last one for its animation.
+    IObject *lastObject = nullptr;
+    const priv::ObjectConsumer add_object = [&](ObjectPtr& o) -> void {
+      lastObject = o.get();
+      scene->add(o);
+    };
+
+    const auto animate_object = [&](const tinyxml2::XMLElement *xml_Object) -> bool {
+      if( animation == nullptr  ||  xml_Object == nullptr  ||  lastObject == nullptr ) {
+        return true;
+      }
+      if( !priv::parseObjectAnimation(animation, xml_Object, lastObject) ) {
+        fprintf(stderr, "Unable to parse animation of object of type \"%s\"!\n",
+                xml_Object->Attribute("type"));
+        return false;
+      }
+      return true;
+    };
+
+    priv::SceneIndexer indexer;
+    priv::Prototypes prototypes;
+    const priv::SceneElementsConsumer load_elements = [&](priv::SceneElements& elements) -> bool {
+      const auto is_definition = [](const priv::SceneElement& element) -> bool {
+        return priv::isMaterialDefinition(element.node);
+      };
+      priv::forEachSceneElement(elements.begin(), elements.end(), is_definition,
+                                [&](priv::SceneElement& element) -> void {
+        priv::parseSceneElement(&element, sceneDir, sceneFile, scene->geometryCache(),
+                                scene->materials());
+        if( index != nullptr ) {
+          priv::hashSceneElement(&element);
+        }
+      });
+
+      // NOTE: As before, loading fails at the first erroneous element.
+      for(priv::SceneElement& element : elements) {
+        if( !priv::isValidSceneElement(element)  ||
+            !priv::instantiateSceneElement(&element, &prototypes) ) {
+          return false;
+        }
+
+        const tinyxml2::XMLElement *node = element.node;
+        for(ObjectPtr& object : element.objects) {
+          element.index.objects.push_back(object.get());
+        }
+        element.index.light = element.light.get();
+
+        if(        priv::compare(node->Name(), "BackgroundColor") ) {
+          scene->setBackgroundColor(element.background);
+        } else if( priv::compare(node->Name(), "Light") ) {
+          for(ObjectPtr& object : element.objects) {
+            add_object(object);
+          }
+          scene->add(element.light);
+          if( !animate_object(node->FirstChildElement("Object")) ) {
+            return false;
+          }
+        } else if( priv::compare(node->Name(), "Object") ) {
+          add_object(element.objects.front());
+          if( !animate_object(node) ) {
+            return false;
+          }
+        } else if( priv::compare(node->Name(), "Text")  ||
+                   priv::compare(node->Name(), "Instance") ) {
+          for(ObjectPtr& object : element.objects) {
+            scene->add(object);
+          }
+        }
+
+        if( index != nullptr ) {
+          indexer.setKey(&element.index, node);
+          indexer.hashReferences(&element.index, node);
+          index->push_back(std::move(element.index));
+        }
+      }
+
+      elements.clear();
+
+      return true;
+    };
+
+    // (1) Stream <Scene> ////////////////////////////////////////////////////
 
     tinyxml2::XMLDocument doc;
-    if( doc.LoadFile(filename) != tinyxml2::XML_SUCCESS ) {
-      fprintf(stderr, "Unable to load XML scene \"%s\"!\n", filename);
-      return false;
-    }
+    tinyxml2::XMLElement *xml_Tracer = doc.NewElement("Tracer");
+    doc.InsertEndChild(xml_Tracer);
 
-    const tinyxml2::XMLElement *xml_Tracer = doc.FirstChildElement("Tracer");
-    if( xml_Tracer == nullptr ) {
-      fprintf(stderr, "Invalid XML scene!\n");
+    bool has_scene = false;
+    if( !priv::streamScene(&has_scene, xml_Tracer, filename, load_elements) ) {
       return false;
     }
 
+    // (2) Options & Camera //////////////////////////////////////////////////
+
     bool ok = false;
 
     *options = RenderOptions::load(xml_Tracer, &ok);
@@ -84,52 +389,42 @@ namespace rt {
       return false;
     }
 
-    const tinyxml2::XMLElement *xml_Scene = xml_Tracer->FirstChildElement("Scene");
-    if( xml_Scene == nullptr ) {
+    if( animation != nullptr  &&  !priv::parseCameraAnimation(animation, xml_Tracer, *options) ) {
+      fprintf(stderr, "Unable to parse camera animation!\n");
+      return false;
+    }
+
+    if( !has_scene ) {
       fprintf(stderr, "Unable to initialize scene!\n");
       return false;
     }
 
-    const priv::ObjectConsumer add_object = [&](ObjectPtr& o) -> void {
-      scene->add(o);
-    };
+    return true;
+  }
 
-    const tinyxml2::XMLElement *node = xml_Scene->FirstChildElement();
-    while( node != nullptr ) {
-      if(        priv::compare(node->Name(), "BackgroundColor") ) {
-        bool myOk{false};
-        const Color bg = priv::parseColor(node, &myOk);
-        if( !myOk ) {
-          fprintf(stderr, "Unable to parse background color!");
-          return false;
-        }
-        scene->setBackgroundColor(bg);
-      } else if( priv::compare(node->Name(), "Light") ) {
-        LightPtr light = priv::parseLight(node, add_object);
-        if( !light ) {
-          fprintf(stderr, "Unable to add light of type \"%s\"!\n", node->Attribute("type"));
-          return false;
-        }
-        scene->add(light);
-      } else if( priv::compare(node->Name(), "Object") ) {
-        ObjectPtr object = priv::parseObject(node);
-        if( !object ) {
-          fprintf(stderr, "Unable to add object of type \"%s\"!\n", node->Attribute("type"));
-          return false;
-        }
-        scene->add(object);
-      } else if( priv::compare(node->Name(), "Text") ) {
-        Objects objects = priv::parseText(node);
-        if( objects.empty() ) {
-          fprintf(stderr, "Unable to add text!\n");
-          return false;
-        }
-        for(ObjectPtr& object : objects) {
-          scene->add(object);
-        }
-      }
+  bool loadSceneCached(Scene *scene, RenderOptions *options, const char *filename,
+                       SceneIndex *index)
+  {
+    bool ok = false;
+    const uint64_t hash = hashSceneFile(filename, &ok);
+    if( !ok ) {
+      return loadScene(scene, options, filename, nullptr, index);
+    }
+
+    const std::string cacheName = sceneCacheName(filename);
+    if( readSceneCache(scene, options, cacheName.data(), hash, index) ) {
+      return true;
+    }
+
+    // NOTE: The cache always records the index, so that it may be reloaded.
+    SceneIndex myIndex;
+    if( !loadScene(scene, options, filename, nullptr, &myIndex) ) {
+      return false;
+    }
+    writeSceneCache(*scene, *options, cacheName.data(), hash, &myIndex);
 
-      node = node->NextSiblingElement();
+    if( index != nullptr ) {
+      *index = std::move(myIndex);
     }
 
     return true;
@@ -0,0 +1,169 @@
+/****************************************************************************
+** Copyright (c) 2021, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#include <tinyxml2.h>
+
+#include "rt/Loader/SceneLoaderBase.h"
+#include "rt/Scene/Animation.h"
+
+namespace rt {
+
+  namespace priv {
+
+    // Implementation ////////////////////////////////////////////////////////
+
+    real_t parseKeyAngle(const tinyxml2::XMLElement *node,
+                         const char *id, const char *idByPI2, bool *ok)
+    {
+      *ok = true;
+      if(        const tinyxml2::XMLElement *elem = node->FirstChildElement(id);
+                 elem != nullptr ) {
+        return parseAngle(elem, ok);
+      } else if( const tinyxml2::XMLElement *elem = node->FirstChildElement(idByPI2);
+                 elem != nullptr ) {
+        return real_t(parseSignedInt(elem, ok))*PI_HALF;
+      }
+      return 0;
+    }
+
+    bool parseKeyFrame(real_t *frame, const tinyxml2::XMLElement *node)
+    {
+      return node->QueryAttribute("frame", frame) == tinyxml2::XML_SUCCESS;
+    }
+
+    // NOTE: Unlike parseTransform(), the angles are kept for interpolation.
+    bool parseTransformKey(TransformKey *key, const tinyxml2::XMLElement *node)
+    {
+      bool myOk = false;
+
+      if( !parseKeyFrame(&key->frame, node) ) {
+        return false;
+      }
+
+      key->translate = 0;
+      if( const tinyxml2::XMLElement *elem = node->FirstChildElement("Translate");
+          elem != nullptr ) {
+        key->translate = parseVertex(elem, &myOk);
+        if( !myOk ) {
+          return false;
+        }
+      }
+
+      key->rotate = 0;
+      if( const tinyxml2::XMLElement *elem = node->FirstChildElement("Rotate");
+          elem != nullptr ) {
+        key->rotate.x = parseKeyAngle(elem, "rx", "rxByPI2", &myOk);
+        if( !myOk ) {
+          return false;
+        }
+        key->rotate.y = parseKeyAngle(elem, "ry", "ryByPI2", &myOk);
+        if( !myOk ) {
+          return false;
+        }
+        key->rotate.z = parseKeyAngle(elem, "rz", "rzByPI2", &myOk);
+        if( !myOk ) {
+          return false;
+        }
+      }
+
+      return true;
+    }
+
+    // Export ////////////////////////////////////////////////////////////////
+
+    bool parseCameraAnimation(Animation *animation, const tinyxml2::XMLElement *parent,
+                              const RenderOptions& options)
+    {
+      const tinyxml2::XMLElement *xml_Options = parent->FirstChildElement("Options");
+      if( xml_Options == nullptr ) {
+        return true;
+      }
+
+      const tinyxml2::XMLElement *xml_Animation = xml_Options->FirstChildElement("Animation");
+      if( xml_Animation == nullptr ) {
+        return true;
+      }
+
+      for(const tinyxml2::XMLElement *node = xml_Animation->FirstChildElement("Keyframe");
+          node != nullptr; node = node->NextSiblingElement("Keyframe")) {
+        bool myOk = false;
+
+        CameraKey key;
+        if( !parseKeyFrame(&key.frame, node) ) {
+          return false;
+        }
+
+        // NOTE: Missing vectors default to the static camera setup.
+        key.eye = parseVertex(node->FirstChildElement("Eye"), &myOk);
+        if( !myOk ) {
+          key.eye = options.eye;
+        }
+
+        key.lookAt = parseVertex(node->FirstChildElement("LookAt"), &myOk);
+        if( !myOk ) {
+          key.lookAt = options.lookAt;
+        }
+
+        key.cameraUp = parseDirection(node->FirstChildElement("CameraUp"), &myOk);
+        if( !myOk ) {
+          key.cameraUp = options.cameraUp;
+        }
+
+        animation->addCameraKey(key);
+      }
+
+      return true;
+    }
+
+    bool parseObjectAnimation(Animation *animation, const tinyxml2::XMLElement *parent,
+                              IObject *object)
+    {
+      const tinyxml2::XMLElement *xml_Animation = parent->FirstChildElement("Animation");
+      if( xml_Animation == nullptr ) {
+        return true;
+      }
+
+      for(const tinyxml2::XMLElement *node = xml_Animation->FirstChildElement("Keyframe");
+          node != nullptr; node = node->NextSiblingElement("Keyframe")) {
+        TransformKey key;
+        if( !parseTransformKey(&key, node) ) {
+          return false;
+        }
+
+        animation->addObjectKey(object, key);
+      }
+
+      return true;
+    }
+
+  } // namespace priv
+
+} // namespace rt
@@ -29,8 +29,11 @@
 ** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 *****************************************************************************/
 
+#include <filesystem>
+
 #include "rt/Light/DiffuseAreaLight.h"
 #include "rt/Light/DirectionalLight.h"
+#include "rt/Light/EnvironmentLight.h"
 #include "rt/Light/PointLight.h"
 #include "rt/Loader/SceneLoaderBase.h"
 #include "rt/Loader/SceneLoaderObject.h"
@@ -42,7 +45,8 @@ namespace rt {
 
     // Implementation ////////////////////////////////////////////////////////
 
-    LightPtr parseDiffuseAreaLight(const tinyxml2::XMLElement *node, const ObjectConsumer& add_object)
+    LightPtr parseDiffuseAreaLight(const tinyxml2::XMLElement *node, const ObjectConsumer& add_object,
+                                   const MaterialRegistryPtr& materials)
     {
       bool myOk = false;
 
@@ -51,12 +55,12 @@ namespace rt {
         return LightPtr();
       }
 
-      ObjectPtr object = parseObject(node->FirstChildElement("Object"), true);
+      ObjectPtr object = parseObject(node->FirstChildElement("Object"), materials, true);
       if( !object ) {
         return LightPtr();
       }
 
-      MaterialPtr material = MatteMaterial::create();
+      const MaterialRef material = materials->add(MatteMaterial::create());
       if( !material ) {
         return LightPtr();
       }
@@ -109,6 +113,51 @@ namespace rt {
       return light;
     }
 
+    LightPtr parseEnvironmentLight(const tinyxml2::XMLElement *node,
+                                   const std::filesystem::path& sceneDir)
+    {
+      bool myOk = false;
+
+      std::filesystem::path filename = parseString(node->FirstChildElement("Filename"), &myOk);
+      if( !myOk ) {
+        return LightPtr();
+      }
+      if( filename.is_relative() ) {
+        filename = sceneDir/filename;
+      }
+
+      Color L = parseColor(node->FirstChildElement("Radiance"), &myOk);
+      if( !myOk ) {
+        L = Color(1);
+      }
+
+      Transform lightToWorld;
+      if( const tinyxml2::XMLElement *xml_Transform = node->FirstChildElement("Transform");
+          xml_Transform != nullptr ) {
+        lightToWorld = parseTransform(xml_Transform, &myOk);
+        if( !myOk ) {
+          return LightPtr();
+        }
+      }
+
+      LightPtr light = EnvironmentLight::create(lightToWorld, L, filename.string().data());
+      if( !light ) {
+        return LightPtr();
+      }
+
+      const size_t numSamples = parseSize(node->FirstChildElement("NumSamples"), &myOk);
+      if( myOk ) {
+        light->setNumSamples(numSamples);
+      }
+
+      const real_t scale = parseReal(node->FirstChildElement("Scale"), &myOk);
+      if( myOk ) {
+        light->setScale(scale);
+      }
+
+      return light;
+    }
+
     LightPtr parsePointLight(const tinyxml2::XMLElement *node)
     {
       bool myOk = false;
@@ -140,16 +189,19 @@ namespace rt {
 
     // Export ////////////////////////////////////////////////////////////////
 
-    LightPtr parseLight(const tinyxml2::XMLElement *node, const ObjectConsumer& add_object)
+    LightPtr parseLight(const tinyxml2::XMLElement *node, const ObjectConsumer& add_object,
+                        const std::filesystem::path& sceneDir, const MaterialRegistryPtr& materials)
     {
       if( node == nullptr ) {
         return LightPtr();
       }
 
       if(        node->Attribute("type", "DiffuseAreaLight") != nullptr ) {
-        return parseDiffuseAreaLight(node, add_object);
+        return parseDiffuseAreaLight(node, add_object, materials);
       } else if( node->Attribute("type", "Directional") != nullptr ) {
         return parseDirectionalLight(node);
+      } else if( node->Attribute("type", "Environment") != nullptr ) {
+        return parseEnvironmentLight(node, sceneDir);
       } else if( node->Attribute("type", "Point") != nullptr ) {
         return parsePointLight(node);
       }
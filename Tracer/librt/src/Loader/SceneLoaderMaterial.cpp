@@ -29,9 +29,12 @@
 ** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 *****************************************************************************/
 
+#include <cstdio>
+
 #include <tinyxml2.h>
 
 #include "rt/Loader/SceneLoaderBase.h"
+#include "rt/Material/MaterialRegistry.h"
 #include "rt/Material/MatteMaterial.h"
 #include "rt/Material/MirrorMaterial.h"
 #include "rt/Material/OpaqueMaterial.h"
@@ -44,9 +47,14 @@ namespace rt {
 
     // Implementation ////////////////////////////////////////////////////////
 
-    MaterialPtr parseMatteMaterial(const tinyxml2::XMLElement *node)
+    TextureRef parseTexture(const tinyxml2::XMLElement *node, const MaterialRegistryPtr& materials)
+    {
+      return materials->add(ITexture::load(node));
+    }
+
+    MaterialPtr parseMatteMaterial(const tinyxml2::XMLElement *node, const MaterialRegistryPtr& materials)
     {
-      TexturePtr texture = ITexture::load(node->FirstChildElement("Texture"));
+      const TextureRef texture = parseTexture(node->FirstChildElement("Texture"), materials);
       if( !texture ) {
         return MaterialPtr();
       }
@@ -74,11 +82,11 @@ namespace rt {
       return result;
     }
 
-    MaterialPtr parseOpaqueMaterial(const tinyxml2::XMLElement *node)
+    MaterialPtr parseOpaqueMaterial(const tinyxml2::XMLElement *node, const MaterialRegistryPtr& materials)
     {
       bool myOk = false;
 
-      TexturePtr diffuse = ITexture::load(node->FirstChildElement("Diffuse"));
+      const TextureRef diffuse = parseTexture(node->FirstChildElement("Diffuse"), materials);
       if( !diffuse ) {
         return MaterialPtr();
       }
@@ -91,9 +99,9 @@ namespace rt {
         }
       }
 
-      TexturePtr specular;
+      TextureRef specular;
       if( node->FirstChildElement("Specular") != nullptr ) {
-        specular = ITexture::load(node->FirstChildElement("Specular"));
+        specular = parseTexture(node->FirstChildElement("Specular"), materials);
         if( !specular ) {
           return MaterialPtr();
         }
@@ -130,23 +138,32 @@ namespace rt {
 
     // Export ////////////////////////////////////////////////////////////////
 
-    MaterialPtr parseMaterial(const tinyxml2::XMLElement *node)
+    MaterialRef parseMaterial(const tinyxml2::XMLElement *node, const MaterialRegistryPtr& materials)
     {
       if( node == nullptr ) {
-        return MaterialPtr();
+        return MaterialRef();
+      }
+
+      if( const char *name = node->Attribute("ref"); name != nullptr ) {
+        const MaterialRef material = materials->find(name);
+        if( !material ) {
+          fprintf(stderr, "Unable to find material \"%s\"!\n", name);
+        }
+        return material;
       }
 
+      MaterialPtr material;
       if(        node->Attribute("type", "Matte") != nullptr ) {
-        return parseMatteMaterial(node);
+        material = parseMatteMaterial(node, materials);
       } else if( node->Attribute("type", "Mirror") != nullptr ) {
-        return parseMirrorMaterial(node);
+        material = parseMirrorMaterial(node);
       } else if( node->Attribute("type", "Opaque") != nullptr ) {
-        return parseOpaqueMaterial(node);
+        material = parseOpaqueMaterial(node, materials);
       } else if( node->Attribute("type", "Transparent") != nullptr ) {
-        return parseTransparentMaterial(node);
+        material = parseTransparentMaterial(node);
       }
 
-      return MaterialPtr();
+      return materials->add(material);
     }
 
   } // namespace priv
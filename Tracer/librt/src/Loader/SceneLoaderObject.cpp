@@ -31,10 +31,13 @@
 
 #include <tinyxml2.h>
 
+#include "rt/Loader/SceneLoaderObject.h"
+
 #include "rt/Loader/SceneLoaderBase.h"
 #include "rt/Object/Cylinder.h"
 #include "rt/Object/Disk.h"
 #include "rt/Object/Group.h"
+#include "rt/Object/LazyObject.h"
 #include "rt/Object/Plane.h"
 #include "rt/Object/Sphere.h"
 
@@ -44,11 +47,11 @@ namespace rt {
 
     // Import ////////////////////////////////////////////////////////////////
 
-    MaterialPtr parseMaterial(const tinyxml2::XMLElement *node);
+    MaterialRef parseMaterial(const tinyxml2::XMLElement *node, const MaterialRegistryPtr& materials);
 
     // Implementation ////////////////////////////////////////////////////////
 
-    ObjectPtr parseCylinder(const tinyxml2::XMLElement *node)
+    ObjectPtr parseCylinder(const tinyxml2::XMLElement *node, const MaterialRegistryPtr& materials)
     {
       bool myOk = false;
 
@@ -57,7 +60,7 @@ namespace rt {
         return ObjectPtr();
       }
 
-      MaterialPtr material = parseMaterial(node->FirstChildElement("Material"));
+      const MaterialRef material = parseMaterial(node->FirstChildElement("Material"), materials);
       if( !material ) {
         return ObjectPtr();
       }
@@ -78,11 +81,12 @@ namespace rt {
       return object;
     }
 
-    ObjectPtr parseDisk(const tinyxml2::XMLElement *node, const bool mat_is_opt)
+    ObjectPtr parseDisk(const tinyxml2::XMLElement *node, const MaterialRegistryPtr& materials,
+                        const bool mat_is_opt)
     {
       bool myOk = false;
 
-      MaterialPtr material = parseMaterial(node->FirstChildElement("Material"));
+      const MaterialRef material = parseMaterial(node->FirstChildElement("Material"), materials);
       if( !mat_is_opt  &&  !material ) {
         return ObjectPtr();
       }
@@ -103,7 +107,7 @@ namespace rt {
       return object;
     }
 
-    ObjectPtr parsePillar(const tinyxml2::XMLElement *node)
+    ObjectPtr parsePillar(const tinyxml2::XMLElement *node, const MaterialRegistryPtr& materials)
     {
       bool myOk = false;
 
@@ -112,12 +116,10 @@ namespace rt {
         return ObjectPtr();
       }
 
-      MaterialPtr material = parseMaterial(node->FirstChildElement("Material"));
+      const MaterialRef material = parseMaterial(node->FirstChildElement("Material"), materials);
       if( !material ) {
         return ObjectPtr();
       }
-      MaterialPtr materialBottom = material->copy();
-      MaterialPtr materialTop    = material->copy();
 
       const real_t radius = parseReal(node->FirstChildElement("Radius"), &myOk);
       if( !myOk  ||  radius <= 0 ) {
@@ -141,7 +143,7 @@ namespace rt {
       // (2) Top /////////////////////////////////////////////////////////////
 
       ObjectPtr top = Disk::create(Transform::translate(0, 0, height/2), radius);
-      top->setMaterial(materialTop);
+      top->setMaterial(material);
       group->add(top);
 
       // (3) Bottom //////////////////////////////////////////////////////////
@@ -150,13 +152,14 @@ namespace rt {
           Transform::translate(0, 0, -height/2)*
           Transform::rotateZYXbyPI2(0, 0, 2);
       ObjectPtr bottom = Disk::create(xfrmBottom, radius);
-      bottom->setMaterial(materialBottom);
+      bottom->setMaterial(material);
       group->add(bottom);
 
       return groupPtr;
     }
 
-    ObjectPtr parsePlane(const tinyxml2::XMLElement *node, const bool mat_is_opt)
+    ObjectPtr parsePlane(const tinyxml2::XMLElement *node, const MaterialRegistryPtr& materials,
+                         const bool mat_is_opt)
     {
       bool myOk = false;
 
@@ -165,7 +168,7 @@ namespace rt {
         return ObjectPtr();
       }
 
-      MaterialPtr material = parseMaterial(node->FirstChildElement("Material"));
+      const MaterialRef material = parseMaterial(node->FirstChildElement("Material"), materials);
       if( !mat_is_opt  &&  !material ) {
         return ObjectPtr();
       }
@@ -186,11 +189,12 @@ namespace rt {
       return object;
     }
 
-    ObjectPtr parseSphere(const tinyxml2::XMLElement *node, const bool mat_is_opt)
+    ObjectPtr parseSphere(const tinyxml2::XMLElement *node, const MaterialRegistryPtr& materials,
+                          const bool mat_is_opt)
     {
       bool myOk = false;
 
-      MaterialPtr material = parseMaterial(node->FirstChildElement("Material"));
+      const MaterialRef material = parseMaterial(node->FirstChildElement("Material"), materials);
       if( !mat_is_opt  &&  !material ) {
         return ObjectPtr();
       }
@@ -213,27 +217,83 @@ namespace rt {
 
     // Export ////////////////////////////////////////////////////////////////
 
-    ObjectPtr parseObject(const tinyxml2::XMLElement *node, const bool mat_is_opt)
+    ObjectPtr parseObject(const tinyxml2::XMLElement *node, const MaterialRegistryPtr& materials,
+                          const bool mat_is_opt)
     {
       if( node == nullptr ) {
         return ObjectPtr();
       }
 
       if(        node->Attribute("type", "Cylinder") != nullptr ) {
-        return parseCylinder(node);
+        return parseCylinder(node, materials);
       } else if( node->Attribute("type", "Disk") != nullptr ) {
-        return parseDisk(node, mat_is_opt);
+        return parseDisk(node, materials, mat_is_opt);
       } else if( node->Attribute("type", "Pillar") != nullptr ) {
-        return parsePillar(node);
+        return parsePillar(node, materials);
       } else if( node->Attribute("type", "Plane") != nullptr ) {
-        return parsePlane(node, mat_is_opt);
+        return parsePlane(node, materials, mat_is_opt);
       } else if( node->Attribute("type", "Sphere") != nullptr ) {
-        return parseSphere(node, mat_is_opt);
+        return parseSphere(node, materials, mat_is_opt);
       }
 
       return ObjectPtr();
     }
 
+    bool isLazyObject(const tinyxml2::XMLElement *node)
+    {
+      return node != nullptr  &&  node->BoolAttribute("lazy", false);
+    }
+
+    ObjectPtr parseLazyObject(const tinyxml2::XMLElement *node, const std::string& filename,
+                              const XMLRange& range, const GeometryCachePtr& cache,
+                              const MaterialRegistryPtr& materials)
+    {
+      if( node == nullptr ) {
+        return ObjectPtr();
+      }
+
+      Bounds bounds;
+      if( const tinyxml2::XMLElement *xml_Bounds = node->FirstChildElement("Bounds");
+          xml_Bounds != nullptr ) {
+        bool myOk = false;
+
+        const Vertex min = parseVertex(xml_Bounds->FirstChildElement("Min"), &myOk);
+        if( !myOk ) {
+          return ObjectPtr();
+        }
+
+        const Vertex max = parseVertex(xml_Bounds->FirstChildElement("Max"), &myOk);
+        if( !myOk ) {
+          return ObjectPtr();
+        }
+
+        bounds = Bounds(min, max);
+      } else {
+        const ObjectPtr object = parseObject(node, materials);
+        if( !object ) {
+          return ObjectPtr();
+        }
+
+        bounds = object->worldBounds();
+      }
+
+      return LazyObject::create(bounds, lazyObjectLoader(filename, range, materials), cache);
+    }
+
+    LazyObject::Loader lazyObjectLoader(const std::string& filename, const XMLRange& range,
+                                        const MaterialRegistryPtr& materials)
+    {
+      return [=]() -> ObjectPtr {
+        tinyxml2::XMLDocument doc;
+        ObjectPtr object = parseObject(XMLStream::read(&doc, filename.data(), range), materials);
+        if( !object ) {
+          fprintf(stderr, "Unable to load deferred object at line \"%d\" of \"%s\"!\n",
+                  range.line, filename.data());
+        }
+        return object;
+      };
+    }
+
   } // namespace priv
 
 } // namespace rt
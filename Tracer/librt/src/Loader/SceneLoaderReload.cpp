@@ -0,0 +1,455 @@
+/****************************************************************************
+** Copyright (c) 2021, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#include <cstdint>
+
+#include <algorithm>
+#include <execution>
+#include <filesystem>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <tinyxml2.h>
+
+#include "rt/Loader/SceneLoader.h"
+
+#include "rt/Loader/SceneLoaderElement.h"
+#include "rt/Loader/SceneLoaderObject.h"
+#include "rt/Loader/SceneLoaderStringUtil.h"
+#include "rt/Object/Group.h"
+#include "rt/Object/LazyObject.h"
+#include "rt/Renderer/IRenderer.h"
+#include "rt/Scene/Scene.h"
+
+namespace rt {
+
+  namespace priv {
+
+    // Imports ///////////////////////////////////////////////////////////////
+
+    MaterialRef parseMaterial(const tinyxml2::XMLElement *node, const MaterialRegistryPtr& materials);
+
+    // Implementation ////////////////////////////////////////////////////////
+
+    // NOTE: 64bit FNV-1a, cf. hashSceneFile(); strings include their terminator.
+    inline constexpr uint64_t FNV_BASIS = 0xcbf29ce484222325;
+    inline constexpr uint64_t FNV_PRIME = 0x100000001b3;
+
+    void hashString(uint64_t *hash, const char *s)
+    {
+      const size_t len = length(s);
+      for(size_t i = 0; i <= len; i++) {
+        *hash ^= i < len
+            ? uint64_t(static_cast<unsigned char>(s[i]))
+            : 0;
+        *hash *= FNV_PRIME;
+      }
+    }
+
+    void hashElement(uint64_t *hash, const tinyxml2::XMLElement *elem, const char *skip)
+    {
+      hashString(hash, elem->Name());
+      for(const tinyxml2::XMLAttribute *attr = elem->FirstAttribute();
+          attr != nullptr; attr = attr->Next()) {
+        hashString(hash, attr->Name());
+        hashString(hash, attr->Value());
+      }
+
+      for(const tinyxml2::XMLNode *node = elem->FirstChild();
+          node != nullptr; node = node->NextSibling()) {
+        if(        const tinyxml2::XMLElement *child = node->ToElement(); child != nullptr ) {
+          if( !compare(child->Name(), skip) ) {
+            hashElement(hash, child, nullptr);
+          }
+        } else if( const tinyxml2::XMLText *text = node->ToText(); text != nullptr ) {
+          hashString(hash, text->Value());
+        }
+      }
+
+      // NOTE: Marks the end of the children, e.g. of nested vs. adjacent elements.
+      hashString(hash, "/");
+    }
+
+    // NOTE: Returns the number of references to named materials.
+    size_t hashReferences(uint64_t *hash, const tinyxml2::XMLElement *elem,
+                          const std::unordered_map<std::string,uint64_t>& definitions)
+    {
+      size_t numReferences = 0;
+      if( const char *ref = elem->Attribute("ref");
+          compare(elem->Name(), "Material")  &&  ref != nullptr ) {
+        const auto it = definitions.find(ref);
+        *hash ^= it != definitions.end()
+            ? it->second
+            : 0;
+        *hash *= FNV_PRIME;
+        numReferences += 1;
+      }
+
+      for(const tinyxml2::XMLElement *child = elem->FirstChildElement();
+          child != nullptr; child = child->NextSiblingElement()) {
+        numReferences += hashReferences(hash, child, definitions);
+      }
+
+      return numReferences;
+    }
+
+    // NOTE: Only these elements are kept by content; any other is parsed anew.
+    inline bool isIndexedElement(const tinyxml2::XMLElement *node)
+    {
+      return compare(node->Name(), "Light")  ||  compare(node->Name(), "Object")  ||
+          compare(node->Name(), "Text");
+    }
+
+    // Export ////////////////////////////////////////////////////////////////
+
+    void hashSceneElement(SceneElement *element)
+    {
+      SceneIndexElement& index = element->index;
+      const tinyxml2::XMLElement *node = element->node;
+
+      index.hash = index.shape = FNV_BASIS;
+      hashElement(&index.hash, node, nullptr);
+      hashElement(&index.shape, node, "Material");
+
+      index.material = 0;
+      if( const tinyxml2::XMLElement *xml_Material = node->FirstChildElement("Material");
+          xml_Material != nullptr ) {
+        index.material = FNV_BASIS;
+        hashElement(&index.material, xml_Material, nullptr);
+      }
+    }
+
+    void SceneIndexer::setKey(SceneIndexElement *element, const tinyxml2::XMLElement *node)
+    {
+      uint64_t key = FNV_BASIS;
+      hashString(&key, node->Name());
+      hashString(&key, node->Attribute("type"));
+
+      if( const char *id = node->Attribute("id"); id != nullptr ) {
+        hashString(&key, "id");
+        hashString(&key, id);
+      } else {
+        const std::string position = std::to_string(_count[key]++);
+        hashString(&key, position.data());
+      }
+
+      element->key = key;
+    }
+
+    void SceneIndexer::hashReferences(SceneIndexElement *element, const tinyxml2::XMLElement *node)
+    {
+      uint64_t hash = FNV_BASIS;
+      if( priv::hashReferences(&hash, node, _definitions) > 0 ) {
+        element->hash = (element->hash ^ hash)*FNV_PRIME;
+
+        // NOTE: A changed definition of an object's material only changes its material.
+        const tinyxml2::XMLElement *xml_Material = node->FirstChildElement("Material");
+        if( xml_Material != nullptr  &&  xml_Material->Attribute("ref") != nullptr ) {
+          element->material = (element->material ^ hash)*FNV_PRIME;
+        } else {
+          element->shape    = (element->shape ^ hash)*FNV_PRIME;
+        }
+      }
+
+      if( isMaterialDefinition(node)  &&  node->Attribute("name") != nullptr ) {
+        _definitions[node->Attribute("name")] = element->hash;
+      }
+    }
+
+  } // namespace priv
+
+  bool reloadScene(Scene *scene, RenderOptions *options, const char *filename,
+                   SceneIndex *index)
+  {
+    if( index->empty() ) {
+      return loadScene(scene, options, filename, nullptr, index);
+    }
+
+    const std::filesystem::path sceneDir = std::filesystem::path(filename).parent_path();
+    const std::string sceneFile = std::filesystem::absolute(filename).string();
+
+    enum class Action {
+      Add = 0,
+      Keep,
+      Material,
+      Replace
+    };
+
+    constexpr size_t NO_MATCH = size_t(-1);
+
+    // NOTE: Elements of same content are matched in document order.
+    std::unordered_map<uint64_t,std::vector<size_t>> oldByHash;
+    for(size_t i = index->size(); i > 0; i--) {
+      oldByHash[(*index)[i - 1].hash].push_back(i - 1);
+    }
+    std::vector<bool> is_matched(index->size(), false);
+
+    // (1) Stream <Scene> & Match Unchanged Elements /////////////////////////
+
+    priv::SceneElements reloaded;
+    std::vector<Action>    actions;
+    std::vector<size_t>    matches;
+
+    priv::SceneIndexer indexer;
+    const priv::SceneElementsConsumer load_elements = [&](priv::SceneElements& elements) -> bool {
+      std::for_each(std::execution::par, elements.begin(), elements.end(),
+                    [&](priv::SceneElement& element) -> void {
+        priv::hashSceneElement(&element);
+      });
+
+      for(priv::SceneElement& element : elements) {
+        indexer.setKey(&element.index, element.node);
+        indexer.hashReferences(&element.index, element.node);
+
+        Action action = Action::Add;
+        size_t  match = NO_MATCH;
+        if( priv::isIndexedElement(element.node) ) {
+          const auto it = oldByHash.find(element.index.hash);
+          if( it != oldByHash.end()  &&  !it->second.empty() ) {
+            action = Action::Keep;
+            match  = it->second.back();
+            it->second.pop_back();
+            is_matched[match] = true;
+          }
+        }
+
+        // NOTE: The XML of unchanged elements is released immediately.
+        if( action == Action::Keep ) {
+          element.node = nullptr;
+          element.doc.reset();
+        }
+
+        reloaded.push_back(std::move(element));
+        actions.push_back(action);
+        matches.push_back(match);
+      }
+
+      elements.clear();
+
+      return true;
+    };
+
+    tinyxml2::XMLDocument doc;
+    tinyxml2::XMLElement *xml_Tracer = doc.NewElement("Tracer");
+    doc.InsertEndChild(xml_Tracer);
+
+    bool has_scene = false;
+    if( !priv::streamScene(&has_scene, xml_Tracer, filename, load_elements) ) {
+      return false;
+    }
+
+    bool ok = false;
+
+    const RenderOptions myOptions = RenderOptions::load(xml_Tracer, &ok);
+    if( !ok ) {
+      fprintf(stderr, "Unable to parse render options!\n");
+      return false;
+    }
+
+    if( !has_scene ) {
+      fprintf(stderr, "Unable to initialize scene!\n");
+      return false;
+    }
+
+    // (2) Match Changed Elements by Key /////////////////////////////////////
+
+    std::unordered_map<uint64_t,size_t> oldByKey;
+    for(size_t i = 0; i < index->size(); i++) {
+      if( !is_matched[i] ) {
+        oldByKey.emplace((*index)[i].key, i);
+      }
+    }
+
+    for(size_t i = 0; i < reloaded.size(); i++) {
+      const priv::SceneElement& element = reloaded[i];
+      if( actions[i] != Action::Add  ||  !priv::isIndexedElement(element.node) ) {
+        continue;
+      }
+
+      const auto it = oldByKey.find(element.index.key);
+      if( it == oldByKey.end()  ||  is_matched[it->second] ) {
+        continue;
+      }
+      actions[i] = Action::Replace;
+      matches[i] = it->second;
+      is_matched[it->second] = true;
+
+      // NOTE: The material of e.g. a Group is not the material of its children.
+      const SceneIndexElement& old = (*index)[it->second];
+      const bool is_plain = priv::compare(element.node->Name(), "Text")  ||
+          (priv::compare(element.node->Name(), "Object")  &&
+           !priv::isLazyObject(element.node)  &&  old.objects.size() == 1  &&
+           dynamic_cast<const Group*>(old.objects.front()) == nullptr  &&
+           dynamic_cast<const LazyObject*>(old.objects.front()) == nullptr);
+      if( is_plain  &&  element.index.shape == old.shape  &&  element.index.material != 0 ) {
+        actions[i] = Action::Material;
+      }
+    }
+
+    // (3) Parse Changed Elements ////////////////////////////////////////////
+
+    std::vector<MaterialRef> materials(reloaded.size());
+
+    std::vector<size_t> parsed;
+    for(size_t i = 0; i < reloaded.size(); i++) {
+      if( actions[i] != Action::Keep ) {
+        parsed.push_back(i);
+      }
+    }
+
+    // NOTE: All material definitions are parsed anew; cf. isIndexedElement().
+    scene->materials()->clearNames();
+
+    const auto is_definition = [&](const size_t i) -> bool {
+      return priv::isMaterialDefinition(reloaded[i].node);
+    };
+    priv::forEachSceneElement(parsed.begin(), parsed.end(), is_definition,
+                              [&](const size_t i) -> void {
+      priv::SceneElement& element = reloaded[i];
+      if( actions[i] == Action::Material ) {
+        materials[i] = priv::parseMaterial(element.node->FirstChildElement("Material"),
+                                           scene->materials());
+        element.ok   = bool(materials[i]);
+      } else {
+        priv::parseSceneElement(&element, sceneDir, sceneFile, scene->geometryCache(),
+                                scene->materials());
+      }
+    });
+
+    // NOTE: The scene is left as is, if any element fails to parse.
+    for(const size_t i : parsed) {
+      if( !priv::isValidSceneElement(reloaded[i]) ) {
+        return false;
+      }
+    }
+
+    // NOTE: Prototypes are not indexed, hence all of them & their instances are parsed anew.
+    priv::Prototypes prototypes;
+    for(const size_t i : parsed) {
+      if( actions[i] != Action::Material  &&
+          !priv::instantiateSceneElement(&reloaded[i], &prototypes) ) {
+        return false;
+      }
+    }
+
+    // (4) Remove Elements ///////////////////////////////////////////////////
+
+    // NOTE: Elements are replaced in place, if they yield as many objects & lights as before.
+    for(size_t i = 0; i < reloaded.size(); i++) {
+      if( actions[i] != Action::Replace ) {
+        continue;
+      }
+      const SceneIndexElement& old = (*index)[matches[i]];
+      if( reloaded[i].objects.size() != old.objects.size()  ||
+          bool(reloaded[i].light) != (old.light != nullptr) ) {
+        actions[i] = Action::Add;
+        is_matched[matches[i]] = false;
+      }
+    }
+
+    for(size_t i = 0; i < index->size(); i++) {
+      if( is_matched[i] ) {
+        continue;
+      }
+      const SceneIndexElement& old = (*index)[i];
+      for(const IObject *object : old.objects) {
+        scene->remove(object);
+      }
+      scene->remove(old.light);
+    }
+
+    // (5) Update Scene & Index //////////////////////////////////////////////
+
+    SceneIndex myIndex;
+    myIndex.reserve(reloaded.size());
+
+    Color background(0);
+    for(size_t i = 0; i < reloaded.size(); i++) {
+      priv::SceneElement& element = reloaded[i];
+
+      if(        actions[i] == Action::Keep ) {
+        SceneIndexElement& kept = myIndex.emplace_back(std::move((*index)[matches[i]]));
+        kept.key = element.index.key;
+        // NOTE: The element may have moved within the file.
+        for(IObject *object : kept.objects) {
+          if( LazyObject *lazy = dynamic_cast<LazyObject*>(object); lazy != nullptr ) {
+            lazy->setLoader(priv::lazyObjectLoader(sceneFile, element.range,
+                                                   scene->materials()));
+          }
+        }
+        continue;
+
+      } else if( actions[i] == Action::Material ) {
+        SceneIndexElement& changed = myIndex.emplace_back(std::move((*index)[matches[i]]));
+        for(IObject *object : changed.objects) {
+          object->setMaterial(materials[i]);
+        }
+        changed.key      = element.index.key;
+        changed.hash     = element.index.hash;
+        changed.material = element.index.material;
+        continue;
+      }
+
+      for(ObjectPtr& object : element.objects) {
+        element.index.objects.push_back(object.get());
+      }
+      element.index.light = element.light.get();
+
+      const tinyxml2::XMLElement *node = element.node;
+      if(        actions[i] == Action::Replace ) {
+        const SceneIndexElement& old = (*index)[matches[i]];
+        auto object = element.objects.begin();
+        for(const IObject *o : old.objects) {
+          scene->replace(o, *object++);
+        }
+        scene->replace(old.light, element.light);
+      } else if( priv::compare(node->Name(), "BackgroundColor") ) {
+        background = element.background;
+      } else {
+        for(ObjectPtr& object : element.objects) {
+          scene->add(object);
+        }
+        scene->add(element.light);
+      }
+
+      myIndex.push_back(std::move(element.index));
+    }
+
+    scene->setBackgroundColor(background);
+
+    *index   = std::move(myIndex);
+    *options = myOptions;
+
+    return true;
+  }
+
+} // namespace rt
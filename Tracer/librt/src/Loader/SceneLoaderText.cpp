@@ -33,6 +33,7 @@
 #include <tinyxml2.h>
 
 #include "rt/Loader/SceneLoaderBase.h"
+#include "rt/Material/MaterialRegistry.h"
 #include "rt/Object/Sphere.h"
 
 #define FW  8
@@ -44,13 +45,13 @@ namespace rt {
 
     // Import ////////////////////////////////////////////////////////////////
 
-    MaterialPtr parseMaterial(const tinyxml2::XMLElement *node);
+    MaterialRef parseMaterial(const tinyxml2::XMLElement *node, const MaterialRegistryPtr& materials);
 
     // Implementation ////////////////////////////////////////////////////////
 
     Objects createSpheres(std::string text, const real_t radius,
                           const real_t dx, const real_t dz,
-                          const MaterialPtr& material, const Transform& transform)
+                          const MaterialRef& material, const Transform& transform)
     {
       using size_type = std::string::size_type;
 
@@ -88,11 +89,9 @@ namespace rt {
               continue;
             }
 
-            MaterialPtr objMaterial = material->copy();
-
             ObjectPtr obj =
                 rt::Sphere::create(transform*rt::Transform::translate(ox, 0, oz), radius);
-            obj->setMaterial(objMaterial);
+            obj->setMaterial(material);
 
             spheres.push_back(std::move(obj));
           } // For Each Column
@@ -104,7 +103,7 @@ namespace rt {
 
     // Export ////////////////////////////////////////////////////////////////
 
-    Objects parseText(const tinyxml2::XMLElement *node)
+    Objects parseText(const tinyxml2::XMLElement *node, const MaterialRegistryPtr& materials)
     {
       if( node == nullptr ) {
         return Objects();
@@ -122,7 +121,7 @@ namespace rt {
         return Objects();
       }
 
-      const MaterialPtr material = parseMaterial(node->FirstChildElement("Material"));
+      const MaterialRef material = parseMaterial(node->FirstChildElement("Material"), materials);
       if( !material ) {
         return Objects();
       }
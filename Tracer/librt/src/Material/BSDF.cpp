@@ -93,6 +93,20 @@ namespace rt {
     return _bxdfs[i];
   }
 
+  Color BSDF::albedo(const SurfaceInfo& surface) const
+  {
+    if( isEmpty() ) {
+      return Color();
+    }
+    Color sum;
+    for(size_t i = 0; i < size(); i++) {
+      sum += haveTexture(i)
+          ? _bxdfs[i]->color()*_material->textureLookup(i, surface.texCoord2D())
+          : _bxdfs[i]->color();
+    }
+    return sum/real_t(size());
+  }
+
   Color BSDF::eval(const SurfaceInfo& surface, const Direction& wi,
                    const IBxDF::Flags flags) const
   {
@@ -163,7 +177,8 @@ namespace rt {
 
     // (5) Compute Value of BSDF for Sampled Direction ///////////////////////
 
-    if( !bxdf->isSpecular()  &&  matching > 1 ) {
+    // NOTE: Evaluate even a single matching BxDF to account for its texture!
+    if( !bxdf->isSpecular() ) {
       f = evalS(surface.woS, wiS, surface.texCoord2D(), flags);
     }
 
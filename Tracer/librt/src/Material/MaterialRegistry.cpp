@@ -0,0 +1,115 @@
+/****************************************************************************
+** Copyright (c) 2021, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#include "rt/Material/MaterialRegistry.h"
+
+namespace rt {
+
+  ////// public //////////////////////////////////////////////////////////////
+
+  MaterialRegistry::MaterialRegistry() noexcept
+  {
+  }
+
+  MaterialRegistry::~MaterialRegistry() noexcept
+  {
+  }
+
+  MaterialRef MaterialRegistry::add(MaterialPtr& material)
+  {
+    return _materials.add(material);
+  }
+
+  MaterialRef MaterialRegistry::add(MaterialPtr&& material)
+  {
+    return _materials.add(material);
+  }
+
+  TextureRef MaterialRegistry::add(TexturePtr& texture)
+  {
+    return _textures.add(texture);
+  }
+
+  TextureRef MaterialRegistry::add(TexturePtr&& texture)
+  {
+    return _textures.add(texture);
+  }
+
+  MaterialRef MaterialRegistry::find(const std::string& name) const
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    const auto it = _names.find(name);
+    return it != _names.end()
+        ? it->second
+        : MaterialRef();
+  }
+
+  void MaterialRegistry::setName(const std::string& name, const MaterialRef& material)
+  {
+    if( name.empty()  ||  !material ) {
+      return;
+    }
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    _names[name] = material;
+  }
+
+  void MaterialRegistry::clear()
+  {
+    _materials.clear();
+    _textures.clear();
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    _names.clear();
+  }
+
+  void MaterialRegistry::clearNames()
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _names.clear();
+  }
+
+  size_t MaterialRegistry::numMaterials() const
+  {
+    return _materials.size();
+  }
+
+  size_t MaterialRegistry::numTextures() const
+  {
+    return _textures.size();
+  }
+
+  MaterialRegistryPtr MaterialRegistry::create()
+  {
+    return std::make_shared<MaterialRegistry>();
+  }
+
+} // namespace rt
@@ -31,6 +31,7 @@
 
 #include "rt/Material/MatteMaterial.h"
 
+#include "rt/Base/Registry.h"
 #include "rt/BxDF/LambertianBRDF.h"
 
 namespace rt {
@@ -55,12 +56,23 @@ namespace rt {
   {
     MaterialPtr result = create();
     MatteMaterial *matte = MATTE(result);
-    if( _texture ) {
-      matte->setTexture(_texture->copy());
-    }
+    matte->setTexture(_texture);
     return result;
   }
 
+  size_t MatteMaterial::hash() const
+  {
+    size_t seed = 0;
+    hashCombine(&seed, _texture ? _texture->hash() : 0);
+    return seed;
+  }
+
+  bool MatteMaterial::isEqual(const IMaterial& other) const
+  {
+    const MatteMaterial *matte = dynamic_cast<const MatteMaterial*>(&other);
+    return matte != nullptr  &&  isSameTexture(_texture, matte->_texture);
+  }
+
   bool MatteMaterial::haveTexture(const size_t i) const
   {
     return i == LAMBERTIAN  &&  _texture;
@@ -74,6 +86,11 @@ namespace rt {
     return Color();
   }
 
+  const ITexture *MatteMaterial::texture() const
+  {
+    return _texture.get();
+  }
+
   void MatteMaterial::setTexture(TexturePtr& texture)
   {
     _texture = std::move(texture);
@@ -84,6 +101,11 @@ namespace rt {
     _texture = std::move(texture);
   }
 
+  void MatteMaterial::setTexture(const TextureRef& texture)
+  {
+    _texture = texture;
+  }
+
   MaterialPtr MatteMaterial::create()
   {
     return std::make_unique<MatteMaterial>();
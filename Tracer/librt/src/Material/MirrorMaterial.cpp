@@ -31,6 +31,7 @@
 
 #include "rt/Material/MirrorMaterial.h"
 
+#include "rt/Base/Registry.h"
 #include "rt/BxDF/MirrorBRDF.h"
 
 namespace rt {
@@ -55,6 +56,19 @@ namespace rt {
     return result;
   }
 
+  size_t MirrorMaterial::hash() const
+  {
+    size_t seed = 2;
+    hashCombine(&seed, reflectance());
+    return seed;
+  }
+
+  bool MirrorMaterial::isEqual(const IMaterial& other) const
+  {
+    const MirrorMaterial *mirror = dynamic_cast<const MirrorMaterial*>(&other);
+    return mirror != nullptr  &&  reflectance() == mirror->reflectance();
+  }
+
   void MirrorMaterial::setReflectance(const real_t r)
   {
     bsdf()->asBxDF<MirrorBRDF>(0)->setReflectance(r);
@@ -31,6 +31,7 @@
 
 #include "rt/Material/OpaqueMaterial.h"
 
+#include "rt/Base/Registry.h"
 #include "rt/BxDF/LambertianBRDF.h"
 #include "rt/BxDF/PhongBRDF.h"
 
@@ -58,16 +59,30 @@ namespace rt {
   {
     MaterialPtr result = create();
     OpaqueMaterial *opaque = OPAQUE(result);
-    if( _diffTex ) {
-      opaque->setDiffuse(_diffTex->copy());
-    }
+    opaque->setDiffuse(_diffTex);
     opaque->setShininess(shininess());
-    if( _specTex ) {
-      opaque->setSpecular(_specTex->copy());
-    }
+    opaque->setSpecular(_specTex);
     return result;
   }
 
+  size_t OpaqueMaterial::hash() const
+  {
+    size_t seed = 3;
+    hashCombine(&seed, _diffTex ? _diffTex->hash() : 0);
+    hashCombine(&seed, shininess());
+    hashCombine(&seed, _specTex ? _specTex->hash() : 0);
+    return seed;
+  }
+
+  bool OpaqueMaterial::isEqual(const IMaterial& other) const
+  {
+    const OpaqueMaterial *opaque = dynamic_cast<const OpaqueMaterial*>(&other);
+    return opaque != nullptr  &&
+        isSameTexture(_diffTex, opaque->_diffTex)  &&
+        shininess() == opaque->shininess()  &&
+        isSameTexture(_specTex, opaque->_specTex);
+  }
+
   bool OpaqueMaterial::haveTexture(const size_t i) const
   {
     return (i == DIFF  &&  _diffTex)  ||  (i == SPEC  &&  _specTex);
@@ -88,6 +103,11 @@ namespace rt {
     return bsdf()->asBxDF<PhongBRDF>(SPEC)->shininess() >= ONE  &&  _specTex;
   }
 
+  const ITexture *OpaqueMaterial::diffuse() const
+  {
+    return _diffTex.get();
+  }
+
   void OpaqueMaterial::setDiffuse(TexturePtr& tex)
   {
     _diffTex = std::move(tex);
@@ -98,6 +118,11 @@ namespace rt {
     _diffTex = std::move(tex);
   }
 
+  void OpaqueMaterial::setDiffuse(const TextureRef& tex)
+  {
+    _diffTex = tex;
+  }
+
   void OpaqueMaterial::setShininess(const real_t spec)
   {
     bsdf()->asBxDF<PhongBRDF>(SPEC)->setShininess(spec);
@@ -108,6 +133,11 @@ namespace rt {
     return bsdf()->asBxDF<PhongBRDF>(SPEC)->shininess();
   }
 
+  const ITexture *OpaqueMaterial::specular() const
+  {
+    return _specTex.get();
+  }
+
   void OpaqueMaterial::setSpecular(TexturePtr& tex)
   {
     _specTex = std::move(tex);
@@ -118,6 +148,11 @@ namespace rt {
     _specTex = std::move(tex);
   }
 
+  void OpaqueMaterial::setSpecular(const TextureRef& tex)
+  {
+    _specTex = tex;
+  }
+
   MaterialPtr OpaqueMaterial::create()
   {
     return std::make_unique<OpaqueMaterial>();
@@ -31,6 +31,7 @@
 
 #include "rt/Material/TransparentMaterial.h"
 
+#include "rt/Base/Registry.h"
 #include "rt/BxDF/SpecularReflectionBRDF.h"
 #include "rt/BxDF/SpecularTransmissionBTDF.h"
 
@@ -62,6 +63,19 @@ namespace rt {
     return result;
   }
 
+  size_t TransparentMaterial::hash() const
+  {
+    size_t seed = 4;
+    hashCombine(&seed, refraction());
+    return seed;
+  }
+
+  bool TransparentMaterial::isEqual(const IMaterial& other) const
+  {
+    const TransparentMaterial *transparent = dynamic_cast<const TransparentMaterial*>(&other);
+    return transparent != nullptr  &&  refraction() == transparent->refraction();
+  }
+
   bool TransparentMaterial::isShadowCaster() const
   {
     return false;
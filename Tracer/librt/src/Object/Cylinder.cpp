@@ -85,11 +85,27 @@ namespace rt {
     return true;
   }
 
+  real_t Cylinder::height() const
+  {
+    return _height;
+  }
+
+  real_t Cylinder::radius() const
+  {
+    return _radius;
+  }
+
   real_t Cylinder::area() const
   {
     return TWO_PI*_radius*_height;
   }
 
+  Bounds Cylinder::objectBounds() const
+  {
+    const real_t hz = _height/TWO;
+    return Bounds(Vertex{-_radius, -_radius, -hz}, Vertex{_radius, _radius, hz});
+  }
+
   SurfaceInfo Cylinder::sample(const Sample2D& xi, real_t *pdf) const
   {
     SAMPLES_2D(xi);
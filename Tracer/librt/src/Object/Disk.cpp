@@ -90,11 +90,21 @@ namespace rt {
     return true;
   }
 
+  real_t Disk::radius() const
+  {
+    return _radius;
+  }
+
   real_t Disk::area() const
   {
     return PI*_radius*_radius;
   }
 
+  Bounds Disk::objectBounds() const
+  {
+    return Bounds(Vertex{-_radius, -_radius, 0}, Vertex{_radius, _radius, 0});
+  }
+
   SurfaceInfo Disk::sample(const Sample2D& xi, real_t *pdf) const
   {
     const Vertex Pdisk = ConcentricDisk::sample(xi);
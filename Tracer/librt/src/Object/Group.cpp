@@ -50,16 +50,41 @@ namespace rt {
   void Group::add(ObjectPtr& object)
   {
     if( object ) {
+      _locals.push_back(object->objectToWorld());
+      _objects.push_back(std::move(object));
+      _objects.back()->setObjectToWorld(objectToWorld()*_locals.back());
+    }
+  }
+
+  void Group::addInWorld(ObjectPtr& object)
+  {
+    if( object ) {
+      _locals.push_back(objectToWorld().inverse()*object->objectToWorld());
       _objects.push_back(std::move(object));
-      _objects.back()->moveObject(objectToWorld());
     }
   }
 
   void Group::clear()
   {
+    _locals.clear();
     _objects.clear();
   }
 
+  const Objects& Group::objects() const
+  {
+    return _objects;
+  }
+
+  void Group::setObjectToWorld(const Transform& objectToWorld)
+  {
+    IObject::setObjectToWorld(objectToWorld);
+
+    auto local = _locals.begin();
+    for(ObjectPtr& o : _objects) {
+      o->setObjectToWorld(objectToWorld*(*local++));
+    }
+  }
+
   bool Group::castShadow(const Ray &ray) const
   {
     for(const ObjectPtr& o : _objects) {
@@ -106,11 +131,38 @@ namespace rt {
     return 0;
   }
 
+  Bounds Group::objectBounds() const
+  {
+    return Bounds();
+  }
+
   SurfaceInfo Group::sample(const Sample2D &/*xi*/, real_t * /*pdf*/) const
   {
     return SurfaceInfo();
   }
 
+  Bounds Group::worldBounds() const
+  {
+    Bounds result;
+    for(const ObjectPtr& o : _objects) {
+      const Bounds b = o->worldBounds();
+      if( b.isValid() ) {
+        result.update(b.min());
+        result.update(b.max());
+      }
+    }
+    return result;
+  }
+
+  size_t Group::memory() const
+  {
+    size_t numBytes = sizeof(Group);
+    for(const ObjectPtr& o : _objects) {
+      numBytes += o->memory();
+    }
+    return numBytes;
+  }
+
   ObjectPtr Group::create(const Transform& objectToWorld)
   {
     return std::make_unique<Group>(objectToWorld);
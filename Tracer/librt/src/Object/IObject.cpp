@@ -69,11 +69,6 @@ namespace rt {
     _areaLight = light;
   }
 
-  IMaterial *IObject::material()
-  {
-    return _material.get();
-  }
-
   const IMaterial *IObject::material() const
   {
     return _material.get();
@@ -89,10 +84,14 @@ namespace rt {
     _material = std::move(material);
   }
 
+  void IObject::setMaterial(const MaterialRef& material)
+  {
+    _material = material;
+  }
+
   void IObject::moveObject(const Transform& objectToWorld)
   {
-    _xfrmWO = objectToWorld*_xfrmWO;
-    _xfrmOW = _xfrmWO.inverse();
+    setObjectToWorld(objectToWorld*_xfrmWO);
   }
 
   const Transform& IObject::objectToWorld() const
@@ -102,8 +101,18 @@ namespace rt {
 
   void IObject::setObjectToWorld(const Transform& objectToWorld)
   {
-    _xfrmWO = Transform();
-    moveObject(objectToWorld);
+    _xfrmWO = objectToWorld;
+    _xfrmOW = _xfrmWO.inverse();
+  }
+
+  Bounds IObject::worldBounds() const
+  {
+    return toWorld(objectBounds());
+  }
+
+  size_t IObject::memory() const
+  {
+    return sizeof(IObject);
   }
 
   real_t IObject::pdf(const SurfaceInfo& /*surface*/) const
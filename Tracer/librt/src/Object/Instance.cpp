@@ -0,0 +1,115 @@
+/****************************************************************************
+** Copyright (c) 2021, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#include "rt/Object/Instance.h"
+
+#include "rt/Object/SurfaceInfo.h"
+
+namespace rt {
+
+  ////// public //////////////////////////////////////////////////////////////
+
+  Instance::Instance(const Transform& objectToWorld,
+                     const PrototypePtr& prototype) noexcept
+    : IObject(objectToWorld)
+    , _prototype{prototype}
+  {
+  }
+
+  Instance::~Instance() noexcept
+  {
+  }
+
+  const Instance::PrototypePtr& Instance::prototype() const
+  {
+    return _prototype;
+  }
+
+  bool Instance::castShadow(const Ray& ray) const
+  {
+    return _prototype->castShadow(toObject(ray));
+  }
+
+  bool Instance::intersect(SurfaceInfo *surface, const Ray& ray) const
+  {
+    if( !ray.isValid() ) {
+      return false;
+    }
+
+    // NOTE: Transforms are rigid, hence 't' is the same in both coordinate systems.
+    if( !_prototype->intersect(surface, toObject(ray)) ) {
+      return false;
+    }
+
+    if( surface != nullptr ) {
+      surface->N = toWorld(surface->N);
+      surface->P = toWorld(surface->P);
+
+      surface->initializeShading(ray);
+    }
+
+    return true;
+  }
+
+  real_t Instance::area() const
+  {
+    return _prototype->area();
+  }
+
+  Bounds Instance::objectBounds() const
+  {
+    return _prototype->worldBounds();
+  }
+
+  size_t Instance::memory() const
+  {
+    return sizeof(Instance);
+  }
+
+  SurfaceInfo Instance::sample(const Sample2D& xi, real_t *pdf) const
+  {
+    SurfaceInfo surface = _prototype->sample(xi, pdf);
+    surface.N = toWorld(surface.N);
+    surface.P = toWorld(surface.P);
+
+    return surface;
+  }
+
+  ObjectPtr Instance::create(const Transform& objectToWorld,
+                             const PrototypePtr& prototype)
+  {
+    if( !prototype ) {
+      return ObjectPtr();
+    }
+    return std::make_unique<Instance>(objectToWorld, prototype);
+  }
+
+} // namespace rt
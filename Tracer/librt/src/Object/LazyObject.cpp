@@ -0,0 +1,221 @@
+/****************************************************************************
+** Copyright (c) 2021, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#include "rt/Object/LazyObject.h"
+
+#include "rt/Object/SurfaceInfo.h"
+
+namespace rt {
+
+  ////// public //////////////////////////////////////////////////////////////
+
+  LazyObject::LazyObject(const Bounds& bounds, const Loader& loader,
+                         const GeometryCachePtr& cache) noexcept
+    : IObject(Transform())
+    , _bounds{bounds}
+    , _cache{cache}
+    , _loader{loader}
+    , _worldBounds{bounds}
+  {
+    _cache->attach(this);
+  }
+
+  LazyObject::~LazyObject() noexcept
+  {
+    _cache->detach(this);
+  }
+
+  bool LazyObject::isResident() const
+  {
+    return _resident.load() != nullptr;
+  }
+
+  void LazyObject::setLoader(const Loader& loader)
+  {
+    if( !loader ) {
+      return;
+    }
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    _loader = loader;
+    _is_failed.store(false);
+  }
+
+  void LazyObject::setObjectToWorld(const Transform& objectToWorld)
+  {
+    IObject::setObjectToWorld(objectToWorld);
+    _worldBounds = toWorld(_bounds);
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    _is_moved = true;
+    if( _geometry ) {
+      _geometry->setObjectToWorld(objectToWorld*_geometryToObject);
+    }
+  }
+
+  bool LazyObject::castShadow(const Ray& ray) const
+  {
+    if( !ray.isValid()  ||  !_worldBounds.intersect(ray, true) ) {
+      return false;
+    }
+    const IObject *geometry = acquire();
+    return geometry != nullptr  &&  geometry->castShadow(ray);
+  }
+
+  bool LazyObject::intersect(SurfaceInfo *surface, const Ray& ray) const
+  {
+    if( !ray.isValid()  ||  !_worldBounds.intersect(ray, true) ) {
+      return false;
+    }
+    const IObject *geometry = acquire();
+    return geometry != nullptr  &&  geometry->intersect(surface, ray);
+  }
+
+  real_t LazyObject::area() const
+  {
+    const IObject *geometry = acquire();
+    return geometry != nullptr
+        ? geometry->area()
+        : 0;
+  }
+
+  Bounds LazyObject::objectBounds() const
+  {
+    return _bounds;
+  }
+
+  SurfaceInfo LazyObject::sample(const Sample2D& xi, real_t *pdf) const
+  {
+    const IObject *geometry = acquire();
+    return geometry != nullptr
+        ? geometry->sample(xi, pdf)
+        : SurfaceInfo();
+  }
+
+  Bounds LazyObject::worldBounds() const
+  {
+    return _worldBounds;
+  }
+
+  ObjectPtr LazyObject::create(const Bounds& bounds, const Loader& loader,
+                               const GeometryCachePtr& cache)
+  {
+    if( !bounds.isValid()  ||  !loader  ||  !cache ) {
+      return ObjectPtr();
+    }
+    return std::make_unique<LazyObject>(bounds, loader, cache);
+  }
+
+  ////// private /////////////////////////////////////////////////////////////
+
+  const IObject *LazyObject::acquire() const
+  {
+    // NOTE: Mark this object as used BEFORE looking up its geometry; cf. unload().
+    if( const uint64_t block = _cache->block(); block > 0 ) {
+      // NOTE: Blocks end in any order; hence only the latest block is kept.
+      uint64_t used = _block.load();
+      while( used < block  &&  !_block.compare_exchange_weak(used, block) ) {
+      }
+    } else {
+      const uint64_t frame = _cache->frame();
+      if( _frame.load() != frame ) {
+        _frame.store(frame);
+      }
+    }
+
+    if( const IObject *geometry = _resident.load(); geometry != nullptr ) {
+      return geometry;
+    }
+
+    if( _is_failed.load() ) {
+      return nullptr;
+    }
+
+    const IObject *geometry = nullptr;
+    size_t numBytes = 0;
+    {
+      std::lock_guard<std::mutex> lock(_mutex);
+
+      geometry = _resident.load();
+      if( geometry == nullptr ) {
+        _geometry = _loader();
+        if( !_geometry ) {
+          _is_failed.store(true);
+          return nullptr;
+        }
+
+        _geometryToObject = _geometry->objectToWorld();
+        if( _is_moved ) {
+          _geometry->setObjectToWorld(objectToWorld()*_geometryToObject);
+        }
+
+        geometry = _geometry.get();
+        numBytes = geometry->memory();
+        _resident.store(geometry);
+      }
+    }
+
+    // NOTE: Inserting may unload other objects, hence this object's lock is released.
+    if( numBytes > 0 ) {
+      _cache->insert(this, numBytes);
+    }
+
+    return geometry;
+  }
+
+  // NOTE: 'block' is the oldest block in flight; cf. GeometryCache::evict().
+  bool LazyObject::isPinned(const uint64_t frame, const uint64_t block) const
+  {
+    return _frame.load() >= frame  ||  _block.load() >= block;
+  }
+
+  bool LazyObject::unload(const uint64_t frame, const uint64_t block) const
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    /*
+     * NOTE:
+     * acquire() stores the block or frame before it reads '_resident', whereas the
+     * geometry is hidden before these are read here. Either acquire() does not see
+     * the geometry, or the geometry is found to be in use & is restored.
+     */
+    _resident.store(nullptr);
+    if( isPinned(frame, block) ) {
+      _resident.store(_geometry.get());
+      return false;
+    }
+
+    _geometry.reset();
+
+    return true;
+  }
+
+} // namespace rt
@@ -103,11 +103,28 @@ namespace rt {
     return true;
   }
 
+  real_t Plane::height() const
+  {
+    return _height;
+  }
+
+  real_t Plane::width() const
+  {
+    return _width;
+  }
+
   real_t Plane::area() const
   {
     return _width*_height;
   }
 
+  Bounds Plane::objectBounds() const
+  {
+    const real_t hx = _width /TWO;
+    const real_t hy = _height/TWO;
+    return Bounds(Vertex{-hx, -hy, 0}, Vertex{hx, hy, 0});
+  }
+
   SurfaceInfo Plane::sample(const Sample2D& xi, real_t *pdf) const
   {
     SAMPLES_2D(xi);
@@ -88,11 +88,21 @@ namespace rt {
     return true;
   }
 
+  real_t Sphere::radius() const
+  {
+    return _radius;
+  }
+
   real_t Sphere::area() const
   {
     return FOUR_PI*_radius*_radius;
   }
 
+  Bounds Sphere::objectBounds() const
+  {
+    return Bounds(Vertex(-_radius), Vertex(_radius));
+  }
+
   SurfaceInfo Sphere::sample(const Sample2D& xi, real_t *pdf) const
   {
     const Vertex Psphere = geom::to_vertex(UniformSphere::sample(xi));
@@ -34,6 +34,7 @@
 #include "rt/Material/BSDF.h"
 #include "rt/Object/IObject.h"
 #include "rt/Object/SurfaceInfo.h"
+#include "rt/Scene/Scene.h"
 
 namespace rt {
 
@@ -50,6 +51,23 @@ namespace rt {
 
   ////// protected ///////////////////////////////////////////////////////////
 
+  Color BaseRenderer::primaryRadiance(Ray *ray, const size_t x, const size_t y, const size_t s,
+                                      const ScenePtr& scene, const CameraPtr& camera,
+                                      const SamplerPtr& sampler) const
+  {
+    SurfaceInfo ref;
+    SCENE(scene)->intersectPrimary(&ref, ray, x, y, s, view(), camera, sampler);
+    return shade(*ray, ref, scene, sampler, 0);
+  }
+
+  Color BaseRenderer::radiance(const Ray& ray, const ScenePtr& scene, const SamplerPtr& sampler,
+                               const uint_t depth, const Color& /*throughput*/) const
+  {
+    SurfaceInfo ref;
+    SCENE(scene)->intersect(&ref, ray);
+    return shade(ray, ref, scene, sampler, depth);
+  }
+
   Color BaseRenderer::specularReflectOrTransmit(const SurfaceInfo& ref, const ScenePtr& scene,
                                                 const SamplerPtr& sampler, const uint_t depth,
                                                 const bool is_transmit) const
@@ -67,7 +85,7 @@ namespace rt {
       return Color();
     }
 
-    const Color Li = radiance(ref.ray(wi), scene, sampler, depth + 1);
+    const Color Li = radiance(ref.ray(wi), scene, sampler, depth + 1, Color(1));
     return f*Li*absCosTi/pdf;
   }
 
@@ -0,0 +1,957 @@
+/****************************************************************************
+** Copyright (c) 2021, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#include <vector>
+
+#include "rt/Renderer/BidirectionalRenderer.h"
+
+#include "geom/Shading.h"
+#include "rt/Light/IAreaLight.h"
+#include "rt/Object/IObject.h"
+#include "rt/Object/SurfaceInfo.h"
+#include "rt/Renderer/RenderLoop.h"
+#include "rt/Renderer/RenderUtils.h"
+#include "rt/Sampler/Sampling.h"
+#include "rt/Scene/Scene.h"
+
+namespace rt {
+
+  namespace priv {
+
+    ////// Types /////////////////////////////////////////////////////////////
+
+    struct PathVertex {
+      enum Type : uint_t {
+        Camera = 0,
+        Light,
+        Surface
+      };
+
+      PathVertex() noexcept = default;
+
+      inline bool isOnSurface() const
+      {
+        return !N.isZero();
+      }
+
+      inline const ILight *emitter() const
+      {
+        if(        type == Light ) {
+          return light;
+        } else if( type == Surface  &&  surface.object != nullptr ) {
+          return surface->areaLight();
+        }
+        return nullptr;
+      }
+
+      inline bool isLight() const
+      {
+        return emitter() != nullptr;
+      }
+
+      inline bool isDeltaLight() const
+      {
+        return type == Light  &&  light->isDeltaLight();
+      }
+
+      bool isConnectible() const
+      {
+        if(        type == Light ) {
+          return light->type() != ILight::DeltaDirection;
+        } else if( type == Surface ) {
+          const IBxDF::Flags flags = IBxDF::Flags(IBxDF::AllFlags & ~IBxDF::Specular);
+          return surface->material()->bsdf()->count(flags) > 0;
+        }
+        return true;
+      }
+
+      Type          type{Surface};
+      Color         beta{};
+      bool          is_delta{false};
+      real_t        pdfFwd{0};
+      real_t        pdfRev{0};
+      Vertex        P{};
+      Normal        N{};      // NOTE: Zero if not on a surface (e.g. camera, point light)!
+      SurfaceInfo   surface{};
+      const ILight *light{nullptr};
+    };
+
+    struct CameraInfo {
+      const ICamera *camera{nullptr};
+      Transform      xfrmCW{}; // World -> Camera
+      Transform      xfrmWC{}; // Camera -> World
+      real_t         filmArea{0};
+      real_t         lensArea{1};
+      real_t         lensRadius{0};
+      real_t         zScreen{0};
+    };
+
+    struct Context {
+      const Scene   *scene{nullptr};
+      const ISampler *sampler{nullptr};
+      CameraInfo     camera{};
+      real_t         lightPdf{0};
+      size_t         numLights{0};
+    };
+
+    template<typename T>
+    class ScopedAssignment {
+    public:
+      ScopedAssignment(T *target, const T& value) noexcept
+        : _target{target}
+      {
+        if( _target != nullptr ) {
+          _backup  = *_target;
+          *_target = value;
+        }
+      }
+
+      ~ScopedAssignment() noexcept
+      {
+        if( _target != nullptr ) {
+          *_target = _backup;
+        }
+      }
+
+    private:
+      ScopedAssignment() noexcept = delete;
+
+      ScopedAssignment(const ScopedAssignment&) noexcept = delete;
+      ScopedAssignment& operator=(const ScopedAssignment&) noexcept = delete;
+
+      T *_target{nullptr};
+      T  _backup{};
+    };
+
+    ////// Camera ////////////////////////////////////////////////////////////
+
+    /*
+     * Cf. to PBR3 Chapter "16.1.1 Sampling Cameras"; directions are in WORLD
+     * coordinates and are leaving the lens.
+     */
+
+    real_t cosCamera(const Context& ctx, const Vertex& pLensW, const Direction& w,
+                     real_t *x = nullptr, real_t *y = nullptr)
+    {
+      const Vertex    pLens = ctx.camera.xfrmCW*pLensW;
+      const Direction   dir = ctx.camera.xfrmCW*w;
+      const real_t cosTheta = -dir.z; // NOTE: The camera is looking down the negative z-axis!
+
+      real_t rx{0}, ry{0};
+      if( cosTheta <= ZERO  ||  !ctx.camera.camera->raster(&rx, &ry, pLens, dir) ) {
+        return 0;
+      }
+
+      if( x != nullptr ) {
+        *x = rx;
+      }
+      if( y != nullptr ) {
+        *y = ry;
+      }
+
+      return cosTheta;
+    }
+
+    real_t importance(const Context& ctx, const real_t cosTheta)
+    {
+      const real_t cos2Theta = cosTheta*cosTheta;
+      return ONE/(ctx.camera.filmArea*ctx.camera.lensArea*cos2Theta*cos2Theta);
+    }
+
+    real_t pdfCamera(const Context& ctx, const Vertex& pLensW, const Direction& w)
+    {
+      const real_t cosTheta = cosCamera(ctx, pLensW, w);
+      if( cosTheta <= ZERO ) {
+        return 0;
+      }
+      return ONE/(ctx.camera.filmArea*cosTheta*cosTheta*cosTheta);
+    }
+
+    ////// Path Vertex ///////////////////////////////////////////////////////
+
+    /*
+     * Cf. to PBR3 Chapter "16.3.1 Vertex Abstraction Layer".
+     */
+
+    real_t convertDensity(const PathVertex& from, const real_t pdfDir, const PathVertex& to)
+    {
+      const Vertex  delta = to.P - from.P;
+      const real_t     rr = n4::dot(delta, delta); // Squared Distance
+      if( rr == ZERO ) {
+        return 0;
+      }
+      real_t pdf = pdfDir/rr;
+      if( to.isOnSurface() ) {
+        pdf *= geom::absDot(to.N, geom::to_direction(delta)/Math::sqrt(rr));
+      }
+      return pdf;
+    }
+
+    real_t pdfBSDF(const SurfaceInfo& surface, const Direction& wo, const Direction& wi)
+    {
+      SurfaceInfo swapped = surface;
+      swapped.wo  = wo;
+      swapped.woS = swapped.toShading(wo);
+      return swapped->material()->bsdf()->pdf(swapped, wi);
+    }
+
+    real_t pdfLight(const PathVertex& v, const PathVertex& next)
+    {
+      const Vertex delta = next.P - v.P;
+      const real_t    rr = n4::dot(delta, delta);
+      if( rr == ZERO ) {
+        return 0;
+      }
+      const Direction w = geom::to_direction(delta)/Math::sqrt(rr);
+
+      real_t pdfPos{0}, pdfDir{0};
+      v.emitter()->pdfLe(Ray(v.P, w), v.N, &pdfPos, &pdfDir);
+
+      real_t pdf = pdfDir/rr;
+      if( next.isOnSurface() ) {
+        pdf *= geom::absDot(next.N, w);
+      }
+      return pdf;
+    }
+
+    real_t pdfLightOrigin(const Context& ctx, const PathVertex& v, const PathVertex& next)
+    {
+      const Direction w = geom::to_direction(n4::direction(v.P, next.P));
+
+      real_t pdfPos{0}, pdfDir{0};
+      v.emitter()->pdfLe(Ray(v.P, w), v.N, &pdfPos, &pdfDir);
+
+      return pdfPos*ctx.lightPdf;
+    }
+
+    real_t pdf(const Context& ctx, const PathVertex& v,
+               const PathVertex *prev, const PathVertex& next)
+    {
+      if( v.type == PathVertex::Light ) {
+        return pdfLight(v, next);
+      }
+
+      const Vertex deltaNext = next.P - v.P;
+      if( n4::dot(deltaNext, deltaNext) == ZERO ) {
+        return 0;
+      }
+      const Direction wn = geom::to_direction(n4::direction(v.P, next.P));
+
+      real_t pdfDir = 0;
+      if( v.type == PathVertex::Camera ) {
+        pdfDir = pdfCamera(ctx, v.P, wn);
+      } else if( prev != nullptr ) {
+        const Vertex deltaPrev = prev->P - v.P;
+        if( n4::dot(deltaPrev, deltaPrev) == ZERO ) {
+          return 0;
+        }
+        const Direction wp = geom::to_direction(n4::direction(v.P, prev->P));
+        pdfDir = pdfBSDF(v.surface, wp, wn);
+      }
+
+      return convertDensity(v, pdfDir, next);
+    }
+
+    Color f(const PathVertex& v, const PathVertex& next)
+    {
+      if( v.type != PathVertex::Surface ) {
+        return Color();
+      }
+      const Direction wi = geom::to_direction(n4::direction(v.P, next.P));
+      return v.surface->material()->bsdf()->eval(v.surface, wi);
+    }
+
+    Color Le(const PathVertex& v, const PathVertex& prev)
+    {
+      if( v.type != PathVertex::Surface  ||  !v.isLight() ) {
+        return Color();
+      }
+      const Direction w = geom::to_direction(n4::direction(v.P, prev.P));
+      return v.surface.Le(w);
+    }
+
+    bool isVisible(const Context& ctx, const PathVertex& from, const PathVertex& to)
+    {
+      // NOTE: Cf. SurfaceInfo::ray(const SurfaceInfo&)!
+      const Direction delta = geom::to_direction(to.P - from.P);
+      const real_t     tMax = n4::length(delta) - SHADOW_BIAS;
+      return !ctx.scene->intersect(Ray(from.P, delta, tMax));
+    }
+
+    real_t G(const Context& ctx, const PathVertex& v0, const PathVertex& v1)
+    {
+      const Vertex delta = v0.P - v1.P;
+      const real_t    rr = n4::dot(delta, delta);
+      if( rr == ZERO ) {
+        return 0;
+      }
+      const Direction w = geom::to_direction(delta)/Math::sqrt(rr);
+
+      real_t g = ONE/rr;
+      if( v0.isOnSurface() ) {
+        g *= geom::absDot(v0.N, w);
+      }
+      if( v1.isOnSurface() ) {
+        g *= geom::absDot(v1.N, w);
+      }
+
+      return g > ZERO  &&  isVisible(ctx, v0, v1)
+          ? g
+          : 0;
+    }
+
+    ////// Subpaths //////////////////////////////////////////////////////////
+
+    size_t randomWalk(const Context& ctx, Ray ray, Color beta, const real_t pdfDir,
+                      const size_t maxDepth, const bool is_radiance,
+                      PathVertex *path, Color *Lbackground)
+    {
+      if( maxDepth == 0 ) {
+        return 0;
+      }
+
+      size_t bounces = 0;
+      real_t  pdfFwd = pdfDir;
+      real_t  pdfRev = 0;
+      for(;;) {
+        SurfaceInfo surface;
+        const bool is_intersect = ctx.scene->intersect(&surface, ray);
+
+        if( beta.isZero() ) {
+          break;
+        }
+
+        PathVertex& vertex = path[bounces];
+        PathVertex&   prev = path[bounces - 1];
+
+        // (1) Account for Escaped Camera Rays ///////////////////////////////
+
+        /*
+         * NOTE:
+         * Infinite lights are otherwise accounted for by connecting to a sampled
+         * light (s = 1); only primary rays & specular bounces add their radiance.
+         */
+        if( !is_intersect ) {
+          if( is_radiance  &&  Lbackground != nullptr ) {
+            *Lbackground += bounces == 0  ||  prev.is_delta
+                ? beta*ctx.scene->Le(ray)
+                : beta*ctx.scene->backgroundColor();
+          }
+          break;
+        }
+
+        // (2) Store Surface Vertex //////////////////////////////////////////
+
+        vertex = PathVertex();
+        vertex.type    = PathVertex::Surface;
+        vertex.beta    = beta;
+        vertex.P       = surface.P;
+        vertex.N       = surface.N;
+        vertex.surface = surface;
+        vertex.pdfFwd  = convertDensity(prev, pdfFwd, vertex);
+
+        if( ++bounces >= maxDepth ) {
+          break;
+        }
+
+        // (3) Sample BSDF for New Direction /////////////////////////////////
+
+        const BSDF *bsdf = surface->material()->bsdf();
+
+        IBxDF::Flags sampled_flags{IBxDF::InvalidFlags};
+        Direction               wi;
+        const Color         f = bsdf->sample(surface, &wi, ctx.sampler->sample2D(), &pdfFwd,
+                                             IBxDF::AllFlags, &sampled_flags);
+        const real_t absCosTi = geom::absDot(wi, surface.N);
+        if( pdfFwd <= ZERO  ||  absCosTi == ZERO  ||  f.isZero() ) {
+          break;
+        }
+
+        beta *= f*absCosTi/pdfFwd;
+        pdfRev = pdfBSDF(surface, wi, surface.wo);
+        if( isSpecular(sampled_flags) ) {
+          vertex.is_delta = true;
+          pdfRev = pdfFwd = 0;
+        }
+        if( !is_radiance ) {
+          beta *= adjointScale(surface, sampled_flags);
+        }
+
+        ray = surface.ray(wi);
+
+        // (4) Compute Reverse Area Density of Previous Vertex ///////////////
+
+        prev.pdfRev = convertDensity(vertex, pdfRev, prev);
+      }
+
+      return bounces;
+    }
+
+    size_t cameraSubpath(const Context& ctx, const Ray& rayC, const size_t maxDepth,
+                         PathVertex *path, Color *Lbackground)
+    {
+      if( maxDepth == 0 ) {
+        return 0;
+      }
+
+      // NOTE: The camera's ray originates from the screen; trace it back to the lens!
+      const Vertex  orgC = rayC.origin();
+      const Vertex pLens = orgC - geom::to_vertex(rayC.direction()*(orgC.z/rayC.direction().z));
+
+      const Ray ray = ctx.camera.xfrmWC*rayC;
+
+      PathVertex& camera = path[0];
+      camera = PathVertex();
+      camera.type = PathVertex::Camera;
+      camera.beta = Color(1);
+      camera.P    = ctx.camera.xfrmWC*pLens;
+
+      const real_t pdfDir = pdfCamera(ctx, camera.P, ray.direction());
+
+      return randomWalk(ctx, ray, camera.beta, pdfDir, maxDepth - 1, true,
+                        path + 1, Lbackground) + 1;
+    }
+
+    const ILight *chooseLight(const Context& ctx)
+    {
+      if( ctx.numLights < 1 ) {
+        return nullptr;
+      }
+      const Lights& lights = ctx.scene->lights();
+      const size_t  choice = sampling::choose(ctx.sampler->sample(), ctx.numLights);
+      return std::next(lights.cbegin(), choice)->get();
+    }
+
+    size_t lightSubpath(const Context& ctx, const size_t maxDepth, PathVertex *path)
+    {
+      if( maxDepth == 0 ) {
+        return 0;
+      }
+
+      // (1) Sample Light Ray ////////////////////////////////////////////////
+
+      const ILight *light = chooseLight(ctx);
+      if( light == nullptr ) {
+        return 0;
+      }
+
+      const Sample2D xiPos = ctx.sampler->sample2D();
+      const Sample2D xiDir = ctx.sampler->sample2D();
+
+      Ray        ray;
+      Normal       N;
+      real_t  pdfPos{0}, pdfDir{0};
+      const Color Le = light->sampleLe(xiPos, xiDir, &ray, &N, &pdfPos, &pdfDir);
+      if( pdfPos <= ZERO  ||  pdfDir <= ZERO  ||  Le.isZero() ) {
+        return 0;
+      }
+
+      // (2) Store Light Vertex //////////////////////////////////////////////
+
+      PathVertex& vertex = path[0];
+      vertex = PathVertex();
+      vertex.type   = PathVertex::Light;
+      vertex.beta   = Le;
+      vertex.P      = ray.origin();
+      vertex.N      = N;
+      vertex.light  = light;
+      vertex.pdfFwd = pdfPos*ctx.lightPdf;
+
+      const real_t absCosTo = N.isZero()
+          ? ONE
+          : geom::absDot(N, ray.direction());
+      const Color beta = Le*absCosTo/(ctx.lightPdf*pdfPos*pdfDir);
+
+      return randomWalk(ctx, ray, beta, pdfDir, maxDepth - 1, false,
+                        path + 1, nullptr) + 1;
+    }
+
+    ////// Connecting Subpaths ///////////////////////////////////////////////
+
+    /*
+     * Cf. to PBR3 Chapter "16.3.4 Multiple Importance Sampling".
+     */
+    real_t misWeight(const Context& ctx, PathVertex *lightVertices, PathVertex *cameraVertices,
+                     const PathVertex& sampled, const size_t s, const size_t t)
+    {
+      if( s + t == 2 ) {
+        return 1;
+      }
+
+      const auto remap0 = [](const real_t x) -> real_t {
+        return x != ZERO
+            ? x
+            : 1;
+      };
+
+      PathVertex      *qs = s > 0 ? &lightVertices[s - 1]  : nullptr;
+      PathVertex      *pt = t > 0 ? &cameraVertices[t - 1] : nullptr;
+      PathVertex *qsMinus = s > 1 ? &lightVertices[s - 2]  : nullptr;
+      PathVertex *ptMinus = t > 1 ? &cameraVertices[t - 2] : nullptr;
+
+      // (1) Temporarily Update Vertices of Connection ///////////////////////
+
+      const ScopedAssignment<PathVertex> a1(s == 1
+                                            ? qs
+                                            : t == 1
+                                              ? pt
+                                              : nullptr, sampled);
+
+      const ScopedAssignment<bool> a2(pt != nullptr ? &pt->is_delta : nullptr, false);
+      const ScopedAssignment<bool> a3(qs != nullptr ? &qs->is_delta : nullptr, false);
+
+      const ScopedAssignment<real_t> a4(pt != nullptr ? &pt->pdfRev : nullptr,
+                                        pt == nullptr
+                                        ? 0
+                                        : s > 0
+                                          ? pdf(ctx, *qs, qsMinus, *pt)
+                                          : pdfLightOrigin(ctx, *pt, *ptMinus));
+      const ScopedAssignment<real_t> a5(ptMinus != nullptr ? &ptMinus->pdfRev : nullptr,
+                                        ptMinus == nullptr
+                                        ? 0
+                                        : s > 0
+                                          ? pdf(ctx, *pt, qs, *ptMinus)
+                                          : pdfLight(*pt, *ptMinus));
+
+      const ScopedAssignment<real_t> a6(qs != nullptr ? &qs->pdfRev : nullptr,
+                                        qs == nullptr
+                                        ? 0
+                                        : pdf(ctx, *pt, ptMinus, *qs));
+      const ScopedAssignment<real_t> a7(qsMinus != nullptr ? &qsMinus->pdfRev : nullptr,
+                                        qsMinus == nullptr
+                                        ? 0
+                                        : pdf(ctx, *qs, pt, *qsMinus));
+
+      // (2) Consider Hypothetical Strategies Along the Camera Subpath ///////
+
+      real_t sumRi = 0;
+
+      real_t ri = 1;
+      for(size_t i = t - 1; i > 0; i--) {
+        ri *= remap0(cameraVertices[i].pdfRev)/remap0(cameraVertices[i].pdfFwd);
+        if( !cameraVertices[i].is_delta  &&  !cameraVertices[i - 1].is_delta ) {
+          sumRi += ri;
+        }
+      }
+
+      // (3) Consider Hypothetical Strategies Along the Light Subpath ////////
+
+      ri = 1;
+      for(size_t i = s; i > 0; i--) {
+        const PathVertex& v = lightVertices[i - 1];
+        ri *= remap0(v.pdfRev)/remap0(v.pdfFwd);
+        const bool is_delta_light = i > 1
+            ? lightVertices[i - 2].is_delta
+            : lightVertices[0].isDeltaLight();
+        if( !v.is_delta  &&  !is_delta_light ) {
+          sumRi += ri;
+        }
+      }
+
+      return ONE/(ONE + sumRi);
+    }
+
+    Color connect(const Context& ctx, PathVertex *lightVertices, PathVertex *cameraVertices,
+                  const size_t s, const size_t t, real_t *x, real_t *y)
+    {
+      Color      L;
+      PathVertex sampled;
+      real_t     weight = -1;
+
+      if( s == 0 ) {
+        // (1) Camera Subpath Hits an Area Light /////////////////////////////
+
+        const PathVertex& pt = cameraVertices[t - 1];
+        if( pt.isLight() ) {
+          L = Le(pt, cameraVertices[t - 2])*pt.beta;
+        }
+
+      } else if( t == 1 ) {
+        // (2) Connect Light Subpath to the Camera ///////////////////////////
+
+        const PathVertex& qs = lightVertices[s - 1];
+        if( !qs.isConnectible() ) {
+          return Color();
+        }
+
+        const Vertex pLensC = ctx.camera.lensRadius > ZERO
+            ? ctx.camera.lensRadius*ConcentricDisk::sample(ctx.sampler->sample2D())
+            : Vertex();
+
+        sampled = PathVertex();
+        sampled.type = PathVertex::Camera;
+        sampled.P    = ctx.camera.xfrmWC*pLensC;
+
+        const Vertex  delta = sampled.P - qs.P;
+        const real_t     rr = n4::dot(delta, delta);
+        if( rr == ZERO ) {
+          return Color();
+        }
+        const Direction  wi = geom::to_direction(delta)/Math::sqrt(rr);
+
+        const real_t cosTheta = cosCamera(ctx, sampled.P, -wi, x, y);
+        if( cosTheta <= ZERO ) {
+          return Color();
+        }
+
+        const real_t pdfW = rr/(cosTheta*ctx.camera.lensArea); // NOTE: Solid angle at 'qs'.
+        sampled.beta = Color(importance(ctx, cosTheta)/pdfW);
+
+        /*
+         * NOTE:
+         * Primary rays originate from the screen; hence, anything in between
+         * the lens and the screen is neither seen nor occluding!
+         */
+        const Vertex pC = ctx.camera.xfrmCW*qs.P;
+        if( pC.z >= ctx.camera.zScreen ) {
+          return Color();
+        }
+
+        const Direction dirC = geom::to_direction(pC - pLensC);
+        PathVertex screen;
+        screen.P = ctx.camera.xfrmWC*(pLensC + geom::to_vertex(dirC*((ctx.camera.zScreen - pLensC.z)/dirC.z)));
+
+        L = qs.beta*f(qs, sampled)*sampled.beta;
+        if( qs.isOnSurface() ) {
+          L *= geom::absDot(wi, qs.N);
+        }
+        if( !L.isZero()  &&  !isVisible(ctx, qs, screen) ) {
+          return Color();
+        }
+
+      } else if( s == 1 ) {
+        // (3) Connect Camera Subpath to a Sampled Light /////////////////////
+
+        const PathVertex& pt = cameraVertices[t - 1];
+        if( !pt.isConnectible() ) {
+          return Color();
+        }
+
+        const ILight *light = chooseLight(ctx);
+        if( light == nullptr ) {
+          return Color();
+        }
+
+        const Sample2D xiPos = ctx.sampler->sample2D();
+        const Sample2D xiDir = ctx.sampler->sample2D();
+
+        Ray        ray;
+        Normal       N;
+        real_t  pdfPos{0}, pdfDir{0};
+        const Color Le = light->sampleLe(xiPos, xiDir, &ray, &N, &pdfPos, &pdfDir);
+
+        if( pdfPos > ZERO ) {
+          /*
+           * NOTE:
+           * The light is sampled with respect to area to match pdfLightOrigin().
+           */
+          sampled = PathVertex();
+          sampled.type  = PathVertex::Light;
+          sampled.P     = ray.origin();
+          sampled.N     = N;
+          sampled.light = light;
+
+          // NOTE: An area light's radiance is evaluated towards 'pt'!
+          Color Lemit = Le;
+          if( light->type() == ILight::Area ) {
+            SurfaceInfo surface;
+            surface.P = sampled.P;
+            surface.N = sampled.N;
+            const Direction wo = geom::to_direction(n4::direction(sampled.P, pt.P));
+            Lemit = static_cast<const IAreaLight*>(light)->radiance(surface, wo);
+          }
+          sampled.beta   = Lemit/(pdfPos*ctx.lightPdf);
+          sampled.pdfFwd = pdfLightOrigin(ctx, sampled, pt);
+
+          L = pt.beta*f(pt, sampled)*sampled.beta;
+          if( !L.isZero() ) {
+            L *= G(ctx, pt, sampled);
+          }
+
+        } else {
+          /*
+           * NOTE:
+           * A light unable to emit rays (e.g. a directional light) can only
+           * contribute by means of this strategy; hence no MIS is applied!
+           */
+          real_t pdfLi{0};
+          Ray      vis{};
+          Direction wi{};
+          const Color Li = light->sampleLi(pt.surface, &wi, ctx.sampler->sample2D(),
+                                           &pdfLi, &vis);
+          if( pdfLi <= ZERO  ||  Li.isZero() ) {
+            return Color();
+          }
+
+          L = pt.beta*pt.surface->material()->bsdf()->eval(pt.surface, wi)*Li*
+              geom::absDot(wi, pt.N)/(pdfLi*ctx.lightPdf);
+          if( !L.isZero()  &&  ctx.scene->intersect(vis) ) {
+            return Color();
+          }
+          weight = 1;
+        }
+
+      } else {
+        // (4) Connect Light and Camera Subpaths /////////////////////////////
+
+        const PathVertex& qs = lightVertices[s - 1];
+        const PathVertex& pt = cameraVertices[t - 1];
+        if( !qs.isConnectible()  ||  !pt.isConnectible() ) {
+          return Color();
+        }
+
+        L = qs.beta*f(qs, pt)*f(pt, qs)*pt.beta;
+        if( !L.isZero() ) {
+          L *= G(ctx, qs, pt);
+        }
+      }
+
+      if( L.isZero() ) {
+        return Color();
+      }
+
+      if( weight < ZERO ) {
+        weight = misWeight(ctx, lightVertices, cameraVertices, sampled, s, t);
+      }
+
+      return L*weight;
+    }
+
+  } // namespace priv
+
+  ////// public //////////////////////////////////////////////////////////////
+
+  BidirectionalRenderer::BidirectionalRenderer(const RenderOptions& options) noexcept
+    : IRenderer(options)
+  {
+  }
+
+  BidirectionalRenderer::~BidirectionalRenderer() noexcept
+  {
+  }
+
+  // NOTE: The light tracing strategies splat onto the entire frame.
+  bool BidirectionalRenderer::isResumable() const
+  {
+    return false;
+  }
+
+  void BidirectionalRenderer::beginFrame(const ScenePtr& /*scene*/, const CameraPtr& camera,
+                                         const SamplerPtr& /*sampler*/)
+  {
+    _film.clear();
+    if( camera ) {
+      _film.resize(camera->width(), camera->height());
+    }
+    _numLightPaths.store(0, std::memory_order_relaxed);
+  }
+
+  bool BidirectionalRenderer::endFrame(Image *image, Film *film) const
+  {
+    if( _film.isEmpty() ) {
+      return false;
+    }
+
+    const real_t splatScale = BidirectionalRenderer::splatScale();
+
+    // NOTE: The caller's film lacks the splats; merge them now...
+    if( film != nullptr  &&  film->width() == _film.width()  &&  film->height() == _film.height() ) {
+      for(size_t y = 0; y < _film.height(); y++) {
+        for(size_t x = 0; x < _film.width(); x++) {
+          film->setPixel(x, y, _film.pixel(x, y) + splatScale*_film.splat(x, y));
+        }
+      }
+    }
+
+    *image = _film.develop(splatScale, options().gamma);
+    return !image->isEmpty();
+  }
+
+  Image BidirectionalRenderer::render(RenderBlock block, const ScenePtr& _scene,
+                                      const CameraPtr& camera, const SamplerPtr& sampler,
+                                      Film *film) const
+  {
+    const Scene *scene = SCENE(_scene);
+    if( scene == nullptr ) {
+      return Image();
+    }
+
+    Image image = createImage(block, camera);
+    if( image.isEmpty() ) {
+      return Image();
+    }
+
+    const size_t maxDepth = options().maxDepth;
+
+    // (1) Setup Context /////////////////////////////////////////////////////
+
+    priv::Context ctx;
+    ctx.scene   = scene;
+    ctx.sampler = sampler.get();
+
+    ctx.camera.camera     = camera.get();
+    ctx.camera.xfrmWC     = view();
+    ctx.camera.xfrmCW     = view().inverse();
+    ctx.camera.filmArea   = camera->filmArea();
+    ctx.camera.zScreen    = camera->zScreen();
+    ctx.camera.lensRadius = sampler->isRandom() // cf. FrustumCamera::ray()
+        ? camera->lensRadius()
+        : 0;
+    ctx.camera.lensArea   = ctx.camera.lensRadius > ZERO
+        ? PI*ctx.camera.lensRadius*ctx.camera.lensRadius
+        : 1;
+
+    ctx.numLights = scene->lights().size();
+    ctx.lightPdf  = ctx.numLights > 0
+        ? ONE/static_cast<real_t>(ctx.numLights)
+        : 0;
+
+    if( ctx.camera.filmArea <= ZERO ) {
+      return Image();
+    }
+
+    const bool have_film = _film.width() == camera->width()  &&  _film.height() == camera->height();
+    const bool have_aovs = film != nullptr  &&  film->haveAOVs()  &&
+        film->width() == camera->width()  &&  film->height() == camera->height();
+
+    // (2) Render ////////////////////////////////////////////////////////////
+
+    std::vector<priv::PathVertex> cameraVertices(maxDepth + 2);
+    std::vector<priv::PathVertex>  lightVertices(maxDepth + 1);
+
+    const bool is_done = render_loop(image, block.x0, block.y0, [&](const size_t x, const size_t y) -> Color {
+      Color color;
+      AOVAccumulator aovs;
+      for(size_t i = 0; i < sampler->numSamplesPerPixel(); i++) {
+        if( isCancelled() ) {
+          break;
+        }
+
+        // (2.1) Generate Subpaths ///////////////////////////////////////////
+
+        sampler->beginSample(x, y, i);
+
+        const Ray ray = camera->ray(x, y, sampler);
+        if( AOV aov; have_aovs  &&  scene->aov(&aov, view()*ray) ) {
+          aovs.add(aov);
+        }
+
+        Color L;
+        const size_t numCamera = priv::cameraSubpath(ctx, ray, maxDepth + 2,
+                                                     cameraVertices.data(), &L);
+        const size_t  numLight = priv::lightSubpath(ctx, maxDepth + 1,
+                                                    lightVertices.data());
+
+        // (2.2) Connect Subpaths ////////////////////////////////////////////
+
+        /*
+         * NOTE:
+         * Connecting to a sampled light (s = 1) does not require a light subpath;
+         * lights unable to emit rays (e.g. infinite lights) rely on this strategy!
+         */
+        const size_t maxLight = std::max<size_t>(numLight, 1);
+
+        for(size_t t = 1; t <= numCamera; t++) {
+          for(size_t s = 0; s <= maxLight; s++) {
+            const size_t depth = s + t;
+            if( (s == 1  &&  t == 1)  ||  depth < 2  ||  depth - 2 > maxDepth ) {
+              continue;
+            }
+
+            real_t rx{0}, ry{0};
+            const Color Lpath = priv::connect(ctx, lightVertices.data(), cameraVertices.data(),
+                                              s, t, &rx, &ry);
+            if(        t != 1 ) {
+              L += Lpath;
+            } else if( have_film  &&  !Lpath.isZero() ) {
+              _film.addSplat(rx, ry, Lpath);
+            }
+          }
+        }
+
+        color += L;
+      }
+      color /= static_cast<real_t>(sampler->numSamplesPerPixel());
+
+      if( have_film ) {
+        _film.setPixel(x, y, color);
+      }
+      if( have_aovs ) {
+        film->setAOV(x, y, aovs.average());
+      }
+
+      return color;
+    }, options().gamma, &cancelled());
+    if( !is_done  ||  isCancelled() ) {
+      return Image();
+    }
+
+    _numLightPaths.fetch_add(image.width()*image.height()*sampler->numSamplesPerPixel(),
+                             std::memory_order_relaxed);
+
+    return image;
+  }
+
+  RendererPtr BidirectionalRenderer::create(const RenderOptions& options)
+  {
+    return std::make_unique<BidirectionalRenderer>(options);
+  }
+
+  ////// private /////////////////////////////////////////////////////////////
+
+  /*
+   * NOTE:
+   * Unsupported; paths are generated and connected by render(), as the light
+   * tracing strategies' contributions are splatted to arbitrary pixels.
+   * Cf. to IRenderer::radiance().
+   */
+  Color BidirectionalRenderer::radiance(const Ray& /*ray*/, const ScenePtr& /*scene*/,
+                                        const SamplerPtr& /*sampler*/,
+                                        const uint_t /*depth*/, const Color& /*throughput*/) const
+  {
+    return Color();
+  }
+
+  /*
+   * NOTE:
+   * Every camera sample traces one light subpath, whose splats estimate the
+   * entire image; i.e. the scale depends on the number of pixels rendered,
+   * which is less than the image's when rendering a crop window.
+   */
+  real_t BidirectionalRenderer::splatScale() const
+  {
+    const size_t numLightPaths = _numLightPaths.load(std::memory_order_relaxed);
+    return numLightPaths > 0
+        ? static_cast<real_t>(_film.width()*_film.height())/static_cast<real_t>(numLightPaths)
+        : ONE;
+  }
+
+} // namespace rt
@@ -65,17 +65,15 @@ namespace rt {
 
   ////// private /////////////////////////////////////////////////////////////
 
-  Color DirectLightingRenderer::radiance(const Ray& ray, const ScenePtr& _scene,
-                                         const SamplerPtr& sampler,
-                                         const uint_t depth, const Color& /*throughput*/) const
+  Color DirectLightingRenderer::shade(const Ray& ray, const SurfaceInfo& ref,
+                                      const ScenePtr& _scene, const SamplerPtr& sampler,
+                                      const uint_t depth) const
   {
     const RenderOptions& options = DirectLightingRenderer::options();
     const Scene           *scene = SCENE(_scene);
 
-    SurfaceInfo ref;
-    if( !scene->intersect(&ref, ray) ) {
-      // NOTE: PBR3 uses an InfiniteAreaLight to compute background radiance.
-      return scene->backgroundColor();
+    if( !ref.isHit() ) {
+      return scene->Le(ray);
     }
 
     Color Lo;
@@ -0,0 +1,202 @@
+/****************************************************************************
+** Copyright (c) 2021, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#include <algorithm>
+#include <mutex>
+
+#include "rt/Renderer/IrradianceCache.h"
+
+namespace rt {
+
+  ////// public //////////////////////////////////////////////////////////////
+
+  IrradianceCache::IrradianceCache() noexcept
+  {
+  }
+
+  IrradianceCache::~IrradianceCache() noexcept
+  {
+  }
+
+  real_t IrradianceCache::accuracy() const
+  {
+    return _accuracy;
+  }
+
+  void IrradianceCache::setAccuracy(const real_t a)
+  {
+    _accuracy = std::max<real_t>(0.01, a);
+  }
+
+  void IrradianceCache::clear()
+  {
+    std::unique_lock<std::shared_mutex> lock(_mutex);
+    _root.reset();
+    _size = 0;
+  }
+
+  void IrradianceCache::insert(const IrradianceRecord& record)
+  {
+    // NOTE: A record's weight exceeds 1/a within a distance of a*R.
+    const real_t radius = _accuracy*record.R;
+    if( radius <= ZERO ) {
+      return;
+    }
+
+    std::unique_lock<std::shared_mutex> lock(_mutex);
+
+    grow(record.P, radius);
+
+    Node *node = _root.get();
+    for(real_t halfSize = node->halfSize/TWO; halfSize >= radius; halfSize /= TWO) {
+      const size_t i = node->octant(record.P);
+      if( !node->children[i] ) {
+        const Vertex offset{i & 1 ? halfSize : -halfSize,
+                            i & 2 ? halfSize : -halfSize,
+                            i & 4 ? halfSize : -halfSize};
+        node->children[i] = std::make_unique<Node>(node->center + offset, halfSize);
+      }
+      node = node->children[i].get();
+    }
+
+    node->records.push_back(record);
+    _size++;
+  }
+
+  bool IrradianceCache::interpolate(Color *E, const Vertex& P, const Normal& N) const
+  {
+    std::shared_lock<std::shared_mutex> lock(_mutex);
+
+    Color  sumE;
+    real_t sumW = 0;
+    if( _root ) {
+      interpolate(_root.get(), P, N, &sumE, &sumW);
+    }
+    if( sumW <= ZERO ) {
+      return false;
+    }
+
+    *E = sumE/sumW;
+    return true;
+  }
+
+  bool IrradianceCache::isEmpty() const
+  {
+    return size() < 1;
+  }
+
+  size_t IrradianceCache::size() const
+  {
+    std::shared_lock<std::shared_mutex> lock(_mutex);
+    return _size;
+  }
+
+  ////// private /////////////////////////////////////////////////////////////
+
+  IrradianceCache::Node::Node(const Vertex& center, const real_t halfSize) noexcept
+    : center{center}
+    , halfSize{halfSize}
+  {
+  }
+
+  bool IrradianceCache::Node::contains(const Vertex& P, const real_t margin) const
+  {
+    const real_t extent = halfSize + margin;
+    return std::abs(P.x - center.x) <= extent  &&
+        std::abs(P.y - center.y) <= extent  &&
+        std::abs(P.z - center.z) <= extent;
+  }
+
+  size_t IrradianceCache::Node::octant(const Vertex& P) const
+  {
+    return (P.x >= center.x ? 1 : 0) | (P.y >= center.y ? 2 : 0) | (P.z >= center.z ? 4 : 0);
+  }
+
+  void IrradianceCache::grow(const Vertex& P, const real_t radius)
+  {
+    if( !_root ) {
+      _root = std::make_unique<Node>(P, radius*real_t(8));
+    }
+
+    // NOTE: The old root becomes the octant of the new root facing away from 'P'.
+    while( !_root->contains(P)  ||  _root->halfSize < radius ) {
+      const real_t   h = _root->halfSize;
+      const Vertex   c = _root->center;
+      const Vertex offset{P.x >= c.x ? h : -h,
+                          P.y >= c.y ? h : -h,
+                          P.z >= c.z ? h : -h};
+
+      std::unique_ptr<Node> root = std::make_unique<Node>(c + offset, TWO*h);
+      const size_t i = root->octant(c);
+      root->children[i] = std::move(_root);
+      _root = std::move(root);
+    }
+  }
+
+  void IrradianceCache::interpolate(const Node *node, const Vertex& P, const Normal& N,
+                                    Color *sumE, real_t *sumW) const
+  {
+    if( !node->contains(P, node->halfSize) ) {
+      return;
+    }
+
+    for(const IrradianceRecord& record : node->records) {
+      const real_t w = weight(record, P, N);
+      if( w > ONE/_accuracy ) {
+        *sumE += record.E*w;
+        *sumW += w;
+      }
+    }
+
+    for(const std::unique_ptr<Node>& child : node->children) {
+      if( child ) {
+        interpolate(child.get(), P, N, sumE, sumW);
+      }
+    }
+  }
+
+  real_t IrradianceCache::weight(const IrradianceRecord& record, const Vertex& P,
+                                 const Normal& N) const
+  {
+    // NOTE: Reject records in front of 'P'; they do not 'see' the same surroundings!
+    const real_t d = n4::dot(P - record.P, geom::to_vertex(N + record.N))/TWO;
+    if( d < -real_t(0.01)*record.R ) {
+      return 0;
+    }
+
+    const real_t cosTheta = std::min<real_t>(ONE, n4::dot(N, record.N));
+    const real_t    error = n4::distance(P, record.P)/record.R + Math::sqrt(ONE - cosTheta);
+    // NOTE: Bound the weight; a query at the record's position would otherwise
+    //       yield an infinite weight and hence 'inf/inf = NaN' irradiance!
+    return ONE/std::max<real_t>(error, real_t(1e-4));
+  }
+
+} // namespace rt
@@ -0,0 +1,318 @@
+/****************************************************************************
+** Copyright (c) 2021, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#include <algorithm>
+
+#include "rt/Renderer/IrradianceCachingRenderer.h"
+
+#include "geom/Shading.h"
+#include "rt/Object/IObject.h"
+#include "rt/Object/SurfaceInfo.h"
+#include "rt/Renderer/RenderUtils.h"
+#include "rt/Sampler/Sampling.h"
+#include "rt/Scene/Scene.h"
+
+namespace rt {
+
+  namespace priv {
+
+    inline const IBxDF::Flags LAMBERTIAN = IBxDF::Flags(IBxDF::Diffuse | IBxDF::Reflection);
+
+    inline const IBxDF::Flags NON_SPECULAR = IBxDF::Flags(IBxDF::AllFlags & ~IBxDF::Specular);
+
+    inline bool isLambertian(const BSDF *bsdf)
+    {
+      return !bsdf->isEmpty()  &&  bsdf->count(LAMBERTIAN) == bsdf->size();
+    }
+
+  } // namespace priv
+
+  ////// public //////////////////////////////////////////////////////////////
+
+  IrradianceCachingRenderer::IrradianceCachingRenderer(const RenderOptions& options) noexcept
+    : BaseRenderer(options)
+  {
+  }
+
+  IrradianceCachingRenderer::~IrradianceCachingRenderer() noexcept
+  {
+  }
+
+  real_t IrradianceCachingRenderer::accuracy() const
+  {
+    return _cache.accuracy();
+  }
+
+  void IrradianceCachingRenderer::setAccuracy(const real_t a)
+  {
+    _cache.setAccuracy(a);
+  }
+
+  real_t IrradianceCachingRenderer::minSpacing() const
+  {
+    return _minSpacing;
+  }
+
+  real_t IrradianceCachingRenderer::maxSpacing() const
+  {
+    return _maxSpacing;
+  }
+
+  void IrradianceCachingRenderer::setSpacing(const real_t minSpacing, const real_t maxSpacing)
+  {
+    _minSpacing = std::max<real_t>(SHADOW_BIAS, minSpacing);
+    _maxSpacing = std::max<real_t>(_minSpacing, maxSpacing);
+  }
+
+  size_t IrradianceCachingRenderer::numGatherRays() const
+  {
+    return _numGatherRays;
+  }
+
+  void IrradianceCachingRenderer::setNumGatherRays(const size_t numRays)
+  {
+    _numGatherRays = std::max<size_t>(1, numRays);
+  }
+
+  void IrradianceCachingRenderer::beginFrame(const ScenePtr& /*scene*/, const CameraPtr& /*camera*/,
+                                             const SamplerPtr& /*sampler*/)
+  {
+    _cache.clear();
+    _numLookups      = 0;
+    _numInterpolated = 0;
+  }
+
+  const IrradianceCache& IrradianceCachingRenderer::cache() const
+  {
+    return _cache;
+  }
+
+  IrradianceStats IrradianceCachingRenderer::stats() const
+  {
+    IrradianceStats result;
+    result.numRecords      = _cache.size();
+    result.numLookups      = _numLookups.load();
+    result.numInterpolated = _numInterpolated.load();
+    return result;
+  }
+
+  RenderStats IrradianceCachingRenderer::statistics() const
+  {
+    const IrradianceStats s = stats();
+    return RenderStats{
+      {"Irradiance records", double(s.numRecords)},
+      {"Irradiance lookups", double(s.numLookups)},
+      {"Irradiance interpolated [%]", s.numLookups > 0
+       ? 100.0*double(s.numInterpolated)/double(s.numLookups)
+       : 0.0}
+    };
+  }
+
+  RendererPtr IrradianceCachingRenderer::create(const RenderOptions& options)
+  {
+    return std::make_unique<IrradianceCachingRenderer>(options);
+  }
+
+  ////// private /////////////////////////////////////////////////////////////
+
+  IrradianceRecord IrradianceCachingRenderer::computeRecord(const SurfaceInfo& ref, const Normal& N,
+                                                            const Scene& scene,
+                                                            const SamplerPtr& sampler,
+                                                            const uint_t maxDepth) const
+  {
+    const bool is_flipped = geom::shading::cosTheta(ref.woS) < ZERO;
+
+    Color     sumL;
+    real_t sumInvT = 0;
+    for(size_t i = 0; i < _numGatherRays; i++) {
+      Direction wiS = CosineHemisphere::sample(sampler->sample2D());
+      if( is_flipped ) {
+        wiS = Direction{wiS.x, wiS.y, -wiS.z};
+      }
+
+      real_t t = INF_REAL_T;
+      sumL += gather(ref.ray(ref.toWorld(wiS)), scene, sampler, maxDepth, &t);
+      if( t < INF_REAL_T ) {
+        sumInvT += ONE/t;
+      }
+    }
+
+    IrradianceRecord record;
+    record.P = ref.P;
+    record.N = N;
+    // NOTE: Cosine-weighted sampling cancels all terms of the estimator but PI.
+    record.E = sumL*PI/real_t(_numGatherRays);
+    record.R = sumInvT > ZERO
+        ? std::clamp<real_t>(real_t(_numGatherRays)/sumInvT, _minSpacing, _maxSpacing)
+        : _maxSpacing;
+
+    return record;
+  }
+
+  Color IrradianceCachingRenderer::gather(const Ray& _ray, const Scene& scene,
+                                          const SamplerPtr& sampler,
+                                          const uint_t maxDepth, real_t *t) const
+  {
+    Color              beta(1);
+    Color                 L;
+    Ray                 ray{_ray};
+    bool is_specular_bounce = false;
+
+    // Path trace indirect light; direct light is sampled at the cache's position!
+    for(uint_t bounces = 0; ; bounces++) {
+      SurfaceInfo ref;
+      const bool is_intersect = scene.intersect(&ref, ray);
+      if( bounces == 0  &&  is_intersect ) {
+        *t = ref.t;
+      }
+
+      if( is_specular_bounce ) {
+        if( is_intersect ) {
+          L += beta*ref.Le(ref.wo);
+        } else {
+          L += beta*scene.Le(ray);
+        }
+      }
+
+      if( !is_intersect  ||  bounces >= maxDepth ) {
+        break;
+      }
+
+      L += beta*uniformSampleOneLight(ref, scene, sampler);
+
+      const BSDF *bsdf = ref->material()->bsdf();
+
+      real_t              pdfRef{0};
+      IBxDF::Flags sampled_flags{IBxDF::InvalidFlags};
+      Direction               wi;
+      const Color         f = bsdf->sample(ref, &wi, sampler->sample2D(), &pdfRef,
+                                           IBxDF::AllFlags, &sampled_flags);
+      const real_t absCosTi = geom::absDot(wi, ref.N);
+      if( pdfRef <= ZERO  ||  absCosTi == ZERO  ||  f.isZero() ) {
+        break;
+      }
+
+      beta *= f*absCosTi/pdfRef;
+      is_specular_bounce = isSpecular(sampled_flags);
+      ray = ref.ray(wi);
+
+      if( bounces > 3 ) {
+        const real_t q = std::max<real_t>(0.0625, ONE - beta.max());
+        if( sampler->sample() < q ) {
+          break;
+        }
+        beta /= ONE - q;
+      }
+    }
+
+    return L;
+  }
+
+  Color IrradianceCachingRenderer::indirect(const SurfaceInfo& ref, const Scene& scene,
+                                            const SamplerPtr& sampler, const uint_t depth) const
+  {
+    const RenderOptions& options = IrradianceCachingRenderer::options();
+    const uint_t        maxDepth = options.maxDepth - depth - 1;
+
+    const BSDF *bsdf = ref->material()->bsdf();
+    if( bsdf->count(priv::NON_SPECULAR) < 1 ) {
+      return Color();
+    }
+
+    // (1) Path Trace Non-Lambertian Surfaces ////////////////////////////////
+
+    if( !priv::isLambertian(bsdf) ) {
+      real_t    pdf = 0;
+      Direction  wi{};
+      const Color         f = bsdf->sample(ref, &wi, sampler->sample2D(), &pdf, priv::NON_SPECULAR);
+      const real_t absCosTi = geom::absDot(wi, ref.N);
+      if( pdf <= ZERO  ||  absCosTi == ZERO  ||  f.isZero() ) {
+        return Color();
+      }
+
+      real_t t = INF_REAL_T;
+      return f*gather(ref.ray(wi), scene, sampler, maxDepth, &t)*absCosTi/pdf;
+    }
+
+    // (2) Lookup or Compute Irradiance //////////////////////////////////////
+
+    const Normal N = geom::shading::cosTheta(ref.woS) < ZERO
+        ? -ref.N
+        : ref.N;
+
+    _numLookups.fetch_add(1, std::memory_order_relaxed);
+
+    Color E;
+    if( _cache.interpolate(&E, ref.P, N) ) {
+      _numInterpolated.fetch_add(1, std::memory_order_relaxed);
+    } else {
+      const IrradianceRecord record = computeRecord(ref, N, scene, sampler, maxDepth);
+      _cache.insert(record);
+      E = record.E;
+    }
+
+    // (3) Reflect Irradiance ////////////////////////////////////////////////
+
+    // NOTE: A Lambertian BRDF does not depend on the incident direction.
+    const Color f = bsdf->eval(ref, geom::to_direction(N), priv::LAMBERTIAN);
+
+    return f*E;
+  }
+
+  Color IrradianceCachingRenderer::shade(const Ray& ray, const SurfaceInfo& ref,
+                                         const ScenePtr& _scene, const SamplerPtr& sampler,
+                                         const uint_t depth) const
+  {
+    const RenderOptions& options = IrradianceCachingRenderer::options();
+    const Scene           *scene = SCENE(_scene);
+
+    if( !ref.isHit() ) {
+      return scene->Le(ray);
+    }
+
+    Color Lo;
+
+    Lo += ref.Le(ref.wo);
+
+    if( scene->lights().size() > 0 ) {
+      Lo += uniformSampleAllLights(ref, *scene, sampler);
+    }
+
+    if( depth + 1 < options.maxDepth ) {
+      Lo += specularReflectOrTransmit(ref, _scene, sampler, depth, false);
+      Lo += specularReflectOrTransmit(ref, _scene, sampler, depth, true);
+      Lo += indirect(ref, *scene, sampler, depth);
+    }
+
+    return Lo;
+  }
+
+} // namespace rt
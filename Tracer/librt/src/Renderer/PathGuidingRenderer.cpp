@@ -0,0 +1,394 @@
+/****************************************************************************
+** Copyright (c) 2021, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#include <algorithm>
+#include <chrono>
+#include <execution>
+#include <mutex>
+#include <numeric>
+
+#include "rt/Renderer/PathGuidingRenderer.h"
+
+#include "rt/Object/IObject.h"
+#include "rt/Object/SurfaceInfo.h"
+#include "rt/Renderer/RenderUtils.h"
+#include "rt/Scene/Scene.h"
+
+namespace rt {
+
+  namespace priv {
+
+    using Clock = std::chrono::steady_clock;
+
+    inline const IBxDF::Flags NON_SPECULAR = IBxDF::Flags(IBxDF::AllFlags & ~IBxDF::Specular);
+
+    inline const IBxDF::Flags NON_SPECULAR_REFLECTION =
+        IBxDF::Flags(IBxDF::Reflection | IBxDF::Diffuse | IBxDF::Glossy);
+
+    inline real_t average(const Color& c)
+    {
+      return (c(0) + c(1) + c(2))/real_t(3);
+    }
+
+    inline real_t safeDiv(const real_t a, const real_t b)
+    {
+      return b > ZERO
+          ? a/b
+          : 0;
+    }
+
+    inline Direction mirror(const Direction& w, const Direction& n)
+    {
+      return w - TWO*n4::dot(w, n)*n;
+    }
+
+    /*
+     * NOTE:
+     * The guiding distribution covers the whole sphere. For BSDFs lacking a
+     * non-specular transmission all directions below the surface are mirrored
+     * into the hemisphere of 'wo'; the pdf of the folded distribution is then the
+     * sum of the pdfs of both mirror images.
+     */
+    inline real_t guidePdf(const DTree *dtree, const Direction& wi, const Direction& n,
+                           const bool is_folded)
+    {
+      return is_folded
+          ? dtree->pdf(wi) + dtree->pdf(mirror(wi, n))
+          : dtree->pdf(wi);
+    }
+
+    // NOTE: Contributions divided by the throughput yield the radiance incident at the vertex.
+    template<typename PathT>
+    inline void addContribution(PathT *path, const Color& C)
+    {
+      if( path == nullptr  ||  C.isZero() ) {
+        return;
+      }
+      for(auto& v : *path) {
+        v.Li += Color(safeDiv(C(0), v.beta(0)), safeDiv(C(1), v.beta(1)), safeDiv(C(2), v.beta(2)));
+      }
+    }
+
+  } // namespace priv
+
+  ////// public //////////////////////////////////////////////////////////////
+
+  PathGuidingRenderer::PathGuidingRenderer(const RenderOptions& options) noexcept
+    : IRenderer(options)
+  {
+  }
+
+  PathGuidingRenderer::~PathGuidingRenderer() noexcept
+  {
+  }
+
+  real_t PathGuidingRenderer::bsdfSamplingFraction() const
+  {
+    return _bsdfSamplingFraction;
+  }
+
+  void PathGuidingRenderer::setBsdfSamplingFraction(const real_t fraction)
+  {
+    _bsdfSamplingFraction = std::clamp<real_t>(fraction, 0.01, 1);
+  }
+
+  size_t PathGuidingRenderer::maxMemory() const
+  {
+    return _maxMemory;
+  }
+
+  void PathGuidingRenderer::setMaxMemory(const size_t numBytes)
+  {
+    _maxMemory = numBytes;
+  }
+
+  size_t PathGuidingRenderer::numTrainingPasses() const
+  {
+    return _numTrainingPasses;
+  }
+
+  void PathGuidingRenderer::setNumTrainingPasses(const size_t numPasses)
+  {
+    _numTrainingPasses = std::min<size_t>(numPasses, 10);
+  }
+
+  size_t PathGuidingRenderer::spatialThreshold() const
+  {
+    return _spatialThreshold;
+  }
+
+  void PathGuidingRenderer::setSpatialThreshold(const size_t numSamples)
+  {
+    _spatialThreshold = std::max<size_t>(1, numSamples);
+  }
+
+  void PathGuidingRenderer::beginFrame(const ScenePtr& scene, const CameraPtr& camera,
+                                       const SamplerPtr& sampler)
+  {
+    _sdtree.clear();
+    _msecTraining = 0;
+
+    if( SCENE(scene) == nullptr  ||  !camera  ||  _numTrainingPasses < 1 ) {
+      return;
+    }
+
+    const priv::Clock::time_point begin = priv::Clock::now();
+    train(*SCENE(scene), camera, sampler);
+    _msecTraining = std::chrono::duration<real_t,std::milli>(priv::Clock::now() - begin).count();
+  }
+
+  GuidingStats PathGuidingRenderer::stats() const
+  {
+    GuidingStats result;
+    result.numLeaves    = _sdtree.numLeaves();
+    result.memory       = _sdtree.memory();
+    result.msecTraining = _msecTraining;
+    return result;
+  }
+
+  RenderStats PathGuidingRenderer::statistics() const
+  {
+    const GuidingStats s = stats();
+    return RenderStats{
+      {"Guiding spatial leaves", double(s.numLeaves)},
+      {"Guiding memory [MiB]", double(s.memory)/double(1 << 20)},
+      {"Guiding memory cap [MiB]", double(_maxMemory)/double(1 << 20)},
+      {"Guiding training [ms]", double(s.msecTraining)}
+    };
+  }
+
+  RendererPtr PathGuidingRenderer::create(const RenderOptions& options)
+  {
+    return std::make_unique<PathGuidingRenderer>(options);
+  }
+
+  ////// private /////////////////////////////////////////////////////////////
+
+  Color PathGuidingRenderer::primaryRadiance(Ray *ray, const size_t x, const size_t y,
+                                             const size_t s, const ScenePtr& scene,
+                                             const CameraPtr& camera,
+                                             const SamplerPtr& sampler) const
+  {
+    SurfaceInfo ref;
+    SCENE(scene)->intersectPrimary(&ref, ray, x, y, s, view(), camera, sampler);
+    return trace(*ray, &ref, *SCENE(scene), sampler, nullptr);
+  }
+
+  Color PathGuidingRenderer::radiance(const Ray& ray, const ScenePtr& scene,
+                                      const SamplerPtr& sampler,
+                                      const uint_t /*depth*/, const Color& /*throughput*/) const
+  {
+    return trace(ray, nullptr, *SCENE(scene), sampler, nullptr);
+  }
+
+  Color PathGuidingRenderer::trace(const Ray& _ray, const SurfaceInfo *primary,
+                                   const Scene& scene, const SamplerPtr& sampler,
+                                   GuidePath *path) const
+  {
+    const RenderOptions& options = PathGuidingRenderer::options();
+
+    Color              beta(1);
+    Color                 L;
+    Ray                 ray{_ray};
+    bool is_specular_bounce = false;
+
+    // Find next path vertex and accumulate contribution
+    for(uint_t bounces = 0; ; bounces++) {
+      // Intersect ray with scene (or reuse the primary hit) and store intersection in 'ref'
+      SurfaceInfo ref;
+      if( bounces == 0  &&  primary != nullptr ) {
+        ref = *primary;
+      } else {
+        scene.intersect(&ref, ray);
+      }
+      const bool is_intersect = ref.isHit();
+
+      // Possibly add emitted light at intersection
+      if( bounces == 0  ||  is_specular_bounce ) {
+        const Color C = is_intersect
+            ? beta*ref.Le(ref.wo)
+            : beta*scene.Le(ray);
+        L += C;
+        priv::addContribution(path, C);
+      }
+
+      // Terminate path if ray escaped or maxDepth was reached
+      if( !is_intersect  ||  bounces >= options.maxDepth ) {
+        break;
+      }
+
+      // Sample illumination from lights to find path contribution
+      const Color Ld = beta*uniformSampleOneLight(ref, scene, sampler);
+      L += Ld;
+      priv::addContribution(path, Ld);
+
+      // Lookup guiding distribution
+      const BSDF *bsdf = ref->material()->bsdf();
+
+      const bool have_leaf = !_sdtree.isEmpty();
+      const size_t    leaf = have_leaf
+          ? _sdtree.leafIndex(ref.P)
+          : 0;
+      const DTree   *dtree = have_leaf  &&  bsdf->count(priv::NON_SPECULAR) > 0
+          ? _sdtree.samplingTree(leaf)
+          : nullptr;
+      const real_t   alpha = dtree != nullptr  &&  !dtree->isEmpty()
+          ? _bsdfSamplingFraction
+          : ONE;
+
+      const Direction     n = geom::to_direction(ref.N);
+      const bool  is_folded = dtree != nullptr  &&
+          bsdf->count(priv::NON_SPECULAR_REFLECTION) == bsdf->count(priv::NON_SPECULAR);
+
+      // Sample BSDF or guiding distribution to get new path direction
+      real_t                 pdf{0};
+      IBxDF::Flags sampled_flags{IBxDF::InvalidFlags};
+      Direction               wi;
+      Color                    f;
+      if( sampler->sample() < alpha ) {
+        real_t pdfBSDF{0};
+        f = bsdf->sample(ref, &wi, sampler->sample2D(), &pdfBSDF, IBxDF::AllFlags, &sampled_flags);
+        if( pdfBSDF <= ZERO ) {
+          break;
+        }
+
+        // NOTE: The guiding distribution cannot sample specular directions!
+        pdf = isSpecular(sampled_flags)  ||  alpha == ONE
+            ? alpha*pdfBSDF
+            : alpha*pdfBSDF + (ONE - alpha)*priv::guidePdf(dtree, wi, n, is_folded);
+      } else {
+        real_t pdfGuide{0};
+        wi = dtree->sample(sampler->sample2D(), &pdfGuide);
+        if( pdfGuide <= ZERO ) {
+          break;
+        }
+
+        if( is_folded  &&
+            geom::isSameHemisphere(wi, ref.N) != geom::isSameHemisphere(ref.wo, ref.N) ) {
+          wi = priv::mirror(wi, n);
+        }
+
+        f   = bsdf->eval(ref, wi);
+        pdf = alpha*bsdf->pdf(ref, wi) + (ONE - alpha)*priv::guidePdf(dtree, wi, n, is_folded);
+        sampled_flags = priv::NON_SPECULAR;
+      }
+
+      const real_t absCosTi = geom::absDot(wi, ref.N);
+      if( pdf <= ZERO  ||  absCosTi == ZERO  ||  f.isZero() ) {
+        break;
+      }
+
+      beta *= f*absCosTi/pdf;
+      is_specular_bounce = isSpecular(sampled_flags);
+      ray = ref.ray(wi);
+
+      // Possibly terminate the path with Russian roulette
+      bool is_terminated = false;
+      if( bounces > 3 ) {
+        const real_t q = std::max<real_t>(0.0625, ONE - beta.max());
+        if( sampler->sample() < q ) {
+          is_terminated = true;
+        } else {
+          beta /= ONE - q;
+        }
+      }
+
+      // Remember vertex for training
+      if( path != nullptr  &&  have_leaf  &&  !is_specular_bounce ) {
+        GuideVertex v;
+        v.P    = ref.P;
+        v.wi   = wi;
+        v.pdf  = pdf;
+        v.beta = beta;
+        v.leaf = leaf;
+        path->push_back(v);
+      }
+
+      if( is_terminated ) {
+        break;
+      }
+    }
+
+    return L;
+  }
+
+  void PathGuidingRenderer::train(const Scene& scene, const CameraPtr& camera,
+                                  const SamplerPtr& sampler)
+  {
+    std::vector<size_t> rows(camera->height());
+    std::iota(rows.begin(), rows.end(), 0);
+
+    _sdtree.reset();
+
+    for(size_t pass = 0; pass < _numTrainingPasses; pass++) {
+      const size_t numSamples = size_t{1} << pass;
+
+      // (1) Trace & Record Paths in Parallel ////////////////////////////////
+
+      Bounds bounds;
+      std::mutex mutex;
+      std::for_each(std::execution::par, rows.begin(), rows.end(), [&](const size_t y) -> void {
+        const SamplerPtr mysampler = sampler->copy();
+        mysampler->beginStream(pass*rows.size() + y);
+
+        Bounds mybounds;
+        GuidePath path;
+        for(size_t x = 0; x < camera->width(); x++) {
+          for(size_t s = 0; s < numSamples; s++) {
+            path.clear();
+            trace(view()*camera->ray(x, y, mysampler), nullptr, scene, mysampler, &path);
+
+            for(const GuideVertex& v : path) {
+              _sdtree.record(v.leaf, v.wi, priv::average(v.Li)/v.pdf);
+              mybounds.update(v.P);
+            }
+          }
+        }
+
+        if( pass == 0  &&  mybounds.isValid() ) {
+          std::lock_guard<std::mutex> lock(mutex);
+          bounds.update(mybounds.min());
+          bounds.update(mybounds.max());
+        }
+      });
+
+      // (2) Refine SD-Tree //////////////////////////////////////////////////
+
+      if( pass == 0 ) {
+        _sdtree.setBounds(bounds);
+      }
+
+      const real_t threshold = real_t(_spatialThreshold)*Math::sqrt(real_t(numSamples));
+      _sdtree.refine(size_t(threshold), _maxMemory);
+    }
+  }
+
+} // namespace rt
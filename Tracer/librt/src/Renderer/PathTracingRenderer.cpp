@@ -29,6 +29,11 @@
 ** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 *****************************************************************************/
 
+#include <algorithm>
+#include <chrono>
+#include <execution>
+#include <numeric>
+
 #include "rt/Renderer/PathTracingRenderer.h"
 
 #include "rt/Object/SurfaceInfo.h"
@@ -37,6 +42,72 @@
 
 namespace rt {
 
+  namespace priv {
+
+    using Clock = std::chrono::steady_clock;
+
+    // Resolution of the radiance cache along the scene's longest axis
+    inline constexpr size_t CACHE_RESOLUTION = 32;
+
+    // Pixel stride of the pre-pass recording the radiance cache
+    inline constexpr size_t RECORD_STRIDE = 4;
+
+    // Minimum number of records of a cache cell to be trusted
+    inline constexpr size_t MIN_RECORDS = 16;
+
+    // Regularization of the relative variance of dark pixels
+    inline constexpr real_t RELATIVE_EPSILON = 0.01;
+
+    // NOTE: A pixel of the adaptive roulette's pre-pass.
+    struct PrePixel {
+      Vertex         P{}; // Primary vertex of the first sample
+      real_t        Le{0}; // Luminance emitted from 'P'
+      real_t      mean{0};
+      real_t  variance{0}; // Variance of one sample
+      bool      is_hit{false};
+    };
+
+    // NOTE: A path vertex recorded by the pre-pass; cf. RadianceCache::record().
+    struct PreRecord {
+      Vertex     P{};
+      real_t     L{0};
+      real_t  cost{0};
+      real_t  twin{0};
+    };
+
+    // Lower bound of Russian roulette's survival probability
+    inline constexpr real_t MIN_SURVIVAL = 0.25;
+
+    // Damping of the splitting factor; a single pre-pass over-estimates splitting's gain
+    inline constexpr real_t SPLIT_DAMPING = 0.5;
+
+    inline real_t safeDiv(const real_t a, const real_t b)
+    {
+      return b > ZERO
+          ? a/b
+          : 0;
+    }
+
+    // NOTE: Channels without throughput are lost to contributions; cf. addContribution().
+    inline Color masked(const Color& L, const Color& beta)
+    {
+      return Color(beta(0) > ZERO ? L(0) : 0, beta(1) > ZERO ? L(1) : 0, beta(2) > ZERO ? L(2) : 0);
+    }
+
+    // NOTE: Contributions divided by the throughput yield the radiance leaving the vertex.
+    template<typename PathT>
+    inline void addContribution(PathT *path, const Color& C)
+    {
+      if( path == nullptr  ||  C.isZero() ) {
+        return;
+      }
+      for(auto& v : *path) {
+        v.Lo += Color(safeDiv(C(0), v.beta(0)), safeDiv(C(1), v.beta(1)), safeDiv(C(2), v.beta(2)));
+      }
+    }
+
+  } // namespace priv
+
   ////// public //////////////////////////////////////////////////////////////
 
   PathTracingRenderer::PathTracingRenderer(const RenderOptions& options) noexcept
@@ -48,6 +119,90 @@ namespace rt {
   {
   }
 
+  bool PathTracingRenderer::isAdaptiveRoulette() const
+  {
+    return _adaptiveRoulette;
+  }
+
+  void PathTracingRenderer::setAdaptiveRoulette(const bool on)
+  {
+    _adaptiveRoulette = on;
+  }
+
+  size_t PathTracingRenderer::maxSplit() const
+  {
+    return _maxSplit;
+  }
+
+  void PathTracingRenderer::setMaxSplit(const size_t n)
+  {
+    _maxSplit = std::max<size_t>(1, n);
+  }
+
+  size_t PathTracingRenderer::maxPathSplit() const
+  {
+    return _maxPathSplit;
+  }
+
+  void PathTracingRenderer::setMaxPathSplit(const size_t n)
+  {
+    _maxPathSplit = std::max<size_t>(1, n);
+  }
+
+  size_t PathTracingRenderer::numPrePassSamples() const
+  {
+    return _numPrePassSamples;
+  }
+
+  void PathTracingRenderer::setNumPrePassSamples(const size_t numSamples)
+  {
+    _numPrePassSamples = std::max<size_t>(2, numSamples);
+  }
+
+  void PathTracingRenderer::beginFrame(const ScenePtr& scene, const CameraPtr& camera,
+                                       const SamplerPtr& sampler)
+  {
+    _cache.clear();
+    _imageCost     = 0;
+    _imageVariance = 0;
+    _msecPrePass   = 0;
+
+    if( SCENE(scene) == nullptr  ||  !camera  ||  !_adaptiveRoulette ) {
+      return;
+    }
+
+    const priv::Clock::time_point begin = priv::Clock::now();
+    prePass(*SCENE(scene), camera, sampler);
+    _msecPrePass = std::chrono::duration<real_t,std::milli>(priv::Clock::now() - begin).count();
+  }
+
+  AdaptiveStats PathTracingRenderer::stats() const
+  {
+    AdaptiveStats result;
+    result.numCells      = _cache.numCells();
+    result.numRecords    = _cache.numRecords();
+    result.imageCost     = _imageCost;
+    result.imageVariance = _imageVariance;
+    result.msecPrePass   = _msecPrePass;
+    return result;
+  }
+
+  RenderStats PathTracingRenderer::statistics() const
+  {
+    if( !_adaptiveRoulette ) {
+      return RenderStats();
+    }
+
+    const AdaptiveStats s = stats();
+    return RenderStats{
+      {"Adaptive roulette cells", double(s.numCells)},
+      {"Adaptive roulette records", double(s.numRecords)},
+      {"Adaptive roulette cost", double(s.imageCost)},
+      {"Adaptive roulette rel. variance", double(s.imageVariance)},
+      {"Adaptive roulette pre-pass [ms]", double(s.msecPrePass)}
+    };
+  }
+
   RendererPtr PathTracingRenderer::create(const RenderOptions& options)
   {
     return std::make_unique<PathTracingRenderer>(options);
@@ -55,32 +210,63 @@ namespace rt {
 
   ////// private /////////////////////////////////////////////////////////////
 
-  Color PathTracingRenderer::radiance(const Ray& _ray, const ScenePtr& _scene,
+  Color PathTracingRenderer::primaryRadiance(Ray *ray, const size_t x, const size_t y,
+                                             const size_t s, const ScenePtr& scene,
+                                             const CameraPtr& camera,
+                                             const SamplerPtr& sampler) const
+  {
+    SurfaceInfo ref;
+    SCENE(scene)->intersectPrimary(&ref, ray, x, y, s, view(), camera, sampler);
+    return radiance(*ray, &ref, *SCENE(scene), sampler);
+  }
+
+  Color PathTracingRenderer::radiance(const Ray& ray, const ScenePtr& scene,
                                       const SamplerPtr& sampler,
                                       const uint_t /*depth*/, const Color& /*throughput*/) const
+  {
+    return radiance(ray, nullptr, *SCENE(scene), sampler);
+  }
+
+  Color PathTracingRenderer::radiance(const Ray& ray, const SurfaceInfo *primary,
+                                      const Scene& scene, const SamplerPtr& sampler) const
+  {
+    if( _adaptiveRoulette  &&  !_cache.isEmpty() ) {
+      return traceAdaptive(ray, primary, scene, sampler, 0, Color(1), false, 0, 1);
+    }
+    return trace(ray, primary, scene, sampler, nullptr);
+  }
+
+  Color PathTracingRenderer::trace(const Ray& _ray, const SurfaceInfo *primary,
+                                   const Scene& scene, const SamplerPtr& sampler,
+                                   CachePath *path, const uint_t firstBounce,
+                                   const bool is_specular) const
   {
     const RenderOptions& options = PathTracingRenderer::options();
-    const Scene           *scene = SCENE(_scene);
 
     Color              beta(1);
     Color                 L;
     Ray                 ray{_ray};
-    bool is_specular_bounce = false;
+    bool is_specular_bounce = is_specular;
 
     // Find next path vertex and accumulate contribution
-    for(uint_t bounces = 0; ; bounces++) {
-      // Intersect ray with scene and store intersection in 'ref'
+    for(uint_t bounces = firstBounce; ; bounces++) {
+      // Intersect ray with scene (or reuse the primary hit) and store intersection in 'ref'
       SurfaceInfo ref;
-      const bool is_intersect = scene->intersect(&ref, ray);
+      if( bounces == firstBounce  &&  primary != nullptr ) {
+        ref = *primary;
+      } else {
+        scene.intersect(&ref, ray);
+      }
+      const bool is_intersect = ref.isHit();
 
       // Possibly add emitted light at intersection
       if( bounces == 0  ||  is_specular_bounce ) {
         // Add emitted light at path vertex or from the environment
-        if( is_intersect ) {
-          L += beta*ref.Le(ref.wo);
-        } else {
-          L += beta*scene->backgroundColor();
-        }
+        const Color C = is_intersect
+            ? beta*ref.Le(ref.wo)
+            : beta*scene.Le(ray);
+        L += C;
+        priv::addContribution(path, C);
       }
 
       // Terminate path if ray escaped or maxDepth was reached
@@ -88,8 +274,19 @@ namespace rt {
         break;
       }
 
+      // Remember vertex for the radiance cache
+      if( path != nullptr ) {
+        CacheVertex v;
+        v.P    = ref.P;
+        v.beta = beta;
+        v.twin = priv::masked(twin(ref, scene, sampler, bounces), beta);
+        path->push_back(v);
+      }
+
       // Sample illumination from lights to find path contribution
-      L += beta*uniformSampleOneLight(ref, *scene, sampler);
+      const Color Ld = beta*uniformSampleOneLight(ref, scene, sampler);
+      L += Ld;
+      priv::addContribution(path, Ld);
 
       // Sample BSDF to get new path direction
       const BSDF *bsdf = ref->material()->bsdf();
@@ -121,4 +318,232 @@ namespace rt {
     return L;
   }
 
+  Color PathTracingRenderer::traceAdaptive(const Ray& ray, const SurfaceInfo *primary,
+                                           const Scene& scene, const SamplerPtr& sampler,
+                                           const uint_t bounces, const Color& beta,
+                                           const bool is_specular_bounce,
+                                           real_t estimate, const real_t numPaths) const
+  {
+    const RenderOptions& options = PathTracingRenderer::options();
+
+    // Intersect ray with scene (or reuse the primary hit) and store intersection in 'ref'
+    SurfaceInfo ref;
+    if( primary != nullptr ) {
+      ref = *primary;
+    } else {
+      scene.intersect(&ref, ray);
+    }
+    const bool is_intersect = ref.isHit();
+
+    Color L;
+
+    // Possibly add emitted light at intersection
+    if( bounces == 0  ||  is_specular_bounce ) {
+      // Add emitted light at path vertex or from the environment
+      L += is_intersect
+          ? beta*ref.Le(ref.wo)
+          : beta*scene.Le(ray);
+    }
+
+    // Terminate path if ray escaped or maxDepth was reached
+    if( !is_intersect  ||  bounces >= options.maxDepth ) {
+      return L;
+    }
+
+    // The primary vertex' cached radiance estimates the pixel's value
+    RadianceStats stats;
+    const bool have_stats = _cache.lookup(&stats, ref.P, priv::MIN_RECORDS)  &&
+        stats.cost > ZERO  &&  _imageVariance > ZERO;
+    if( bounces == 0 ) {
+      estimate = have_stats
+          ? ref.Le(ref.wo).luminance() + stats.mean
+          : 0;
+    }
+
+    // Determine the expected number of paths continuing from this vertex
+    real_t q = ONE;
+    if( have_stats  &&  estimate > ZERO ) {
+      /*
+       * NOTE:
+       * Relative to the pixel's estimate, Russian roulette adds to the pixel's
+       * variance in proportion to the continuation's second moment, splitting
+       * removes from it in proportion to the vertex' variance. Either is weighed
+       * against the continuation's cost, relative to the image's (relative)
+       * variance & cost per sample.
+       */
+      const real_t   b = beta.luminance();
+      const real_t rel = b*b/(estimate*estimate + priv::RELATIVE_EPSILON);
+      const real_t eff = _imageCost/(_imageVariance*stats.cost);
+      q = Math::sqrt(rel*stats.moment2*eff);
+      if( q >= ONE ) {
+        // NOTE: Splitting is capped per vertex and along the path.
+        const real_t maxSplit = std::clamp<real_t>(real_t(_maxPathSplit)/numPaths,
+                                                   ONE, real_t(_maxSplit));
+        q = std::clamp<real_t>(priv::SPLIT_DAMPING*Math::sqrt(rel*stats.variance*eff),
+                               ONE, maxSplit);
+      } else {
+        q = std::max<real_t>(q, priv::MIN_SURVIVAL);
+      }
+    } else if( bounces > 4 ) {
+      // NOTE: Same as trace(), which plays the roulette for the next vertex.
+      q = std::min<real_t>(0.9375, beta.max());
+    }
+
+    // Terminate the path with Russian roulette or split it
+    // NOTE: Averaging split paths is unbiased for any number of them, hence 'q'
+    //       is rounded deterministically, avoiding the variance of a random count.
+    Color    weight{beta};
+    size_t numSplit = 1;
+    if( q < ONE ) {
+      if( sampler->sample() >= q ) {
+        return L;
+      }
+      weight /= q;
+    } else {
+      numSplit = std::min(size_t(q + ONE_HALF), size_t(real_t(_maxPathSplit)/numPaths));
+      numSplit = std::max<size_t>(1, numSplit);
+      weight  /= real_t(numSplit);
+    }
+
+    // Sample BSDF to get new path direction(s)
+    const BSDF *bsdf = ref->material()->bsdf();
+
+    for(size_t i = 0; i < numSplit; i++) {
+      // Sample illumination from lights to find path contribution
+      L += weight*uniformSampleOneLight(ref, scene, sampler);
+
+      real_t              pdfRef{0};
+      IBxDF::Flags sampled_flags{IBxDF::InvalidFlags};
+      Direction               wi;
+      const Color         f = bsdf->sample(ref, &wi, sampler->sample2D(), &pdfRef,
+                                           IBxDF::AllFlags, &sampled_flags);
+      const real_t absCosTi = geom::absDot(wi, ref.N);
+      if( pdfRef <= ZERO  ||  absCosTi == ZERO  ||  f.isZero() ) {
+        continue;
+      }
+
+      L += traceAdaptive(ref.ray(wi), nullptr, scene, sampler, bounces + 1,
+                         weight*f*absCosTi/pdfRef, isSpecular(sampled_flags), estimate,
+                         numPaths*real_t(numSplit));
+    }
+
+    return L;
+  }
+
+  // NOTE: Estimates the radiance leaving 'ref' like trace(), excluding its emission.
+  Color PathTracingRenderer::twin(const SurfaceInfo& ref, const Scene& scene,
+                                  const SamplerPtr& sampler, const uint_t bounces) const
+  {
+    const Color Ld = uniformSampleOneLight(ref, scene, sampler);
+
+    const BSDF *bsdf = ref->material()->bsdf();
+
+    real_t              pdfRef{0};
+    IBxDF::Flags sampled_flags{IBxDF::InvalidFlags};
+    Direction               wi;
+    const Color         f = bsdf->sample(ref, &wi, sampler->sample2D(), &pdfRef,
+                                         IBxDF::AllFlags, &sampled_flags);
+    const real_t absCosTi = geom::absDot(wi, ref.N);
+    if( pdfRef <= ZERO  ||  absCosTi == ZERO  ||  f.isZero() ) {
+      return Ld;
+    }
+
+    return Ld + f*absCosTi/pdfRef*trace(ref.ray(wi), nullptr, scene, sampler, nullptr,
+                                        bounces + 1, isSpecular(sampled_flags));
+  }
+
+  void PathTracingRenderer::prePass(const Scene& scene, const CameraPtr& camera,
+                                    const SamplerPtr& sampler)
+  {
+    constexpr size_t S = priv::RECORD_STRIDE;
+
+    std::vector<size_t> rows((camera->height() + S - 1)/S);
+    std::iota(rows.begin(), rows.end(), 0);
+
+    const size_t numX = (camera->width() + S - 1)/S;
+
+    // (1) Trace Paths in Parallel /////////////////////////////////////////////
+
+    // NOTE: The cache's bounds are known only once all paths were traced.
+    std::vector<priv::PrePixel> pixels(numX*rows.size());
+    std::vector<std::vector<priv::PreRecord>> records(rows.size());
+    std::vector<real_t> costs(rows.size(), 0);
+    std::vector<Bounds> bounds(rows.size());
+    std::for_each(std::execution::par, rows.begin(), rows.end(), [&](const size_t row) -> void {
+      const size_t y = row*S;
+
+      const SamplerPtr mysampler = sampler->copy();
+      mysampler->beginStream(y);
+
+      CachePath path;
+      for(size_t x = 0; x < camera->width(); x += S) {
+        priv::PrePixel& pixel = pixels[row*numX + x/S];
+
+        real_t sumL{0}, sumL2{0};
+        for(size_t s = 0; s < _numPrePassSamples; s++) {
+          path.clear();
+          const Color Li = trace(view()*camera->ray(x, y, mysampler), nullptr, scene, mysampler, &path);
+          const real_t L = Li.luminance();
+          sumL  += L;
+          sumL2 += L*L;
+
+          for(size_t i = 0; i < path.size(); i++) {
+            records[row].push_back({path[i].P, path[i].Lo.luminance(), real_t(path.size() - i),
+                                    path[i].twin.luminance()});
+            bounds[row].update(path[i].P);
+          }
+          costs[row] += real_t(std::max<size_t>(1, path.size()));
+
+          if( s == 0  &&  !path.empty() ) {
+            pixel.P      = path[0].P;
+            pixel.Le     = L - path[0].Lo.luminance();
+            pixel.is_hit = true;
+          }
+        }
+
+        // Variance of one sample of this pixel
+        pixel.mean     = sumL/real_t(_numPrePassSamples);
+        pixel.variance = std::max<real_t>(0, sumL2 - pixel.mean*sumL)/real_t(_numPrePassSamples - 1);
+      }
+    });
+
+    // (2) Record Paths ////////////////////////////////////////////////////////
+
+    Bounds cacheBounds;
+    for(const Bounds& b : bounds) {
+      if( b.isValid() ) {
+        cacheBounds.update(b.min());
+        cacheBounds.update(b.max());
+      }
+    }
+
+    _cache.reset(cacheBounds, priv::CACHE_RESOLUTION);
+    if( _cache.isEmpty() ) {
+      return;
+    }
+
+    for(const std::vector<priv::PreRecord>& myrecords : records) {
+      for(const priv::PreRecord& r : myrecords) {
+        _cache.record(r.P, r.L, r.cost, r.twin);
+      }
+    }
+
+    // (3) Estimate Image's Relative Variance //////////////////////////////////
+
+    // NOTE: The pixels are estimated like traceAdaptive() does, once the cache is complete.
+    real_t sumVariance{0};
+    for(const priv::PrePixel& pixel : pixels) {
+      RadianceStats stats;
+      const real_t estimate = pixel.is_hit  &&  _cache.lookup(&stats, pixel.P, priv::MIN_RECORDS)
+          ? pixel.Le + stats.mean
+          : pixel.mean;
+      sumVariance += pixel.variance/(estimate*estimate + priv::RELATIVE_EPSILON);
+    }
+
+    const real_t numPixels = real_t(pixels.size());
+    _imageCost     = std::accumulate(costs.begin(), costs.end(), real_t(0))/
+        (numPixels*real_t(_numPrePassSamples));
+    _imageVariance = sumVariance/numPixels;
+  }
+
 } // namespace rt
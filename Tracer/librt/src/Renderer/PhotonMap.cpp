@@ -0,0 +1,164 @@
+/****************************************************************************
+** Copyright (c) 2021, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#include <algorithm>
+
+#include "rt/Renderer/PhotonMap.h"
+
+namespace rt {
+
+  namespace priv {
+
+    inline real_t component(const Vertex& v, const uint_t axis)
+    {
+      return axis == 0
+          ? v.x
+          : axis == 1
+            ? v.y
+            : v.z;
+    }
+
+  } // namespace priv
+
+  ////// public //////////////////////////////////////////////////////////////
+
+  void PhotonMap::build(Photons&& photons)
+  {
+    _photons = std::move(photons);
+    _photons.shrink_to_fit();
+    build(0, _photons.size());
+  }
+
+  void PhotonMap::clear()
+  {
+    _photons.clear();
+    _photons.shrink_to_fit();
+  }
+
+  bool PhotonMap::isEmpty() const
+  {
+    return _photons.empty();
+  }
+
+  size_t PhotonMap::memory() const
+  {
+    return _photons.capacity()*sizeof(Photon);
+  }
+
+  size_t PhotonMap::size() const
+  {
+    return _photons.size();
+  }
+
+  void PhotonMap::query(const Vertex& P, const real_t radius, const Callback& callback) const
+  {
+    if( _photons.empty()  ||  radius <= ZERO ) {
+      return;
+    }
+    query(0, _photons.size(), P, radius*radius, callback);
+  }
+
+  ////// private /////////////////////////////////////////////////////////////
+
+  void PhotonMap::build(const size_t lo, const size_t hi)
+  {
+    if( hi - lo < 2 ) {
+      return;
+    }
+
+    // (1) Split Along Axis of Largest Extent ////////////////////////////////
+
+    Vertex pMin{MAX_REAL_T, MAX_REAL_T, MAX_REAL_T};
+    Vertex pMax{MIN_REAL_T, MIN_REAL_T, MIN_REAL_T};
+    for(size_t i = lo; i < hi; i++) {
+      const Vertex& P = _photons[i].P;
+      pMin = Vertex{std::min(pMin.x, P.x), std::min(pMin.y, P.y), std::min(pMin.z, P.z)};
+      pMax = Vertex{std::max(pMax.x, P.x), std::max(pMax.y, P.y), std::max(pMax.z, P.z)};
+    }
+
+    const Vertex extent = pMax - pMin;
+    const uint_t   axis = extent.x >= extent.y  &&  extent.x >= extent.z
+        ? 0
+        : extent.y >= extent.z
+          ? 1
+          : 2;
+
+    // (2) Partition Around Median ///////////////////////////////////////////
+
+    const size_t mid = lo + (hi - lo)/2;
+    std::nth_element(_photons.begin() + lo, _photons.begin() + mid, _photons.begin() + hi,
+                     [=](const Photon& a, const Photon& b) -> bool {
+      return priv::component(a.P, axis) < priv::component(b.P, axis);
+    });
+    _photons[mid].axis = axis;
+
+    // (3) Recurse ///////////////////////////////////////////////////////////
+
+    build(lo, mid);
+    build(mid + 1, hi);
+  }
+
+  void PhotonMap::query(const size_t lo, const size_t hi, const Vertex& P, const real_t radius2,
+                        const Callback& callback) const
+  {
+    if( lo >= hi ) {
+      return;
+    }
+
+    const size_t     mid = lo + (hi - lo)/2;
+    const Photon& photon = _photons[mid];
+
+    const Vertex     delta = photon.P - P;
+    const real_t distance2 = n4::dot(delta, delta);
+    if( distance2 <= radius2 ) {
+      callback(photon, distance2);
+    }
+
+    if( hi - lo < 2 ) {
+      return;
+    }
+
+    // NOTE: Descend into the half containing 'P' first!
+    const real_t d = priv::component(P, photon.axis) - priv::component(photon.P, photon.axis);
+    if( d < ZERO ) {
+      query(lo, mid, P, radius2, callback);
+      if( d*d <= radius2 ) {
+        query(mid + 1, hi, P, radius2, callback);
+      }
+    } else {
+      query(mid + 1, hi, P, radius2, callback);
+      if( d*d <= radius2 ) {
+        query(lo, mid, P, radius2, callback);
+      }
+    }
+  }
+
+} // namespace rt
@@ -0,0 +1,445 @@
+/****************************************************************************
+** Copyright (c) 2021, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#include <algorithm>
+#include <chrono>
+#include <execution>
+
+#include "rt/Renderer/PhotonMappingRenderer.h"
+
+#include "rt/Object/IObject.h"
+#include "rt/Object/SurfaceInfo.h"
+#include "rt/Renderer/RenderUtils.h"
+#include "rt/Sampler/Sampling.h"
+#include "rt/Scene/Scene.h"
+
+namespace rt {
+
+  namespace priv {
+
+    using Clock = std::chrono::steady_clock;
+
+    inline constexpr size_t PHOTON_CHUNK = 4096;
+
+    inline constexpr size_t PHOTON_WAVE = 16; // Chunks
+
+    inline constexpr real_t PHOTON_ALPHA = real_t(2)/real_t(3);
+
+    inline const IBxDF::Flags NON_SPECULAR = IBxDF::Flags(IBxDF::AllFlags & ~IBxDF::Specular);
+
+    inline real_t elapsed(const Clock::time_point& begin)
+    {
+      return std::chrono::duration<real_t,std::milli>(Clock::now() - begin).count();
+    }
+
+    inline bool isDiffuse(const SurfaceInfo& surface)
+    {
+      return surface->material()->bsdf()->count(NON_SPECULAR) > 0;
+    }
+
+    struct PhotonChunk {
+      Photons photons{};
+      size_t numEmitted{0};
+    };
+
+    /*
+     * NOTE:
+     * Only caustic photons (i.e. paths L S+ D) are stored;
+     * the power is NOT yet normalized by the number of emitted photons!
+     */
+    void tracePhoton(const Scene& scene, const SamplerPtr& sampler,
+                     const uint_t maxDepth, Photons *photons)
+    {
+      const Lights& lights = scene.lights();
+
+      // (1) Sample Light Ray ////////////////////////////////////////////////
+
+      const size_t   choice = sampling::choose(sampler->sample(), lights.size());
+      const LightPtr& light = *std::next(lights.cbegin(), choice);
+
+      const Sample2D xiPos = sampler->sample2D();
+      const Sample2D xiDir = sampler->sample2D();
+
+      Ray        ray;
+      Normal       N;
+      real_t  pdfPos{0}, pdfDir{0};
+      const Color Le = light->sampleLe(xiPos, xiDir, &ray, &N, &pdfPos, &pdfDir);
+      if( pdfPos <= ZERO  ||  pdfDir <= ZERO  ||  Le.isZero() ) {
+        return;
+      }
+
+      const real_t absCosTo = N.isZero()
+          ? ONE
+          : geom::absDot(N, ray.direction());
+      Color beta = Le*absCosTo*real_t(lights.size())/(pdfPos*pdfDir);
+
+      // (2) Follow Specular Bounces /////////////////////////////////////////
+
+      bool is_caustic = false;
+      for(uint_t bounces = 0; bounces < maxDepth; bounces++) {
+        SurfaceInfo surface;
+        if( !scene.intersect(&surface, ray) ) {
+          break;
+        }
+
+        if( isDiffuse(surface) ) {
+          if( is_caustic ) {
+            Photon photon;
+            photon.P     = surface.P;
+            photon.wi    = surface.wo;
+            photon.N     = surface.N;
+            photon.power = beta;
+            photons->push_back(photon);
+          }
+          break;
+        }
+
+        const BSDF *bsdf = surface->material()->bsdf();
+
+        real_t                pdf{0};
+        IBxDF::Flags sampled_flags{IBxDF::InvalidFlags};
+        Direction               wi;
+        const Color         f = bsdf->sample(surface, &wi, sampler->sample2D(), &pdf,
+                                             IBxDF::AllFlags, &sampled_flags);
+        const real_t absCosTi = geom::absDot(wi, surface.N);
+        if( pdf <= ZERO  ||  absCosTi == ZERO  ||  f.isZero() ) {
+          break;
+        }
+
+        beta *= f*absCosTi*adjointScale(surface, sampled_flags)/pdf;
+        is_caustic = true;
+        ray = surface.ray(wi);
+      }
+    }
+
+  } // namespace priv
+
+  ////// public //////////////////////////////////////////////////////////////
+
+  PhotonMappingRenderer::PhotonMappingRenderer(const RenderOptions& options) noexcept
+    : IRenderer(options)
+  {
+  }
+
+  PhotonMappingRenderer::~PhotonMappingRenderer() noexcept
+  {
+  }
+
+  size_t PhotonMappingRenderer::maxMemory() const
+  {
+    return _maxMemory;
+  }
+
+  void PhotonMappingRenderer::setMaxMemory(const size_t numBytes)
+  {
+    _maxMemory = std::max<size_t>(sizeof(Photon), numBytes);
+  }
+
+  size_t PhotonMappingRenderer::numPasses() const
+  {
+    return _numPasses;
+  }
+
+  void PhotonMappingRenderer::setNumPasses(const size_t numPasses)
+  {
+    _numPasses = std::max<size_t>(1, numPasses);
+  }
+
+  size_t PhotonMappingRenderer::numPhotons() const
+  {
+    return _numPhotons;
+  }
+
+  void PhotonMappingRenderer::setNumPhotons(const size_t numPhotons)
+  {
+    _numPhotons = numPhotons;
+  }
+
+  real_t PhotonMappingRenderer::radius() const
+  {
+    return _radius;
+  }
+
+  void PhotonMappingRenderer::setRadius(const real_t r)
+  {
+    _radius = std::max<real_t>(0, r);
+  }
+
+  void PhotonMappingRenderer::beginFrame(const ScenePtr& scene, const CameraPtr& /*camera*/,
+                                         const SamplerPtr& sampler)
+  {
+    _passes.clear();
+    _stats = PhotonStats();
+    _numQueries  = 0;
+    _nsecQueries = 0;
+
+    shootPhotons(scene, sampler);
+  }
+
+  PhotonStats PhotonMappingRenderer::stats() const
+  {
+    PhotonStats result = _stats;
+    result.numQueries  = _numQueries.load();
+    result.msecQueries = real_t(_nsecQueries.load())/real_t(1e6);
+    return result;
+  }
+
+  RenderStats PhotonMappingRenderer::statistics() const
+  {
+    const PhotonStats s = stats();
+    return RenderStats{
+      {"Photons emitted", double(s.numEmitted)},
+      {"Photons stored", double(s.numStored)},
+      {"Photon passes", double(_passes.size())},
+      {"Photon memory [MiB]", double(s.memory)/double(1 << 20)},
+      {"Photon memory cap [MiB]", double(_maxMemory)/double(1 << 20)},
+      {"Photon shooting [ms]", double(s.msecShoot)},
+      {"Photon map build [ms]", double(s.msecBuild)},
+      {"Photon queries", double(s.numQueries)},
+      {"Photon queries [ms]", double(s.msecQueries)}
+    };
+  }
+
+  RendererPtr PhotonMappingRenderer::create(const RenderOptions& options)
+  {
+    return std::make_unique<PhotonMappingRenderer>(options);
+  }
+
+  ////// private /////////////////////////////////////////////////////////////
+
+  Color PhotonMappingRenderer::estimateCaustics(const SurfaceInfo& surface, const Pass& pass) const
+  {
+    if( pass.map.isEmpty() ) {
+      return Color();
+    }
+
+    const priv::Clock::time_point begin = priv::Clock::now();
+
+    const BSDF *bsdf = surface->material()->bsdf();
+
+    Color sum;
+    pass.map.query(surface.P, pass.radius, [&](const Photon& photon, const real_t) -> void {
+      // NOTE: Avoid leaking photons across corners & thin objects!
+      if( n4::dot(photon.N, surface.N) < ONE_HALF ) {
+        return;
+      }
+      sum += bsdf->eval(surface, photon.wi, priv::NON_SPECULAR)*photon.power;
+    });
+
+    _numQueries.fetch_add(1, std::memory_order_relaxed);
+    const auto nsec = std::chrono::duration_cast<std::chrono::nanoseconds>(priv::Clock::now() - begin);
+    _nsecQueries.fetch_add(size_t(nsec.count()), std::memory_order_relaxed);
+
+    return sum/(PI*pass.radius*pass.radius);
+  }
+
+  Color PhotonMappingRenderer::primaryRadiance(Ray *ray, const size_t x, const size_t y,
+                                               const size_t s, const ScenePtr& scene,
+                                               const CameraPtr& camera,
+                                               const SamplerPtr& sampler) const
+  {
+    SurfaceInfo ref;
+    SCENE(scene)->intersectPrimary(&ref, ray, x, y, s, view(), camera, sampler);
+    return trace(*ray, &ref, *SCENE(scene), sampler);
+  }
+
+  Color PhotonMappingRenderer::radiance(const Ray& ray, const ScenePtr& scene,
+                                        const SamplerPtr& sampler,
+                                        const uint_t /*depth*/, const Color& /*throughput*/) const
+  {
+    return trace(ray, nullptr, *SCENE(scene), sampler);
+  }
+
+  void PhotonMappingRenderer::shootPhotons(const ScenePtr& _scene, const SamplerPtr& sampler)
+  {
+    const Scene *scene = SCENE(_scene);
+    if( scene == nullptr  ||  scene->lights().empty()  ||  _numPhotons < 1 ) {
+      return;
+    }
+
+    const size_t maxStored = std::max<size_t>(1, _maxMemory/sizeof(Photon)/_numPasses);
+    const size_t numChunks = (_numPhotons + priv::PHOTON_CHUNK - 1)/priv::PHOTON_CHUNK;
+
+    real_t radius2 = _radius*_radius;
+
+    _passes.resize(_numPasses);
+    for(size_t i = 0; i < _passes.size(); i++) {
+      // (1) Shoot Photons in Parallel ///////////////////////////////////////
+
+      const priv::Clock::time_point shoot_begin = priv::Clock::now();
+
+      /*
+       * NOTE:
+       * Chunks are traced in waves of fixed size and merged in index order;
+       * the first chunk exceeding the memory cap ends the pass. Hence the kept photons
+       * are always the same prefix of chunks, independent of the scheduling, and their
+       * power is normalized by the number of photons emitted by that prefix.
+       */
+      Photons photons;
+      size_t numEmitted = 0;
+      bool is_full = false;
+      for(size_t first = 0; first < numChunks  &&  !is_full; first += priv::PHOTON_WAVE) {
+        std::vector<priv::PhotonChunk> chunks(std::min(priv::PHOTON_WAVE, numChunks - first));
+        std::for_each(std::execution::par,
+                      chunks.begin(), chunks.end(), [&](priv::PhotonChunk& chunk) -> void {
+          const size_t      index = first + size_t(&chunk - chunks.data());
+          const size_t numPhotons = std::min(priv::PHOTON_CHUNK, _numPhotons - index*priv::PHOTON_CHUNK);
+
+          const SamplerPtr mysampler = sampler->copy();
+          mysampler->beginStream(i*numChunks + index);
+          for(size_t j = 0; j < numPhotons; j++) {
+            priv::tracePhoton(*scene, mysampler, options().maxDepth, &chunk.photons);
+          }
+          chunk.numEmitted = numPhotons;
+        });
+
+        for(priv::PhotonChunk& chunk : chunks) {
+          if( photons.size() + chunk.photons.size() > maxStored ) {
+            is_full = true;
+            break;
+          }
+          photons.insert(photons.end(), chunk.photons.begin(), chunk.photons.end());
+          numEmitted += chunk.numEmitted;
+        }
+      }
+
+      if( numEmitted > 0 ) {
+        for(Photon& photon : photons) {
+          photon.power /= real_t(numEmitted);
+        }
+      }
+
+      _stats.msecShoot += priv::elapsed(shoot_begin);
+
+      // (2) Build Photon Map ////////////////////////////////////////////////
+
+      const priv::Clock::time_point build_begin = priv::Clock::now();
+
+      Pass& pass = _passes[i];
+      pass.map.build(std::move(photons));
+      pass.radius = Math::sqrt(radius2);
+
+      _stats.msecBuild  += priv::elapsed(build_begin);
+      _stats.numEmitted += numEmitted;
+      _stats.numStored  += pass.map.size();
+      _stats.memory     += pass.map.memory();
+
+      // (3) Shrink Radius for Next Pass /////////////////////////////////////
+
+      radius2 *= (real_t(i + 1) + priv::PHOTON_ALPHA)/real_t(i + 2);
+    }
+  }
+
+  Color PhotonMappingRenderer::trace(const Ray& _ray, const SurfaceInfo *primary,
+                                     const Scene& scene, const SamplerPtr& sampler) const
+  {
+    const RenderOptions& options = PhotonMappingRenderer::options();
+
+    const Pass *pass = !_passes.empty()
+        ? &_passes[sampling::choose(sampler->sample(), _passes.size())]
+        : nullptr;
+
+    Color              beta(1);
+    Color                 L;
+    Ray                 ray{_ray};
+    bool is_specular_bounce = false;
+    bool   is_diffuse_found = false;
+
+    // Find next path vertex and accumulate contribution
+    for(uint_t bounces = 0; ; bounces++) {
+      // Intersect ray with scene (or reuse the primary hit) and store intersection in 'ref'
+      SurfaceInfo ref;
+      if( bounces == 0  &&  primary != nullptr ) {
+        ref = *primary;
+      } else {
+        scene.intersect(&ref, ray);
+      }
+      const bool is_intersect = ref.isHit();
+
+      // Possibly add emitted light at intersection
+      if( bounces == 0  ||  is_specular_bounce ) {
+        /*
+         * NOTE:
+         * Light reaching a diffuse vertex via specular bounces only
+         * is a caustic, which is accounted for by the photon map!
+         */
+        if(        is_intersect  &&  (!is_diffuse_found  ||  pass == nullptr) ) {
+          L += beta*ref.Le(ref.wo);
+        } else if( !is_intersect ) {
+          L += beta*scene.Le(ray);
+        }
+      }
+
+      // Terminate path if ray escaped or maxDepth was reached
+      if( !is_intersect  ||  bounces >= options.maxDepth ) {
+        break;
+      }
+
+      // Sample illumination from lights & caustics to find path contribution
+      L += beta*uniformSampleOneLight(ref, scene, sampler);
+      if( pass != nullptr  &&  priv::isDiffuse(ref) ) {
+        L += beta*estimateCaustics(ref, *pass);
+      }
+
+      // Sample BSDF to get new path direction
+      const BSDF *bsdf = ref->material()->bsdf();
+
+      real_t              pdfRef{0};
+      IBxDF::Flags sampled_flags{IBxDF::InvalidFlags};
+      Direction               wi;
+      const Color         f = bsdf->sample(ref, &wi, sampler->sample2D(), &pdfRef,
+                                           IBxDF::AllFlags, &sampled_flags);
+      const real_t absCosTi = geom::absDot(wi, ref.N);
+      if( pdfRef <= ZERO  ||  absCosTi == ZERO  ||  f.isZero() ) {
+        break;
+      }
+
+      beta *= f*absCosTi/pdfRef;
+      is_specular_bounce = isSpecular(sampled_flags);
+      if( !is_specular_bounce ) {
+        is_diffuse_found = true;
+      }
+      ray = ref.ray(wi);
+
+      // Possibly terminate the path with Russian roulette
+      if( bounces > 3 ) {
+        const real_t q = std::max<real_t>(0.0625, ONE - beta.max());
+        if( sampler->sample() < q ) {
+          break;
+        }
+        beta /= ONE - q;
+      }
+    }
+
+    return L;
+  }
+
+} // namespace rt
@@ -0,0 +1,173 @@
+/****************************************************************************
+** Copyright (c) 2021, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#include <algorithm>
+#include <cmath>
+
+#include "rt/Renderer/RadianceCache.h"
+
+namespace rt {
+
+  ////// public //////////////////////////////////////////////////////////////
+
+  RadianceCache::RadianceCache() noexcept
+  {
+  }
+
+  RadianceCache::~RadianceCache() noexcept
+  {
+  }
+
+  void RadianceCache::clear()
+  {
+    _bounds = Bounds();
+    _res[0] = _res[1] = _res[2] = 0;
+    _cells.clear();
+  }
+
+  void RadianceCache::reset(const Bounds& bounds, const size_t resolution)
+  {
+    clear();
+    if( !bounds.isValid()  ||  resolution < 1 ) {
+      return;
+    }
+
+    // NOTE: The longest axis is divided into 'resolution' cells, the others proportionally.
+    const Vertex    ext = bounds.max() - bounds.min();
+    const real_t extMax = std::max<real_t>({ext.x, ext.y, ext.z});
+    if( extMax <= ZERO ) {
+      return;
+    }
+
+    const real_t cellSize = extMax/real_t(resolution);
+    const real_t    ext3[3] = {ext.x, ext.y, ext.z};
+    for(size_t i = 0; i < 3; i++) {
+      _res[i] = std::clamp<size_t>(size_t(std::ceil(ext3[i]/cellSize)), 1, resolution);
+    }
+
+    _bounds = bounds;
+    _cells  = std::vector<Cell>(_res[0]*_res[1]*_res[2]);
+  }
+
+  // NOTE: 'L2' is a second estimate of the radiance leaving the vertex, independent of 'L'.
+  void RadianceCache::record(const Vertex& P, const real_t L, const real_t cost, const real_t L2)
+  {
+    size_t index = 0;
+    if( !std::isfinite(L)  ||  L < ZERO  ||  !std::isfinite(L2)  ||  L2 < ZERO  ||
+        !cellIndex(&index, P) ) {
+      return;
+    }
+
+    Cell& cell = _cells[index];
+    cell.sum.fetch_add(L, std::memory_order_relaxed);
+    cell.sum2.fetch_add(L*L, std::memory_order_relaxed);
+    cell.sumVar.fetch_add((L - L2)*(L - L2)*ONE_HALF, std::memory_order_relaxed);
+    cell.cost.fetch_add(cost, std::memory_order_relaxed);
+    cell.count.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  bool RadianceCache::lookup(RadianceStats *stats, const Vertex& P, const size_t minRecords) const
+  {
+    size_t index = 0;
+    if( !cellIndex(&index, P) ) {
+      return false;
+    }
+
+    const Cell&   cell = _cells[index];
+    const size_t   count = cell.count.load(std::memory_order_relaxed);
+    if( count < std::max<size_t>(1, minRecords) ) {
+      return false;
+    }
+
+    stats->mean     = cell.sum.load(std::memory_order_relaxed)/real_t(count);
+    stats->moment2  = cell.sum2.load(std::memory_order_relaxed)/real_t(count);
+    stats->variance = cell.sumVar.load(std::memory_order_relaxed)/real_t(count);
+    stats->cost     = cell.cost.load(std::memory_order_relaxed)/real_t(count);
+
+    return true;
+  }
+
+  bool RadianceCache::isEmpty() const
+  {
+    return _cells.empty();
+  }
+
+  size_t RadianceCache::numCells() const
+  {
+    return _cells.size();
+  }
+
+  size_t RadianceCache::numRecords() const
+  {
+    size_t numRecords = 0;
+    for(const Cell& cell : _cells) {
+      numRecords += cell.count.load(std::memory_order_relaxed);
+    }
+    return numRecords;
+  }
+
+  ////// private /////////////////////////////////////////////////////////////
+
+  RadianceCache::Cell::Cell() noexcept
+    : sum{0}
+    , sum2{0}
+    , sumVar{0}
+    , cost{0}
+    , count{0}
+  {
+  }
+
+  bool RadianceCache::cellIndex(size_t *index, const Vertex& P) const
+  {
+    if( _cells.empty() ) {
+      return false;
+    }
+
+    const Vertex    min = _bounds.min();
+    const Vertex    ext = _bounds.max() - min;
+    const real_t   p3[3] = {P.x - min.x, P.y - min.y, P.z - min.z};
+    const real_t ext3[3] = {ext.x, ext.y, ext.z};
+
+    size_t cell[3] = {0, 0, 0};
+    for(size_t i = 0; i < 3; i++) {
+      if( p3[i] < ZERO  ||  p3[i] > ext3[i] ) {
+        return false;
+      }
+      if( ext3[i] > ZERO ) {
+        cell[i] = std::min<size_t>(size_t(p3[i]/ext3[i]*real_t(_res[i])), _res[i] - 1);
+      }
+    }
+
+    *index = (cell[2]*_res[1] + cell[1])*_res[0] + cell[0];
+    return true;
+  }
+
+} // namespace rt
@@ -31,7 +31,8 @@
 
 #include "rt/Renderer/RenderUtils.h"
 
-#include "rt/BxDF/IBxDF.h"
+#include "geom/Shading.h"
+#include "rt/BxDF/SpecularTransmissionBTDF.h"
 #include "rt/Light/IAreaLight.h"
 #include "rt/Object/IObject.h"
 #include "rt/Object/SurfaceInfo.h"
@@ -83,7 +84,9 @@ namespace rt {
           ? lightInfo->areaLight() == IAREALIGHT(light)
             ? lightInfo.Le(-wi) // Area light's emittance.
             : Color()
-          : scene.backgroundColor();
+          : light->isInfiniteLight()
+            ? light->Le(ray)    // Infinite light's radiance.
+            : scene.backgroundColor();
       if( Li.isZero() ) { // Light does not contribute...
         return Color();
       }
@@ -135,6 +138,22 @@ namespace rt {
 
   } // namespace priv
 
+  real_t adjointScale(const SurfaceInfo& surface, const IBxDF::Flags sampled_flags)
+  {
+    if( !isSpecular(sampled_flags)  ||  !isTransmission(sampled_flags) ) {
+      return 1;
+    }
+    const BSDF *bsdf = surface->material()->bsdf();
+    for(size_t i = 0; i < bsdf->size(); i++) {
+      const SpecularTransmissionBTDF *btdf = bsdf->asBxDF<SpecularTransmissionBTDF>(i);
+      if( btdf != nullptr ) {
+        const real_t eta = geom::shading::boundaryEta(surface.woS, ONE, btdf->refraction());
+        return ONE/eta/eta;
+      }
+    }
+    return 1;
+  }
+
   Color estimateDirectLighting(const SurfaceInfo& ref, const Sample2D& xiRef,
                                const LightPtr& light, const Sample2D& xiLight,
                                const Scene& scene, const bool do_specular)
@@ -0,0 +1,499 @@
+/****************************************************************************
+** Copyright (c) 2021, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#include <algorithm>
+#include <cmath>
+#include <tuple>
+
+#include "rt/Renderer/SDTree.h"
+
+namespace rt {
+
+  namespace priv {
+
+    inline constexpr real_t DTREE_THRESHOLD = 0.01;
+
+    inline constexpr uint_t DTREE_MAX_DEPTH = 20;
+
+    inline constexpr real_t ONE_MINUS_EPSILON = ONE - real_t(0x1p-20);
+
+    inline real_t component(const Vertex& v, const uint_t axis)
+    {
+      return axis == 0
+          ? v.x
+          : axis == 1
+            ? v.y
+            : v.z;
+    }
+
+    inline real_t clamp01(const real_t x)
+    {
+      return std::clamp<real_t>(x, 0, ONE_MINUS_EPSILON);
+    }
+
+    inline std::tuple<real_t,real_t> toCanonical(const Direction& wi)
+    {
+      const real_t cosTheta = std::clamp<real_t>(wi.z, -1, 1);
+      real_t phi = std::atan2(wi.y, wi.x);
+      if( phi < ZERO ) {
+        phi += TWO_PI;
+      }
+      return {clamp01((cosTheta + ONE)/TWO), clamp01(phi/TWO_PI)};
+    }
+
+    inline Direction fromCanonical(const real_t u, const real_t v)
+    {
+      const real_t cosTheta = TWO*u - ONE;
+      const real_t sinTheta = Math::sqrt(std::max<real_t>(0, ONE - cosTheta*cosTheta));
+      return geom::spherical(sinTheta, cosTheta, TWO_PI*v);
+    }
+
+    inline size_t quadrant(real_t *u, real_t *v)
+    {
+      const size_t col = *u >= ONE_HALF ? 1 : 0;
+      const size_t row = *v >= ONE_HALF ? 1 : 0;
+      *u = clamp01(TWO*(*u) - real_t(col));
+      *v = clamp01(TWO*(*v) - real_t(row));
+      return 2*row + col;
+    }
+
+    // Choose between two halves & remap 'xi' to [0,1)
+    inline size_t choose(real_t *xi, const real_t sum0, const real_t sum1)
+    {
+      const real_t p0 = sum0/(sum0 + sum1);
+      if( *xi < p0 ) {
+        *xi = clamp01(*xi/p0);
+        return 0;
+      }
+      *xi = clamp01((*xi - p0)/(ONE - p0));
+      return 1;
+    }
+
+  } // namespace priv
+
+  ////// DTree - public //////////////////////////////////////////////////////
+
+  DTree::DTree() noexcept
+    : _nodes(1)
+  {
+  }
+
+  DTree::~DTree() noexcept
+  {
+  }
+
+  DTree::DTree(const DTree& other) noexcept
+    : _nodes{other._nodes}
+    , _numSamples{other.numSamples()}
+  {
+  }
+
+  DTree& DTree::operator=(const DTree& other) noexcept
+  {
+    if( this != &other ) {
+      _nodes = other._nodes;
+      _numSamples.store(other.numSamples(), std::memory_order_relaxed);
+    }
+    return *this;
+  }
+
+  bool DTree::isEmpty() const
+  {
+    return total() <= ZERO;
+  }
+
+  size_t DTree::numNodes() const
+  {
+    return _nodes.size();
+  }
+
+  size_t DTree::numSamples() const
+  {
+    return _numSamples.load(std::memory_order_relaxed);
+  }
+
+  void DTree::setNumSamples(const size_t numSamples)
+  {
+    _numSamples.store(numSamples, std::memory_order_relaxed);
+  }
+
+  real_t DTree::pdf(const Direction& wi) const
+  {
+    if( isEmpty() ) {
+      return ONE/FOUR_PI;
+    }
+
+    auto [u, v] = priv::toCanonical(wi);
+
+    real_t pdf = 1;
+    for(size_t index = 0; ; ) {
+      const Node& node = _nodes[index];
+      const real_t total = node.total();
+      if( total <= ZERO ) {
+        return 0;
+      }
+
+      const size_t i = priv::quadrant(&u, &v);
+      pdf *= real_t(4)*node.sum(i)/total;
+
+      if( node.children[i] == 0 ) {
+        break;
+      }
+      index = node.children[i];
+    }
+
+    return pdf/FOUR_PI;
+  }
+
+  Direction DTree::sample(const Sample2D& xi, real_t *pdf) const
+  {
+    SAMPLES_2D(xi);
+
+    real_t u = xi1, v = xi2;
+    if( isEmpty() ) {
+      *pdf = ONE/FOUR_PI;
+      return priv::fromCanonical(u, v);
+    }
+
+    // NOTE: Choose a row (i.e. 'v') first, then a column (i.e. 'u') within the row.
+    real_t  originU = 0, originV = 0;
+    real_t     size = 1;
+    real_t  density = 1;
+    for(size_t index = 0; ; ) {
+      const Node& node = _nodes[index];
+      const real_t total = node.total();
+      if( total <= ZERO ) {
+        *pdf = 0;
+        return Direction();
+      }
+
+      const size_t row = priv::choose(&v, node.sum(0) + node.sum(1), node.sum(2) + node.sum(3));
+      const size_t col = priv::choose(&u, node.sum(2*row), node.sum(2*row + 1));
+      const size_t   i = 2*row + col;
+
+      density *= real_t(4)*node.sum(i)/total;
+
+      size /= TWO;
+      originU += real_t(col)*size;
+      originV += real_t(row)*size;
+
+      if( node.children[i] == 0 ) {
+        break;
+      }
+      index = node.children[i];
+    }
+
+    *pdf = density/FOUR_PI;
+    return priv::fromCanonical(originU + u*size, originV + v*size);
+  }
+
+  void DTree::record(const Direction& wi, const real_t value)
+  {
+    _numSamples.fetch_add(1, std::memory_order_relaxed);
+    if( !std::isfinite(value)  ||  value <= ZERO ) {
+      return;
+    }
+
+    auto [u, v] = priv::toCanonical(wi);
+
+    for(size_t index = 0; ; ) {
+      Node& node = _nodes[index];
+      const size_t i = priv::quadrant(&u, &v);
+      node.sums[i].fetch_add(value, std::memory_order_relaxed);
+
+      if( node.children[i] == 0 ) {
+        break;
+      }
+      index = node.children[i];
+    }
+  }
+
+  /*
+   * NOTE:
+   * The new topology subdivides all quadrants holding more than 'threshold' of the
+   * total energy; quadrants lacking a node inherit a quarter of their parent's
+   * energy per sub-quadrant. All sums & the number of samples are reset.
+   */
+  void DTree::refine(const real_t threshold, const uint_t maxDepth, const size_t maxNodes)
+  {
+    struct Item {
+      uint32_t index{0};
+      uint32_t  prev{0};
+      bool have_prev{false};
+      std::array<real_t,4> energy{};
+      uint_t depth{0};
+    };
+
+    std::vector<Node> nodes(1);
+
+    if( const real_t total = DTree::total(); total > ZERO ) {
+      std::vector<Item> stack;
+
+      Item root;
+      root.have_prev = true;
+      root.depth     = 1;
+      for(size_t i = 0; i < 4; i++) {
+        root.energy[i] = _nodes[0].sum(i);
+      }
+      stack.push_back(root);
+
+      while( !stack.empty() ) {
+        const Item item = stack.back();
+        stack.pop_back();
+
+        for(size_t i = 0; i < 4; i++) {
+          if( item.energy[i] <= threshold*total  ||  item.depth >= maxDepth  ||
+              nodes.size() >= maxNodes ) {
+            continue;
+          }
+
+          const uint32_t child = uint32_t(nodes.size());
+          nodes.emplace_back();
+          nodes[item.index].children[i] = child;
+
+          Item next;
+          next.index = child;
+          next.depth = item.depth + 1;
+          if( item.have_prev  &&  _nodes[item.prev].children[i] != 0 ) {
+            next.prev      = _nodes[item.prev].children[i];
+            next.have_prev = true;
+            for(size_t j = 0; j < 4; j++) {
+              next.energy[j] = _nodes[next.prev].sum(j);
+            }
+          } else {
+            next.energy.fill(item.energy[i]/real_t(4));
+          }
+          stack.push_back(next);
+        }
+      }
+    }
+
+    _nodes = std::move(nodes);
+    _numSamples.store(0, std::memory_order_relaxed);
+  }
+
+  size_t DTree::nodeSize()
+  {
+    return sizeof(Node);
+  }
+
+  ////// DTree - private /////////////////////////////////////////////////////
+
+  DTree::Node::Node() noexcept
+  {
+    for(std::atomic<real_t>& s : sums) {
+      s.store(0, std::memory_order_relaxed);
+    }
+    children.fill(0);
+  }
+
+  DTree::Node::Node(const Node& other) noexcept
+  {
+    operator=(other);
+  }
+
+  DTree::Node& DTree::Node::operator=(const Node& other) noexcept
+  {
+    for(size_t i = 0; i < 4; i++) {
+      sums[i].store(other.sum(i), std::memory_order_relaxed);
+    }
+    children = other.children;
+    return *this;
+  }
+
+  real_t DTree::Node::sum(const size_t i) const
+  {
+    return sums[i].load(std::memory_order_relaxed);
+  }
+
+  real_t DTree::Node::total() const
+  {
+    return sum(0) + sum(1) + sum(2) + sum(3);
+  }
+
+  real_t DTree::total() const
+  {
+    return _nodes[0].total();
+  }
+
+  ////// SDTree - public /////////////////////////////////////////////////////
+
+  SDTree::SDTree() noexcept
+  {
+  }
+
+  SDTree::~SDTree() noexcept
+  {
+  }
+
+  void SDTree::clear()
+  {
+    _leaves.clear();
+    _nodes.clear();
+  }
+
+  void SDTree::reset()
+  {
+    clear();
+
+    _nodes.resize(1);
+    _leaves.resize(1);
+  }
+
+  void SDTree::setBounds(const Bounds& bounds)
+  {
+    if( _nodes.size() == 1 ) {
+      _nodes[0].bounds = bounds;
+    }
+  }
+
+  bool SDTree::isEmpty() const
+  {
+    return _nodes.empty();
+  }
+
+  size_t SDTree::memory() const
+  {
+    size_t numNodes = 0;
+    for(const Leaf& leaf : _leaves) {
+      numNodes += leaf.sampling.numNodes() + leaf.building.numNodes();
+    }
+    return _nodes.size()*sizeof(Node) + _leaves.size()*sizeof(Leaf) + numNodes*DTree::nodeSize();
+  }
+
+  size_t SDTree::numLeaves() const
+  {
+    return _leaves.size();
+  }
+
+  size_t SDTree::leafIndex(const Vertex& P) const
+  {
+    size_t index = 0;
+    while( _nodes[index].children[0] != 0 ) {
+      const Node& node = _nodes[index];
+      const real_t mid = (priv::component(node.bounds.min(), node.axis) +
+                          priv::component(node.bounds.max(), node.axis))/TWO;
+      index = priv::component(P, node.axis) < mid
+          ? node.children[0]
+          : node.children[1];
+    }
+    return _nodes[index].leaf;
+  }
+
+  const DTree *SDTree::samplingTree(const size_t leaf) const
+  {
+    return &_leaves[leaf].sampling;
+  }
+
+  void SDTree::record(const size_t leaf, const Direction& wi, const real_t value)
+  {
+    _leaves[leaf].building.record(wi, value);
+  }
+
+  void SDTree::refine(const size_t threshold, const size_t maxMemory)
+  {
+    if( isEmpty() ) {
+      return;
+    }
+
+    // (1) Subdivide Space ///////////////////////////////////////////////////
+
+    // NOTE: Nodes appended by split() are visited, too.
+    for(size_t i = 0; i < _nodes.size(); i++) {
+      if( _nodes[i].children[0] == 0  &&
+          _leaves[_nodes[i].leaf].building.numSamples() > threshold  &&
+          memory() < maxMemory/2 ) {
+        split(i);
+      }
+    }
+
+    // (2) Freeze Sampling & Refine Building /////////////////////////////////
+
+    const size_t numBytes = _nodes.size()*sizeof(Node) + _leaves.size()*sizeof(Leaf);
+    const size_t maxNodes = std::max<size_t>(1, maxMemory > numBytes
+                                             ? (maxMemory - numBytes)/(2*DTree::nodeSize())/_leaves.size()
+                                             : 1);
+    for(Leaf& leaf : _leaves) {
+      leaf.sampling = leaf.building;
+      leaf.building.refine(priv::DTREE_THRESHOLD, priv::DTREE_MAX_DEPTH, maxNodes);
+    }
+  }
+
+  ////// SDTree - private ////////////////////////////////////////////////////
+
+  void SDTree::split(const size_t index)
+  {
+    const Bounds bounds = _nodes[index].bounds;
+    const size_t   leaf = _nodes[index].leaf;
+
+    // (1) Split Along Axis of Largest Extent ////////////////////////////////
+
+    const Vertex extent = bounds.max() - bounds.min();
+    const uint_t   axis = extent.x >= extent.y  &&  extent.x >= extent.z
+        ? 0
+        : extent.y >= extent.z
+          ? 1
+          : 2;
+
+    Vertex midMin = bounds.min();
+    Vertex midMax = bounds.max();
+    const real_t mid = (priv::component(bounds.min(), axis) + priv::component(bounds.max(), axis))/TWO;
+    if(        axis == 0 ) {
+      midMin.x = midMax.x = mid;
+    } else if( axis == 1 ) {
+      midMin.y = midMax.y = mid;
+    } else {
+      midMin.z = midMax.z = mid;
+    }
+
+    // (2) Children Share the Parent's Distribution & Half Its Samples ///////
+
+    const size_t numSamples = _leaves[leaf].building.numSamples()/2;
+    _leaves[leaf].building.setNumSamples(numSamples);
+    const Leaf copy = _leaves[leaf];
+    _leaves.push_back(copy);
+
+    Node lower;
+    lower.bounds = Bounds(bounds.min(), midMax);
+    lower.leaf   = leaf;
+
+    Node upper;
+    upper.bounds = Bounds(midMin, bounds.max());
+    upper.leaf   = _leaves.size() - 1;
+
+    _nodes[index].axis        = axis;
+    _nodes[index].children[0] = uint32_t(_nodes.size());
+    _nodes[index].children[1] = uint32_t(_nodes.size() + 1);
+    _nodes.push_back(lower);
+    _nodes.push_back(upper);
+  }
+
+} // namespace rt
@@ -54,15 +54,14 @@ namespace rt {
 
   ////// private /////////////////////////////////////////////////////////////
 
-  Color WhittedRenderer::radiance(const Ray& ray, const ScenePtr& _scene,
-                                  const SamplerPtr& sampler,
-                                  const uint_t depth, const Color& /*throughput*/) const
+  Color WhittedRenderer::shade(const Ray& ray, const SurfaceInfo& ref,
+                               const ScenePtr& _scene, const SamplerPtr& sampler,
+                               const uint_t depth) const
   {
     const Scene *scene = SCENE(_scene);
 
-    SurfaceInfo ref;
-    if( !scene->intersect(&ref, ray) ) {
-      return scene->backgroundColor();
+    if( !ref.isHit() ) {
+      return scene->Le(ray);
     }
 
     Color Lo;
@@ -0,0 +1,222 @@
+/****************************************************************************
+** Copyright (c) 2021, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#include <algorithm>
+
+#include "rt/Scene/Animation.h"
+
+#include "rt/Scene/Scene.h"
+
+namespace rt {
+
+  namespace priv {
+
+    template<typename T>
+    inline T lerp3D(const T& a, const T& b, const real_t t)
+    {
+      T result;
+      for(size_t i = 0; i < 3; i++) {
+        result(i) = a(i) + (b(i) - a(i))*t;
+      }
+      return result;
+    }
+
+    template<typename T>
+    inline bool isSame3D(const T& a, const T& b)
+    {
+      return a(0) == b(0)  &&  a(1) == b(1)  &&  a(2) == b(2);
+    }
+
+    /*
+     * NOTE:
+     * Returns the keys enclosing 'frame' & the interpolation parameter 't' in [0,1];
+     * 'keys' must NOT be empty & are sorted by frame.
+     */
+    template<typename KeyT>
+    real_t findKeys(const KeyT **k0, const KeyT **k1,
+                    const std::vector<KeyT>& keys, const real_t frame)
+    {
+      const auto hi = std::upper_bound(keys.begin(), keys.end(), frame,
+                                       [](const real_t f, const KeyT& key) -> bool {
+        return f < key.frame;
+      });
+
+      if(        hi == keys.begin() ) {
+        *k0 = *k1 = &keys.front();
+        return 0;
+      } else if( hi == keys.end() ) {
+        *k0 = *k1 = &keys.back();
+        return 0;
+      }
+
+      *k0 = &*(hi - 1);
+      *k1 = &*hi;
+
+      const real_t span = (*k1)->frame - (*k0)->frame;
+      return span > ZERO
+          ? std::clamp<real_t>((frame - (*k0)->frame)/span, 0, 1)
+          : 0;
+    }
+
+    template<typename KeyT>
+    void insertKey(std::vector<KeyT> *keys, const KeyT& key)
+    {
+      const auto pos = std::upper_bound(keys->begin(), keys->end(), key.frame,
+                                        [](const real_t f, const KeyT& other) -> bool {
+        return f < other.frame;
+      });
+      keys->insert(pos, key);
+    }
+
+  } // namespace priv
+
+  ////// TransformKey - public ///////////////////////////////////////////////
+
+  Transform TransformKey::transform() const
+  {
+    return
+        Transform::translate(translate.x, translate.y, translate.z)*
+        Transform::rotateZYX(rotate.z, rotate.y, rotate.x);
+  }
+
+  ////// Animation - public //////////////////////////////////////////////////
+
+  Animation::Animation() noexcept = default;
+
+  Animation::~Animation() noexcept = default;
+
+  Animation::Animation(Animation&&) noexcept = default;
+
+  Animation& Animation::operator=(Animation&&) noexcept = default;
+
+  void Animation::clear()
+  {
+    _camera.clear();
+    _tracks.clear();
+  }
+
+  bool Animation::isEmpty() const
+  {
+    return _camera.empty()  &&  _tracks.empty();
+  }
+
+  real_t Animation::firstFrame() const
+  {
+    real_t result = _camera.empty()
+        ? MAX_REAL_T
+        : _camera.front().frame;
+    for(const Track& track : _tracks) {
+      result = std::min(result, track.keys.front().frame);
+    }
+    return isEmpty()
+        ? 0
+        : result;
+  }
+
+  real_t Animation::lastFrame() const
+  {
+    real_t result = _camera.empty()
+        ? -MAX_REAL_T
+        : _camera.back().frame;
+    for(const Track& track : _tracks) {
+      result = std::max(result, track.keys.back().frame);
+    }
+    return isEmpty()
+        ? 0
+        : result;
+  }
+
+  void Animation::addCameraKey(const CameraKey& key)
+  {
+    priv::insertKey(&_camera, key);
+  }
+
+  void Animation::addObjectKey(IObject *object, const TransformKey& key)
+  {
+    if( object == nullptr ) {
+      return;
+    }
+
+    auto it = std::find_if(_tracks.begin(), _tracks.end(), [=](const Track& track) -> bool {
+      return track.object == object;
+    });
+    if( it == _tracks.end() ) {
+      _tracks.emplace_back(object);
+      it = std::prev(_tracks.end());
+    }
+
+    priv::insertKey(&it->keys, key);
+  }
+
+  size_t Animation::apply(Scene *scene, RenderOptions *options, const real_t frame)
+  {
+    // (1) Camera ////////////////////////////////////////////////////////////
+
+    if( !_camera.empty() ) {
+      const CameraKey *k0 = nullptr;
+      const CameraKey *k1 = nullptr;
+      const real_t t = priv::findKeys(&k0, &k1, _camera, frame);
+
+      options->eye      = priv::lerp3D(k0->eye, k1->eye, t);
+      options->lookAt   = priv::lerp3D(k0->lookAt, k1->lookAt, t);
+      options->cameraUp = n4::normalize(priv::lerp3D(k0->cameraUp, k1->cameraUp, t));
+    }
+
+    // (2) Objects ///////////////////////////////////////////////////////////
+
+    size_t numUpdated = 0;
+    for(Track& track : _tracks) {
+      const TransformKey *k0 = nullptr;
+      const TransformKey *k1 = nullptr;
+      const real_t t = priv::findKeys(&k0, &k1, track.keys, frame);
+
+      TransformKey key;
+      key.frame     = frame;
+      key.translate = priv::lerp3D(k0->translate, k1->translate, t);
+      key.rotate    = priv::lerp3D(k0->rotate, k1->rotate, t);
+
+      // NOTE: Objects held still between keyframes are left untouched.
+      if( track.have_last  &&
+          priv::isSame3D(key.translate, track.last.translate)  &&
+          priv::isSame3D(key.rotate, track.last.rotate) ) {
+        continue;
+      }
+
+      scene->setObjectToWorld(track.object, key.transform());
+      track.last      = key;
+      track.have_last = true;
+      numUpdated++;
+    }
+
+    return numUpdated;
+  }
+
+} // namespace rt
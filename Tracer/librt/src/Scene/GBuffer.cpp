@@ -0,0 +1,216 @@
+/****************************************************************************
+** Copyright (c) 2021, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#include <typeinfo>
+
+#include "rt/Scene/GBuffer.h"
+
+#include "rt/Sampler/SimpleSampler.h"
+
+namespace rt {
+
+  namespace priv {
+
+    inline bool isSame(const Vertex& a, const Vertex& b)
+    {
+      return a.x == b.x  &&  a.y == b.y  &&  a.z == b.z;
+    }
+
+    inline bool isSame(const Direction& a, const Direction& b)
+    {
+      return a.x == b.x  &&  a.y == b.y  &&  a.z == b.z;
+    }
+
+    // NOTE: Distinct seeds or sample ranges must not share primary hits.
+    inline uint64_t samplerSeed(const SamplerPtr& sampler)
+    {
+      const SimpleSampler *simple = dynamic_cast<const SimpleSampler*>(sampler.get());
+      return simple != nullptr  &&  simple->isSeeded()
+          ? simple->seed() ^ (uint64_t(simple->firstSample()) << 32) ^ 1
+          : 0;
+    }
+
+    inline bool isSameView(const RenderOptions& a, const RenderOptions& b)
+    {
+      return isSame(a.eye, b.eye)  &&  isSame(a.lookAt, b.lookAt)  &&
+          isSame(a.cameraUp, b.cameraUp)  &&
+          a.fov_rad == b.fov_rad  &&  a.worldToScreen == b.worldToScreen  &&
+          a.aperture == b.aperture  &&  a.focus == b.focus;
+    }
+
+  } // namespace priv
+
+  ////// public //////////////////////////////////////////////////////////////
+
+  GBuffer::GBuffer() noexcept
+  {
+  }
+
+  GBuffer::~GBuffer() noexcept
+  {
+  }
+
+  GBuffer::GBuffer(GBuffer&&) noexcept = default;
+
+  GBuffer& GBuffer::operator=(GBuffer&&) noexcept = default;
+
+  size_t GBuffer::maxMemory() const
+  {
+    return _maxMemory;
+  }
+
+  void GBuffer::setMaxMemory(const size_t numBytes)
+  {
+    _maxMemory = numBytes;
+    if( memory() > _maxMemory ) {
+      clear();
+    }
+  }
+
+  void GBuffer::begin(const CameraPtr& camera, const SamplerPtr& sampler,
+                      const RenderOptions& options)
+  {
+    if( !camera  ||  !sampler ) {
+      clear();
+      return;
+    }
+
+    const std::string cameraType = typeid(*camera).name();
+    const size_t      numSamples = sampler->isRandom()
+        ? sampler->numSamplesPerPixel()
+        : 1;
+    const uint64_t          seed = priv::samplerSeed(sampler);
+
+    const bool is_same = !_records.empty()  &&  cameraType == _camera  &&
+        camera->width() == _width  &&  camera->height() == _height  &&
+        numSamples == _numSamples  &&  seed == _seed  &&  priv::isSameView(options, _options);
+    if( is_same ) {
+      return;
+    }
+
+    clear();
+
+    const size_t numRecords = camera->width()*camera->height()*numSamples;
+    if( numRecords < 1  ||  numRecords*sizeof(Record) > _maxMemory ) {
+      return;
+    }
+
+    _camera     = cameraType;
+    _width      = camera->width();
+    _height     = camera->height();
+    _numSamples = numSamples;
+    _seed       = seed;
+    _options    = options;
+    _records.resize(numRecords);
+  }
+
+  void GBuffer::clear()
+  {
+    _camera.clear();
+    _width      = 0;
+    _height     = 0;
+    _numSamples = 0;
+    _seed       = 0;
+    _options    = RenderOptions();
+    _records    = std::vector<Record>();
+  }
+
+  bool GBuffer::isEmpty() const
+  {
+    return _records.empty();
+  }
+
+  size_t GBuffer::memory() const
+  {
+    return _records.size()*sizeof(Record);
+  }
+
+  bool GBuffer::lookup(SurfaceInfo *surface, Ray *ray,
+                       const size_t x, const size_t y, const size_t s) const
+  {
+    size_t i = 0;
+    if( !index(&i, x, y, s)  ||  !_records[i].is_valid ) {
+      return false;
+    }
+
+    const Record& record = _records[i];
+
+    *ray     = record.ray;
+    *surface = SurfaceInfo();
+    if( record.object != nullptr ) {
+      surface->t      = record.t;
+      surface->P      = record.P;
+      surface->N      = record.N;
+      surface->u      = record.u;
+      surface->v      = record.v;
+      surface->object = record.object;
+      surface->initializeShading(record.ray);
+    }
+
+    return true;
+  }
+
+  void GBuffer::store(const size_t x, const size_t y, const size_t s,
+                      const Ray& ray, const SurfaceInfo& surface)
+  {
+    size_t i = 0;
+    if( !index(&i, x, y, s) ) {
+      return;
+    }
+
+    Record& record = _records[i];
+
+    record.ray = ray;
+    if( surface.isHit() ) {
+      record.t      = surface.t;
+      record.P      = surface.P;
+      record.N      = surface.N;
+      record.u      = surface.u;
+      record.v      = surface.v;
+      record.object = surface.object;
+    } else {
+      record.object = nullptr;
+    }
+    record.is_valid = true;
+  }
+
+  ////// private /////////////////////////////////////////////////////////////
+
+  bool GBuffer::index(size_t *i, const size_t x, const size_t y, const size_t s) const
+  {
+    if( _records.empty()  ||  x >= _width  ||  y >= _height  ||  s >= _numSamples ) {
+      return false;
+    }
+    *i = (y*_width + x)*_numSamples + s;
+    return true;
+  }
+
+} // namespace rt
@@ -0,0 +1,230 @@
+/****************************************************************************
+** Copyright (c) 2021, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#include <iterator>
+#include <utility>
+#include <vector>
+
+#include "rt/Scene/GeometryCache.h"
+
+#include "rt/Object/LazyObject.h"
+
+namespace rt {
+
+  namespace priv {
+
+    // NOTE: The block rendered by this thread; a thread renders one block at a time.
+    struct ThreadBlock {
+      const GeometryCache *cache{nullptr};
+      uint64_t block{0};
+    };
+
+    thread_local ThreadBlock threadBlock;
+
+  } // namespace priv
+
+  ////// public //////////////////////////////////////////////////////////////
+
+  GeometryCache::GeometryCache() noexcept
+  {
+  }
+
+  GeometryCache::~GeometryCache() noexcept
+  {
+  }
+
+  size_t GeometryCache::maxMemory() const
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _maxMemory;
+  }
+
+  void GeometryCache::setMaxMemory(const size_t numBytes)
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _maxMemory = numBytes;
+  }
+
+  size_t GeometryCache::memory() const
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _memory;
+  }
+
+  size_t GeometryCache::numObjects() const
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _numObjects;
+  }
+
+  size_t GeometryCache::numResident() const
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _entries.size();
+  }
+
+  void GeometryCache::beginFrame()
+  {
+    _frame.fetch_add(1);
+  }
+
+  uint64_t GeometryCache::frame() const
+  {
+    return _frame.load();
+  }
+
+  void GeometryCache::beginBlock()
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _block++;
+    _blocks.insert(_block);
+    priv::threadBlock = priv::ThreadBlock{this, _block};
+  }
+
+  void GeometryCache::endBlock()
+  {
+    if( priv::threadBlock.cache != this ) {
+      return;
+    }
+
+    {
+      std::lock_guard<std::mutex> lock(_mutex);
+      _blocks.erase(priv::threadBlock.block);
+    }
+    priv::threadBlock = priv::ThreadBlock();
+
+    // NOTE: The block's geometry may now be evicted.
+    evict();
+  }
+
+  GeometryCachePtr GeometryCache::create()
+  {
+    return std::make_shared<GeometryCache>();
+  }
+
+  ////// private /////////////////////////////////////////////////////////////
+
+  void GeometryCache::attach(const LazyObject * /*object*/)
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _numObjects++;
+  }
+
+  void GeometryCache::detach(const LazyObject *object)
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _numObjects--;
+
+    const auto it = _entries.find(object);
+    if( it != _entries.end() ) {
+      _memory -= it->second.numBytes;
+      _lru.erase(it->second.lru);
+      _entries.erase(it);
+    }
+  }
+
+  uint64_t GeometryCache::block() const
+  {
+    return priv::threadBlock.cache == this
+        ? priv::threadBlock.block
+        : 0;
+  }
+
+  void GeometryCache::evict()
+  {
+    const uint64_t frame = _frame.load();
+
+    std::vector<std::pair<const LazyObject*,size_t>> victims;
+    uint64_t block = 0;
+    {
+      std::lock_guard<std::mutex> lock(_mutex);
+
+      // NOTE: Geometry last used before the oldest block in flight is no longer referred to.
+      block = _blocks.empty()
+          ? _block + 1
+          : *_blocks.begin();
+
+      /*
+       * NOTE:
+       * The least recently used objects are evicted first. Pinned objects are moved
+       * to the front instead; hence the list is (re)ordered by use only when memory
+       * is exceeded, without locking on each access.
+       */
+      for(size_t n = _lru.size(); _memory > _maxMemory  &&  n > 0; n--) {
+        const LazyObject *candidate = _lru.back();
+        if( candidate->isPinned(frame, block) ) {
+          _lru.splice(_lru.begin(), _lru, std::prev(_lru.end()));
+          continue;
+        }
+
+        const auto it = _entries.find(candidate);
+        victims.emplace_back(candidate, it->second.numBytes);
+        _memory -= it->second.numBytes;
+        _entries.erase(it);
+        _lru.pop_back();
+      }
+    }
+
+    // NOTE: Victims are unloaded after unlocking, as loading objects lock the cache.
+    bool is_restored = false;
+    for(const auto& [victim, victimBytes] : victims) {
+      if( !victim->unload(frame, block) ) {
+        insert(victim, victimBytes, false);
+        is_restored = true;
+      }
+    }
+
+    // NOTE: The blocks using restored victims may have ended before these were restored.
+    if( is_restored ) {
+      evict();
+    }
+  }
+
+  void GeometryCache::insert(const LazyObject *object, const size_t numBytes, const bool may_evict)
+  {
+    {
+      std::lock_guard<std::mutex> lock(_mutex);
+
+      if( _entries.count(object) > 0 ) {
+        return;
+      }
+
+      _lru.push_front(object);
+      _entries[object] = Entry{_lru.begin(), numBytes};
+      _memory += numBytes;
+    }
+
+    if( may_evict ) {
+      evict();
+    }
+  }
+
+} // namespace rt
@@ -29,12 +29,33 @@
 ** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 *****************************************************************************/
 
+#include <algorithm>
+
 #include "rt/Scene/Scene.h"
 
+#include "rt/Material/BSDF.h"
 #include "rt/Object/SurfaceInfo.h"
 
 namespace rt {
 
+  namespace priv {
+
+    /*
+     * NOTE:
+     * Ties, e.g. of coplanar surfaces, are resolved in order of insertion,
+     * independent of the order the BVH visits the objects in.
+     */
+    inline bool isCloser(const SurfaceInfo& hit, const size_t index,
+                         const SurfaceInfo& closest, const size_t closestIndex)
+    {
+      return !closest.isHit()  ||  hit.t < closest.t  ||
+          (hit.t == closest.t  &&  index < closestIndex);
+    }
+
+  } // namespace priv
+
+  ////// public //////////////////////////////////////////////////////////////
+
   Scene::Scene() = default;
 
   Scene::~Scene() = default;
@@ -47,6 +68,7 @@ namespace rt {
   {
     if( light ) {
       _lights.push_back(std::move(light));
+      _gbuffer.clear();
     }
   }
 
@@ -54,9 +76,69 @@ namespace rt {
   {
     if( object ) {
       _objects.push_back(std::move(object));
+      _bvh_dirty = true;
+      _gbuffer.clear();
     }
   }
 
+  bool Scene::aov(AOV *aov, const Ray& ray) const
+  {
+    *aov = AOV();
+    if( !ray.isValid() ) {
+      return false;
+    }
+
+    SurfaceInfo surface;
+    size_t closest = 0;
+    traverse(ray, [&](const size_t index, const IObject *o, real_t *tMax) -> bool {
+      SurfaceInfo hit;
+      if( o->intersect(&hit, ray)  &&  priv::isCloser(hit, index, surface, closest) ) {
+        surface = hit;
+        closest = index;
+        *tMax = hit.t;
+      }
+      return true;
+    });
+    aov->objectId = surface.isHit()
+        ? uint_t(closest + 1)
+        : 0;
+    if( !surface.isHit() ) {
+      return false;
+    }
+
+    aov->albedo = surface->material()->bsdf()->albedo(surface);
+    aov->N      = geom::isSameHemisphere(surface.N, surface.wo)
+        ? surface.N
+        : -surface.N;
+    aov->depth  = surface.t;
+
+    return true;
+  }
+
+  void Scene::beginFrame(const CameraPtr& camera, const SamplerPtr& sampler,
+                         const RenderOptions& options)
+  {
+    updateBVH();
+
+    _geometryCache->beginFrame();
+
+    if( _use_gbuffer  &&  _geometryCache->numObjects() < 1 ) {
+      _gbuffer.begin(camera, sampler, options);
+    } else {
+      _gbuffer.clear();
+    }
+  }
+
+  void Scene::beginBlock() const
+  {
+    _geometryCache->beginBlock();
+  }
+
+  void Scene::endBlock() const
+  {
+    _geometryCache->endBlock();
+  }
+
   Color Scene::backgroundColor() const
   {
     return _backgroundColor;
@@ -72,6 +154,20 @@ namespace rt {
     _backgroundColor = 0;
     _lights.clear();
     _objects.clear();
+    _bvh.clear();
+    _bvh_dirty = true;
+    _bvhIndex.clear();
+    _bvhObjects.clear();
+    _gbuffer.clear();
+    // NOTE: The cache (& its settings) outlive clear(), unless this scene was moved from.
+    if( !_geometryCache ) {
+      _geometryCache = GeometryCache::create();
+    }
+    if( _materials ) {
+      _materials->clear();
+    } else {
+      _materials = MaterialRegistry::create();
+    }
   }
 
   bool Scene::intersect(SurfaceInfo *surface, const Ray& ray) const
@@ -81,15 +177,16 @@ namespace rt {
     }
 
     *surface = SurfaceInfo();
-    for(const ObjectPtr& o : _objects) {
+    size_t closest = 0;
+    traverse(ray, [&](const size_t index, const IObject *o, real_t *tMax) -> bool {
       SurfaceInfo hit;
-      if( !o->intersect(&hit, ray) ) {
-        continue;
-      }
-      if( !surface->isHit()  ||  hit.t < surface->t ) {
+      if( o->intersect(&hit, ray)  &&  priv::isCloser(hit, index, *surface, closest) ) {
         *surface = hit;
+        closest = index;
+        *tMax = hit.t;
       }
-    }
+      return true;
+    });
     return surface->isHit();
   }
 
@@ -99,20 +196,43 @@ namespace rt {
       return false;
     }
 
-    if( _use_cast_shadow ) {
-      for(const ObjectPtr& o : _objects) {
-        if( o->castShadow(ray) ) {
-          return true;
-        }
-      }
-    } else {
-      for(const ObjectPtr& o : _objects) {
-        if( o->intersect(nullptr, ray) ) {
-          return true;
-        }
+    bool is_hit = false;
+    traverse(ray, [&](const size_t /*index*/, const IObject *o, real_t * /*tMax*/) -> bool {
+      is_hit = _use_cast_shadow
+          ? o->castShadow(ray)
+          : o->intersect(nullptr, ray);
+      return !is_hit;
+    });
+    return is_hit;
+  }
+
+  bool Scene::intersectPrimary(SurfaceInfo *surface, Ray *ray,
+                               const size_t x, const size_t y, const size_t s,
+                               const Transform& view, const CameraPtr& camera,
+                               const SamplerPtr& sampler) const
+  {
+    if( _gbuffer.lookup(surface, ray, x, y, s) ) {
+      return surface->isHit();
+    }
+
+    *ray = view*camera->ray(x, y, sampler);
+    *surface = SurfaceInfo();
+    const bool is_hit = intersect(surface, *ray);
+
+    _gbuffer.store(x, y, s, *ray, *surface);
+
+    return is_hit;
+  }
+
+  Color Scene::Le(const Ray& ray) const
+  {
+    Color L = _backgroundColor;
+    for(const LightPtr& light : _lights) {
+      if( light->isInfiniteLight() ) {
+        L += light->Le(ray);
       }
     }
-    return false;
+    return L;
   }
 
   const Lights& Scene::lights() const
@@ -120,6 +240,124 @@ namespace rt {
     return _lights;
   }
 
+  const Objects& Scene::objects() const
+  {
+    return _objects;
+  }
+
+  void Scene::moveObject(IObject *object, const Transform& objectToWorld)
+  {
+    if( object != nullptr ) {
+      object->moveObject(objectToWorld);
+      refitBVH(object);
+      _gbuffer.clear();
+    }
+  }
+
+  void Scene::setObjectToWorld(IObject *object, const Transform& objectToWorld)
+  {
+    if( object != nullptr ) {
+      object->setObjectToWorld(objectToWorld);
+      refitBVH(object);
+      _gbuffer.clear();
+    }
+  }
+
+  void Scene::remove(const ILight *light)
+  {
+    const auto it = std::find_if(_lights.begin(), _lights.end(),
+                                 [&](const LightPtr& l) -> bool { return l.get() == light; });
+    if( it != _lights.end() ) {
+      _lights.erase(it);
+      _gbuffer.clear();
+    }
+  }
+
+  void Scene::remove(const IObject *object)
+  {
+    const auto it = std::find_if(_objects.begin(), _objects.end(),
+                                 [&](const ObjectPtr& o) -> bool { return o.get() == object; });
+    if( it != _objects.end() ) {
+      _objects.erase(it);
+      _bvh_dirty = true;
+      _gbuffer.clear();
+    }
+  }
+
+  void Scene::replace(const ILight *light, LightPtr& other)
+  {
+    const auto it = std::find_if(_lights.begin(), _lights.end(),
+                                 [&](const LightPtr& l) -> bool { return l.get() == light; });
+    if( it != _lights.end()  &&  other ) {
+      *it = std::move(other);
+      _gbuffer.clear();
+    }
+  }
+
+  void Scene::replace(const IObject *object, ObjectPtr& other)
+  {
+    const auto it = std::find_if(_objects.begin(), _objects.end(),
+                                 [&](const ObjectPtr& o) -> bool { return o.get() == object; });
+    if( it == _objects.end()  ||  !other ) {
+      return;
+    }
+
+    *it = std::move(other);
+    _gbuffer.clear();
+
+    if( _bvh_dirty ) {
+      return;
+    }
+
+    const auto index = _bvhIndex.find(object);
+    if( index == _bvhIndex.end() ) {
+      _bvh_dirty = true;
+      return;
+    }
+
+    const size_t prim = index->second;
+    _bvhIndex.erase(index);
+    _bvhIndex[it->get()] = prim;
+    _bvhObjects[prim]    = it->get();
+    refitBVH(it->get());
+  }
+
+  const BVH& Scene::bvh() const
+  {
+    return _bvh;
+  }
+
+  void Scene::buildBVH()
+  {
+    _bvhIndex.clear();
+    _bvhObjects.clear();
+
+    std::vector<Bounds> bounds;
+    bounds.reserve(_objects.size());
+    for(const ObjectPtr& o : _objects) {
+      _bvhIndex[o.get()] = _bvhObjects.size();
+      _bvhObjects.push_back(o.get());
+      bounds.push_back(o->worldBounds());
+    }
+
+    _bvh.build(bounds);
+    _bvh_dirty = false;
+  }
+
+  void Scene::updateBVH(const bool wait)
+  {
+    if( _bvh_dirty ) {
+      buildBVH();
+    } else {
+      _bvh.update(wait);
+    }
+  }
+
+  void Scene::setBVHRebuildThreshold(const real_t ratio)
+  {
+    _bvh.setRebuildThreshold(ratio);
+  }
+
   bool Scene::useCastShadow() const
   {
     return _use_cast_shadow;
@@ -130,9 +368,70 @@ namespace rt {
     _use_cast_shadow = on;
   }
 
+  const GBuffer& Scene::gbuffer() const
+  {
+    return _gbuffer;
+  }
+
+  bool Scene::useGBuffer() const
+  {
+    return _use_gbuffer;
+  }
+
+  void Scene::setUseGBuffer(const bool on)
+  {
+    _use_gbuffer = on;
+    if( !_use_gbuffer ) {
+      _gbuffer.clear();
+    }
+  }
+
+  const GeometryCachePtr& Scene::geometryCache() const
+  {
+    return _geometryCache;
+  }
+
+  const MaterialRegistryPtr& Scene::materials() const
+  {
+    return _materials;
+  }
+
   ScenePtr Scene::create()
   {
     return std::make_unique<Scene>();
   }
 
+  ////// private /////////////////////////////////////////////////////////////
+
+  // NOTE: 'visit(index, object, &tMax)'; cf. BVH::traverse().
+  template<typename VisitorT>
+  void Scene::traverse(const Ray& ray, VisitorT&& visit) const
+  {
+    if( _bvh_dirty ) {
+      size_t index = 0;
+      real_t  tMax = ray.tMax();
+      for(const ObjectPtr& o : _objects) {
+        if( !visit(index++, o.get(), &tMax) ) {
+          return;
+        }
+      }
+      return;
+    }
+
+    _bvh.traverse(ray, [&](const size_t index, real_t *tMax) -> bool {
+      return visit(index, _bvhObjects[index], tMax);
+    });
+  }
+
+  void Scene::refitBVH(const IObject *object)
+  {
+    if( _bvh_dirty ) {
+      return;
+    }
+
+    if( const auto it = _bvhIndex.find(object); it != _bvhIndex.end() ) {
+      _bvh.refit(it->second, object->worldBounds());
+    }
+  }
+
 } // namespace rt
@@ -0,0 +1,81 @@
+/****************************************************************************
+** Copyright (c) 2021, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#pragma once
+
+#include <cstdint>
+
+#include <string>
+#include <vector>
+
+#include "rt/Renderer/PartialImage.h"
+#include "rt/Renderer/RenderContext.h"
+
+/*
+ * NOTE:
+ * The state of an unfinished frame: the accumulated radiance & sample count of
+ * each pixel, the set of completed tiles and the state of the sampler. As seeded
+ * samplers derive their samples from the pixel & sample index, the sampler's
+ * state is its seed and sample range; a resumed frame then matches an
+ * uninterrupted one. Files are replaced atomically, i.e. written to a temporary
+ * file and renamed afterwards.
+ * A checkpoint is only compatible with a frame rendering the same scene file
+ * (cf. to rt::hashSceneFile()), using the same type of renderer & camera and
+ * the same render options.
+ */
+
+struct Checkpoint {
+  Checkpoint() = default;
+
+  // NOTE: The frame's settings; the tiles & partial remain empty.
+  static Checkpoint create(const rt::RenderContext& rc, const rt::size_t tileSize,
+                           const uint64_t sceneHash);
+
+  bool isCompatible(const Checkpoint& other) const;
+
+  bool load(const std::string& filename);
+  bool save(const std::string& filename) const;
+
+  rt::size_t width{0};
+  rt::size_t height{0};
+  rt::RenderBlock window{};
+  rt::size_t tileSize{0};
+  rt::size_t numSamples{0};
+  bool is_seeded{false};
+  uint64_t seed{0};
+  rt::size_t firstSample{0};
+  uint64_t sceneHash{0};
+  std::string renderer{};
+  std::string camera{};
+  rt::RenderOptions options{};
+  std::vector<rt::RenderBlock> tiles{};
+  rt::PartialImage partial{};
+};
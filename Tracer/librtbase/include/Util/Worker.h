@@ -31,6 +31,11 @@
 
 #pragma once
 
+#include <cstdint>
+
+#include <string>
+
+#include "rt/Renderer/Denoiser.h"
 #include "rt/Renderer/RenderContext.h"
 
 class Worker {
@@ -38,8 +43,55 @@ public:
   Worker() = default;
   ~Worker() = default;
 
+  bool denoise() const;
+  void setDenoise(const bool on);
+
+  rt::Denoiser& denoiser();
+
+  // NOTE: If not empty, the window's radiance sums & sample counts are saved as a PartialImage.
+  const std::string& partialFilename() const;
+  void setPartialFilename(const std::string& filename);
+
+  /*
+   * NOTE:
+   * If not empty, a Checkpoint of the frame is saved every 'intervalSec' seconds by a
+   * separate thread, and once the frame is finished. While checkpointing, SIGTERM cancels
+   * the frame and saves a final checkpoint prior to returning false. If resuming, tiles
+   * completed by a compatible checkpoint are not rendered again. The AOVs are not kept,
+   * hence resumed frames are not denoised. Renderers (re)developing the entire frame in
+   * endFrame() (e.g. BidirectionalRenderer) do not support resuming; neither does an
+   * incompatible checkpoint. In both cases, the frame is NOT rendered and false is returned.
+   */
+  const std::string& checkpointFilename() const;
+  void setCheckpointFilename(const std::string& filename, const unsigned int intervalSec = 60);
+
+  bool resume() const;
+  void setResume(const bool on);
+
+  // NOTE: The hash of the rendered scene's file, e.g. rt::hashSceneFile(); cf. to Checkpoint.
+  uint64_t sceneHash() const;
+  void setSceneHash(const uint64_t hash);
+
   Image execute(const rt::RenderContext& rc, const rt::size_t blockSize = 8) const;
 
+  /*
+   * NOTE:
+   * Renders the crop window of 'rc' and composites it into 'image';
+   * an 'image' not matching the camera is replaced by a black one.
+   * Tiles of 'blockSize' x 'blockSize' pixels are rendered center first;
+   * rc.cancel() stops rendering, in which case false is returned.
+   */
+  bool execute(Image *image, const rt::RenderContext& rc, const rt::size_t blockSize = 8) const;
+
 private:
-  static void progress(const rt::size_t y, const rt::size_t height);
+  static void progress(const rt::size_t done, const rt::size_t total);
+  static void terminate(int signum);
+
+  bool _denoise{false};
+  rt::Denoiser _denoiser{};
+  std::string _partialFilename{};
+  std::string _checkpointFilename{};
+  unsigned int _checkpointInterval{60};
+  bool _resume{false};
+  uint64_t _sceneHash{0};
 };
@@ -73,11 +73,23 @@ namespace geom {
       return _X*v;
     }
 
+    // NOTE: All eight corners are transformed, bounding rotated boxes conservatively.
     inline Bounds operator*(const Bounds& bounds) const
     {
-      const Vertex p1 = _X*bounds.min();
-      const Vertex p2 = _X*bounds.max();
-      return Bounds(p1, p2);
+      if( !bounds.isValid() ) {
+        return Bounds();
+      }
+
+      const Vertex p1 = bounds.min();
+      const Vertex p2 = bounds.max();
+
+      Bounds result;
+      for(unsigned int i = 0; i < 8; i++) {
+        result.update(_X*Vertex{(i & 1) != 0 ? p2.x : p1.x,
+                                (i & 2) != 0 ? p2.y : p1.y,
+                                (i & 4) != 0 ? p2.z : p1.z});
+      }
+      return result;
     }
 
     inline Ray operator*(const Ray& ray) const
@@ -124,6 +136,13 @@ namespace geom {
       return Transform(_Xinv);
     }
 
+    // Access ////////////////////////////////////////////////////////////////
+
+    inline const Matrix& matrix() const
+    {
+      return _X;
+    }
+
   private:
     Matrix _X{};
     Matrix _Xinv{};
@@ -0,0 +1,134 @@
+/****************************************************************************
+** Copyright (c) 2021, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+#include "rt/Base/Types.h"
+
+namespace rt {
+
+  /*
+   * NOTE:
+   * Stores objects of type 'T' contiguously in chunks of CHUNK_SIZE objects, e.g. the
+   * objects of a scene. Objects never move, i.e. their addresses & indices remain valid
+   * until clear() destroys all of them & frees their memory at once.
+   */
+  template<typename T, size_t CHUNK_SIZE = 256>
+  class Arena {
+  public:
+    Arena() noexcept = default;
+
+    ~Arena() noexcept
+    {
+      clear();
+    }
+
+    template<typename... Args>
+    T *emplace(Args&&... args)
+    {
+      if( _size == _chunks.size()*CHUNK_SIZE ) {
+        _chunks.push_back(std::make_unique<Chunk>());
+      }
+
+      T *object = new (slot(_size)) T(std::forward<Args>(args)...);
+      _size += 1;
+
+      return object;
+    }
+
+    void clear()
+    {
+      for(size_t i = _size; i > 0; i--) {
+        std::destroy_at(slot(i - 1));
+      }
+      _size = 0;
+      _chunks.clear();
+    }
+
+    bool isEmpty() const
+    {
+      return _size == 0;
+    }
+
+    size_t size() const
+    {
+      return _size;
+    }
+
+    // NOTE: Returns false if 'object' is not stored in this arena.
+    bool indexOf(size_t *index, const T *object) const
+    {
+      for(size_t i = 0; i < _chunks.size(); i++) {
+        const T *first = reinterpret_cast<const T*>(_chunks[i]->data);
+        if( first <= object  &&  object < first + CHUNK_SIZE ) {
+          *index = i*CHUNK_SIZE + size_t(object - first);
+          return *index < _size;
+        }
+      }
+      return false;
+    }
+
+    T& operator[](const size_t i)
+    {
+      return *slot(i);
+    }
+
+    const T& operator[](const size_t i) const
+    {
+      return *slot(i);
+    }
+
+  private:
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+
+    struct Chunk {
+      alignas(T) std::byte data[sizeof(T)*CHUNK_SIZE];
+    };
+
+    T *slot(const size_t i) const
+    {
+      std::byte *data = _chunks[i/CHUNK_SIZE]->data;
+      return std::launder(reinterpret_cast<T*>(data + sizeof(T)*(i%CHUNK_SIZE)));
+    }
+
+    std::vector<std::unique_ptr<Chunk>> _chunks{};
+    size_t _size{0};
+  };
+
+} // namespace rt
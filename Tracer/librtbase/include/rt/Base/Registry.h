@@ -0,0 +1,144 @@
+/****************************************************************************
+** Copyright (c) 2021, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+#include "rt/Base/Types.h"
+
+namespace rt {
+
+  ////// Hashing /////////////////////////////////////////////////////////////
+
+  // NOTE: Cf. boost::hash_combine().
+  template<typename T>
+  inline void hashCombine(size_t *seed, const T& value)
+  {
+    *seed ^= std::hash<T>{}(value) + 0x9e3779b9 + (*seed << 6) + (*seed >> 2);
+  }
+
+  inline void hashCombine(size_t *seed, const Color& color)
+  {
+    hashCombine(seed, color(0));
+    hashCombine(seed, color(1));
+    hashCombine(seed, color(2));
+  }
+
+  inline bool isSameColor(const Color& a, const Color& b)
+  {
+    return a(0) == b(0)  &&  a(1) == b(1)  &&  a(2) == b(2);
+  }
+
+  ////// Registry ////////////////////////////////////////////////////////////
+
+  /*
+   * NOTE:
+   * Deduplicates immutable resources (e.g. materials & textures) by their parameters;
+   * add() hands out an equal resource already registered or registers the given one.
+   * Resources are registered only as long as they are referenced elsewhere.
+   * 'T' provides 'size_t hash() const' & 'bool isEqual(const T&) const'.
+   */
+  template<typename T>
+  class Registry {
+  public:
+    using Ptr = std::unique_ptr<T>;
+    using Ref = std::shared_ptr<const T>;
+
+    Registry() noexcept = default;
+    ~Registry() noexcept = default;
+
+    Ref add(Ptr& resource)
+    {
+      if( !resource ) {
+        return Ref();
+      }
+
+      const size_t hash = resource->hash();
+
+      std::lock_guard<std::mutex> lock(_mutex);
+
+      auto [it, last] = _resources.equal_range(hash);
+      while( it != last ) {
+        Ref shared = it->second.lock();
+        if( !shared ) {
+          it = _resources.erase(it);
+          continue;
+        }
+        if( shared->isEqual(*resource) ) {
+          resource.reset();
+          return shared;
+        }
+        ++it;
+      }
+
+      Ref shared = std::move(resource);
+      _resources.emplace(hash, shared);
+
+      return shared;
+    }
+
+    Ref add(Ptr&& resource)
+    {
+      return add(resource);
+    }
+
+    void clear()
+    {
+      std::lock_guard<std::mutex> lock(_mutex);
+      _resources.clear();
+    }
+
+    // NOTE: The number of resources in use.
+    size_t size() const
+    {
+      std::lock_guard<std::mutex> lock(_mutex);
+      size_t numResources = 0;
+      for(const auto& entry : _resources) {
+        if( !entry.second.expired() ) {
+          numResources += 1;
+        }
+      }
+      return numResources;
+    }
+
+  private:
+    Registry(const Registry&) = delete;
+    Registry& operator=(const Registry&) = delete;
+
+    mutable std::mutex _mutex;
+    std::unordered_multimap<size_t,std::weak_ptr<const T>> _resources;
+  };
+
+} // namespace rt
@@ -49,10 +49,24 @@ namespace rt {
 
     virtual Ray ray(const size_t x, const size_t y, const SamplerPtr& sampler) const = 0;
 
+    /*
+     * Cf. to PBR3 Chapter "16.1.1 Sampling Cameras"
+     * for an explanation of the following functions.
+     *
+     * NOTE: All arguments passed to/returned from these methods are in CAMERA coordinates!
+     */
+    virtual real_t filmArea() const = 0;
+    virtual real_t lensRadius() const;
+    virtual bool raster(real_t *x, real_t *y, const Vertex& pLens, const Direction& dir) const = 0;
+    // NOTE: Primary rays originate from the screen located at z = zScreen()!
+    virtual real_t zScreen() const = 0;
+
   protected:
     static bool isValidFoV(const real_t fov_rad);
     static Ray makeRay(const Matrix& W, const size_t x, const size_t y,
                        const SamplerPtr& sampler);
+    real_t makeFilmArea(const Matrix& W) const;
+    bool makeRaster(real_t *x, real_t *y, const Matrix& W, const Vertex& pScreen) const;
 
   private:
     ICamera() noexcept = delete;
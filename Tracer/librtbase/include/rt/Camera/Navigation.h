@@ -0,0 +1,57 @@
+/****************************************************************************
+** Copyright (c) 2021, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#pragma once
+
+#include "rt/Renderer/RenderOptions.h"
+
+namespace rt {
+
+  /*
+   * NOTE:
+   * Interactive camera navigation; the result is applied using IRenderer::setOptions().
+   * Angles are given in radians; distances are relative to the distance of 'eye' to 'lookAt'.
+   */
+
+  // Rotate 'eye' around 'lookAt'; 'yaw' around 'cameraUp', 'pitch' around the camera's right axis.
+  RenderOptions orbitView(const RenderOptions& options, const real_t yaw, const real_t pitch);
+
+  // Move 'eye' and 'lookAt' within the view plane.
+  RenderOptions panView(const RenderOptions& options, const real_t dx, const real_t dy);
+
+  // Scale the distance of 'eye' to 'lookAt' by 'scale'.
+  RenderOptions dollyView(const RenderOptions& options, const real_t scale);
+
+  // Move 'eye' and 'lookAt' along the camera's forward, right and up axes.
+  RenderOptions walkView(const RenderOptions& options,
+                         const real_t forward, const real_t right, const real_t up);
+
+} // namespace rt
@@ -47,6 +47,10 @@ namespace rt {
 
     Ray ray(const size_t x, const size_t y, const SamplerPtr& sampler) const;
 
+    real_t filmArea() const;
+    bool raster(real_t *x, real_t *y, const Vertex& pLens, const Direction& dir) const;
+    real_t zScreen() const;
+
     static CameraPtr create(const size_t width, const size_t height,
                             const real_t fov_rad);
 
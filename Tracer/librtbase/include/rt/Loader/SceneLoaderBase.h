@@ -35,6 +35,7 @@
 #include <functional>
 #include <string>
 #include <type_traits>
+#include <vector>
 
 #include "rt/Base/Types.h"
 
@@ -52,6 +53,8 @@ namespace rt {
 
     Direction parseDirection(const tinyxml2::XMLElement *node, bool *ok);
 
+    std::vector<Transform> parseInstanceTransforms(const tinyxml2::XMLElement *node, bool *ok);
+
     Normal parseNormal(const tinyxml2::XMLElement *node, bool *ok);
 
     real_t parseReal(const tinyxml2::XMLElement *node, bool *ok);
@@ -0,0 +1,117 @@
+/****************************************************************************
+** Copyright (c) 2021, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#pragma once
+
+#include <cstdio>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace tinyxml2 {
+  class XMLDocument;
+  class XMLElement;
+} // namespace tinyxml2
+
+namespace rt {
+
+  namespace priv {
+
+    // NOTE: The location of an element in its file.
+    struct XMLRange {
+      size_t offset{0};
+      size_t size{0};
+      int line{1};
+    };
+
+    /*
+     * NOTE:
+     * Reads an XML file element by element, without building its whole DOM. After open(),
+     * the children of the root element are the current level. Each child is either read()
+     * into a (small) document of its own, or enter()ed, making its children the current
+     * level until leave(). Only the text of one element at a time is held in memory.
+     * Line numbers of read elements are relative to their first line; cf. lineNum().
+     * A read element may be read again later from its XMLRange.
+     */
+    class XMLStream {
+    public:
+      XMLStream() noexcept;
+      ~XMLStream() noexcept;
+
+      bool isError() const;
+
+      bool open(const char *filename);
+
+      const char *rootName() const;
+
+      // NOTE: The name of the next child of the current level; nullptr at its end.
+      const char *nextName();
+
+      bool enter();
+      bool leave();
+
+      const tinyxml2::XMLElement *read(tinyxml2::XMLDocument *doc, XMLRange *range = nullptr);
+
+      static const tinyxml2::XMLElement *read(tinyxml2::XMLDocument *doc, const char *filename,
+                                              const XMLRange& range);
+
+      // NOTE: The line of 'elem' in the file, if its document was read() from 'range'.
+      static int lineNum(const tinyxml2::XMLElement *elem, const XMLRange& range);
+
+    private:
+      using FilePtr = std::unique_ptr<FILE,decltype(&fclose)>;
+
+      void consume(const size_t n);
+      bool ensure(const size_t n);
+      bool fill();
+      bool find(size_t *at, const char *token, const size_t from);
+      bool scanElement(size_t *end);
+      bool scanTag(size_t *end, bool *is_empty, const size_t from);
+      bool skipToTag();
+      bool startsWith(const char *token, const size_t at);
+
+      std::string _buffer{};
+      bool _empty{false};
+      bool _eof{false};
+      bool _error{false};
+      FilePtr _file{nullptr, &fclose};
+      int _line{1};
+      std::vector<std::string> _levels{};
+      std::string _name{};
+      size_t _offset{0};
+      size_t _pos{0};
+      std::string _root{};
+    };
+
+  } // namespace priv
+
+} // namespace rt
@@ -0,0 +1,96 @@
+/****************************************************************************
+** Copyright (c) 2021, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#pragma once
+
+#include "rt/Base/Types.h"
+
+namespace rt {
+
+  /*
+   * NOTE:
+   * Arbitrary Output Variables (AOVs) of the first hit along a camera ray;
+   * e.g. to guide a denoiser. Object IDs start at 1; zero denotes a miss.
+   */
+  struct AOV {
+    AOV() noexcept = default;
+
+    inline bool isHit() const
+    {
+      return objectId != 0;
+    }
+
+    Color   albedo{};
+    Normal       N{}; // Shading normal facing the ray's origin
+    real_t   depth{0};
+    uint_t objectId{0};
+  };
+
+  /*
+   * NOTE:
+   * Averages the AOVs of a pixel's samples; the object ID is the first hit's.
+   */
+  struct AOVAccumulator {
+    AOVAccumulator() noexcept = default;
+
+    inline void add(const AOV& aov)
+    {
+      if( !aov.isHit() ) {
+        return;
+      }
+      if( numHits == 0 ) {
+        sum.objectId = aov.objectId;
+      }
+      sum.albedo += aov.albedo;
+      sum.N      += aov.N;
+      sum.depth  += aov.depth;
+      numHits++;
+    }
+
+    inline AOV average() const
+    {
+      if( numHits == 0 ) {
+        return AOV();
+      }
+      AOV result = sum;
+      result.albedo /= real_t(numHits);
+      result.N       = !result.N.isZero()
+          ? n4::normalize(result.N)
+          : result.N;
+      result.depth  /= real_t(numHits);
+      return result;
+    }
+
+    AOV       sum{};
+    size_t numHits{0};
+  };
+
+} // namespace rt
@@ -0,0 +1,74 @@
+/****************************************************************************
+** Copyright (c) 2021, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#pragma once
+
+#include "rt/Renderer/Film.h"
+
+namespace rt {
+
+  /*
+   * NOTE:
+   * Cf. to Dammertz et al., "Edge-Avoiding A-Trous Wavelet Transform for fast
+   * Global Illumination Filtering" and to Schied et al., "Spatiotemporal
+   * Variance-Guided Filtering" (SVGF).
+   * The film's radiance is demodulated by the albedo prior to filtering, hence
+   * textures are preserved. Edges are stopped by the normals, the relative depth,
+   * the object IDs and the luminance, which is normalized by a spatial estimate
+   * of its variance. Pixels lacking a hit (i.e. the background) are kept.
+   */
+  class Denoiser {
+  public:
+    Denoiser() noexcept;
+    ~Denoiser() noexcept;
+
+    size_t numIterations() const;
+    void setNumIterations(const size_t numIterations);
+
+    real_t sigmaDepth() const;
+    void setSigmaDepth(const real_t sigma);
+
+    real_t sigmaLuminance() const;
+    void setSigmaLuminance(const real_t sigma);
+
+    real_t sigmaNormal() const;
+    void setSigmaNormal(const real_t sigma);
+
+    bool denoise(Film *film) const;
+
+  private:
+    size_t _numIterations{5};
+    real_t _sigmaDepth{0.01};
+    real_t _sigmaLuminance{4};
+    real_t _sigmaNormal{128};
+  };
+
+} // namespace rt
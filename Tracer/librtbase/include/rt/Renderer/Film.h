@@ -0,0 +1,97 @@
+/****************************************************************************
+** Copyright (c) 2021, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "Image.h"
+#include "rt/Base/Types.h"
+#include "rt/Renderer/AOV.h"
+
+namespace rt {
+
+  /*
+   * NOTE:
+   * A Film accumulates the floating point radiance of a rendered image.
+   * Each pixel is written by exactly one render block, whereas splats
+   * (e.g. light tracing contributions) may be added from any thread.
+   * Optionally, the AOVs of each pixel are kept alongside its radiance.
+   */
+  class Film {
+  public:
+    Film() noexcept;
+    ~Film() noexcept;
+
+    bool haveAOVs() const;
+    bool isEmpty() const;
+
+    size_t width() const;
+    size_t height() const;
+
+    void clear();
+    bool resize(const size_t width, const size_t height, const bool with_aovs = false);
+
+    // NOTE: Progressive refinement; blends the radiance of 'pass' using L += weight*(Lpass - L).
+    bool accumulate(const Film& pass, const real_t weight);
+
+    AOV aov(const size_t x, const size_t y) const;
+    void setAOV(const size_t x, const size_t y, const AOV& aov);
+
+    Color pixel(const size_t x, const size_t y) const;
+    void setPixel(const size_t x, const size_t y, const Color& L);
+
+    Color splat(const size_t x, const size_t y) const;
+    void addSplat(const real_t x, const real_t y, const Color& L);
+
+    Image develop(const real_t splatScale, const real_t gamma = ONE) const;
+
+  private:
+    Film(const Film&) noexcept = delete;
+    Film& operator=(const Film&) noexcept = delete;
+
+    Film(Film&&) noexcept = delete;
+    Film& operator=(Film&&) noexcept = delete;
+
+    inline size_t index(const size_t x, const size_t y) const
+    {
+      return y*_width + x;
+    }
+
+    std::vector<AOV>                         _aovs{};
+    std::vector<Color>                     _pixels{};
+    std::unique_ptr<std::atomic<real_t>[]> _splats{};
+    size_t _width{}, _height{};
+  };
+
+} // namespace rt
@@ -31,8 +31,14 @@
 
 #pragma once
 
+#include <atomic>
+#include <string>
+#include <vector>
+
 #include "Image.h"
 #include "rt/Camera/ICamera.h"
+#include "rt/Renderer/Film.h"
+#include "rt/Renderer/RenderBlock.h"
 #include "rt/Renderer/RenderOptions.h"
 #include "rt/Sampler/ISampler.h"
 #include "rt/Scene/IScene.h"
@@ -41,6 +47,13 @@ namespace rt {
 
   using RendererPtr = std::unique_ptr<class IRenderer>;
 
+  struct RenderStat {
+    std::string name{};
+    double     value{0};
+  };
+
+  using RenderStats = std::vector<RenderStat>;
+
   class IRenderer {
   public:
     IRenderer(const RenderOptions& options) noexcept;
@@ -49,20 +62,73 @@ namespace rt {
     const RenderOptions& options() const;
     void setOptions(const RenderOptions& options);
 
-    Image render(size_t y0, size_t y1, const ScenePtr& scene,
-                 const CameraPtr& camera, const SamplerPtr& sampler) const;
+    /*
+     * NOTE:
+     * Cooperative cancellation; once cancelled, render() stops at the next sample
+     * and returns an empty image. RenderContext::beginFrame() resets the flag.
+     */
+    bool isCancelled() const;
+    void setCancelled(const bool on);
+
+    /*
+     * NOTE:
+     * A frame is resumable from a subset of its tiles, if each pixel only depends
+     * on the samples taken within its tile, i.e. endFrame() does not (re)develop it.
+     */
+    virtual bool isResumable() const;
+
+    /*
+     * NOTE:
+     * beginFrame() and endFrame() are called before and after ALL blocks of an image
+     * have been rendered; endFrame() returns true if it (re)developed 'image'.
+     * If 'film' is not null, it receives the frame's radiance and AOVs prior to tone mapping.
+     */
+    virtual void beginFrame(const ScenePtr& scene, const CameraPtr& camera,
+                            const SamplerPtr& sampler);
+    virtual bool endFrame(Image *image, Film *film) const;
+
+    /*
+     * NOTE:
+     * Statistics of the last frame as named values; renderers never print them,
+     * that is left to the frontends.
+     */
+    virtual RenderStats statistics() const;
+
+    virtual Image render(RenderBlock block, const ScenePtr& scene,
+                         const CameraPtr& camera, const SamplerPtr& sampler,
+                         Film *film) const;
 
   protected:
+    const std::atomic_bool& cancelled() const;
+    const Transform& view() const;
+
+    static Image createImage(RenderBlock& block, const CameraPtr& camera);
+
+    /*
+     * NOTE:
+     * Radiance of the sample 's' of pixel (x,y); 'ray' receives the primary ray in
+     * world coordinates. Renderers may override this to start from cached primary hits.
+     */
+    virtual Color primaryRadiance(Ray *ray, const size_t x, const size_t y, const size_t s,
+                                  const ScenePtr& scene, const CameraPtr& camera,
+                                  const SamplerPtr& sampler) const;
+
+    /*
+     * NOTE:
+     * Radiance arriving along 'ray'; it is ONLY invoked by the default render()
+     * (i.e. through primaryRadiance()). Renderers overriding render() with an
+     * estimator that is not expressible per ray (e.g. bidirectional path tracing)
+     * do NOT support it; their implementation returns black.
+     */
     virtual Color radiance(const Ray& ray, const ScenePtr& scene, const SamplerPtr& sampler,
                            const uint_t depth = 0, const Color& throughput = Color(1)) const = 0;
 
   private:
     IRenderer() noexcept = delete;
 
-    static Image createImage(size_t& y0, size_t& y1, const CameraPtr& camera);
-
-    RenderOptions _options{};
-    Transform     _view{};
+    std::atomic_bool _cancelled{false};
+    RenderOptions      _options{};
+    Transform             _view{};
   };
 
 } // namespace rt
@@ -0,0 +1,102 @@
+/****************************************************************************
+** Copyright (c) 2021, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+
+#include <vector>
+
+#include "Image.h"
+#include "rt/Base/Types.h"
+#include "rt/Renderer/RenderBlock.h"
+
+namespace rt {
+
+  class Film;
+
+  /*
+   * NOTE:
+   * A partial render holds the sum of each pixel's radiance samples & their number.
+   * Partials of the same frame, rendered using distinct seeds or sample ranges,
+   * are merged by adding both; merge() is independent of the partials' order.
+   * Files start with the text header "RTPARTIAL width height gamma endianness",
+   * followed by the rows of pixels from top to bottom; each pixel consists of
+   * the sum's three 32-bit floats and the count as a 32-bit unsigned integer.
+   */
+  class PartialImage {
+  public:
+    PartialImage() noexcept;
+    ~PartialImage() noexcept;
+
+    bool isEmpty() const;
+
+    size_t width() const;
+    size_t height() const;
+
+    real_t gamma() const;
+    void setGamma(const real_t gamma);
+
+    void clear();
+    bool resize(const size_t width, const size_t height);
+
+    Color sum(const size_t x, const size_t y) const;
+    uint32_t count(const size_t x, const size_t y) const;
+    void add(const size_t x, const size_t y, const Color& sum, const uint32_t count);
+
+    // NOTE: Adds the radiance of 'film' within 'window', each pixel's being the mean of 'numSamples'.
+    bool add(const Film& film, const RenderBlock& window, const uint32_t numSamples);
+
+    Image develop() const;
+
+    bool load(const char *filename);
+    bool save(const char *filename) const;
+
+    // NOTE: Read/write the partial at the current position of 'file'.
+    bool read(FILE *file);
+    bool write(FILE *file) const;
+
+    static bool merge(PartialImage *result, const std::vector<const PartialImage*>& partials);
+
+  private:
+    inline size_t index(const size_t x, const size_t y) const
+    {
+      return y*_width + x;
+    }
+
+    std::vector<uint32_t> _counts{};
+    std::vector<Color>      _sums{};
+    size_t _width{}, _height{};
+    real_t _gamma{1};
+  };
+
+} // namespace rt
@@ -0,0 +1,89 @@
+/****************************************************************************
+** Copyright (c) 2021, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#pragma once
+
+#include <algorithm>
+#include <vector>
+
+#include "rt/Base/Types.h"
+
+namespace rt {
+
+  /*
+   * NOTE:
+   * A rectangular block of pixels [x0,x1) x [y0,y1); e.g. a tile being rendered
+   * or a crop window. An empty crop window denotes the entire image.
+   */
+  struct RenderBlock {
+    RenderBlock() noexcept = default;
+
+    RenderBlock(const size_t x0, const size_t y0, const size_t x1, const size_t y1) noexcept
+      : x0{x0}
+      , y0{y0}
+      , x1{x1}
+      , y1{y1}
+    {
+    }
+
+    inline bool isEmpty() const
+    {
+      return x0 >= x1  ||  y0 >= y1;
+    }
+
+    inline size_t width() const
+    {
+      return isEmpty()
+          ? 0
+          : x1 - x0;
+    }
+
+    inline size_t height() const
+    {
+      return isEmpty()
+          ? 0
+          : y1 - y0;
+    }
+
+    // Intersection with an image of size 'width' x 'height'
+    inline RenderBlock clipped(const size_t width, const size_t height) const
+    {
+      return RenderBlock(std::min(x0, width), std::min(y0, height),
+                         std::min(x1, width), std::min(y1, height));
+    }
+
+    size_t x0{0}, y0{0};
+    size_t x1{0}, y1{0};
+  };
+
+  using RenderBlocks = std::vector<RenderBlock>;
+
+} // namespace rt
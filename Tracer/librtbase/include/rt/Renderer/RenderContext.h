@@ -31,18 +31,20 @@
 
 #pragma once
 
-#include <list>
-#include <tuple>
-
 #include "rt/Renderer/IRenderer.h"
+#include "rt/Renderer/RenderBlock.h"
 #include "rt/Scene/IScene.h"
 
 namespace rt {
 
-  using RenderBlock  = std::tuple<size_t,size_t>;
-  using RenderBlocks = std::list<RenderBlock>;
+  // NOTE: Splits 'window' into blocks of at most 'blockSize' rows.
+  RenderBlocks makeRenderBlocks(const RenderBlock& window, const size_t blockSize);
+
+  // NOTE: Splits 'window' into tiles of at most 'tileSize' x 'tileSize' pixels.
+  RenderBlocks makeRenderTiles(const RenderBlock& window, const size_t tileSize);
 
-  RenderBlocks makeRenderBlocks(const size_t height, const size_t blockSize);
+  // NOTE: Orders 'blocks' by the distance of their centers to (x,y); nearest first.
+  void prioritizeRenderBlocks(RenderBlocks *blocks, const real_t x, const real_t y);
 
   struct RenderContext {
     RenderContext() noexcept = default;
@@ -51,12 +53,22 @@ namespace rt {
 
     bool isValid() const;
 
-    Image render(const RenderBlock& block) const;
+    // NOTE: Thread-safe; stops all blocks being rendered until the next beginFrame().
+    void cancel() const;
+    bool isCancelled() const;
+
+    // NOTE: Crop window clipped to the camera; the entire image if 'window' is empty.
+    RenderBlock renderWindow() const;
+
+    void beginFrame() const;
+    Image render(const RenderBlock& block, Film *film = nullptr) const;
+    bool endFrame(Image *image, Film *film = nullptr) const;
 
     CameraPtr camera;
     RendererPtr renderer;
     SamplerPtr sampler;
     ScenePtr scene;
+    RenderBlock window;
 
   private:
     RenderContext(const RenderContext&) noexcept = delete;
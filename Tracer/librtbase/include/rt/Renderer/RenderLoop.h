@@ -31,21 +31,33 @@
 
 #pragma once
 
+#include <atomic>
+
 #include "Image.h"
 #include "rt/Base/Types.h"
 
 namespace rt {
 
+  /*
+   * NOTE:
+   * 'image' holds the pixels starting at (x0,y0). If 'cancelled' is set,
+   * the loop stops prior to the next row and returns false.
+   */
   template<typename RadianceFunc>
-  void render_loop(Image& image, const size_t y0, const RadianceFunc& radiance,
-                   const real_t gamma = ONE)
+  bool render_loop(Image& image, const size_t x0, const size_t y0, const RadianceFunc& radiance,
+                   const real_t gamma = ONE, const std::atomic_bool *cancelled = nullptr)
   {
     const real_t invGamma = ONE/std::max(ONE, gamma); // Decoding gamma only!
 
+    const size_t x1 = x0 + image.width();
     const size_t y1 = y0 + image.height();
     for(size_t y = y0; y < y1; y++) {
+      if( cancelled != nullptr  &&  cancelled->load(std::memory_order_relaxed) ) {
+        return false;
+      }
+
       uint8_t *row = image.row(y - y0);
-      for(size_t x = 0; x < image.width(); x++) {
+      for(size_t x = x0; x < x1; x++) {
         const Color Li = radiance(x, y);
 
         const Color color = invGamma != ONE
@@ -58,6 +70,8 @@ namespace rt {
         *row++ = 0xFF;
       }
     }
+
+    return true;
   }
 
 } // namespace rt
@@ -0,0 +1,82 @@
+/****************************************************************************
+** Copyright (c) 2021, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#pragma once
+
+#include <vector>
+
+#include "rt/Sampler/Sample.h"
+
+namespace rt {
+
+  /*
+   * NOTE:
+   * Piecewise-constant distributions; cf. to PBR3 Chapter "13.3.1 Example:
+   * Piecewise-Constant 1D Functions" and "13.6.7 Piecewise-Constant 2D Distributions".
+   * Continuous samples are returned in [0,1).
+   */
+
+  class Distribution1D {
+  public:
+    Distribution1D() noexcept;
+    Distribution1D(const real_t *f, const size_t n) noexcept;
+    ~Distribution1D() noexcept;
+
+    size_t count() const;
+    real_t func(const size_t i) const;
+    real_t integral() const;
+
+    real_t pdf(const real_t x) const;
+    real_t sample(const real_t xi, real_t *pdf, size_t *offset = nullptr) const;
+
+  private:
+    std::vector<real_t> _func{};
+    std::vector<real_t> _cdf{};
+    real_t _integral{0};
+  };
+
+  class Distribution2D {
+  public:
+    Distribution2D() noexcept;
+    Distribution2D(const real_t *f, const size_t nu, const size_t nv) noexcept;
+    ~Distribution2D() noexcept;
+
+    bool isEmpty() const;
+
+    real_t pdf(const real_t u, const real_t v) const;
+    std::tuple<real_t,real_t> sample(const Sample2D& xi, real_t *pdf) const;
+
+  private:
+    std::vector<Distribution1D> _conditional{}; // p(u|v)
+    Distribution1D _marginal{};                 // p(v)
+  };
+
+} // namespace rt
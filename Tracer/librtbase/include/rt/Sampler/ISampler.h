@@ -49,6 +49,20 @@ namespace rt {
 
     virtual SamplerPtr copy() const = 0;
 
+    /*
+     * NOTE:
+     * Called by the render loop prior to taking sample 's' of pixel (x,y);
+     * allows a sampler to draw reproducible samples independent of threading.
+     */
+    virtual void beginSample(const size_t x, const size_t y, const size_t s) const;
+
+    /*
+     * NOTE:
+     * Called by passes outside the render loop (e.g. photon shooting) prior to drawing
+     * the samples of work item 'id'; the calling thread draws the stream's samples.
+     */
+    virtual void beginStream(const size_t id) const;
+
     virtual real_t sample() const = 0;
 
     virtual Sample2D sample2D() const = 0;
@@ -31,28 +31,49 @@
 
 #pragma once
 
-#include <random>
+#include <cstdint>
 
 #include "rt/Sampler/ISampler.h"
 
 namespace rt {
 
+  /*
+   * NOTE:
+   * Samples are drawn from a per-thread random number generator. A seeded sampler
+   * restarts the generator for each sample of each pixel, deriving its state from
+   * the seed, the pixel and the sample's index; the first sample's index is offset
+   * by 'firstSample'. Hence, a seeded image is reproducible regardless of threading,
+   * and renders of disjoint sample ranges draw independent samples.
+   * Likewise, a stream's state is derived from the seed, 'firstSample' and its id.
+   */
   class SimpleSampler : public ISampler {
   public:
     SimpleSampler(const size_t numSamplesPerPixel);
+    SimpleSampler(const size_t numSamplesPerPixel, const uint64_t seed, const size_t firstSample = 0);
     ~SimpleSampler();
 
+    bool isSeeded() const;
+    uint64_t seed() const;
+    size_t firstSample() const;
+
     SamplerPtr copy() const;
 
+    void beginSample(const size_t x, const size_t y, const size_t s) const;
+
+    void beginStream(const size_t id) const;
+
     real_t sample() const;
 
     Sample2D sample2D() const;
 
     static SamplerPtr create(const size_t numSamplesPerPixel);
+    static SamplerPtr create(const size_t numSamplesPerPixel, const uint64_t seed,
+                             const size_t firstSample = 0);
 
   private:
-    std::uniform_real_distribution<rt::real_t> _dis{};
-    std::mt19937                               _gen{};
+    bool _is_seeded{false};
+    uint64_t _seed{0};
+    size_t _firstSample{0};
   };
 
 } // namespace rt
@@ -0,0 +1,173 @@
+/****************************************************************************
+** Copyright (c) 2021, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#pragma once
+
+#include <cstdint>
+
+#include <future>
+#include <vector>
+
+#include "rt/Base/Types.h"
+
+namespace rt {
+
+  /*
+   * NOTE:
+   * Bounding volume hierarchy over a scene's objects, built for dynamic scenes.
+   * Primitives are identified by their index into the bounds passed to build().
+   *
+   * - refit() updates a moved primitive's leaf & its ancestors bottom-up,
+   *   stopping at the first unchanged node; the SAH cost is tracked incrementally.
+   * - Once the cost degraded past rebuildThreshold() times the cost after the last
+   *   build, update() starts a rebuild on a background thread from a snapshot of the
+   *   bounds; the current hierarchy remains in use until a later update() swaps in
+   *   the result & refits it to primitives moved meanwhile.
+   *
+   * Traversals may run concurrently; refit() & update() must NOT overlap them,
+   * i.e. they are called between frames.
+   */
+  class BVH {
+  public:
+    BVH() noexcept;
+    ~BVH() noexcept;
+
+    BVH(BVH&&) noexcept;
+    BVH& operator=(BVH&&) noexcept;
+
+    void clear();
+
+    bool isEmpty() const;
+
+    size_t numNodes() const;
+    size_t numPrimitives() const;
+
+    void build(const std::vector<Bounds>& bounds);
+
+    void refit(const size_t prim, const Bounds& bounds);
+
+    // NOTE: Expected cost of tracing a ray relative to the root's surface area.
+    real_t cost() const;
+    real_t buildCost() const;
+
+    bool isRebuilding() const;
+    real_t rebuildThreshold() const;
+    void setRebuildThreshold(const real_t ratio);
+
+    // NOTE: Returns true if a finished rebuild was swapped in.
+    bool update(const bool wait = false);
+
+    /*
+     * NOTE:
+     * Calls 'visit(prim, &tMax)' for each primitive in leaves intersected by 'ray'
+     * before 'tMax', nearest nodes first; 'visit' may shorten 'tMax' and returns
+     * false to stop the traversal.
+     */
+    template<typename VisitorT>
+    void traverse(const Ray& ray, VisitorT&& visit) const
+    {
+      if( _tree.nodes.empty() ) {
+        return;
+      }
+
+      Ray myray = ray;
+
+      uint32_t stack[MAX_DEPTH];
+      size_t top = 0;
+      stack[top++] = 0;
+      while( top > 0 ) {
+        const Node& node = _tree.nodes[stack[--top]];
+        if( !node.bounds.intersect(myray, true) ) {
+          continue;
+        }
+
+        if( node.count > 0 ) {
+          for(uint32_t i = 0; i < node.count; i++) {
+            real_t tMax = myray.tMax();
+            if( !visit(size_t(_tree.prims[node.first + i]), &tMax) ) {
+              return;
+            }
+            // NOTE: Slack keeps coplanar hits at the same distance; cf. flat bounds.
+            myray.setTMax(tMax < ray.tMax()
+                          ? tMax*TMAX_SLACK
+                          : tMax);
+          }
+        } else {
+          // NOTE: The child nearer to the ray's origin is popped first.
+          if( myray.direction()(node.axis) < ZERO ) {
+            stack[top++] = node.first;
+            stack[top++] = node.first + 1;
+          } else {
+            stack[top++] = node.first + 1;
+            stack[top++] = node.first;
+          }
+        }
+      }
+    }
+
+  private:
+    BVH(const BVH&) = delete;
+    BVH& operator=(const BVH&) = delete;
+
+    // NOTE: The build bounds the depth, cf. MAX_SAH_DEPTH; hence the traversal's stack.
+    static constexpr size_t     MAX_DEPTH = 128;
+    static constexpr size_t MAX_SAH_DEPTH = 48;
+    static constexpr size_t MAX_LEAF_SIZE = 4;
+    static constexpr real_t    TMAX_SLACK = real_t(1.0001);
+
+    // NOTE: Internal nodes' children are stored adjacently at 'first' & 'first + 1'.
+    struct Node {
+      Bounds   bounds{};
+      uint32_t parent{0};
+      uint32_t first{0};
+      uint32_t count{0};
+      uint32_t axis{0};
+    };
+
+    struct Tree {
+      std::vector<Node>     nodes{};
+      std::vector<uint32_t> prims{};
+      std::vector<uint32_t> leafOf{};
+      real_t                sumCost{0};
+    };
+
+    static Tree buildTree(const std::vector<Bounds>& bounds);
+    static void refitAll(Tree *tree, const std::vector<Bounds>& bounds);
+    static real_t cost(const Tree& tree);
+
+    std::vector<Bounds> _bounds{};
+    real_t              _buildCost{0};
+    std::future<Tree>   _rebuild{};
+    real_t              _rebuildThreshold{1.5};
+    Tree                _tree{};
+  };
+
+} // namespace rt
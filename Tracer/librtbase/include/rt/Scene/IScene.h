@@ -33,6 +33,10 @@
 
 #include <memory>
 
+#include "rt/Camera/ICamera.h"
+#include "rt/Renderer/AOV.h"
+#include "rt/Renderer/RenderOptions.h"
+
 namespace rt {
 
   using ScenePtr = std::unique_ptr<class IScene>;
@@ -40,6 +44,24 @@ namespace rt {
   class IScene {
   public:
     virtual ~IScene() noexcept;
+
+    virtual bool aov(AOV *aov, const Ray& ray) const;
+
+    /*
+     * NOTE:
+     * beginFrame() is called before ALL blocks of an image are rendered, allowing
+     * the scene to (in)validate data depending on the camera (e.g. primary hits).
+     */
+    virtual void beginFrame(const CameraPtr& camera, const SamplerPtr& sampler,
+                            const RenderOptions& options);
+
+    /*
+     * NOTE:
+     * beginBlock() & endBlock() are called by the rendering thread around each block
+     * of an image; data referred to by the block's hits needs to persist in between.
+     */
+    virtual void beginBlock() const;
+    virtual void endBlock() const;
   };
 
 } // namespace rt
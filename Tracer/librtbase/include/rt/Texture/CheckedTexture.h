@@ -43,8 +43,16 @@ namespace rt {
 
     TexturePtr copy() const;
 
+    size_t hash() const;
+    bool isEqual(const ITexture& other) const;
+
     Color lookup(const TexCoord2D& tex) const final;
 
+    Color colorA() const;
+    Color colorB() const;
+    real_t scaleS() const;
+    real_t scaleT() const;
+
     static TexturePtr create(const Color& colorA, const Color& colorB,
                              const real_t scaleS, const real_t scaleT);
 
@@ -42,8 +42,13 @@ namespace rt {
 
     TexturePtr copy() const;
 
+    size_t hash() const;
+    bool isEqual(const ITexture& other) const;
+
     Color lookup(const TexCoord2D& tex) const final;
 
+    Color color() const;
+
     static TexturePtr create(const Color& color);
 
     static TexturePtr load(const tinyxml2::XMLElement *elem);
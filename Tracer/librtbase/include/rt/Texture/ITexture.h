@@ -42,6 +42,7 @@ namespace tinyxml2 {
 namespace rt {
 
   using TexturePtr = std::unique_ptr<class ITexture>;
+  using TextureRef = std::shared_ptr<const class ITexture>;
 
   class ITexture {
   public:
@@ -49,6 +50,10 @@ namespace rt {
 
     virtual TexturePtr copy() const = 0;
 
+    // NOTE: Textures of equal parameters may be shared; cf. Registry.
+    virtual size_t hash() const = 0;
+    virtual bool isEqual(const ITexture& other) const = 0;
+
     virtual Color lookup(const TexCoord2D& tex) const = 0;
 
     static bool isTexture(const tinyxml2::XMLElement *elem);
@@ -56,4 +61,9 @@ namespace rt {
     static size_t readId(const tinyxml2::XMLElement *elem, const rt::size_t defaultId = 0);
   };
 
+  inline bool isSameTexture(const TextureRef& a, const TextureRef& b)
+  {
+    return a == b  ||  (a  &&  b  &&  a->isEqual(*b));
+  }
+
 } // namespace rt
@@ -0,0 +1,239 @@
+/****************************************************************************
+** Copyright (c) 2021, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#include <cinttypes>
+#include <cstdio>
+
+#include <memory>
+#include <typeinfo>
+
+#include "Util/Checkpoint.h"
+
+#include "rt/Sampler/SimpleSampler.h"
+
+namespace priv {
+
+  using FilePtr = std::unique_ptr<FILE,decltype(&fclose)>;
+
+  constexpr std::size_t NUM_OPTIONS = 14;
+
+  constexpr std::size_t MAX_TYPENAME = 255;
+
+  inline bool isSame(const rt::RenderBlock& a, const rt::RenderBlock& b)
+  {
+    return a.x0 == b.x0  &&  a.y0 == b.y0  &&  a.x1 == b.x1  &&  a.y1 == b.y1;
+  }
+
+  // NOTE: The options' values in order of declaration; the values are compared exactly.
+  inline std::vector<double> toValues(const rt::RenderOptions& options)
+  {
+    return std::vector<double>{
+      options.eye(0), options.eye(1), options.eye(2),
+      options.lookAt(0), options.lookAt(1), options.lookAt(2),
+      options.cameraUp(0), options.cameraUp(1), options.cameraUp(2),
+      options.fov_rad, options.worldToScreen, options.aperture, options.focus,
+      options.gamma
+    };
+  }
+
+  inline rt::RenderOptions fromValues(const std::vector<double>& v, const rt::uint_t maxDepth)
+  {
+    using rt::real_t;
+
+    rt::RenderOptions options;
+    options.eye           = rt::Vertex{real_t(v[0]), real_t(v[1]), real_t(v[2])};
+    options.lookAt        = rt::Vertex{real_t(v[3]), real_t(v[4]), real_t(v[5])};
+    options.cameraUp      = rt::Direction{real_t(v[6]), real_t(v[7]), real_t(v[8])};
+    options.fov_rad       = real_t(v[9]);
+    options.worldToScreen = real_t(v[10]);
+    options.aperture      = real_t(v[11]);
+    options.focus         = real_t(v[12]);
+    options.gamma         = real_t(v[13]);
+    options.maxDepth      = maxDepth;
+    return options;
+  }
+
+  inline bool isSame(const rt::RenderOptions& a, const rt::RenderOptions& b)
+  {
+    return toValues(a) == toValues(b)  &&  a.maxDepth == b.maxDepth;
+  }
+
+  inline bool readLine(FILE *file, std::string *line)
+  {
+    char buffer[MAX_TYPENAME + 1];
+    if( fscanf(file, " %255[^\n]", buffer) != 1 ) {
+      return false;
+    }
+    *line = buffer;
+    return true;
+  }
+
+} // namespace priv
+
+////// public ////////////////////////////////////////////////////////////////
+
+Checkpoint Checkpoint::create(const rt::RenderContext& rc, const rt::size_t tileSize,
+                              const uint64_t sceneHash)
+{
+  Checkpoint checkpoint;
+  checkpoint.width      = rc.camera->width();
+  checkpoint.height     = rc.camera->height();
+  checkpoint.window     = rc.renderWindow();
+  checkpoint.tileSize   = tileSize;
+  checkpoint.numSamples = rc.sampler->isRandom()
+      ? rc.sampler->numSamplesPerPixel()
+      : 1;
+
+  const rt::SimpleSampler *simple = dynamic_cast<const rt::SimpleSampler*>(rc.sampler.get());
+  if( simple != nullptr  &&  simple->isSeeded() ) {
+    checkpoint.is_seeded   = true;
+    checkpoint.seed        = simple->seed();
+    checkpoint.firstSample = simple->firstSample();
+  }
+
+  // NOTE: The types' names are implementation defined, but stable for a build.
+  checkpoint.sceneHash = sceneHash;
+  checkpoint.renderer  = typeid(*rc.renderer).name();
+  checkpoint.camera    = typeid(*rc.camera).name();
+  checkpoint.options   = rc.renderer->options();
+
+  return checkpoint;
+}
+
+bool Checkpoint::isCompatible(const Checkpoint& other) const
+{
+  return width == other.width  &&  height == other.height  &&
+      priv::isSame(window, other.window)  &&  tileSize == other.tileSize  &&
+      numSamples == other.numSamples  &&  is_seeded == other.is_seeded  &&
+      seed == other.seed  &&  firstSample == other.firstSample  &&
+      sceneHash == other.sceneHash  &&  renderer == other.renderer  &&
+      camera == other.camera  &&  priv::isSame(options, other.options);
+}
+
+bool Checkpoint::load(const std::string& filename)
+{
+  *this = Checkpoint();
+
+  priv::FilePtr file(fopen(filename.data(), "rb"), &fclose);
+  if( !file ) {
+    return false;
+  }
+
+  unsigned long w{0}, h{0}, x0{0}, y0{0}, x1{0}, y1{0}, size{0}, n{0}, first{0}, numTiles{0};
+  int seeded{0};
+  uint64_t s{0}, hash{0};
+  if( fscanf(file.get(), "RTCHECKPOINT 2 %lu %lu %lu %lu %lu %lu %lu %lu %d %" SCNu64 " %lu %" SCNx64,
+             &w, &h, &x0, &y0, &x1, &y1, &size, &n, &seeded, &s, &first, &hash) != 12  ||
+      !priv::readLine(file.get(), &renderer)  ||  !priv::readLine(file.get(), &camera) ) {
+    return false;
+  }
+
+  std::vector<double> values(priv::NUM_OPTIONS);
+  for(double& value : values) {
+    if( fscanf(file.get(), "%la", &value) != 1 ) {
+      return false;
+    }
+  }
+  unsigned int maxDepth{0};
+  if( fscanf(file.get(), "%u %lu", &maxDepth, &numTiles) != 2 ) {
+    return false;
+  }
+
+  width       = w;
+  height      = h;
+  window      = rt::RenderBlock(x0, y0, x1, y1);
+  tileSize    = size;
+  numSamples  = n;
+  is_seeded   = seeded != 0;
+  seed        = s;
+  firstSample = first;
+  sceneHash   = hash;
+  options     = priv::fromValues(values, maxDepth);
+
+  for(unsigned long i = 0; i < numTiles; i++) {
+    if( fscanf(file.get(), "%lu %lu %lu %lu", &x0, &y0, &x1, &y1) != 4 ) {
+      return false;
+    }
+    tiles.emplace_back(x0, y0, x1, y1);
+  }
+
+  return fgetc(file.get()) == '\n'  &&  partial.read(file.get())  &&
+      partial.width() == width  &&  partial.height() == height;
+}
+
+bool Checkpoint::save(const std::string& filename) const
+{
+  const std::string temporary = filename + ".tmp";
+
+  {
+    priv::FilePtr file(fopen(temporary.data(), "wb"), &fclose);
+    if( !file ) {
+      return false;
+    }
+
+    using ulong = unsigned long;
+    if( renderer.empty()  ||  renderer.size() > priv::MAX_TYPENAME  ||
+        camera.empty()  ||  camera.size() > priv::MAX_TYPENAME ) {
+      return false;
+    }
+
+    if( fprintf(file.get(), "RTCHECKPOINT 2\n%lu %lu\n%lu %lu %lu %lu\n%lu\n%lu %d %" PRIu64 " %lu\n"
+                "%016" PRIx64 "\n%s\n%s\n",
+                ulong(width), ulong(height),
+                ulong(window.x0), ulong(window.y0), ulong(window.x1), ulong(window.y1),
+                ulong(tileSize), ulong(numSamples), is_seeded ? 1 : 0, seed, ulong(firstSample),
+                sceneHash, renderer.data(), camera.data()) < 0 ) {
+      return false;
+    }
+
+    for(const double value : priv::toValues(options)) {
+      if( fprintf(file.get(), "%a ", value) < 0 ) {
+        return false;
+      }
+    }
+    if( fprintf(file.get(), "%u\n%lu\n", options.maxDepth, ulong(tiles.size())) < 0 ) {
+      return false;
+    }
+
+    for(const rt::RenderBlock& tile : tiles) {
+      if( fprintf(file.get(), "%lu %lu %lu %lu\n",
+                  ulong(tile.x0), ulong(tile.y0), ulong(tile.x1), ulong(tile.y1)) < 0 ) {
+        return false;
+      }
+    }
+
+    if( !partial.write(file.get())  ||  fflush(file.get()) != 0 ) {
+      return false;
+    }
+  }
+
+  return std::rename(temporary.data(), filename.data()) == 0;
+}
@@ -29,14 +29,31 @@
 ** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 *****************************************************************************/
 
+#include <csignal>
+
 #include <algorithm>
+#include <atomic>
 #include <chrono>
+#include <condition_variable>
 #include <execution>
 #include <iostream>
 #include <mutex>
+#include <numeric>
+#include <thread>
+#include <vector>
 
 #include "Util/Worker.h"
 
+#include "Util/Checkpoint.h"
+#include "rt/Renderer/PartialImage.h"
+
+namespace priv {
+
+  // NOTE: Set by Worker::terminate(); lock-free, hence safe to use in a signal handler.
+  std::atomic_bool is_terminated{false};
+
+} // namespace priv
+
 template<typename CLOCK>
 struct Elapsed {
   using      minutes = std::chrono::minutes;
@@ -71,46 +88,353 @@ std::basic_ostream<CharT,Traits>& operator<<(std::basic_ostream<CharT,Traits>& o
       << elapsed.msec.count() << "ms";
 }
 
+bool Worker::denoise() const
+{
+  return _denoise;
+}
+
+void Worker::setDenoise(const bool on)
+{
+  _denoise = on;
+}
+
+rt::Denoiser& Worker::denoiser()
+{
+  return _denoiser;
+}
+
+const std::string& Worker::partialFilename() const
+{
+  return _partialFilename;
+}
+
+void Worker::setPartialFilename(const std::string& filename)
+{
+  _partialFilename = filename;
+}
+
+const std::string& Worker::checkpointFilename() const
+{
+  return _checkpointFilename;
+}
+
+void Worker::setCheckpointFilename(const std::string& filename, const unsigned int intervalSec)
+{
+  _checkpointFilename = filename;
+  _checkpointInterval = std::max(1u, intervalSec);
+}
+
+bool Worker::resume() const
+{
+  return _resume;
+}
+
+void Worker::setResume(const bool on)
+{
+  _resume = on;
+}
+
+uint64_t Worker::sceneHash() const
+{
+  return _sceneHash;
+}
+
+void Worker::setSceneHash(const uint64_t hash)
+{
+  _sceneHash = hash;
+}
+
 Image Worker::execute(const rt::RenderContext& rc, const rt::size_t blockSize) const
 {
-  Image image(rc.camera->width(), rc.camera->height());
-  if( image.isEmpty() ) {
+  Image image;
+  if( !execute(&image, rc, blockSize) ) {
     return Image();
   }
+  return image;
+}
+
+bool Worker::execute(Image *image, const rt::RenderContext& rc, const rt::size_t blockSize) const
+{
+  const rt::size_t  width = rc.camera->width();
+  const rt::size_t height = rc.camera->height();
+  if( image->width() != width  ||  image->height() != height ) {
+    if( !image->resize(width, height) ) {
+      return false;
+    }
+  }
 
-  const rt::RenderBlocks blocks = rt::makeRenderBlocks(image.height(), blockSize);
+  const rt::RenderBlock window = rc.renderWindow();
+  rt::RenderBlocks blocks = rt::makeRenderTiles(window, blockSize);
   if( blocks.empty() ) {
-    return Image();
+    return false;
+  }
+  rt::prioritizeRenderBlocks(&blocks, rt::real_t(window.x0 + window.x1)/2,
+                             rt::real_t(window.y0 + window.y1)/2);
+  const std::vector<rt::RenderBlock> tiles(blocks.begin(), blocks.end());
+
+  /*
+   * NOTE:
+   * The frame is rendered separately and composited afterwards, as endFrame()
+   * and the denoiser (re)develop the entire frame.
+   */
+  Image frame(width, height);
+  if( frame.isEmpty() ) {
+    return false;
+  }
+
+  // NOTE: Denoising, partials & checkpoints require the radiance (& AOVs) prior to tone mapping...
+  const bool    have_partial = !_partialFilename.empty();
+  const bool have_checkpoint = !_checkpointFilename.empty();
+  rt::Film film;
+  if( (_denoise  ||  have_partial  ||  have_checkpoint)  &&  !film.resize(width, height, _denoise) ) {
+    return false;
+  }
+  rt::Film *myfilm = _denoise  ||  have_partial  ||  have_checkpoint
+      ? &film
+      : nullptr;
+
+  const rt::size_t numSamples = rc.sampler->isRandom()
+      ? rc.sampler->numSamplesPerPixel()
+      : 1;
+
+  // Resume //////////////////////////////////////////////////////////////////
+
+  const Checkpoint settings = Checkpoint::create(rc, blockSize, _sceneHash);
+
+  std::vector<bool> is_restored(tiles.size(), false);
+  if( have_checkpoint  &&  _resume ) {
+    // NOTE: Refuse to render, lest the checkpoint be overwritten.
+    if( !rc.renderer->isResumable() ) {
+      std::cerr << "ERROR: Renderer does not support resuming!" << std::endl;
+      return false;
+    }
+
+    Checkpoint saved;
+    if(        !saved.load(_checkpointFilename) ) {
+      std::cerr << "WARNING: Unable to resume from \"" << _checkpointFilename << "\"!" << std::endl;
+    } else if( !saved.isCompatible(settings) ) {
+      std::cerr << "ERROR: Checkpoint \"" << _checkpointFilename << "\" does not match frame!" << std::endl;
+      return false;
+    } else {
+      for(const rt::RenderBlock& block : saved.tiles) {
+        for(rt::size_t i = 0; i < tiles.size(); i++) {
+          const rt::RenderBlock& tile = tiles[i];
+          if( tile.x0 != block.x0  ||  tile.y0 != block.y0  ||
+              tile.x1 != block.x1  ||  tile.y1 != block.y1 ) {
+            continue;
+          }
+
+          for(rt::size_t y = tile.y0; y < tile.y1; y++) {
+            for(rt::size_t x = tile.x0; x < tile.x1; x++) {
+              const uint32_t count = saved.partial.count(x, y);
+              film.setPixel(x, y, count > 0
+                            ? saved.partial.sum(x, y)/rt::real_t(count)
+                            : rt::Color(0));
+            }
+          }
+          is_restored[i] = true;
+        }
+      }
+    }
+  }
+
+  std::vector<rt::size_t> pending;
+  std::vector<rt::RenderBlock> completed;
+  for(rt::size_t i = 0; i < tiles.size(); i++) {
+    if( is_restored[i] ) {
+      completed.push_back(tiles[i]);
+    } else {
+      pending.push_back(i);
+    }
+  }
+  const bool is_resumed = !completed.empty();
+  if( is_resumed ) {
+    std::cout << "Resumed " << completed.size() << "/" << tiles.size() << " tiles." << std::endl;
   }
 
   const auto tim_begin = std::chrono::high_resolution_clock::now();
 
-  rt::size_t done = 0;
+  rc.beginFrame();
+
+  // Checkpoints /////////////////////////////////////////////////////////////
+
   std::mutex mutex;
-  std::for_each(std::execution::par_unseq,
-                blocks.begin(), blocks.end(), [&](const rt::RenderBlock& block) -> void {
-    const Image slice = rc.render(block);
+
+  /*
+   * NOTE:
+   * Pixels of completed tiles are no longer written by the render threads;
+   * hence, only taking the list of completed tiles requires locking.
+   */
+  const auto saveCheckpoint = [&]() -> bool {
+    Checkpoint checkpoint = settings;
     {
       std::lock_guard<std::mutex> lock(mutex);
-      const auto [y0, y1] = block;
-      image.copy(y0, slice);
-      done += y1 - y0;
-      progress(done, image.height());
+      checkpoint.tiles = completed;
+    }
+
+    checkpoint.partial.setGamma(rc.renderer->options().gamma);
+    if( !checkpoint.partial.resize(width, height) ) {
+      return false;
+    }
+    for(const rt::RenderBlock& tile : checkpoint.tiles) {
+      checkpoint.partial.add(film, tile, uint32_t(numSamples));
+    }
+
+    if( !checkpoint.save(_checkpointFilename) ) {
+      std::cerr << "ERROR: Unable to save checkpoint \"" << _checkpointFilename << "\"!" << std::endl;
+      return false;
+    }
+    return true;
+  };
+
+  bool is_finished = false;
+  std::mutex finishedMutex;
+  std::condition_variable finishedCond;
+
+  using Handler = void (*)(int);
+  Handler prevHandler = SIG_DFL;
+  std::thread checkpointer;
+  if( have_checkpoint ) {
+    priv::is_terminated = false;
+    prevHandler = std::signal(SIGTERM, &Worker::terminate);
+
+    checkpointer = std::thread([&]() -> void {
+      using clock = std::chrono::steady_clock;
+
+      clock::time_point last = clock::now();
+      std::unique_lock<std::mutex> lock(finishedMutex);
+      while( !is_finished ) {
+        finishedCond.wait_for(lock, std::chrono::milliseconds(100));
+        if( priv::is_terminated ) {
+          rc.cancel();
+          break;
+        }
+
+        if( clock::now() - last >= std::chrono::seconds(_checkpointInterval) ) {
+          lock.unlock();
+          saveCheckpoint();
+          lock.lock();
+          last = clock::now();
+        }
+      }
+    });
+  }
+
+  // Render //////////////////////////////////////////////////////////////////
+
+  /*
+   * NOTE:
+   * Threads fetch the next tile in order of priority from a shared index,
+   * rather than having the tiles partitioned among them up front.
+   */
+  std::vector<unsigned int> threads(std::max(1u, std::thread::hardware_concurrency()));
+  std::iota(threads.begin(), threads.end(), 0);
+
+  const rt::size_t numPixels = window.width()*window.height();
+  rt::size_t done = 0;
+  for(const rt::RenderBlock& tile : completed) {
+    done += tile.width()*tile.height();
+  }
+
+  std::atomic<rt::size_t> next{0};
+  std::for_each(std::execution::par,
+                threads.begin(), threads.end(), [&](const unsigned int /*thread*/) -> void {
+    for(rt::size_t i = next++; i < pending.size()  &&  !rc.isCancelled(); i = next++) {
+      const rt::RenderBlock& tile = tiles[pending[i]];
+      const Image slice = rc.render(tile, myfilm);
+      if( slice.isEmpty() ) {
+        continue;
+      }
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        frame.copy(tile.x0, tile.y0, slice);
+        completed.push_back(tile);
+        const rt::size_t  prevDone = done;
+        done += tile.width()*tile.height();
+        if( (prevDone*100)/numPixels != (done*100)/numPixels ) {
+          progress(done, numPixels);
+        }
+      }
     }
   });
 
+  if( have_checkpoint ) {
+    {
+      std::lock_guard<std::mutex> lock(finishedMutex);
+      is_finished = true;
+    }
+    finishedCond.notify_all();
+    checkpointer.join();
+
+    std::signal(SIGTERM, prevHandler);
+
+    if( saveCheckpoint() ) {
+      std::cout << "Saved checkpoint \"" << _checkpointFilename << "\"." << std::endl;
+    }
+  }
+
+  if( rc.isCancelled() ) {
+    std::cout << "Cancelled!" << std::endl;
+    return false;
+  }
+
+  // NOTE: Restored tiles are developed from their radiance.
+  if( is_resumed ) {
+    const Image developed = film.develop(0, rc.renderer->options().gamma);
+    for(rt::size_t i = 0; i < tiles.size(); i++) {
+      if( is_restored[i] ) {
+        const rt::RenderBlock& tile = tiles[i];
+        frame.copy(tile.x0, tile.y0, developed.crop(tile.x0, tile.y0, tile.width(), tile.height()));
+      }
+    }
+  }
+
+  rc.endFrame(&frame, myfilm);
+
+  for(const rt::RenderStat& stat : rc.renderer->statistics()) {
+    std::cout << stat.name << ": " << stat.value << std::endl;
+  }
+
+  // Partial /////////////////////////////////////////////////////////////////
+
+  if( have_partial ) {
+    rt::PartialImage partial;
+    partial.setGamma(rc.renderer->options().gamma);
+    if( !partial.resize(width, height)  ||
+        !partial.add(film, window, uint32_t(numSamples))  ||
+        !partial.save(_partialFilename.data()) ) {
+      std::cerr << "ERROR: Unable to save partial \"" << _partialFilename << "\"!" << std::endl;
+      return false;
+    }
+  }
+
+  // Post-Process ////////////////////////////////////////////////////////////
+
+  if( _denoise  &&  is_resumed ) {
+    std::cout << "Resumed frames are not denoised!" << std::endl;
+  } else if( _denoise  &&  _denoiser.denoise(myfilm) ) {
+    frame = film.develop(0, rc.renderer->options().gamma);
+  }
+
+  image->copy(window.x0, window.y0, frame.crop(window.x0, window.y0, window.width(), window.height()));
+
   const auto tim_end = std::chrono::high_resolution_clock::now();
   const Elapsed<std::chrono::high_resolution_clock> elapsed(tim_begin, tim_end);
   std::cout << "Duration: " << elapsed << std::endl;
 
-  return image;
+  return true;
 }
 
 ////// private ///////////////////////////////////////////////////////////////
 
-void Worker::progress(const rt::size_t y, const rt::size_t height)
+void Worker::progress(const rt::size_t done, const rt::size_t total)
 {
-  const rt::size_t p = (y*100)/height;
-  printf("Progress: %3d%% (%6d/%6d)\n", int(p), int(y), int(height));
+  const rt::size_t p = (done*100)/total;
+  printf("Progress: %3d%% (%8d/%8d)\n", int(p), int(done), int(total));
   fflush(stdout);
 }
+
+void Worker::terminate(int /*signum*/)
+{
+  priv::is_terminated = true;
+}
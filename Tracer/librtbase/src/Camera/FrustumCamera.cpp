@@ -100,6 +100,48 @@ namespace rt {
     return makeRay(_windowTransform, x, y, sampler);
   }
 
+  real_t FrustumCamera::filmArea() const
+  {
+    return makeFilmArea(_windowTransform);
+  }
+
+  real_t FrustumCamera::lensRadius() const
+  {
+    return _rLens > ZERO  &&  _zFocus < ZERO
+        ? _rLens
+        : 0;
+  }
+
+  bool FrustumCamera::raster(real_t *x, real_t *y, const Vertex& pLens, const Direction& dir) const
+  {
+    if( dir.z >= ZERO ) {
+      return false;
+    }
+
+    if( lensRadius() > ZERO ) {
+      // (1) Image Ray's Focus ///////////////////////////////////////////////
+
+      const real_t tFocus = (_zFocus - pLens.z)/dir.z;
+      const Vertex     pf = pLens + geom::to_vertex(tFocus*dir);
+
+      // (2) Primary Ray to Screen ///////////////////////////////////////////
+
+      const Vertex ps{ pf.x*_zNear/_zFocus, pf.y*_zNear/_zFocus, _zNear};
+
+      // Done! ///////////////////////////////////////////////////////////////
+
+      return makeRaster(x, y, _windowTransform, ps);
+    }
+
+    const Vertex pScreen = geom::to_vertex(dir*(_zNear/dir.z));
+    return makeRaster(x, y, _windowTransform, pScreen);
+  }
+
+  real_t FrustumCamera::zScreen() const
+  {
+    return _zNear;
+  }
+
   CameraPtr FrustumCamera::create(const size_t width, const size_t height,
                                   const real_t fov_rad, const real_t worldToScreen,
                                   const real_t aperture, const real_t focus)
@@ -55,6 +55,11 @@ namespace rt {
     return _height;
   }
 
+  real_t ICamera::lensRadius() const
+  {
+    return 0;
+  }
+
   ////// protected ///////////////////////////////////////////////////////////
 
   bool ICamera::isValidFoV(const real_t fov_rad)
@@ -77,4 +82,32 @@ namespace rt {
     return Ray(org, geom::to_direction(org));
   }
 
+  /*
+   * NOTE:
+   * The window transform 'W' maps a raster position onto the screen located at z = W(2,3).
+   * Only scaling and translation are applied, hence the area of the film at unit
+   * distance and the inverse mapping are readily available.
+   */
+  real_t ICamera::makeFilmArea(const Matrix& W) const
+  {
+    const real_t zScreen = W(2, 3);
+    if( zScreen == ZERO ) {
+      return 0;
+    }
+    return static_cast<real_t>(_width*_height)*Math::abs(W(0, 0)*W(1, 1))/zScreen/zScreen;
+  }
+
+  bool ICamera::makeRaster(real_t *x, real_t *y, const Matrix& W, const Vertex& pScreen) const
+  {
+    if( W(0, 0) == ZERO  ||  W(1, 1) == ZERO ) {
+      return false;
+    }
+
+    *x = (pScreen.x - W(0, 3))/W(0, 0);
+    *y = (pScreen.y - W(1, 3))/W(1, 1);
+
+    return ZERO <= *x  &&  *x < static_cast<real_t>(_width)  &&
+        ZERO <= *y  &&  *y < static_cast<real_t>(_height);
+  }
+
 } // namespace rt
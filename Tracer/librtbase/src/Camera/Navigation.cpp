@@ -0,0 +1,150 @@
+/****************************************************************************
+** Copyright (c) 2021, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#include <algorithm>
+
+#include "rt/Camera/Navigation.h"
+
+namespace rt {
+
+  namespace priv {
+
+    // NOTE: Keep the view direction away from 'cameraUp' to avoid a degenerate look-at.
+    inline constexpr real_t MIN_POLAR_ANGLE = 0.01;
+
+    struct ViewFrame {
+      Direction forward{};
+      Direction   right{};
+      Direction      up{};
+      real_t   distance{0};
+    };
+
+    bool makeViewFrame(ViewFrame *frame, const RenderOptions& options)
+    {
+      const Direction d = geom::to_direction(options.lookAt - options.eye);
+      frame->distance = n4::length(d);
+      if( frame->distance <= ZERO ) {
+        return false;
+      }
+      frame->forward = d/frame->distance;
+
+      const Direction right = n4::cross(frame->forward, options.cameraUp);
+      const real_t   length = n4::length(right);
+      if( length <= ZERO ) {
+        return false;
+      }
+      frame->right = right/length;
+      frame->up    = n4::cross(frame->right, frame->forward);
+
+      return true;
+    }
+
+    // Rodrigues' rotation of 'v' around the normalized 'axis'
+    Direction rotate(const Direction& v, const Direction& axis, const real_t angle)
+    {
+      const real_t cosA = Math::cos(angle);
+      const real_t sinA = Math::sin(angle);
+      return v*cosA + n4::cross(axis, v)*sinA + axis*(n4::dot(axis, v)*(ONE - cosA));
+    }
+
+    RenderOptions translateView(const RenderOptions& options, const Direction& offset)
+    {
+      RenderOptions result = options;
+      result.eye    = options.eye    + geom::to_vertex(offset);
+      result.lookAt = options.lookAt + geom::to_vertex(offset);
+      return result;
+    }
+
+  } // namespace priv
+
+  ////// public //////////////////////////////////////////////////////////////
+
+  RenderOptions orbitView(const RenderOptions& options, const real_t yaw, const real_t pitch)
+  {
+    priv::ViewFrame frame;
+    if( !priv::makeViewFrame(&frame, options) ) {
+      return options;
+    }
+
+    const Direction up = n4::normalize(options.cameraUp);
+
+    // (1) Limit Pitch to the Open Range of Polar Angles ///////////////////////
+
+    const real_t theta = Math::acos(std::clamp<real_t>(n4::dot(-frame.forward, up), -ONE, ONE));
+    const real_t thetaNew = std::clamp<real_t>(theta - pitch,
+                                               priv::MIN_POLAR_ANGLE, PI - priv::MIN_POLAR_ANGLE);
+
+    // (2) Rotate Eye around LookAt ////////////////////////////////////////////
+
+    Direction d = -frame.forward*frame.distance;
+    d = priv::rotate(d, frame.right, thetaNew - theta);
+    d = priv::rotate(d, up, yaw);
+
+    RenderOptions result = options;
+    result.eye = options.lookAt + geom::to_vertex(d);
+
+    return result;
+  }
+
+  RenderOptions panView(const RenderOptions& options, const real_t dx, const real_t dy)
+  {
+    priv::ViewFrame frame;
+    if( !priv::makeViewFrame(&frame, options) ) {
+      return options;
+    }
+    return priv::translateView(options, (frame.right*dx + frame.up*dy)*frame.distance);
+  }
+
+  RenderOptions dollyView(const RenderOptions& options, const real_t scale)
+  {
+    priv::ViewFrame frame;
+    if( !priv::makeViewFrame(&frame, options)  ||  scale <= ZERO ) {
+      return options;
+    }
+
+    RenderOptions result = options;
+    result.eye = options.lookAt - geom::to_vertex(frame.forward*(frame.distance*scale));
+
+    return result;
+  }
+
+  RenderOptions walkView(const RenderOptions& options,
+                         const real_t forward, const real_t right, const real_t up)
+  {
+    priv::ViewFrame frame;
+    if( !priv::makeViewFrame(&frame, options) ) {
+      return options;
+    }
+    return priv::translateView(options,
+                               (frame.forward*forward + frame.right*right + frame.up*up)*frame.distance);
+  }
+
+} // namespace rt
@@ -62,6 +62,25 @@ namespace rt {
     return makeRay(_windowTransform, x, y, sampler);
   }
 
+  real_t SimpleCamera::filmArea() const
+  {
+    return makeFilmArea(_windowTransform);
+  }
+
+  bool SimpleCamera::raster(real_t *x, real_t *y, const Vertex& /*pLens*/, const Direction& dir) const
+  {
+    if( dir.z >= ZERO ) {
+      return false;
+    }
+    const Vertex pScreen = geom::to_vertex(dir*(_windowTransform(2, 3)/dir.z));
+    return makeRaster(x, y, _windowTransform, pScreen);
+  }
+
+  real_t SimpleCamera::zScreen() const
+  {
+    return _windowTransform(2, 3);
+  }
+
   CameraPtr SimpleCamera::create(const size_t width, const size_t height,
                                  const real_t fov_rad)
   {
@@ -171,6 +171,93 @@ namespace rt {
       return n4::normalize(parseVector3D<Direction>(node, "x", "y", "z", ok));
     }
 
+    /*
+     * NOTE: An instance is placed by its optional <Transform>, which is
+     *       repeated by either an <Array> or a <Grid> generator:
+     *
+     *       <Array><Count/><Offset><x/><y/><z/></Offset></Array>
+     *       <Grid><CountX/><CountY/><CountZ/><Step><x/><y/><z/></Step></Grid>
+     *
+     *       Offsets and steps are applied in world space; omitted grid counts
+     *       default to one.
+     */
+    std::vector<Transform> parseInstanceTransforms(const tinyxml2::XMLElement *node, bool *ok)
+    {
+      using MyElem = tinyxml2::XMLElement;
+
+      if( ok != nullptr ) {
+        *ok = false;
+      }
+
+      if( node == nullptr ) {
+        return std::vector<Transform>();
+      }
+
+      bool myOk = false;
+
+      Transform xform;
+      if( const MyElem *elem = node->FirstChildElement("Transform"); elem != nullptr ) {
+        xform = parseTransform(elem, &myOk);
+        if( !myOk ) {
+          return std::vector<Transform>();
+        }
+      }
+
+      // NOTE: An array is a grid along its offset.
+      size_t count[3] = {1, 1, 1};
+      Vertex  step[3] = {0, 0, 0};
+      if( const MyElem *elem = node->FirstChildElement("Array"); elem != nullptr ) {
+        count[0] = parseSize(elem->FirstChildElement("Count"), &myOk);
+        if( !myOk ) {
+          return std::vector<Transform>();
+        }
+
+        step[0] = parseVertex(elem->FirstChildElement("Offset"), &myOk);
+        if( !myOk ) {
+          return std::vector<Transform>();
+        }
+      } else if( const MyElem *elem = node->FirstChildElement("Grid"); elem != nullptr ) {
+        const char *ids[3] = {"CountX", "CountY", "CountZ"};
+        for(size_t i = 0; i < 3; i++) {
+          if( const MyElem *child = elem->FirstChildElement(ids[i]); child != nullptr ) {
+            count[i] = parseSize(child, &myOk);
+            if( !myOk ) {
+              return std::vector<Transform>();
+            }
+          }
+        }
+
+        const Vertex s = parseVertex(elem->FirstChildElement("Step"), &myOk);
+        if( !myOk ) {
+          return std::vector<Transform>();
+        }
+        step[0] = Vertex{s.x, 0, 0};
+        step[1] = Vertex{0, s.y, 0};
+        step[2] = Vertex{0, 0, s.z};
+      }
+
+      if( count[0] < 1  ||  count[1] < 1  ||  count[2] < 1 ) {
+        return std::vector<Transform>();
+      }
+
+      std::vector<Transform> result;
+      result.reserve(count[0]*count[1]*count[2]);
+      for(size_t k = 0; k < count[2]; k++) {
+        for(size_t j = 0; j < count[1]; j++) {
+          for(size_t i = 0; i < count[0]; i++) {
+            const Vertex t = real_t(i)*step[0] + real_t(j)*step[1] + real_t(k)*step[2];
+            result.push_back(Transform::translate(t.x, t.y, t.z)*xform);
+          }
+        }
+      }
+
+      if( ok != nullptr ) {
+        *ok = true;
+      }
+
+      return result;
+    }
+
     Normal parseNormal(const tinyxml2::XMLElement *node, bool *ok)
     {
       return n4::normalize(parseVector3D<Normal>(node, "x", "y", "z", ok));
@@ -0,0 +1,440 @@
+/****************************************************************************
+** Copyright (c) 2021, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#include <algorithm>
+
+#include <tinyxml2.h>
+
+#include "rt/Loader/SceneLoaderStream.h"
+
+#include "rt/Loader/SceneLoaderStringUtil.h"
+
+namespace rt {
+
+  namespace priv {
+
+    ////// Implementation ////////////////////////////////////////////////////
+
+    inline constexpr size_t STREAM_CHUNK_SIZE = 64*1024;
+
+    inline bool isNameEnd(const char c)
+    {
+      return isSpace(c)  ||  c == '/'  ||  c == '>';
+    }
+
+    ////// public ////////////////////////////////////////////////////////////
+
+    XMLStream::XMLStream() noexcept
+    {
+    }
+
+    XMLStream::~XMLStream() noexcept
+    {
+    }
+
+    bool XMLStream::isError() const
+    {
+      return _error;
+    }
+
+    bool XMLStream::open(const char *filename)
+    {
+      _buffer.clear();
+      _empty = _eof = _error = false;
+      _line = 1;
+      _levels.clear();
+      _name.clear();
+      _offset = 0;
+      _pos = 0;
+      _root.clear();
+
+      _file = FilePtr(fopen(filename, "rb"), &fclose);
+      if( !_file ) {
+        _error = true;
+        return false;
+      }
+
+      // NOTE: Skip UTF-8 BOM.
+      if( startsWith("\xEF\xBB\xBF", 0) ) {
+        consume(3);
+      }
+
+      if( nextName() == nullptr ) {
+        _error = true;
+        return false;
+      }
+      _root = _name;
+
+      return enter();
+    }
+
+    const char *XMLStream::rootName() const
+    {
+      return _root.data();
+    }
+
+    const char *XMLStream::nextName()
+    {
+      if( !_name.empty() ) {
+        return _name.data();
+      }
+
+      if( _error  ||  _empty  ||  !skipToTag()  ||  startsWith("</", 0) ) {
+        return nullptr;
+      }
+
+      size_t n = 1;
+      while( ensure(n + 1)  &&  !isNameEnd(_buffer[_pos + n]) ) {
+        n++;
+      }
+      if( !ensure(n + 1)  ||  n < 2 ) {
+        _error = true;
+        return nullptr;
+      }
+      _name.assign(_buffer, _pos + 1, n - 1);
+
+      return _name.data();
+    }
+
+    bool XMLStream::enter()
+    {
+      if( nextName() == nullptr ) {
+        return false;
+      }
+
+      size_t end = 0;
+      bool is_empty = false;
+      if( !scanTag(&end, &is_empty, 0) ) {
+        _error = true;
+        return false;
+      }
+      consume(end);
+
+      _levels.push_back(std::move(_name));
+      _name.clear();
+      _empty = is_empty;
+
+      return true;
+    }
+
+    bool XMLStream::leave()
+    {
+      if( _error  ||  _levels.empty() ) {
+        return false;
+      }
+
+      // NOTE: Skip the remaining children of the current level.
+      while( nextName() != nullptr ) {
+        size_t end = 0;
+        if( !scanElement(&end) ) {
+          _error = true;
+          return false;
+        }
+        consume(end);
+        _name.clear();
+      }
+
+      if( _error ) {
+        return false;
+      }
+
+      if( _empty ) {
+        _empty = false;
+      } else {
+        size_t end = 0;
+        if( !find(&end, ">", 2) ) {
+          _error = true;
+          return false;
+        }
+
+        std::string name(_buffer, _pos + 2, end - 2);
+        name.erase(std::find_if(name.begin(), name.end(), isNameEnd), name.end());
+        if( name != _levels.back() ) {
+          _error = true;
+          return false;
+        }
+
+        consume(end + 1);
+      }
+
+      _levels.pop_back();
+
+      return true;
+    }
+
+    const tinyxml2::XMLElement *XMLStream::read(tinyxml2::XMLDocument *doc, XMLRange *range)
+    {
+      if( nextName() == nullptr ) {
+        return nullptr;
+      }
+
+      size_t end = 0;
+      if( !scanElement(&end) ) {
+        _error = true;
+        return nullptr;
+      }
+
+      if( range != nullptr ) {
+        range->offset = _offset;
+        range->size   = end;
+        range->line   = _line;
+      }
+      doc->Parse(_buffer.data() + _pos, end);
+
+      consume(end);
+      _name.clear();
+
+      if( doc->Error() ) {
+        _error = true;
+        return nullptr;
+      }
+
+      return doc->RootElement();
+    }
+
+    const tinyxml2::XMLElement *XMLStream::read(tinyxml2::XMLDocument *doc, const char *filename,
+                                                const XMLRange& range)
+    {
+      FilePtr file(fopen(filename, "rb"), &fclose);
+      if( !file  ||  fseek(file.get(), long(range.offset), SEEK_SET) != 0 ) {
+        return nullptr;
+      }
+
+      std::string text(range.size, '\0');
+      if( fread(text.data(), 1, text.size(), file.get()) != text.size() ) {
+        return nullptr;
+      }
+
+      if( doc->Parse(text.data(), text.size()) != tinyxml2::XML_SUCCESS ) {
+        return nullptr;
+      }
+
+      return doc->RootElement();
+    }
+
+    int XMLStream::lineNum(const tinyxml2::XMLElement *elem, const XMLRange& range)
+    {
+      return range.line + elem->GetLineNum() - 1;
+    }
+
+    ////// private ///////////////////////////////////////////////////////////
+
+    void XMLStream::consume(const size_t n)
+    {
+      _line   += int(std::count(_buffer.begin() + _pos, _buffer.begin() + _pos + n, '\n'));
+      _offset += n;
+      _pos    += n;
+    }
+
+    bool XMLStream::ensure(const size_t n)
+    {
+      while( _buffer.size() - _pos < n ) {
+        if( !fill() ) {
+          return false;
+        }
+      }
+      return true;
+    }
+
+    bool XMLStream::fill()
+    {
+      if( !_file  ||  _eof ) {
+        return false;
+      }
+
+      // NOTE: Offsets are relative to '_pos', hence discarding consumed text keeps them valid.
+      if( _pos > 0 ) {
+        _buffer.erase(0, _pos);
+        _pos = 0;
+      }
+
+      const size_t size = _buffer.size();
+      _buffer.resize(size + STREAM_CHUNK_SIZE);
+      const size_t numRead = fread(_buffer.data() + size, 1, STREAM_CHUNK_SIZE, _file.get());
+      _buffer.resize(size + numRead);
+
+      if( numRead < STREAM_CHUNK_SIZE ) {
+        _eof = true;
+        if( ferror(_file.get()) != 0 ) {
+          _error = true;
+        }
+      }
+
+      return numRead > 0;
+    }
+
+    bool XMLStream::find(size_t *at, const char *token, const size_t from)
+    {
+      const size_t len = length(token);
+
+      size_t start = from;
+      while( true ) {
+        const size_t pos = _buffer.find(token, _pos + start);
+        if( pos != std::string::npos ) {
+          *at = pos - _pos;
+          return true;
+        }
+
+        // NOTE: The token may straddle the end of the buffer.
+        const size_t size = _buffer.size() - _pos;
+        if( size >= len ) {
+          start = std::max<size_t>(start, size - len + 1);
+        }
+
+        if( !fill() ) {
+          return false;
+        }
+      }
+    }
+
+    bool XMLStream::scanElement(size_t *end)
+    {
+      size_t depth = 0;
+      size_t     n = 0;
+      do {
+        size_t at = 0;
+        if( !find(&at, "<", n) ) {
+          return false;
+        }
+        n = at;
+
+        if(        startsWith("<!--", n) ) {
+          if( !find(&at, "-->", n + 4) ) {
+            return false;
+          }
+          n = at + 3;
+        } else if( startsWith("<![CDATA[", n) ) {
+          if( !find(&at, "]]>", n + 9) ) {
+            return false;
+          }
+          n = at + 3;
+        } else if( startsWith("<?", n) ) {
+          if( !find(&at, "?>", n + 2) ) {
+            return false;
+          }
+          n = at + 2;
+        } else if( startsWith("</", n) ) {
+          if( depth < 1  ||  !find(&at, ">", n + 2) ) {
+            return false;
+          }
+          n = at + 1;
+          depth--;
+        } else {
+          bool is_empty = false;
+          if( !scanTag(&n, &is_empty, n) ) {
+            return false;
+          }
+          if( !is_empty ) {
+            depth++;
+          }
+        }
+      } while( depth > 0 );
+
+      *end = n;
+
+      return true;
+    }
+
+    bool XMLStream::scanTag(size_t *end, bool *is_empty, const size_t from)
+    {
+      char quote = 0;
+      int  level = 0; // NOTE: Internal subset of <!DOCTYPE>.
+      for(size_t n = from + 1; ensure(n + 1); n++) {
+        const char c = _buffer[_pos + n];
+        if(        quote != 0 ) {
+          if( c == quote ) {
+            quote = 0;
+          }
+        } else if( c == '"'  ||  c == '\'' ) {
+          quote = c;
+        } else if( c == '[' ) {
+          level++;
+        } else if( c == ']' ) {
+          level--;
+        } else if( c == '>'  &&  level < 1 ) {
+          if( is_empty != nullptr ) {
+            *is_empty = _buffer[_pos + n - 1] == '/';
+          }
+          *end = n + 1;
+          return true;
+        }
+      }
+
+      return false;
+    }
+
+    bool XMLStream::skipToTag()
+    {
+      size_t at = 0;
+      while( find(&at, "<", 0) ) {
+        consume(at);
+
+        size_t end = 0;
+        if(        startsWith("<!--", 0) ) {
+          if( !find(&end, "-->", 4) ) {
+            break;
+          }
+          consume(end + 3);
+        } else if( startsWith("<![CDATA[", 0) ) {
+          if( !find(&end, "]]>", 9) ) {
+            break;
+          }
+          consume(end + 3);
+        } else if( startsWith("<?", 0) ) {
+          if( !find(&end, "?>", 2) ) {
+            break;
+          }
+          consume(end + 2);
+        } else if( startsWith("<!", 0) ) {
+          if( !scanTag(&end, nullptr, 0) ) {
+            break;
+          }
+          consume(end);
+        } else {
+          return true;
+        }
+      }
+
+      // NOTE: The document ended before the current level was closed.
+      _error = true;
+
+      return false;
+    }
+
+    bool XMLStream::startsWith(const char *token, const size_t at)
+    {
+      const size_t len = length(token);
+      return ensure(at + len)  &&  _buffer.compare(_pos + at, len, token) == 0;
+    }
+
+  } // namespace priv
+
+} // namespace rt
@@ -0,0 +1,283 @@
+/****************************************************************************
+** Copyright (c) 2021, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#include <algorithm>
+#include <cmath>
+#include <execution>
+#include <numeric>
+#include <vector>
+
+#include "rt/Renderer/Denoiser.h"
+
+namespace rt {
+
+  namespace priv {
+
+    inline constexpr real_t ALBEDO_EPSILON = 0x1p-10;
+
+    inline constexpr real_t DENOISE_EPSILON = 0x1p-10;
+
+    // B3 spline kernel
+    inline constexpr real_t KERNEL[5] = {
+      real_t(1)/real_t(16), real_t(1)/real_t(4), real_t(3)/real_t(8),
+      real_t(1)/real_t(4), real_t(1)/real_t(16)
+    };
+
+    inline real_t luminance(const Color& c)
+    {
+      return real_t(0.2126)*c(0) + real_t(0.7152)*c(1) + real_t(0.0722)*c(2);
+    }
+
+    // NOTE: Channels lacking albedo are NOT demodulated.
+    inline Color safeAlbedo(const Color& albedo)
+    {
+      return Color(albedo(0) > ALBEDO_EPSILON ? albedo(0) : ONE,
+                   albedo(1) > ALBEDO_EPSILON ? albedo(1) : ONE,
+                   albedo(2) > ALBEDO_EPSILON ? albedo(2) : ONE);
+    }
+
+    struct DenoiseContext {
+      size_t width{0};
+      size_t height{0};
+      std::vector<AOV> aovs{};
+
+      inline size_t index(const size_t x, const size_t y) const
+      {
+        return y*width + x;
+      }
+    };
+
+    void estimateVariance(const DenoiseContext& ctx, const std::vector<Color>& color,
+                          std::vector<real_t> *variance, const size_t y)
+    {
+      for(size_t x = 0; x < ctx.width; x++) {
+        const size_t p = ctx.index(x, y);
+        if( !ctx.aovs[p].isHit() ) {
+          (*variance)[p] = 0;
+          continue;
+        }
+
+        real_t sum1 = 0, sum2 = 0;
+        size_t count = 0;
+        for(size_t qy = y > 0 ? y - 1 : 0; qy <= std::min(y + 1, ctx.height - 1); qy++) {
+          for(size_t qx = x > 0 ? x - 1 : 0; qx <= std::min(x + 1, ctx.width - 1); qx++) {
+            const size_t q = ctx.index(qx, qy);
+            if( ctx.aovs[q].objectId != ctx.aovs[p].objectId ) {
+              continue;
+            }
+            const real_t l = luminance(color[q]);
+            sum1 += l;
+            sum2 += l*l;
+            count++;
+          }
+        }
+
+        const real_t mean = sum1/real_t(count);
+        (*variance)[p] = std::max<real_t>(0, sum2/real_t(count) - mean*mean);
+      }
+    }
+
+    void filterRow(const DenoiseContext& ctx, const Denoiser& denoiser, const size_t step,
+                   const std::vector<Color>& colorIn, const std::vector<real_t>& varianceIn,
+                   std::vector<Color> *colorOut, std::vector<real_t> *varianceOut,
+                   const size_t y)
+    {
+      const ptrdiff_t  width = ptrdiff_t(ctx.width);
+      const ptrdiff_t height = ptrdiff_t(ctx.height);
+
+      for(size_t x = 0; x < ctx.width; x++) {
+        const size_t   p = ctx.index(x, y);
+        const AOV& aovP = ctx.aovs[p];
+        if( !aovP.isHit() ) {
+          (*colorOut)[p]    = colorIn[p];
+          (*varianceOut)[p] = varianceIn[p];
+          continue;
+        }
+
+        const real_t lumP = luminance(colorIn[p]);
+        const real_t sigZ = denoiser.sigmaDepth()*aovP.depth*real_t(step) + DENOISE_EPSILON;
+
+        Color   sumC;
+        real_t  sumV = 0;
+        real_t  sumW = 0;
+        for(ptrdiff_t j = -2; j <= 2; j++) {
+          const ptrdiff_t qy = ptrdiff_t(y) + j*ptrdiff_t(step);
+          if( qy < 0  ||  qy >= height ) {
+            continue;
+          }
+
+          for(ptrdiff_t i = -2; i <= 2; i++) {
+            const ptrdiff_t qx = ptrdiff_t(x) + i*ptrdiff_t(step);
+            if( qx < 0  ||  qx >= width ) {
+              continue;
+            }
+
+            const size_t   q = ctx.index(size_t(qx), size_t(qy));
+            const AOV& aovQ = ctx.aovs[q];
+            if( aovQ.objectId != aovP.objectId ) {
+              continue;
+            }
+
+            const real_t wN = std::pow(std::max<real_t>(0, n4::dot(aovP.N, aovQ.N)),
+                                       denoiser.sigmaNormal());
+            const real_t wZ = std::exp(-std::abs(aovP.depth - aovQ.depth)/sigZ);
+            // NOTE: Symmetric in 'p' & 'q'; outliers neither lose nor gain energy.
+            const real_t sigL = denoiser.sigmaLuminance()*Math::sqrt(varianceIn[p] + varianceIn[q]) +
+                DENOISE_EPSILON;
+            const real_t   wL = std::exp(-std::abs(lumP - luminance(colorIn[q]))/sigL);
+            const real_t  w = KERNEL[i + 2]*KERNEL[j + 2]*wN*wZ*wL;
+
+            sumC += colorIn[q]*w;
+            sumV += varianceIn[q]*w*w;
+            sumW += w;
+          }
+        }
+
+        // NOTE: 'p' itself always contributes, hence 'sumW' is positive.
+        (*colorOut)[p]    = sumC/sumW;
+        (*varianceOut)[p] = sumV/(sumW*sumW);
+      }
+    }
+
+  } // namespace priv
+
+  ////// public //////////////////////////////////////////////////////////////
+
+  Denoiser::Denoiser() noexcept
+  {
+  }
+
+  Denoiser::~Denoiser() noexcept
+  {
+  }
+
+  size_t Denoiser::numIterations() const
+  {
+    return _numIterations;
+  }
+
+  void Denoiser::setNumIterations(const size_t numIterations)
+  {
+    _numIterations = std::clamp<size_t>(numIterations, 1, 10);
+  }
+
+  real_t Denoiser::sigmaDepth() const
+  {
+    return _sigmaDepth;
+  }
+
+  void Denoiser::setSigmaDepth(const real_t sigma)
+  {
+    _sigmaDepth = std::max<real_t>(0, sigma);
+  }
+
+  real_t Denoiser::sigmaLuminance() const
+  {
+    return _sigmaLuminance;
+  }
+
+  void Denoiser::setSigmaLuminance(const real_t sigma)
+  {
+    _sigmaLuminance = std::max<real_t>(0, sigma);
+  }
+
+  real_t Denoiser::sigmaNormal() const
+  {
+    return _sigmaNormal;
+  }
+
+  void Denoiser::setSigmaNormal(const real_t sigma)
+  {
+    _sigmaNormal = std::max<real_t>(0, sigma);
+  }
+
+  bool Denoiser::denoise(Film *film) const
+  {
+    if( film == nullptr  ||  film->isEmpty()  ||  !film->haveAOVs() ) {
+      return false;
+    }
+
+    // (1) Setup Context & Demodulate Albedo /////////////////////////////////
+
+    priv::DenoiseContext ctx;
+    ctx.width  = film->width();
+    ctx.height = film->height();
+
+    const size_t numPixels = ctx.width*ctx.height;
+
+    std::vector<Color> color(numPixels);
+    std::vector<Color> albedo(numPixels);
+    ctx.aovs.resize(numPixels);
+    for(size_t y = 0; y < ctx.height; y++) {
+      for(size_t x = 0; x < ctx.width; x++) {
+        const size_t p = ctx.index(x, y);
+        ctx.aovs[p] = film->aov(x, y);
+        albedo[p]   = priv::safeAlbedo(ctx.aovs[p].albedo);
+        color[p]    = film->pixel(x, y)/albedo[p];
+      }
+    }
+
+    std::vector<size_t> rows(ctx.height);
+    std::iota(rows.begin(), rows.end(), 0);
+
+    // (2) Estimate Variance /////////////////////////////////////////////////
+
+    std::vector<real_t> variance(numPixels);
+    std::for_each(std::execution::par, rows.begin(), rows.end(), [&](const size_t y) -> void {
+      priv::estimateVariance(ctx, color, &variance, y);
+    });
+
+    // (3) Filter ////////////////////////////////////////////////////////////
+
+    std::vector<Color>  colorTmp(numPixels);
+    std::vector<real_t> varianceTmp(numPixels);
+    for(size_t i = 0; i < _numIterations; i++) {
+      const size_t step = size_t{1} << i;
+      std::for_each(std::execution::par, rows.begin(), rows.end(), [&](const size_t y) -> void {
+        priv::filterRow(ctx, *this, step, color, variance, &colorTmp, &varianceTmp, y);
+      });
+      color.swap(colorTmp);
+      variance.swap(varianceTmp);
+    }
+
+    // (4) Remodulate Albedo /////////////////////////////////////////////////
+
+    for(size_t y = 0; y < ctx.height; y++) {
+      for(size_t x = 0; x < ctx.width; x++) {
+        const size_t p = ctx.index(x, y);
+        film->setPixel(x, y, color[p]*albedo[p]);
+      }
+    }
+
+    return true;
+  }
+
+} // namespace rt
@@ -0,0 +1,191 @@
+/****************************************************************************
+** Copyright (c) 2021, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#include "rt/Renderer/Film.h"
+
+#include "rt/Renderer/RenderLoop.h"
+
+namespace rt {
+
+  ////// public //////////////////////////////////////////////////////////////
+
+  Film::Film() noexcept
+  {
+  }
+
+  Film::~Film() noexcept
+  {
+  }
+
+  bool Film::haveAOVs() const
+  {
+    return !_aovs.empty();
+  }
+
+  bool Film::isEmpty() const
+  {
+    return _pixels.empty();
+  }
+
+  size_t Film::width() const
+  {
+    return _width;
+  }
+
+  size_t Film::height() const
+  {
+    return _height;
+  }
+
+  void Film::clear()
+  {
+    _width = _height = 0;
+    _aovs.clear();
+    _pixels.clear();
+    _splats.reset();
+  }
+
+  bool Film::resize(const size_t width, const size_t height, const bool with_aovs)
+  {
+    clear();
+
+    if( width < 1  ||  height < 1 ) {
+      return false;
+    }
+
+    const size_t numPixels = width*height;
+
+    try {
+      if( with_aovs ) {
+        _aovs.resize(numPixels);
+      }
+      _pixels.resize(numPixels);
+      _splats = std::make_unique<std::atomic<real_t>[]>(numPixels*3);
+    } catch(...) {
+      clear();
+      return false;
+    }
+
+    for(size_t i = 0; i < numPixels*3; i++) {
+      _splats[i].store(0, std::memory_order_relaxed);
+    }
+
+    _width  = width;
+    _height = height;
+
+    return true;
+  }
+
+  bool Film::accumulate(const Film& pass, const real_t weight)
+  {
+    if( isEmpty()  ||  pass.width() != _width  ||  pass.height() != _height ) {
+      return false;
+    }
+
+    for(size_t y = 0; y < _height; y++) {
+      for(size_t x = 0; x < _width; x++) {
+        Color& L = _pixels[index(x, y)];
+        L += weight*(pass.pixel(x, y) - L);
+      }
+    }
+
+    return true;
+  }
+
+  AOV Film::aov(const size_t x, const size_t y) const
+  {
+    return haveAOVs()
+        ? _aovs[index(x, y)]
+        : AOV();
+  }
+
+  void Film::setAOV(const size_t x, const size_t y, const AOV& aov)
+  {
+    if( haveAOVs() ) {
+      _aovs[index(x, y)] = aov;
+    }
+  }
+
+  Color Film::pixel(const size_t x, const size_t y) const
+  {
+    return _pixels[index(x, y)];
+  }
+
+  void Film::setPixel(const size_t x, const size_t y, const Color& L)
+  {
+    _pixels[index(x, y)] = L;
+  }
+
+  Color Film::splat(const size_t x, const size_t y) const
+  {
+    const size_t i = index(x, y)*3;
+    return Color(_splats[i + 0].load(std::memory_order_relaxed),
+                 _splats[i + 1].load(std::memory_order_relaxed),
+                 _splats[i + 2].load(std::memory_order_relaxed));
+  }
+
+  void Film::addSplat(const real_t x, const real_t y, const Color& L)
+  {
+    if( isEmpty()  ||  !(x >= ZERO)  ||  !(y >= ZERO) ) {
+      return;
+    }
+
+    const size_t ix = static_cast<size_t>(x);
+    const size_t iy = static_cast<size_t>(y);
+    if( ix >= _width  ||  iy >= _height ) {
+      return;
+    }
+
+    const size_t i = index(ix, iy)*3;
+    _splats[i + 0].fetch_add(L(0), std::memory_order_relaxed);
+    _splats[i + 1].fetch_add(L(1), std::memory_order_relaxed);
+    _splats[i + 2].fetch_add(L(2), std::memory_order_relaxed);
+  }
+
+  Image Film::develop(const real_t splatScale, const real_t gamma) const
+  {
+    if( isEmpty() ) {
+      return Image();
+    }
+
+    Image image(_width, _height);
+    if( image.isEmpty() ) {
+      return Image();
+    }
+
+    render_loop(image, 0, 0, [&](const size_t x, const size_t y) -> Color {
+      return pixel(x, y) + splatScale*splat(x, y);
+    }, gamma);
+
+    return image;
+  }
+
+} // namespace rt
@@ -73,47 +73,133 @@ namespace rt {
     _view = xfrmCW.inverse()*Transform::lookAt(eyeC, lookAtC, cameraUpC);
   }
 
-  Image IRenderer::render(size_t y0, size_t y1, const ScenePtr& scene,
-                          const CameraPtr& camera, const SamplerPtr& sampler) const
+  bool IRenderer::isCancelled() const
   {
-    Image image = createImage(y0, y1, camera);
+    return _cancelled.load(std::memory_order_relaxed);
+  }
+
+  void IRenderer::setCancelled(const bool on)
+  {
+    _cancelled.store(on, std::memory_order_relaxed);
+  }
+
+  bool IRenderer::isResumable() const
+  {
+    return true;
+  }
+
+  void IRenderer::beginFrame(const ScenePtr& /*scene*/, const CameraPtr& /*camera*/,
+                             const SamplerPtr& /*sampler*/)
+  {
+  }
+
+  bool IRenderer::endFrame(Image * /*image*/, Film * /*film*/) const
+  {
+    return false;
+  }
+
+  RenderStats IRenderer::statistics() const
+  {
+    return RenderStats();
+  }
+
+  Image IRenderer::render(RenderBlock block, const ScenePtr& scene,
+                          const CameraPtr& camera, const SamplerPtr& sampler,
+                          Film *film) const
+  {
+    Image image = createImage(block, camera);
     if( image.isEmpty() ) {
       return Image();
     }
 
+    const bool have_film = film != nullptr  &&
+        film->width() == camera->width()  &&  film->height() == camera->height();
+    const bool have_aovs = have_film  &&  film->haveAOVs();
+
+    bool is_done = false;
     if( sampler->isRandom() ) {
-      render_loop(image, y0, [&](const size_t x, const size_t y) -> Color {
+      is_done = render_loop(image, block.x0, block.y0, [&](const size_t x, const size_t y) -> Color {
         Color color;
+        AOVAccumulator aovs;
         for(size_t s = 0; s < sampler->numSamplesPerPixel(); s++) {
-          const Color Li = radiance(_view*camera->ray(x, y, sampler), scene, sampler);
+          if( isCancelled() ) {
+            break;
+          }
+
+          sampler->beginSample(x, y, s);
+
+          Ray ray;
+          const Color Li = primaryRadiance(&ray, x, y, s, scene, camera, sampler);
           color += Li;
+
+          if( AOV aov; have_aovs  &&  scene->aov(&aov, ray) ) {
+            aovs.add(aov);
+          }
         }
         color /= static_cast<real_t>(sampler->numSamplesPerPixel());
+
+        if( have_film ) {
+          film->setPixel(x, y, color);
+          film->setAOV(x, y, aovs.average());
+        }
+
         return color;
-      }, _options.gamma);
+      }, _options.gamma, &_cancelled);
     } else {
-      render_loop(image, y0, [&](const size_t x, const size_t y) -> Color {
-        const Color Li = radiance(_view*camera->ray(x, y, sampler), scene, sampler);
+      is_done = render_loop(image, block.x0, block.y0, [&](const size_t x, const size_t y) -> Color {
+        sampler->beginSample(x, y, 0);
+
+        Ray ray;
+        const Color Li = primaryRadiance(&ray, x, y, 0, scene, camera, sampler);
+
+        if( have_film ) {
+          AOV aov;
+          if( have_aovs ) {
+            scene->aov(&aov, ray);
+          }
+          film->setPixel(x, y, Li);
+          film->setAOV(x, y, aov);
+        }
+
         return Li;
-      }, _options.gamma);
+      }, _options.gamma, &_cancelled);
     }
 
-    return image;
+    return is_done  &&  !isCancelled()
+        ? image
+        : Image();
   }
 
-  ////// private /////////////////////////////////////////////////////////////
+  ////// protected ///////////////////////////////////////////////////////////
 
-  Image IRenderer::createImage(size_t& y0, size_t& y1, const CameraPtr& camera)
+  const std::atomic_bool& IRenderer::cancelled() const
+  {
+    return _cancelled;
+  }
+
+  const Transform& IRenderer::view() const
+  {
+    return _view;
+  }
+
+  Image IRenderer::createImage(RenderBlock& block, const CameraPtr& camera)
   {
     if( !camera  ||  camera->width() < 1  ||  camera->height() < 1 ) {
       return Image();
     }
-    y0 = std::clamp<size_t>(y0, 0, camera->height());
-    y1 = std::clamp<size_t>(y1, 0, camera->height());
-    if( y0 >= y1  ||  y0 >= camera->height() ) {
+    block = block.clipped(camera->width(), camera->height());
+    if( block.isEmpty() ) {
       return Image();
     }
-    return Image(camera->width(), y1 - y0);
+    return Image(block.width(), block.height());
+  }
+
+  Color IRenderer::primaryRadiance(Ray *ray, const size_t x, const size_t y, const size_t /*s*/,
+                                   const ScenePtr& scene, const CameraPtr& camera,
+                                   const SamplerPtr& sampler) const
+  {
+    *ray = _view*camera->ray(x, y, sampler);
+    return radiance(*ray, scene, sampler);
   }
 
 } // namespace rt
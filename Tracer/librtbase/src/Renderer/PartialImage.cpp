@@ -0,0 +1,333 @@
+/****************************************************************************
+** Copyright (c) 2021, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#include <cstdio>
+#include <cstring>
+
+#include <algorithm>
+#include <bit>
+#include <memory>
+
+#include "rt/Renderer/PartialImage.h"
+
+#include "rt/Renderer/Film.h"
+#include "rt/Renderer/RenderLoop.h"
+
+namespace rt {
+
+  namespace priv {
+
+    using FilePtr = std::unique_ptr<FILE,decltype(&fclose)>;
+
+    inline constexpr size_t PIXEL_SIZE = 3*sizeof(float) + sizeof(uint32_t);
+
+    inline bool isLittleEndian()
+    {
+      return std::endian::native == std::endian::little;
+    }
+
+    template<typename T>
+    inline T readValue(const unsigned char *data, const bool do_swap)
+    {
+      unsigned char bytes[sizeof(T)];
+      memcpy(bytes, data, sizeof(T));
+      if( do_swap ) {
+        std::reverse(bytes, bytes + sizeof(T));
+      }
+      T value;
+      memcpy(&value, bytes, sizeof(T));
+      return value;
+    }
+
+    template<typename T>
+    inline void writeValue(unsigned char *data, const T value)
+    {
+      memcpy(data, &value, sizeof(T));
+    }
+
+  } // namespace priv
+
+  ////// public //////////////////////////////////////////////////////////////
+
+  PartialImage::PartialImage() noexcept
+  {
+  }
+
+  PartialImage::~PartialImage() noexcept
+  {
+  }
+
+  bool PartialImage::isEmpty() const
+  {
+    return _sums.empty();
+  }
+
+  size_t PartialImage::width() const
+  {
+    return _width;
+  }
+
+  size_t PartialImage::height() const
+  {
+    return _height;
+  }
+
+  real_t PartialImage::gamma() const
+  {
+    return _gamma;
+  }
+
+  void PartialImage::setGamma(const real_t gamma)
+  {
+    _gamma = gamma;
+  }
+
+  void PartialImage::clear()
+  {
+    _width = _height = 0;
+    _counts.clear();
+    _sums.clear();
+  }
+
+  bool PartialImage::resize(const size_t width, const size_t height)
+  {
+    clear();
+
+    if( width < 1  ||  height < 1 ) {
+      return false;
+    }
+
+    try {
+      _counts.resize(width*height, 0);
+      _sums.resize(width*height, Color(0));
+    } catch(...) {
+      clear();
+      return false;
+    }
+
+    _width  = width;
+    _height = height;
+
+    return true;
+  }
+
+  Color PartialImage::sum(const size_t x, const size_t y) const
+  {
+    return _sums[index(x, y)];
+  }
+
+  uint32_t PartialImage::count(const size_t x, const size_t y) const
+  {
+    return _counts[index(x, y)];
+  }
+
+  void PartialImage::add(const size_t x, const size_t y, const Color& sum, const uint32_t count)
+  {
+    _sums[index(x, y)]   += sum;
+    _counts[index(x, y)] += count;
+  }
+
+  bool PartialImage::add(const Film& film, const RenderBlock& window, const uint32_t numSamples)
+  {
+    if( film.width() != _width  ||  film.height() != _height ) {
+      return false;
+    }
+
+    const RenderBlock block = window.clipped(_width, _height);
+    for(size_t y = block.y0; y < block.y1; y++) {
+      for(size_t x = block.x0; x < block.x1; x++) {
+        add(x, y, film.pixel(x, y)*real_t(numSamples), numSamples);
+      }
+    }
+
+    return true;
+  }
+
+  Image PartialImage::develop() const
+  {
+    if( isEmpty() ) {
+      return Image();
+    }
+
+    Image image(_width, _height);
+    if( image.isEmpty() ) {
+      return Image();
+    }
+
+    render_loop(image, 0, 0, [&](const size_t x, const size_t y) -> Color {
+      const uint32_t n = count(x, y);
+      return n > 0
+          ? sum(x, y)/real_t(n)
+          : Color(0);
+    }, _gamma);
+
+    return image;
+  }
+
+  bool PartialImage::load(const char *filename)
+  {
+    priv::FilePtr file(fopen(filename, "rb"), &fclose);
+    return file  &&  read(file.get());
+  }
+
+  bool PartialImage::save(const char *filename) const
+  {
+    priv::FilePtr file(fopen(filename, "wb"), &fclose);
+    return file  &&  write(file.get());
+  }
+
+  bool PartialImage::read(FILE *file)
+  {
+    clear();
+
+    char   magic[10] = {0};
+    char  endian[8] = {0};
+    unsigned long w{0}, h{0};
+    float  gamma{1};
+    if( fscanf(file, "%9s %lu %lu %f %7s", magic, &w, &h, &gamma, endian) != 5  ||
+        fgetc(file) != '\n'  ||  strcmp(magic, "RTPARTIAL") != 0 ) {
+      return false;
+    }
+
+    const bool is_little = strcmp(endian, "little") == 0;
+    if( !is_little  &&  strcmp(endian, "big") != 0 ) {
+      return false;
+    }
+    const bool do_swap = is_little != priv::isLittleEndian();
+
+    if( !resize(size_t(w), size_t(h)) ) {
+      return false;
+    }
+    _gamma = gamma;
+
+    std::vector<unsigned char> line(_width*priv::PIXEL_SIZE);
+    for(size_t y = 0; y < _height; y++) {
+      if( fread(line.data(), 1, line.size(), file) != line.size() ) {
+        clear();
+        return false;
+      }
+
+      for(size_t x = 0; x < _width; x++) {
+        const unsigned char *pixel = line.data() + x*priv::PIXEL_SIZE;
+        _sums[index(x, y)] = Color(priv::readValue<float>(pixel, do_swap),
+                                   priv::readValue<float>(pixel + sizeof(float), do_swap),
+                                   priv::readValue<float>(pixel + 2*sizeof(float), do_swap));
+        _counts[index(x, y)] = priv::readValue<uint32_t>(pixel + 3*sizeof(float), do_swap);
+      }
+    }
+
+    return true;
+  }
+
+  bool PartialImage::write(FILE *file) const
+  {
+    if( isEmpty() ) {
+      return false;
+    }
+
+    if( fprintf(file, "RTPARTIAL %lu %lu %f %s\n",
+                static_cast<unsigned long>(_width), static_cast<unsigned long>(_height),
+                static_cast<double>(_gamma), priv::isLittleEndian() ? "little" : "big") < 0 ) {
+      return false;
+    }
+
+    std::vector<unsigned char> line(_width*priv::PIXEL_SIZE);
+    for(size_t y = 0; y < _height; y++) {
+      for(size_t x = 0; x < _width; x++) {
+        unsigned char *pixel = line.data() + x*priv::PIXEL_SIZE;
+        const Color& S = _sums[index(x, y)];
+        priv::writeValue<float>(pixel, float(S(0)));
+        priv::writeValue<float>(pixel + sizeof(float), float(S(1)));
+        priv::writeValue<float>(pixel + 2*sizeof(float), float(S(2)));
+        priv::writeValue<uint32_t>(pixel + 3*sizeof(float), _counts[index(x, y)]);
+      }
+
+      if( fwrite(line.data(), 1, line.size(), file) != line.size() ) {
+        return false;
+      }
+    }
+
+    return true;
+  }
+
+  bool PartialImage::merge(PartialImage *result, const std::vector<const PartialImage*>& partials)
+  {
+    if( partials.empty() ) {
+      return false;
+    }
+
+    const size_t  width = partials.front()->width();
+    const size_t height = partials.front()->height();
+    for(const PartialImage *partial : partials) {
+      if( partial->isEmpty()  ||  partial->width() != width  ||  partial->height() != height ) {
+        return false;
+      }
+    }
+
+    if( !result->resize(width, height) ) {
+      return false;
+    }
+    result->setGamma(partials.front()->gamma());
+
+    /*
+     * NOTE:
+     * Floating point addition is not associative; hence each pixel's sums are added
+     * in ascending order, rendering the result independent of the partials' order.
+     */
+    std::vector<real_t> values(partials.size());
+    for(size_t i = 0; i < width*height; i++) {
+      Color S;
+      for(int c = 0; c < 3; c++) {
+        for(size_t j = 0; j < partials.size(); j++) {
+          values[j] = partials[j]->_sums[i](c);
+        }
+        std::sort(values.begin(), values.end());
+
+        double sum = 0;
+        for(const real_t value : values) {
+          sum += double(value);
+        }
+        S(c) = real_t(sum);
+      }
+
+      uint32_t count = 0;
+      for(const PartialImage *partial : partials) {
+        count += partial->_counts[i];
+      }
+
+      result->_sums[i]   = S;
+      result->_counts[i] = count;
+    }
+
+    return true;
+  }
+
+} // namespace rt
@@ -29,30 +29,69 @@
 ** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 *****************************************************************************/
 
+#include <algorithm>
+
 #include "rt/Renderer/RenderContext.h"
 
 namespace rt {
 
   ////// Public //////////////////////////////////////////////////////////////
 
-  RenderBlocks makeRenderBlocks(const size_t height, const size_t blockSize)
+  RenderBlocks makeRenderBlocks(const RenderBlock& window, const size_t blockSize)
   {
     RenderBlocks blocks;
+    if( window.isEmpty()  ||  blockSize < 1 ) {
+      return blocks;
+    }
+
+    const size_t height = window.height();
 
     const size_t numBlocks = height/blockSize;
     for(size_t i = 0; i < numBlocks; i++) {
-      const size_t y0 = i*blockSize;
-      blocks.emplace_back(y0, y0 + blockSize);
+      const size_t y0 = window.y0 + i*blockSize;
+      blocks.emplace_back(window.x0, y0, window.x1, y0 + blockSize);
     }
 
     if( const size_t numRemain = height%blockSize; numRemain > 0 ) {
-      const size_t y0 = numBlocks*blockSize;
-      blocks.emplace_back(y0, y0 + numRemain);
+      const size_t y0 = window.y0 + numBlocks*blockSize;
+      blocks.emplace_back(window.x0, y0, window.x1, y0 + numRemain);
     }
 
     return blocks;
   }
 
+  RenderBlocks makeRenderTiles(const RenderBlock& window, const size_t tileSize)
+  {
+    RenderBlocks tiles;
+    if( window.isEmpty()  ||  tileSize < 1 ) {
+      return tiles;
+    }
+
+    for(size_t y0 = window.y0; y0 < window.y1; y0 += tileSize) {
+      const size_t y1 = std::min(y0 + tileSize, window.y1);
+      for(size_t x0 = window.x0; x0 < window.x1; x0 += tileSize) {
+        const size_t x1 = std::min(x0 + tileSize, window.x1);
+        tiles.emplace_back(x0, y0, x1, y1);
+      }
+    }
+
+    return tiles;
+  }
+
+  void prioritizeRenderBlocks(RenderBlocks *blocks, const real_t x, const real_t y)
+  {
+    const auto distance2 = [=](const RenderBlock& block) -> real_t {
+      const real_t dx = real_t(block.x0 + block.x1)/2 - x;
+      const real_t dy = real_t(block.y0 + block.y1)/2 - y;
+      return dx*dx + dy*dy;
+    };
+
+    std::stable_sort(blocks->begin(), blocks->end(),
+                     [&](const RenderBlock& a, const RenderBlock& b) -> bool {
+      return distance2(a) < distance2(b);
+    });
+  }
+
   ////// RenderContext - public //////////////////////////////////////////////
 
   void RenderContext::clear()
@@ -61,6 +100,7 @@ namespace rt {
     renderer.reset();
     sampler.reset();
     scene.reset();
+    window = RenderBlock();
   }
 
   bool RenderContext::isValid() const
@@ -68,11 +108,45 @@ namespace rt {
     return camera  &&  renderer  &&  sampler  &&  scene;
   }
 
-  Image RenderContext::render(const RenderBlock& block) const
+  void RenderContext::cancel() const
+  {
+    renderer->setCancelled(true);
+  }
+
+  bool RenderContext::isCancelled() const
+  {
+    return renderer->isCancelled();
+  }
+
+  RenderBlock RenderContext::renderWindow() const
+  {
+    if( !camera ) {
+      return RenderBlock();
+    }
+    return window.isEmpty()
+        ? RenderBlock(0, 0, camera->width(), camera->height())
+        : window.clipped(camera->width(), camera->height());
+  }
+
+  void RenderContext::beginFrame() const
+  {
+    renderer->setCancelled(false);
+    scene->beginFrame(camera, sampler, renderer->options());
+    renderer->beginFrame(scene, camera, sampler);
+  }
+
+  Image RenderContext::render(const RenderBlock& block, Film *film) const
   {
     const SamplerPtr mysampler = sampler->copy();
-    const auto [y0, y1] = block;
-    return renderer->render(y0, y1, scene, camera, mysampler);
+    scene->beginBlock();
+    Image image = renderer->render(block, scene, camera, mysampler, film);
+    scene->endBlock();
+    return image;
+  }
+
+  bool RenderContext::endFrame(Image *image, Film *film) const
+  {
+    return renderer->endFrame(image, film);
   }
 
 } // namespace rt
@@ -0,0 +1,193 @@
+/****************************************************************************
+** Copyright (c) 2021, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#include <algorithm>
+#include <limits>
+
+#include "rt/Sampler/Distribution.h"
+
+namespace rt {
+
+  namespace priv {
+
+    inline constexpr real_t ONE_MINUS_EPSILON = ONE - std::numeric_limits<real_t>::epsilon();
+
+    inline size_t clampIndex(const real_t x, const size_t n)
+    {
+      return x > ZERO
+          ? std::min<size_t>(size_t(x*real_t(n)), n - 1)
+          : 0;
+    }
+
+  } // namespace priv
+
+  ////// Distribution1D //////////////////////////////////////////////////////
+
+  Distribution1D::Distribution1D() noexcept
+  {
+  }
+
+  Distribution1D::Distribution1D(const real_t *f, const size_t n) noexcept
+    : _func(f, f + n)
+    , _cdf(n + 1)
+  {
+    if( n < 1 ) {
+      _cdf.clear();
+      return;
+    }
+
+    _cdf[0] = 0;
+    for(size_t i = 1; i <= n; i++) {
+      _func[i - 1] = Math::abs(_func[i - 1]);
+      _cdf[i] = _cdf[i - 1] + _func[i - 1]/real_t(n);
+    }
+
+    _integral = _cdf[n];
+    for(size_t i = 1; i <= n; i++) {
+      _cdf[i] = _integral > ZERO
+          ? _cdf[i]/_integral
+          : real_t(i)/real_t(n);
+    }
+  }
+
+  Distribution1D::~Distribution1D() noexcept
+  {
+  }
+
+  size_t Distribution1D::count() const
+  {
+    return _func.size();
+  }
+
+  real_t Distribution1D::func(const size_t i) const
+  {
+    return _func[i];
+  }
+
+  real_t Distribution1D::integral() const
+  {
+    return _integral;
+  }
+
+  real_t Distribution1D::pdf(const real_t x) const
+  {
+    if( _integral <= ZERO ) {
+      return 0;
+    }
+    return _func[priv::clampIndex(x, count())]/_integral;
+  }
+
+  real_t Distribution1D::sample(const real_t xi, real_t *pdf, size_t *offset) const
+  {
+    if( count() < 1 ) {
+      *pdf = 0;
+      return 0;
+    }
+
+    // Find the last CDF entry less than or equal to 'xi'...
+    const auto      it = std::upper_bound(_cdf.begin(), _cdf.end(), xi);
+    const size_t index = std::clamp<size_t>(size_t(std::distance(_cdf.begin(), it)), 1, count()) - 1;
+    if( offset != nullptr ) {
+      *offset = index;
+    }
+
+    // ...and compute the offset within the segment.
+    real_t du = xi - _cdf[index];
+    if( _cdf[index + 1] - _cdf[index] > ZERO ) {
+      du /= _cdf[index + 1] - _cdf[index];
+    }
+
+    *pdf = _integral > ZERO
+        ? _func[index]/_integral
+        : 0;
+
+    return std::min<real_t>((real_t(index) + du)/real_t(count()), priv::ONE_MINUS_EPSILON);
+  }
+
+  ////// Distribution2D //////////////////////////////////////////////////////
+
+  Distribution2D::Distribution2D() noexcept
+  {
+  }
+
+  Distribution2D::Distribution2D(const real_t *f, const size_t nu, const size_t nv) noexcept
+  {
+    if( nu < 1  ||  nv < 1 ) {
+      return;
+    }
+
+    _conditional.reserve(nv);
+    std::vector<real_t> marginal(nv);
+    for(size_t v = 0; v < nv; v++) {
+      _conditional.emplace_back(f + v*nu, nu);
+      marginal[v] = _conditional.back().integral();
+    }
+    _marginal = Distribution1D(marginal.data(), nv);
+  }
+
+  Distribution2D::~Distribution2D() noexcept
+  {
+  }
+
+  bool Distribution2D::isEmpty() const
+  {
+    return _marginal.integral() <= ZERO;
+  }
+
+  real_t Distribution2D::pdf(const real_t u, const real_t v) const
+  {
+    if( isEmpty() ) {
+      return 0;
+    }
+    const Distribution1D& conditional = _conditional[priv::clampIndex(v, _conditional.size())];
+    return conditional.func(priv::clampIndex(u, conditional.count()))/_marginal.integral();
+  }
+
+  std::tuple<real_t,real_t> Distribution2D::sample(const Sample2D& xi, real_t *pdf) const
+  {
+    SAMPLES_2D(xi);
+
+    if( isEmpty() ) {
+      *pdf = 0;
+      return std::tuple<real_t,real_t>{0, 0};
+    }
+
+    real_t pdfV{0}, pdfU{0};
+    size_t    iv{0};
+    const real_t v = _marginal.sample(xi2, &pdfV, &iv);
+    const real_t u = _conditional[iv].sample(xi1, &pdfU);
+
+    *pdf = pdfV*pdfU;
+
+    return std::tuple<real_t,real_t>{u, v};
+  }
+
+} // namespace rt
@@ -52,4 +52,12 @@ namespace rt {
     return _numSamplesPerPixel;
   }
 
+  void ISampler::beginSample(const size_t /*x*/, const size_t /*y*/, const size_t /*s*/) const
+  {
+  }
+
+  void ISampler::beginStream(const size_t /*id*/) const
+  {
+  }
+
 } // namespace rt
@@ -29,33 +29,111 @@
 ** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 *****************************************************************************/
 
+#include <cmath>
+
+#include <limits>
+#include <random>
+
 #include "rt/Sampler/SimpleSampler.h"
 
 namespace rt {
 
+  namespace priv {
+
+    // NOTE: SplitMix64; cheap to (re)seed, as required to restart it for each sample.
+    inline uint64_t splitmix64(uint64_t *state)
+    {
+      uint64_t z = (*state += 0x9E3779B97F4A7C15);
+      z = (z ^ (z >> 30))*0xBF58476D1CE4E5B9;
+      z = (z ^ (z >> 27))*0x94D049BB133111EB;
+      return z ^ (z >> 31);
+    }
+
+    inline uint64_t randomSeed()
+    {
+      std::random_device randDev;
+      return (uint64_t(randDev()) << 32) | uint64_t(randDev());
+    }
+
+    thread_local uint64_t state = randomSeed();
+
+    // NOTE: Separates the streams' states from the pixels' ones.
+    inline constexpr uint64_t STREAM_DOMAIN = 0x53545245414D5321; // "STREAMS!"
+
+  } // namespace priv
+
   ////// public //////////////////////////////////////////////////////////////
 
   SimpleSampler::SimpleSampler(const size_t numSamplesPerPixel)
     : ISampler(numSamplesPerPixel)
   {
-    _dis = std::uniform_real_distribution<real_t>(ZERO, ONE);
+  }
 
-    std::random_device randDev;
-    _gen.seed(randDev());
+  SimpleSampler::SimpleSampler(const size_t numSamplesPerPixel, const uint64_t seed,
+                               const size_t firstSample)
+    : ISampler(numSamplesPerPixel)
+    , _is_seeded{true}
+    , _seed{seed}
+    , _firstSample{firstSample}
+  {
   }
 
   SimpleSampler::~SimpleSampler()
   {
   }
 
+  bool SimpleSampler::isSeeded() const
+  {
+    return _is_seeded;
+  }
+
+  uint64_t SimpleSampler::seed() const
+  {
+    return _seed;
+  }
+
+  size_t SimpleSampler::firstSample() const
+  {
+    return _firstSample;
+  }
+
   SamplerPtr SimpleSampler::copy() const
   {
-    return create(numSamplesPerPixel());
+    return _is_seeded
+        ? create(numSamplesPerPixel(), _seed, _firstSample)
+        : create(numSamplesPerPixel());
+  }
+
+  void SimpleSampler::beginSample(const size_t x, const size_t y, const size_t s) const
+  {
+    if( !_is_seeded ) {
+      return;
+    }
+
+    uint64_t state = _seed;
+    state = priv::splitmix64(&state) ^ uint64_t(x);
+    state = priv::splitmix64(&state) ^ uint64_t(y);
+    state = priv::splitmix64(&state) ^ uint64_t(_firstSample + s);
+    priv::state = priv::splitmix64(&state);
+  }
+
+  void SimpleSampler::beginStream(const size_t id) const
+  {
+    if( !_is_seeded ) {
+      return;
+    }
+
+    uint64_t state = _seed ^ priv::STREAM_DOMAIN;
+    state = priv::splitmix64(&state) ^ uint64_t(_firstSample);
+    state = priv::splitmix64(&state) ^ uint64_t(id);
+    priv::state = priv::splitmix64(&state);
   }
 
   real_t SimpleSampler::sample() const
   {
-    return _dis(*const_cast<std::mt19937*>(&_gen));
+    // NOTE: The most significant bits fill the mantissa; hence the sample is in [0,1).
+    constexpr int numDigits = std::numeric_limits<real_t>::digits;
+    return std::ldexp(real_t(priv::splitmix64(&priv::state) >> (64 - numDigits)), -numDigits);
   }
 
   Sample2D SimpleSampler::sample2D() const
@@ -68,4 +146,10 @@ namespace rt {
     return std::make_unique<SimpleSampler>(numSamplesPerPixel);
   }
 
+  SamplerPtr SimpleSampler::create(const size_t numSamplesPerPixel, const uint64_t seed,
+                                   const size_t firstSample)
+  {
+    return std::make_unique<SimpleSampler>(numSamplesPerPixel, seed, firstSample);
+  }
+
 } // namespace rt
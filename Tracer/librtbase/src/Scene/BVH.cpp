@@ -0,0 +1,360 @@
+/****************************************************************************
+** Copyright (c) 2021, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#include <algorithm>
+#include <chrono>
+#include <numeric>
+
+#include "rt/Scene/BVH.h"
+
+namespace rt {
+
+  namespace priv {
+
+    inline bool isSame(const Bounds& a, const Bounds& b)
+    {
+      const Vertex amin = a.min();
+      const Vertex amax = a.max();
+      const Vertex bmin = b.min();
+      const Vertex bmax = b.max();
+      return
+          amin.x == bmin.x  &&  amin.y == bmin.y  &&  amin.z == bmin.z  &&
+          amax.x == bmax.x  &&  amax.y == bmax.y  &&  amax.z == bmax.z;
+    }
+
+    inline void merge(Bounds *result, const Bounds& b)
+    {
+      if( b.isValid() ) {
+        result->update(b.min());
+        result->update(b.max());
+      }
+    }
+
+    inline real_t surfaceArea(const Bounds& b)
+    {
+      if( !b.isValid() ) {
+        return 0;
+      }
+      const Vertex d = b.max() - b.min();
+      return TWO*(d.x*d.y + d.y*d.z + d.z*d.x);
+    }
+
+    // NOTE: Traversal & intersection are weighted equally.
+    inline real_t nodeCost(const Bounds& bounds, const uint32_t count)
+    {
+      return surfaceArea(bounds)*real_t(std::max<uint32_t>(1, count));
+    }
+
+    inline Vertex centroid(const Bounds& b)
+    {
+      return b.isValid()
+          ? (b.min() + b.max())*ONE_HALF
+          : Vertex(0);
+    }
+
+  } // namespace priv
+
+  ////// public //////////////////////////////////////////////////////////////
+
+  BVH::BVH() noexcept = default;
+
+  BVH::~BVH() noexcept = default;
+
+  BVH::BVH(BVH&&) noexcept = default;
+
+  BVH& BVH::operator=(BVH&&) noexcept = default;
+
+  void BVH::clear()
+  {
+    if( _rebuild.valid() ) {
+      _rebuild.wait();
+    }
+    _rebuild = std::future<Tree>();
+
+    _bounds.clear();
+    _buildCost = 0;
+    _tree = Tree();
+  }
+
+  bool BVH::isEmpty() const
+  {
+    return _tree.nodes.empty();
+  }
+
+  size_t BVH::numNodes() const
+  {
+    return _tree.nodes.size();
+  }
+
+  size_t BVH::numPrimitives() const
+  {
+    return _bounds.size();
+  }
+
+  void BVH::build(const std::vector<Bounds>& bounds)
+  {
+    clear();
+
+    _bounds    = bounds;
+    _tree      = buildTree(_bounds);
+    _buildCost = cost(_tree);
+  }
+
+  void BVH::refit(const size_t prim, const Bounds& bounds)
+  {
+    if( prim >= _bounds.size() ) {
+      return;
+    }
+    _bounds[prim] = bounds;
+
+    if( prim >= _tree.leafOf.size() ) {
+      return;
+    }
+
+    uint32_t index = _tree.leafOf[prim];
+    while( true ) {
+      Node& node = _tree.nodes[index];
+
+      Bounds refitted;
+      if( node.count > 0 ) {
+        for(uint32_t i = 0; i < node.count; i++) {
+          priv::merge(&refitted, _bounds[_tree.prims[node.first + i]]);
+        }
+      } else {
+        priv::merge(&refitted, _tree.nodes[node.first].bounds);
+        priv::merge(&refitted, _tree.nodes[node.first + 1].bounds);
+      }
+
+      // NOTE: Unchanged bounds leave all ancestors unchanged, too.
+      if( priv::isSame(refitted, node.bounds) ) {
+        break;
+      }
+
+      _tree.sumCost -= priv::nodeCost(node.bounds, node.count);
+      node.bounds = refitted;
+      _tree.sumCost += priv::nodeCost(node.bounds, node.count);
+
+      if( index == 0 ) {
+        break;
+      }
+      index = node.parent;
+    }
+  }
+
+  real_t BVH::cost() const
+  {
+    return cost(_tree);
+  }
+
+  real_t BVH::buildCost() const
+  {
+    return _buildCost;
+  }
+
+  bool BVH::isRebuilding() const
+  {
+    return _rebuild.valid();
+  }
+
+  real_t BVH::rebuildThreshold() const
+  {
+    return _rebuildThreshold;
+  }
+
+  void BVH::setRebuildThreshold(const real_t ratio)
+  {
+    _rebuildThreshold = std::max<real_t>(1, ratio);
+  }
+
+  bool BVH::update(const bool wait)
+  {
+    bool is_swapped = false;
+
+    if( _rebuild.valid()  &&
+        (wait  ||  _rebuild.wait_for(std::chrono::seconds(0)) == std::future_status::ready) ) {
+      _tree = _rebuild.get();
+      // NOTE: Primitives may have moved since the snapshot was taken.
+      refitAll(&_tree, _bounds);
+      _buildCost = cost(_tree);
+      is_swapped = true;
+    }
+
+    if( !_rebuild.valid()  &&  !_tree.nodes.empty()  &&
+        cost(_tree) > _rebuildThreshold*_buildCost ) {
+      _rebuild = std::async(std::launch::async, [snapshot = _bounds]() -> Tree {
+        return buildTree(snapshot);
+      });
+    }
+
+    return is_swapped;
+  }
+
+  ////// private /////////////////////////////////////////////////////////////
+
+  BVH::Tree BVH::buildTree(const std::vector<Bounds>& bounds)
+  {
+    Tree tree;
+
+    const size_t numPrims = bounds.size();
+    if( numPrims < 1 ) {
+      return tree;
+    }
+
+    tree.prims.resize(numPrims);
+    std::iota(tree.prims.begin(), tree.prims.end(), 0);
+    tree.leafOf.resize(numPrims, 0);
+    tree.nodes.reserve(2*numPrims);
+    tree.nodes.emplace_back();
+
+    std::vector<Vertex> centroids(numPrims);
+    std::transform(bounds.begin(), bounds.end(), centroids.begin(), priv::centroid);
+
+    std::vector<real_t> areaRight(numPrims);
+
+    const auto build = [&](const auto& self, const uint32_t index,
+                           const uint32_t first, const uint32_t count,
+                           const size_t depth) -> void {
+      const auto begin = tree.prims.begin() + first;
+      const auto   end = begin + count;
+
+      Bounds nodeBounds;
+      for(auto it = begin; it != end; ++it) {
+        priv::merge(&nodeBounds, bounds[*it]);
+      }
+      tree.nodes[index].bounds = nodeBounds;
+
+      // (1) Find Split //////////////////////////////////////////////////////
+
+      const real_t leafCost = priv::nodeCost(nodeBounds, count);
+
+      real_t bestCost = MAX_REAL_T;
+      uint32_t bestAxis = 0;
+      uint32_t bestSplit = count/2;
+      if( count > 1  &&  depth < MAX_SAH_DEPTH ) {
+        for(uint32_t axis = 0; axis < 3; axis++) {
+          std::sort(begin, end, [&](const uint32_t a, const uint32_t b) -> bool {
+            return centroids[a](axis) < centroids[b](axis);
+          });
+
+          Bounds right;
+          for(uint32_t i = count; i > 0; i--) {
+            priv::merge(&right, bounds[*(begin + (i - 1))]);
+            areaRight[i - 1] = priv::surfaceArea(right);
+          }
+
+          Bounds left;
+          for(uint32_t i = 1; i < count; i++) {
+            priv::merge(&left, bounds[*(begin + (i - 1))]);
+            const real_t c = priv::surfaceArea(left)*real_t(i) + areaRight[i]*real_t(count - i);
+            if( c < bestCost ) {
+              bestCost  = c;
+              bestAxis  = axis;
+              bestSplit = i;
+            }
+          }
+        }
+      }
+
+      // NOTE: Add the cost of traversing this node to the cost of splitting it.
+      const bool is_leaf = count <= 1  ||
+          (count <= MAX_LEAF_SIZE  &&  leafCost <= bestCost + priv::surfaceArea(nodeBounds));
+      if( is_leaf ) {
+        tree.nodes[index].first = first;
+        tree.nodes[index].count = count;
+        tree.sumCost += leafCost;
+        for(auto it = begin; it != end; ++it) {
+          tree.leafOf[*it] = index;
+        }
+        return;
+      }
+
+      // (2) Split ///////////////////////////////////////////////////////////
+
+      // NOTE: Beyond MAX_SAH_DEPTH, the median split bounds the depth.
+      std::nth_element(begin, begin + bestSplit, end, [&](const uint32_t a, const uint32_t b) -> bool {
+        return centroids[a](bestAxis) < centroids[b](bestAxis);
+      });
+
+      const uint32_t child = uint32_t(tree.nodes.size());
+      tree.nodes.emplace_back();
+      tree.nodes.emplace_back();
+      tree.nodes[child].parent     = index;
+      tree.nodes[child + 1].parent = index;
+
+      tree.nodes[index].first = child;
+      tree.nodes[index].count = 0;
+      tree.nodes[index].axis  = bestAxis;
+      tree.sumCost += priv::nodeCost(nodeBounds, 0);
+
+      self(self, child, first, bestSplit, depth + 1);
+      self(self, child + 1, first + bestSplit, count - bestSplit, depth + 1);
+    };
+
+    build(build, 0, 0, uint32_t(numPrims), 0);
+
+    return tree;
+  }
+
+  void BVH::refitAll(Tree *tree, const std::vector<Bounds>& bounds)
+  {
+    tree->sumCost = 0;
+
+    // NOTE: Children are stored after their parents.
+    for(size_t index = tree->nodes.size(); index > 0; index--) {
+      Node& node = tree->nodes[index - 1];
+
+      Bounds refitted;
+      if( node.count > 0 ) {
+        for(uint32_t i = 0; i < node.count; i++) {
+          priv::merge(&refitted, bounds[tree->prims[node.first + i]]);
+        }
+      } else {
+        priv::merge(&refitted, tree->nodes[node.first].bounds);
+        priv::merge(&refitted, tree->nodes[node.first + 1].bounds);
+      }
+      node.bounds = refitted;
+
+      tree->sumCost += priv::nodeCost(node.bounds, node.count);
+    }
+  }
+
+  real_t BVH::cost(const Tree& tree)
+  {
+    if( tree.nodes.empty() ) {
+      return 0;
+    }
+    const real_t rootArea = priv::surfaceArea(tree.nodes.front().bounds);
+    return rootArea > ZERO
+        ? tree.sumCost/rootArea
+        : 0;
+  }
+
+} // namespace rt
@@ -39,4 +39,22 @@ namespace rt {
   {
   }
 
+  bool IScene::aov(AOV * /*aov*/, const Ray& /*ray*/) const
+  {
+    return false;
+  }
+
+  void IScene::beginFrame(const CameraPtr& /*camera*/, const SamplerPtr& /*sampler*/,
+                          const RenderOptions& /*options*/)
+  {
+  }
+
+  void IScene::beginBlock() const
+  {
+  }
+
+  void IScene::endBlock() const
+  {
+  }
+
 } // namespace rt
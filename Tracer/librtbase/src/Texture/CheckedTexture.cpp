@@ -32,6 +32,7 @@
 #include "rt/Texture/CheckedTexture.h"
 
 #include "math/Logical.h"
+#include "rt/Base/Registry.h"
 
 namespace rt {
 
@@ -53,6 +54,24 @@ namespace rt {
     return create(_colorA, _colorB, _scaleS, _scaleT);
   }
 
+  size_t CheckedTexture::hash() const
+  {
+    size_t seed = 1;
+    hashCombine(&seed, _colorA);
+    hashCombine(&seed, _colorB);
+    hashCombine(&seed, _scaleS);
+    hashCombine(&seed, _scaleT);
+    return seed;
+  }
+
+  bool CheckedTexture::isEqual(const ITexture& other) const
+  {
+    const CheckedTexture *checked = dynamic_cast<const CheckedTexture*>(&other);
+    return checked != nullptr  &&
+        isSameColor(_colorA, checked->_colorA)  &&  isSameColor(_colorB, checked->_colorB)  &&
+        _scaleS == checked->_scaleS  &&  _scaleT == checked->_scaleT;
+  }
+
   Color CheckedTexture::lookup(const TexCoord2D& tex) const
   {
     TEXCOORDS_2D(tex);
@@ -63,6 +82,26 @@ namespace rt {
         : _colorB;
   }
 
+  Color CheckedTexture::colorA() const
+  {
+    return _colorA;
+  }
+
+  Color CheckedTexture::colorB() const
+  {
+    return _colorB;
+  }
+
+  real_t CheckedTexture::scaleS() const
+  {
+    return _scaleS;
+  }
+
+  real_t CheckedTexture::scaleT() const
+  {
+    return _scaleT;
+  }
+
   TexturePtr CheckedTexture::create(const Color& colorA, const Color& colorB,
                                     const real_t scaleS, const real_t scaleT)
   {
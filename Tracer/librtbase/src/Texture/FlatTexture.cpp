@@ -31,6 +31,8 @@
 
 #include "rt/Texture/FlatTexture.h"
 
+#include "rt/Base/Registry.h"
+
 namespace rt {
 
   FlatTexture::FlatTexture(const Color& color) noexcept
@@ -47,11 +49,29 @@ namespace rt {
     return create(_color);
   }
 
+  size_t FlatTexture::hash() const
+  {
+    size_t seed = 0;
+    hashCombine(&seed, _color);
+    return seed;
+  }
+
+  bool FlatTexture::isEqual(const ITexture& other) const
+  {
+    const FlatTexture *flat = dynamic_cast<const FlatTexture*>(&other);
+    return flat != nullptr  &&  isSameColor(_color, flat->_color);
+  }
+
   Color FlatTexture::lookup(const TexCoord2D& /*tex*/) const
   {
     return _color;
   }
 
+  Color FlatTexture::color() const
+  {
+    return _color;
+  }
+
   TexturePtr FlatTexture::create(const Color& color)
   {
     return std::make_unique<FlatTexture>(color);
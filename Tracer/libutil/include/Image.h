@@ -66,6 +66,10 @@ public:
   size_type height() const;
 
   bool copy(const size_type y, const Image& src);
+  bool copy(const size_type x, const size_type y, const Image& src);
+
+  Image crop(const size_type x, const size_type y,
+             const size_type width, const size_type height) const;
 
   bool saveAsPNG(const char *filename) const;
 
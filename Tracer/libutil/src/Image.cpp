@@ -137,6 +137,34 @@ bool Image::copy(const size_type y, const Image& src)
   return true;
 }
 
+bool Image::copy(const size_type x, const size_type y, const Image& src)
+{
+  if( !isValidX(x)  ||  !isValidY(y)  ||  src.isEmpty()  ||
+      x + src.width() > width()  ||  y + src.height() > height() ) {
+    return false;
+  }
+  for(size_type i = 0; i < src.height(); i++) {
+    std::memcpy(row(y + i) + x*4, src.row(i), src.stride());
+  }
+  return true;
+}
+
+Image Image::crop(const size_type x, const size_type y,
+                  const size_type width, const size_type height) const
+{
+  if( !isValidX(x)  ||  !isValidY(y)  ||
+      x + width > this->width()  ||  y + height > this->height() ) {
+    return Image();
+  }
+
+  Image result(width, height);
+  for(size_type i = 0; i < result.height(); i++) {
+    std::memcpy(result.row(i), row(y + i) + x*4, result.stride());
+  }
+
+  return result;
+}
+
 bool Image::saveAsPNG(const char *filename) const
 {
   if( isEmpty() ) {
@@ -0,0 +1,111 @@
+/****************************************************************************
+** Copyright (c) 2021, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#include <cstdio>
+#include <cstdlib>
+
+#include <string>
+#include <vector>
+
+#include "rt/Renderer/PartialImage.h"
+
+void usage(const char *argv0)
+{
+  fprintf(stderr, "Usage: %s [-o output.png] [-p merged.partial] [-g gamma] partial...\n", argv0);
+}
+
+int main(int argc, char **argv)
+{
+  std::string output = "output.png";
+  std::string merged;
+  rt::real_t gamma = 0;
+
+  std::vector<const char*> filenames;
+  for(int i = 1; i < argc; i++) {
+    const std::string arg(argv[i]);
+    if(        arg == "-o"  &&  i + 1 < argc ) {
+      output = argv[++i];
+    } else if( arg == "-p"  &&  i + 1 < argc ) {
+      merged = argv[++i];
+    } else if( arg == "-g"  &&  i + 1 < argc ) {
+      gamma = rt::real_t(atof(argv[++i]));
+    } else if( arg.empty()  ||  arg[0] == '-' ) {
+      usage(argv[0]);
+      return EXIT_FAILURE;
+    } else {
+      filenames.push_back(argv[i]);
+    }
+  }
+
+  if( filenames.empty() ) {
+    usage(argv[0]);
+    return EXIT_FAILURE;
+  }
+
+  // (1) Load Partials ///////////////////////////////////////////////////////
+
+  std::vector<rt::PartialImage> partials(filenames.size());
+  std::vector<const rt::PartialImage*> ptrs;
+  for(std::size_t i = 0; i < filenames.size(); i++) {
+    if( !partials[i].load(filenames[i]) ) {
+      fprintf(stderr, "ERROR: Unable to load partial \"%s\"!\n", filenames[i]);
+      return EXIT_FAILURE;
+    }
+    ptrs.push_back(&partials[i]);
+  }
+
+  // (2) Merge ///////////////////////////////////////////////////////////////
+
+  rt::PartialImage result;
+  if( !rt::PartialImage::merge(&result, ptrs) ) {
+    fprintf(stderr, "ERROR: Unable to merge partials of different sizes!\n");
+    return EXIT_FAILURE;
+  }
+
+  // NOTE: The gamma defaults to the one of the partials' renderer.
+  if( gamma > 0 ) {
+    result.setGamma(gamma);
+  }
+
+  // (3) Output //////////////////////////////////////////////////////////////
+
+  if( !merged.empty()  &&  !result.save(merged.data()) ) {
+    fprintf(stderr, "ERROR: Unable to save partial \"%s\"!\n", merged.data());
+    return EXIT_FAILURE;
+  }
+
+  if( !result.develop().saveAsPNG(output.data()) ) {
+    fprintf(stderr, "ERROR: Unable to save image \"%s\"!\n", output.data());
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -32,6 +32,9 @@
 #include <cstdio>
 #include <cstdlib>
 
+#include <algorithm>
+#include <string>
+
 #include "math/Solver.h"
 #include "pt/BSDF/Dielectric.h"
 #include "pt/BSDF/Diffuse.h"
@@ -58,8 +61,46 @@ constexpr rt::size_t numSamples = 32;
 constexpr rt::size_t  width = 768;
 constexpr rt::size_t height = 768;
 
-int main(int /*argc*/, char ** /*argv*/)
+void usage(const char *argv0)
+{
+  fprintf(stderr, "Usage: %s [-w x0 y0 x1 y1] [-s samples]\n", argv0);
+}
+
+// NOTE: Parses the crop window [x0,x1) x [y0,y1) from 'argv'.
+bool parseWindow(rt::RenderBlock *window, char **argv)
+{
+  int v[4];
+  for(int i = 0; i < 4; i++) {
+    v[i] = atoi(argv[i]);
+    if( v[i] < 0 ) {
+      return false;
+    }
+  }
+  *window = rt::RenderBlock(rt::size_t(v[0]), rt::size_t(v[1]), rt::size_t(v[2]), rt::size_t(v[3]));
+  return !window->isEmpty()  &&  window->x1 <= width  &&  window->y1 <= height;
+}
+
+int main(int argc, char **argv)
 {
+  rt::RenderBlock window;
+  rt::size_t windowSamples = numSamples*4;
+
+  for(int i = 1; i < argc; i++) {
+    const std::string arg(argv[i]);
+    if(        arg == "-w"  &&  i + 4 < argc ) {
+      if( !parseWindow(&window, argv + i + 1) ) {
+        fprintf(stderr, "ERROR: Invalid crop window!\n");
+        return EXIT_FAILURE;
+      }
+      i += 4;
+    } else if( arg == "-s"  &&  i + 1 < argc ) {
+      windowSamples = rt::size_t(std::max(1, atoi(argv[++i])));
+    } else {
+      usage(argv[0]);
+      return EXIT_FAILURE;
+    }
+  }
+
   rt::RenderContext rc;
 
   // (1) Scene & Options /////////////////////////////////////////////////////
@@ -88,7 +129,21 @@ int main(int /*argc*/, char ** /*argv*/)
   // Done! ///////////////////////////////////////////////////////////////////
 
   Worker worker;
-  const Image image = worker.execute(rc, blockSize);
+  Image image = worker.execute(rc, blockSize);
+  if( image.isEmpty() ) {
+    return EXIT_FAILURE;
+  }
+
+  // NOTE: The crop window is re-rendered using more samples & composited into the image.
+  if( !window.isEmpty() ) {
+    rc.window  = window;
+    rc.sampler = rt::SimpleSampler::create(windowSamples);
+    if( !worker.execute(&image, rc, blockSize) ) {
+      fprintf(stderr, "ERROR: Unable to render crop window!\n");
+      return EXIT_FAILURE;
+    }
+  }
+
   image.saveAsPNG("pt-output.png");
 
   return EXIT_SUCCESS;
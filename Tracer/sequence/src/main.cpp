@@ -0,0 +1,314 @@
+/****************************************************************************
+** Copyright (c) 2021, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+
+#include <algorithm>
+#include <chrono>
+#include <future>
+#include <string>
+
+#include "rt/Camera/FrustumCamera.h"
+#include "rt/Camera/SimpleCamera.h"
+#include "rt/Loader/SceneLoader.h"
+#include "rt/Renderer/BidirectionalRenderer.h"
+#include "rt/Renderer/DirectLightingRenderer.h"
+#include "rt/Renderer/IrradianceCachingRenderer.h"
+#include "rt/Renderer/PathGuidingRenderer.h"
+#include "rt/Renderer/PathTracingRenderer.h"
+#include "rt/Renderer/PhotonMappingRenderer.h"
+#include "rt/Renderer/WhittedRenderer.h"
+#include "rt/Sampler/SimpleSampler.h"
+#include "rt/Scene/Animation.h"
+#include "rt/Scene/Scene.h"
+
+#include "Util/Worker.h"
+
+namespace priv {
+
+  rt::CameraPtr createCamera(const std::string& camera,
+                             const rt::size_t width, const rt::size_t height,
+                             const rt::RenderOptions& options)
+  {
+    if(        camera == "Frustum" ) {
+      return rt::FrustumCamera::create(width, height, options);
+    } else if( camera == "Simple" ) {
+      return rt::SimpleCamera::create(width, height, options);
+    }
+    return rt::CameraPtr();
+  }
+
+  rt::RendererPtr createRenderer(const std::string& method, const rt::RenderOptions& options)
+  {
+    if(        method == "DirectLighting" ) {
+      return rt::DirectLightingRenderer::create(options);
+    } else if( method == "PathTracing" ) {
+      return rt::PathTracingRenderer::create(options);
+    } else if( method == "Whitted" ) {
+      return rt::WhittedRenderer::create(options);
+    } else if( method == "Bidirectional" ) {
+      return rt::BidirectionalRenderer::create(options);
+    } else if( method == "PhotonMapping" ) {
+      return rt::PhotonMappingRenderer::create(options);
+    } else if( method == "IrradianceCaching" ) {
+      return rt::IrradianceCachingRenderer::create(options);
+    } else if( method == "PathGuiding" ) {
+      return rt::PathGuidingRenderer::create(options);
+    }
+    return rt::RendererPtr();
+  }
+
+  /*
+   * NOTE:
+   * The output pattern is never handed to printf(); it must contain exactly
+   * one conversion of the form '%d', '%Nd' or '%0Nd'; '%%' denotes a literal '%'.
+   */
+  struct FramePattern {
+    std::string prefix;
+    std::string suffix;
+    std::size_t width{0};
+    bool        zeros{false};
+  };
+
+  bool parseFramePattern(FramePattern *result, const std::string& pattern)
+  {
+    constexpr std::size_t MAX_WIDTH = 16;
+
+    FramePattern parsed;
+    std::string *text = &parsed.prefix;
+    bool have_conversion = false;
+    for(std::size_t i = 0; i < pattern.size(); i++) {
+      if( pattern[i] != '%' ) {
+        text->push_back(pattern[i]);
+        continue;
+      }
+
+      if( ++i < pattern.size()  &&  pattern[i] == '%' ) {
+        text->push_back('%');
+        continue;
+      }
+
+      if( have_conversion ) {
+        return false;
+      }
+
+      if( i < pattern.size()  &&  pattern[i] == '0' ) {
+        parsed.zeros = true;
+        i++;
+      }
+      for(; i < pattern.size()  &&  pattern[i] >= '0'  &&  pattern[i] <= '9'; i++) {
+        parsed.width = parsed.width*10 + std::size_t(pattern[i] - '0');
+        if( parsed.width > MAX_WIDTH ) {
+          return false;
+        }
+      }
+      if( i >= pattern.size()  ||  pattern[i] != 'd' ) {
+        return false;
+      }
+
+      have_conversion = true;
+      text = &parsed.suffix;
+    }
+
+    if( !have_conversion ) {
+      return false;
+    }
+
+    *result = std::move(parsed);
+
+    return true;
+  }
+
+  std::string frameFilename(const FramePattern& pattern, const int frame)
+  {
+    std::string number = std::to_string(frame);
+    if( number.size() < pattern.width ) {
+      number.insert(0, pattern.width - number.size(), pattern.zeros ? '0' : ' ');
+    }
+    return pattern.prefix + number + pattern.suffix;
+  }
+
+} // namespace priv
+
+void usage(const char *argv0)
+{
+  fprintf(stderr, "Usage: %s [-m method] [-c camera] [-w width] [-h height] [-n samples]\n"
+          "          [-t tileSize] [-f first] [-l last] [-o frame_%%04d.png] scene.xml\n",
+          argv0);
+}
+
+int main(int argc, char **argv)
+{
+  std::string method = "DirectLighting";
+  std::string camera = "Frustum";
+  std::string output = "frame_%04d.png";
+  const char *filename = nullptr;
+  rt::size_t width = 1000;
+  rt::size_t height = 1000;
+  rt::size_t numSamples = 64;
+  rt::size_t tileSize = 8;
+  int first = -1;
+  int last = -1;
+
+  for(int i = 1; i < argc; i++) {
+    const std::string arg(argv[i]);
+    if(        arg == "-m"  &&  i + 1 < argc ) {
+      method = argv[++i];
+    } else if( arg == "-c"  &&  i + 1 < argc ) {
+      camera = argv[++i];
+    } else if( arg == "-w"  &&  i + 1 < argc ) {
+      width = rt::size_t(atoi(argv[++i]));
+    } else if( arg == "-h"  &&  i + 1 < argc ) {
+      height = rt::size_t(atoi(argv[++i]));
+    } else if( arg == "-n"  &&  i + 1 < argc ) {
+      numSamples = rt::size_t(atoi(argv[++i]));
+    } else if( arg == "-t"  &&  i + 1 < argc ) {
+      tileSize = rt::size_t(atoi(argv[++i]));
+    } else if( arg == "-f"  &&  i + 1 < argc ) {
+      first = atoi(argv[++i]);
+    } else if( arg == "-l"  &&  i + 1 < argc ) {
+      last = atoi(argv[++i]);
+    } else if( arg == "-o"  &&  i + 1 < argc ) {
+      output = argv[++i];
+    } else if( arg.empty()  ||  arg[0] == '-'  ||  filename != nullptr ) {
+      usage(argv[0]);
+      return EXIT_FAILURE;
+    } else {
+      filename = argv[i];
+    }
+  }
+
+  if( filename == nullptr ) {
+    usage(argv[0]);
+    return EXIT_FAILURE;
+  }
+
+  priv::FramePattern pattern;
+  if( !priv::parseFramePattern(&pattern, output) ) {
+    fprintf(stderr, "ERROR: Invalid output pattern \"%s\"!\n", output.data());
+    return EXIT_FAILURE;
+  }
+
+  // (1) Load Scene Once /////////////////////////////////////////////////////
+
+  rt::RenderContext rc;
+  rc.scene = rt::Scene::create();
+
+  rt::RenderOptions options;
+  rt::Animation animation;
+  if( !rt::loadScene(rt::SCENE(rc.scene), &options, filename, &animation) ) {
+    return EXIT_FAILURE;
+  }
+
+  rc.renderer = priv::createRenderer(method, options);
+  if( !rc.renderer ) {
+    fprintf(stderr, "ERROR: Invalid method \"%s\"!\n", method.data());
+    return EXIT_FAILURE;
+  }
+
+  // NOTE: The camera's projection does not depend on its position.
+  rc.camera = priv::createCamera(camera, width, height, rc.renderer->options());
+  if( !rc.camera ) {
+    fprintf(stderr, "ERROR: Invalid camera \"%s\"!\n", camera.data());
+    return EXIT_FAILURE;
+  }
+
+  rc.sampler = rt::SimpleSampler::create(numSamples);
+
+  // NOTE: The frame range defaults to the keyframes' one.
+  if( first < 0 ) {
+    first = std::max(0, int(std::floor(animation.firstFrame())));
+  }
+  if( last < 0 ) {
+    last = std::max(first, int(std::ceil(animation.lastFrame())));
+  }
+
+  // (2) Render Frames ///////////////////////////////////////////////////////
+
+  /*
+   * NOTE:
+   * Frames are pipelined; the encoding of frame N overlaps the rendering of frame N+1.
+   * Only the image is shared with the encoder, hence the scene may be animated meanwhile.
+   */
+  const auto tim_begin = std::chrono::steady_clock::now();
+
+  Worker worker;
+  std::future<bool> encoding;
+  bool ok = true;
+  int numFrames = 0;
+  for(int frame = first; frame <= last  &&  ok; frame++) {
+    const rt::size_t numUpdated = animation.apply(rt::SCENE(rc.scene), &options, rt::real_t(frame));
+    rc.renderer->setOptions(options);
+
+    printf("Frame %d: %d object(s) moved.\n", frame, int(numUpdated));
+    fflush(stdout);
+
+    Image image = worker.execute(rc, tileSize);
+    if( image.isEmpty() ) {
+      fprintf(stderr, "ERROR: Unable to render frame %d!\n", frame);
+      ok = false;
+      break;
+    }
+
+    if( encoding.valid() ) {
+      ok = encoding.get();
+    }
+
+    encoding = std::async(std::launch::async,
+                          [image = std::move(image),
+                          name = priv::frameFilename(pattern, frame)]() -> bool {
+      if( !image.saveAsPNG(name.data()) ) {
+        fprintf(stderr, "ERROR: Unable to save frame \"%s\"!\n", name.data());
+        return false;
+      }
+      return true;
+    });
+    numFrames++;
+  }
+
+  if( encoding.valid()  &&  !encoding.get() ) {
+    ok = false;
+  }
+
+  // (3) Throughput //////////////////////////////////////////////////////////
+
+  const double sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - tim_begin).count();
+  if( numFrames > 0  &&  sec > 0 ) {
+    printf("Rendered %d frame(s) in %.1fs: %.1f frames/hour\n",
+           numFrames, sec, double(numFrames)*3600.0/sec);
+  }
+
+  return ok
+      ? EXIT_SUCCESS
+      : EXIT_FAILURE;
+}
@@ -0,0 +1,136 @@
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <vector>
+
+#include "pt/Scene/Scene.h"
+#include "pt/Shape/IntersectionInfo.h"
+
+using Clock = std::chrono::steady_clock;
+
+struct Random {
+  uint32_t state{1};
+
+  rt::real_t operator()(const rt::real_t lo, const rt::real_t hi)
+  {
+    state = state*1664525 + 1013904223;
+    return lo + (hi - lo)*rt::real_t(state >> 8)*0x1p-24f;
+  }
+};
+
+double elapsed_ms(const Clock::time_point& start)
+{
+  return std::chrono::duration<double,std::milli>(Clock::now() - start).count();
+}
+
+/*
+ * NOTE:
+ * Generates a grid of 'numPerAxis'^2 x 'numLayers' boxes. Scratch allocations interleave
+ * the boxes' heap, like the loader's temporaries do.
+ */
+std::vector<pt::ObjectPtr> generate(const int numPerAxis, const int numLayers, Random& random)
+{
+  std::vector<std::unique_ptr<char[]>> scratch;
+  std::vector<pt::ObjectPtr> objects;
+  for(int z = 0; z < numLayers; z++) {
+    for(int y = 0; y < numPerAxis; y++) {
+      for(int x = 0; x < numPerAxis; x++) {
+        const rt::Transform xform = rt::Transform::translate(rt::real_t(2*x - numPerAxis),
+                                                             rt::real_t(2*y - numPerAxis),
+                                                             rt::real_t(2*z));
+        objects.push_back(pt::Object::createBox(xform, random(rt::real_t(0.5), rt::real_t(1.5)),
+                                                random(rt::real_t(0.5), rt::real_t(1.5)),
+                                                random(rt::real_t(0.5), rt::real_t(1.5))));
+        scratch.push_back(std::make_unique<char[]>(size_t(random(16, 512))));
+      }
+    }
+  }
+
+  return objects;
+}
+
+// NOTE: Returns the number of hits of 'numRays' rays cast down onto the grid.
+rt::size_t trace(const pt::Scene& scene, const int numPerAxis, const int numLayers,
+                 const rt::size_t numRays, Random& random)
+{
+  const rt::real_t extent = rt::real_t(numPerAxis);
+  const rt::real_t height = rt::real_t(2*numLayers + 4);
+
+  rt::size_t numHits = 0;
+  for(rt::size_t i = 0; i < numRays; i++) {
+    const rt::Vertex origin(random(-extent, extent), random(-extent, extent), height);
+    const rt::Vertex target(random(-extent, extent), random(-extent, extent), 0);
+    const rt::Ray ray(origin, geom::to_direction(n4::normalize(n4::direction(origin, target))));
+
+    pt::IntersectionInfo info;
+    if( scene.intersect(&info, ray) ) {
+      numHits++;
+    }
+  }
+
+  return numHits;
+}
+
+int main(int argc, char **argv)
+{
+  const int numPerAxis = argc > 1
+      ? std::max(1, atoi(argv[1]))
+      : 64;
+  constexpr int          numLayers = 4;
+  constexpr rt::size_t     numRays = 250000;
+  constexpr int          numFrames = 3;
+
+  Random random;
+  pt::Scene scene;
+
+  std::vector<pt::ObjectPtr> objects = generate(numPerAxis, numLayers, random);
+
+  Clock::time_point start = Clock::now();
+  for(pt::ObjectPtr& object : objects) {
+    scene.add(object);
+  }
+  const double addTime = elapsed_ms(start);
+
+  start = Clock::now();
+  scene.buildBVH();
+  const double bvhTime = elapsed_ms(start);
+
+  printf("%d boxes: add %.1f ms, BVH %.1f ms\n",
+         numPerAxis*numPerAxis*numLayers, addTime, bvhTime);
+
+  rt::size_t expected = 0;
+  for(int frame = 0; frame < numFrames; frame++) {
+    Random rays;
+    start = Clock::now();
+    const rt::size_t numHits = trace(scene, numPerAxis, numLayers, numRays, rays);
+    const double traceTime = elapsed_ms(start);
+
+    printf("frame %d: %.2f Mrays/s, %d hits\n",
+           frame, double(numRays)/traceTime/1000.0, int(numHits));
+
+    if( frame > 0  &&  numHits != expected ) {
+      fprintf(stderr, "ERROR: Frame %d hits %d; expected %d!\n",
+              frame, int(numHits), int(expected));
+      return EXIT_FAILURE;
+    }
+    expected = numHits;
+  }
+
+  start = Clock::now();
+  scene.clear();
+  const double clearTime = elapsed_ms(start);
+
+  printf("clear %.1f ms\n", clearTime);
+
+  Random rays;
+  if( trace(scene, numPerAxis, numLayers, 1000, rays) != 0 ) {
+    fprintf(stderr, "ERROR: Cleared scene is hit!\n");
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,92 @@
+#include <cstdio>
+#include <cstdlib>
+
+#include <vector>
+
+#include "rt/Base/Arena.h"
+
+#define CHECK(cond)                             \
+  if( !(cond) ) {                               \
+    fprintf(stderr, "ERROR: %s!\n", #cond);     \
+    return false;                               \
+  }
+
+// NOTE: Counts the values alive.
+struct Value {
+  Value(const int _value, int *_numAlive) noexcept
+    : value(_value)
+    , numAlive(_numAlive)
+  {
+    (*numAlive)++;
+  }
+
+  ~Value() noexcept
+  {
+    (*numAlive)--;
+  }
+
+  int  value{0};
+  int *numAlive{nullptr};
+};
+
+constexpr size_t chunkSize = 4;
+
+bool testStable()
+{
+  constexpr int numValues = 3*chunkSize + 1;
+
+  int numAlive = 0;
+  rt::Arena<Value,chunkSize> arena;
+  CHECK(arena.isEmpty());
+
+  // NOTE: Addresses remain valid, when further chunks are allocated.
+  std::vector<const Value*> values;
+  for(int i = 0; i < numValues; i++) {
+    values.push_back(arena.emplace(i, &numAlive));
+  }
+  CHECK(arena.size() == numValues  &&  numAlive == numValues);
+
+  for(int i = 0; i < numValues; i++) {
+    size_t index = 0;
+    CHECK(&arena[size_t(i)] == values[size_t(i)]  &&  values[size_t(i)]->value == i);
+    CHECK(arena.indexOf(&index, values[size_t(i)])  &&  index == size_t(i));
+  }
+
+  const Value other(-1, &numAlive);
+  size_t index = 0;
+  CHECK(!arena.indexOf(&index, &other));
+
+  return true;
+}
+
+bool testClear()
+{
+  int numAlive = 0;
+  {
+    rt::Arena<Value,chunkSize> arena;
+    for(size_t i = 0; i < 2*chunkSize; i++) {
+      arena.emplace(int(i), &numAlive);
+    }
+
+    arena.clear();
+    CHECK(arena.isEmpty()  &&  numAlive == 0);
+
+    // NOTE: A cleared arena is reused; the destructor frees all values.
+    arena.emplace(1, &numAlive);
+    CHECK(arena.size() == 1  &&  arena[0].value == 1);
+  }
+  CHECK(numAlive == 0);
+
+  return true;
+}
+
+int main(int /*argc*/, char ** /*argv*/)
+{
+  if( !testStable()  ||  !testClear() ) {
+    return EXIT_FAILURE;
+  }
+
+  printf("arena OK\n");
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,148 @@
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+
+#include <vector>
+
+#include "rt/Scene/BVH.h"
+
+struct Random {
+  uint32_t state{1};
+
+  rt::real_t operator()(const rt::real_t lo, const rt::real_t hi)
+  {
+    state = state*1664525 + 1013904223;
+    return lo + (hi - lo)*rt::real_t(state >> 8)*0x1p-24f;
+  }
+};
+
+struct Sphere {
+  rt::Vertex center;
+  rt::real_t radius;
+
+  rt::Bounds bounds() const
+  {
+    const rt::Vertex r(radius, radius, radius);
+    return rt::Bounds(center - r, center + r);
+  }
+
+  // NOTE: Returns the nearest positive distance of 'ray' or INF_REAL_T.
+  rt::real_t intersect(const rt::Ray& ray) const
+  {
+    const rt::Vertex   o = ray.origin();
+    const rt::Direction d = ray.direction();
+
+    rt::real_t b = 0, c = -radius*radius;
+    for(int i = 0; i < 3; i++) {
+      const rt::real_t oc = o(i) - center(i);
+      b += oc*d(i);
+      c += oc*oc;
+    }
+
+    const rt::real_t disc = b*b - c;
+    if( disc < 0 ) {
+      return rt::INF_REAL_T;
+    }
+    const rt::real_t t0 = -b - std::sqrt(disc);
+    const rt::real_t t1 = -b + std::sqrt(disc);
+    return t0 > 0
+        ? t0
+        : t1 > 0
+          ? t1
+          : rt::INF_REAL_T;
+  }
+};
+
+std::vector<rt::Bounds> boundsOf(const std::vector<Sphere>& spheres)
+{
+  std::vector<rt::Bounds> result;
+  for(const Sphere& sphere : spheres) {
+    result.push_back(sphere.bounds());
+  }
+  return result;
+}
+
+// NOTE: Returns the index of the nearest sphere hit by 'ray' or -1.
+int nearest(const rt::BVH& bvh, const std::vector<Sphere>& spheres, const rt::Ray& ray)
+{
+  int hit = -1;
+  bvh.traverse(ray, [&](const rt::size_t prim, rt::real_t *tMax) -> bool {
+    const rt::real_t t = spheres[prim].intersect(ray);
+    if( t < *tMax ) {
+      *tMax = t;
+      hit = int(prim);
+    }
+    return true;
+  });
+  return hit;
+}
+
+int nearest(const std::vector<Sphere>& spheres, const rt::Ray& ray)
+{
+  int hit = -1;
+  rt::real_t tMax = ray.tMax();
+  for(rt::size_t i = 0; i < spheres.size(); i++) {
+    const rt::real_t t = spheres[i].intersect(ray);
+    if( t < tMax ) {
+      tMax = t;
+      hit = int(i);
+    }
+  }
+  return hit;
+}
+
+int main(int /*argc*/, char ** /*argv*/)
+{
+  constexpr rt::size_t numSpheres = 500;
+  constexpr rt::size_t    numRays = 20000;
+
+  Random random;
+
+  std::vector<Sphere> spheres;
+  for(rt::size_t i = 0; i < numSpheres; i++) {
+    spheres.push_back(Sphere{rt::Vertex(random(-10, 10), random(-10, 10), random(-10, 10)),
+                             random(rt::real_t(0.05), rt::real_t(0.5))});
+  }
+
+  rt::BVH refitted;
+  refitted.build(boundsOf(spheres));
+
+  // NOTE: Every third sphere moves; some move across the whole scene.
+  for(rt::size_t i = 0; i < numSpheres; i += 3) {
+    const rt::real_t extent = i % 2 == 0
+        ? rt::real_t(1)
+        : rt::real_t(20);
+    spheres[i].center = spheres[i].center
+        + rt::Vertex(random(-extent, extent), random(-extent, extent), random(-extent, extent));
+    refitted.refit(i, spheres[i].bounds());
+  }
+
+  rt::BVH rebuilt;
+  rebuilt.build(boundsOf(spheres));
+
+  rt::size_t numHits = 0;
+  for(rt::size_t i = 0; i < numRays; i++) {
+    const rt::Vertex origin(random(-15, 15), random(-15, 15), random(-15, 15));
+    const rt::Vertex target(random(-10, 10), random(-10, 10), random(-10, 10));
+    const rt::Ray ray(origin, geom::to_direction(n4::normalize(n4::direction(origin, target))));
+
+    const int expected = nearest(spheres, ray);
+    const int hitRefitted = nearest(refitted, spheres, ray);
+    const int hitRebuilt  = nearest(rebuilt, spheres, ray);
+    if( hitRefitted != expected  ||  hitRebuilt != expected ) {
+      fprintf(stderr, "ERROR: Ray %d hits %d (refit), %d (rebuild); expected %d!\n",
+              int(i), hitRefitted, hitRebuilt, expected);
+      return EXIT_FAILURE;
+    }
+
+    if( expected >= 0 ) {
+      numHits++;
+    }
+  }
+
+  printf("traced %d rays, %d hits; cost %f (refit) vs. %f (rebuild)\n",
+         int(numRays), int(numHits), refitted.cost(), rebuilt.cost());
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,176 @@
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+
+#include "Util/Checkpoint.h"
+
+#define CHECK(cond)                             \
+  if( !(cond) ) {                               \
+    fprintf(stderr, "ERROR: %s!\n", #cond);     \
+    return false;                               \
+  }
+
+std::string readFile(const std::string& filename)
+{
+  std::ifstream file(filename, std::ios::binary);
+  return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+
+bool isSame(const rt::RenderBlock& a, const rt::RenderBlock& b)
+{
+  return a.x0 == b.x0  &&  a.y0 == b.y0  &&  a.x1 == b.x1  &&  a.y1 == b.y1;
+}
+
+bool isSame(const rt::PartialImage& a, const rt::PartialImage& b)
+{
+  if( a.width() != b.width()  ||  a.height() != b.height()  ||  a.gamma() != b.gamma() ) {
+    return false;
+  }
+  for(rt::size_t y = 0; y < a.height(); y++) {
+    for(rt::size_t x = 0; x < a.width(); x++) {
+      const rt::Color sa = a.sum(x, y);
+      const rt::Color sb = b.sum(x, y);
+      if( sa(0) != sb(0)  ||  sa(1) != sb(1)  ||  sa(2) != sb(2)  ||
+          a.count(x, y) != b.count(x, y) ) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+// NOTE: Values not exactly representable in decimal check the options' exact round trip.
+Checkpoint checkpoint()
+{
+  using rt::real_t;
+
+  Checkpoint result;
+  result.width       = 13;
+  result.height      = 7;
+  result.window      = rt::RenderBlock(1, 2, 12, 7);
+  result.tileSize    = 4;
+  result.numSamples  = 64;
+  result.is_seeded   = true;
+  result.seed        = 0xfedcba9876543210;
+  result.firstSample = 32;
+  result.sceneHash   = 0x0123456789abcdef;
+  result.renderer    = "class rt::PathTracingRenderer";
+  result.camera      = "N2rt12SimpleCameraE";
+
+  result.options.eye           = rt::Vertex{real_t(0.1), real_t(-1)/real_t(3), real_t(1e-7)};
+  result.options.lookAt        = rt::Vertex{real_t(1), real_t(2), real_t(3)};
+  result.options.cameraUp      = rt::Direction{0, 1, 0};
+  result.options.fov_rad       = real_t(0.7853981);
+  result.options.worldToScreen = real_t(1)/real_t(7);
+  result.options.aperture      = real_t(0.05);
+  result.options.focus         = real_t(4.2);
+  result.options.gamma         = real_t(2.2);
+  result.options.maxDepth      = 9;
+
+  result.tiles.emplace_back(1, 2, 5, 6);
+  result.tiles.emplace_back(9, 6, 12, 7);
+
+  result.partial.resize(result.width, result.height);
+  result.partial.setGamma(real_t(2.2));
+  for(rt::size_t y = 0; y < result.height; y++) {
+    for(rt::size_t x = 0; x < result.width; x++) {
+      const real_t v = real_t(x + 1)/real_t(y + 3);
+      result.partial.add(x, y, rt::Color(v, v*real_t(0.1), -v), uint32_t(x*y));
+    }
+  }
+
+  return result;
+}
+
+bool testRoundTrip(const std::string& filename)
+{
+  const Checkpoint expected = checkpoint();
+  CHECK(expected.save(filename));
+
+  Checkpoint actual;
+  CHECK(actual.load(filename));
+  CHECK(actual.isCompatible(expected)  &&  expected.isCompatible(actual));
+  CHECK(actual.renderer == expected.renderer  &&  actual.camera == expected.camera);
+  CHECK(actual.tiles.size() == expected.tiles.size());
+  for(rt::size_t i = 0; i < expected.tiles.size(); i++) {
+    CHECK(isSame(actual.tiles[i], expected.tiles[i]));
+  }
+  CHECK(isSame(actual.partial, expected.partial));
+
+  // NOTE: Saving the loaded checkpoint yields the same file.
+  const std::string again = filename + ".again";
+  CHECK(actual.save(again));
+  const bool is_same = readFile(again) == readFile(filename);
+  std::filesystem::remove(again);
+  CHECK(is_same);
+
+  return true;
+}
+
+bool testCompatibility()
+{
+  const Checkpoint expected = checkpoint();
+
+  Checkpoint other = expected;
+  other.sceneHash++;
+  CHECK(!other.isCompatible(expected));
+
+  other = expected;
+  other.renderer = "class rt::BidirectionalRenderer";
+  CHECK(!other.isCompatible(expected));
+
+  other = expected;
+  other.options.fov_rad = std::nextafter(other.options.fov_rad, rt::real_t(1));
+  CHECK(!other.isCompatible(expected));
+
+  other = expected;
+  other.options.maxDepth++;
+  CHECK(!other.isCompatible(expected));
+
+  // NOTE: Progress is not part of the frame's settings.
+  other = expected;
+  other.tiles.clear();
+  CHECK(other.isCompatible(expected));
+
+  return true;
+}
+
+bool testInvalid(const std::string& filename)
+{
+  Checkpoint actual;
+  CHECK(!actual.load(filename + ".missing"));
+
+  CHECK(checkpoint().save(filename));
+  const auto size = std::filesystem::file_size(filename);
+  std::filesystem::resize_file(filename, size - 1);
+  CHECK(!actual.load(filename));
+
+  Checkpoint unnamed = checkpoint();
+  unnamed.renderer.clear();
+  CHECK(!unnamed.save(filename));
+
+  return true;
+}
+
+int main(int /*argc*/, char ** /*argv*/)
+{
+  const std::string filename =
+      (std::filesystem::temp_directory_path()/"test_checkpoint.ckpt").string();
+
+  const bool ok = testRoundTrip(filename)  &&  testCompatibility()  &&  testInvalid(filename);
+  std::filesystem::remove(filename);
+  std::filesystem::remove(filename + ".tmp");
+
+  if( !ok ) {
+    return EXIT_FAILURE;
+  }
+
+  printf("checkpoint OK\n");
+
+  return EXIT_SUCCESS;
+}
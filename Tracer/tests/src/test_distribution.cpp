@@ -0,0 +1,94 @@
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+
+#include <vector>
+
+#include "rt/Sampler/Distribution.h"
+
+bool isClose(const rt::real_t a, const rt::real_t b, const rt::real_t eps)
+{
+  return std::abs(a - b) <= eps*std::max<rt::real_t>(1, std::abs(b));
+}
+
+int main(int /*argc*/, char ** /*argv*/)
+{
+  using rt::real_t;
+  using rt::size_t;
+
+  constexpr size_t nu = 8;
+  constexpr size_t nv = 4;
+
+  // NOTE: Includes zero cells, which must never be sampled.
+  const real_t f[nv][nu] = {
+    {1, 2, 3, 4, 0, 0, 1, 1},
+    {0, 0, 0, 0, 0, 0, 0, 8},
+    {5, 1, 1, 1, 1, 1, 1, 5},
+    {2, 2, 2, 2, 2, 2, 2, 2}
+  };
+
+  real_t sum = 0;
+  for(size_t y = 0; y < nv; y++) {
+    for(size_t x = 0; x < nu; x++) {
+      sum += f[y][x];
+    }
+  }
+  const real_t mean = sum/real_t(nu*nv);
+
+  const rt::Distribution2D distribution(&f[0][0], nu, nv);
+  if( distribution.isEmpty() ) {
+    fprintf(stderr, "ERROR: Distribution is empty!\n");
+    return EXIT_FAILURE;
+  }
+
+  constexpr size_t n = 256;
+
+  std::vector<size_t> histogram(nu*nv, 0);
+  for(size_t j = 0; j < n; j++) {
+    for(size_t i = 0; i < n; i++) {
+      const rt::Sample2D xi{(real_t(i) + real_t(0.5))/real_t(n),
+                            (real_t(j) + real_t(0.5))/real_t(n)};
+
+      real_t pdf = 0;
+      const auto [u, v] = distribution.sample(xi, &pdf);
+      if( u < 0  ||  u >= 1  ||  v < 0  ||  v >= 1 ) {
+        fprintf(stderr, "ERROR: Sample (%f,%f) out of range!\n", u, v);
+        return EXIT_FAILURE;
+      }
+
+      const size_t x = std::min<size_t>(size_t(u*real_t(nu)), nu - 1);
+      const size_t y = std::min<size_t>(size_t(v*real_t(nv)), nv - 1);
+      if( f[y][x] <= 0 ) {
+        fprintf(stderr, "ERROR: Sampled zero cell (%d,%d)!\n", int(x), int(y));
+        return EXIT_FAILURE;
+      }
+
+      const real_t expected = f[y][x]/mean;
+      if( !isClose(pdf, expected, real_t(1e-4))  ||
+          !isClose(distribution.pdf(u, v), expected, real_t(1e-4)) ) {
+        fprintf(stderr, "ERROR: pdf(%f,%f) = %f, %f; expected %f!\n",
+                u, v, pdf, distribution.pdf(u, v), expected);
+        return EXIT_FAILURE;
+      }
+
+      histogram[y*nu + x]++;
+    }
+  }
+
+  // NOTE: Stratified samples match each cell's probability up to the strata's size.
+  for(size_t y = 0; y < nv; y++) {
+    for(size_t x = 0; x < nu; x++) {
+      const real_t actual   = real_t(histogram[y*nu + x])/real_t(n*n);
+      const real_t expected = f[y][x]/sum;
+      if( std::abs(actual - expected) > real_t(2)/real_t(n) ) {
+        fprintf(stderr, "ERROR: Cell (%d,%d) sampled with %f; expected %f!\n",
+                int(x), int(y), actual, expected);
+        return EXIT_FAILURE;
+      }
+    }
+  }
+
+  printf("sampled %d cells consistently\n", int(nu*nv));
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,142 @@
+#include <cstdio>
+#include <cstdlib>
+
+#include <vector>
+
+#include "rt/Object/LazyObject.h"
+#include "rt/Object/Sphere.h"
+#include "rt/Object/SurfaceInfo.h"
+
+#define CHECK(cond)                             \
+  if( !(cond) ) {                               \
+    fprintf(stderr, "ERROR: %s!\n", #cond);     \
+    return false;                               \
+  }
+
+constexpr int numObjects  = 64;
+constexpr int numCapacity = 4; // NOTE: Objects fitting into the cache.
+
+struct Objects {
+  Objects(const rt::GeometryCachePtr& cache) noexcept
+  {
+    for(int i = 0; i < numObjects; i++) {
+      const rt::real_t x = rt::real_t(3*i);
+      const rt::Bounds bounds(rt::Vertex(x - 1, -1, -1), rt::Vertex(x + 1, 1, 1));
+      objects.push_back(rt::LazyObject::create(bounds, [this,x]() -> rt::ObjectPtr {
+        numLoads++;
+        return rt::Sphere::create(rt::Transform::translate(x, 0, 0), 1);
+      }, cache));
+    }
+  }
+
+  // NOTE: Returns true, if the ray through the center of object 'i' hits it.
+  bool hit(const int i) const
+  {
+    const rt::Ray ray(rt::Vertex(rt::real_t(3*i), 0, -5), rt::Direction(0, 0, 1));
+    rt::SurfaceInfo surface;
+    return objects[size_t(i)]->intersect(&surface, ray)  &&  surface.isHit();
+  }
+
+  bool isResident(const int i) const
+  {
+    return rt::LAZY(objects[size_t(i)])->isResident();
+  }
+
+  std::vector<rt::ObjectPtr> objects;
+  int numLoads{0};
+};
+
+rt::GeometryCachePtr cache()
+{
+  const rt::size_t numBytes = rt::Sphere::create(rt::Transform(), 1)->memory();
+
+  rt::GeometryCachePtr result = rt::GeometryCache::create();
+  result->setMaxMemory(numBytes*numCapacity);
+  return result;
+}
+
+// NOTE: Loads every object once within a single frame, one object per block.
+bool testBlocks()
+{
+  const rt::GeometryCachePtr cache = ::cache();
+  Objects objects(cache);
+
+  cache->beginFrame();
+  for(int i = 0; i < numObjects; i++) {
+    cache->beginBlock();
+    CHECK(objects.hit(i));
+    CHECK(cache->memory() <= cache->maxMemory());
+    cache->endBlock();
+    CHECK(cache->memory() <= cache->maxMemory());
+  }
+
+  CHECK(objects.numLoads == numObjects);
+  CHECK(cache->numResident() == numCapacity);
+
+  return true;
+}
+
+// NOTE: Geometry used by a block in flight is kept, even if exceeding the cache.
+bool testPinned()
+{
+  const rt::GeometryCachePtr cache = ::cache();
+  Objects objects(cache);
+
+  constexpr int numUsed = numCapacity + 2;
+
+  cache->beginFrame();
+  cache->beginBlock();
+  for(int i = 0; i < numUsed; i++) {
+    CHECK(objects.hit(i));
+  }
+  for(int i = 0; i < numUsed; i++) {
+    CHECK(objects.isResident(i));
+  }
+  CHECK(cache->memory() > cache->maxMemory());
+  cache->endBlock();
+
+  CHECK(cache->memory() <= cache->maxMemory());
+  CHECK(objects.numLoads == numUsed);
+
+  return true;
+}
+
+// NOTE: Geometry used outside of any block is kept until the next frame.
+bool testFrame()
+{
+  const rt::GeometryCachePtr cache = ::cache();
+  Objects objects(cache);
+
+  constexpr int numUsed = numCapacity + 2;
+
+  cache->beginFrame();
+  for(int i = 0; i < numUsed; i++) {
+    CHECK(objects.hit(i));
+  }
+
+  cache->beginBlock();
+  CHECK(objects.hit(numUsed));
+  cache->endBlock();
+  for(int i = 0; i < numUsed; i++) {
+    CHECK(objects.isResident(i));
+  }
+
+  cache->beginFrame();
+  cache->beginBlock();
+  CHECK(objects.hit(numUsed + 1));
+  cache->endBlock();
+  CHECK(cache->memory() <= cache->maxMemory());
+
+  return true;
+}
+
+int main(int /*argc*/, char ** /*argv*/)
+{
+  if( !testBlocks()  ||  !testPinned()  ||  !testFrame() ) {
+    return EXIT_FAILURE;
+  }
+
+  printf("geometry cache OK\n");
+
+  return EXIT_SUCCESS;
+}
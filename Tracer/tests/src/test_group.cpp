@@ -0,0 +1,77 @@
+#include <cstdio>
+#include <cstdlib>
+
+#include "rt/Object/Group.h"
+#include "rt/Object/Sphere.h"
+
+bool isSame(const rt::Vertex& a, const rt::Vertex& b)
+{
+  return a(0) == b(0)  &&  a(1) == b(1)  &&  a(2) == b(2);
+}
+
+// NOTE: Compares the transforms exactly by mapping some vertices.
+bool isSame(const rt::Transform& a, const rt::Transform& b)
+{
+  const rt::Vertex vertices[4] = {
+    rt::Vertex(0, 0, 0), rt::Vertex(1, 0, 0), rt::Vertex(0, 1, 0), rt::Vertex(0, 0, 1)
+  };
+  for(const rt::Vertex& v : vertices) {
+    if( !isSame(a*v, b*v) ) {
+      return false;
+    }
+  }
+  return true;
+}
+
+rt::Transform keyframe(const int i)
+{
+  const rt::real_t t = rt::real_t(i)*rt::real_t(0.001);
+  return rt::Transform::translate(t, 2*t, -t)*rt::Transform::rotateZYX(t, 3*t, -2*t);
+}
+
+int main(int /*argc*/, char ** /*argv*/)
+{
+  using rt::Transform;
+
+  constexpr int numKeyframes = 10000;
+
+  // NOTE: outer -> inner -> sphere; children are given relative to their group.
+  const Transform innerToOuter  = Transform::translate(1, 2, 3)*Transform::rotateZYX(0.3f, 0.2f, 0.1f);
+  const Transform sphereToInner = Transform::translate(-2, 0, 1)*Transform::rotateZYX(1, 0, 0.5f);
+
+  rt::ObjectPtr sphere = rt::Sphere::create(sphereToInner, 1);
+  const rt::IObject *mySphere = sphere.get();
+
+  rt::ObjectPtr inner = rt::Group::create(innerToOuter);
+  rt::GROUP(inner)->add(sphere);
+
+  rt::ObjectPtr outer = rt::Group::create(Transform());
+  rt::GROUP(outer)->add(inner);
+
+  // NOTE: A long animation, partly moving the group relative to its current transform.
+  for(int i = 1; i <= numKeyframes; i++) {
+    if( i % 2 == 0 ) {
+      outer->setObjectToWorld(keyframe(i));
+    } else {
+      outer->moveObject(keyframe(i)*outer->objectToWorld().inverse());
+    }
+  }
+
+  const Transform last = keyframe(numKeyframes);
+  outer->setObjectToWorld(last);
+
+  if( !isSame(mySphere->objectToWorld(), last*innerToOuter*sphereToInner) ) {
+    fprintf(stderr, "ERROR: Child's transform drifted!\n");
+    return EXIT_FAILURE;
+  }
+
+  outer->setObjectToWorld(Transform());
+  if( !isSame(mySphere->objectToWorld(), innerToOuter*sphereToInner) ) {
+    fprintf(stderr, "ERROR: Child's transform was not restored!\n");
+    return EXIT_FAILURE;
+  }
+
+  printf("animated %d keyframes\n", numKeyframes);
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,103 @@
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+
+#include <algorithm>
+#include <numeric>
+#include <vector>
+
+#include "rt/Renderer/PartialImage.h"
+
+std::vector<unsigned char> bytes(const rt::PartialImage& image)
+{
+  std::vector<unsigned char> result;
+
+  FILE *file = tmpfile();
+  if( file == nullptr ) {
+    return result;
+  }
+
+  if( image.write(file)  &&  fseek(file, 0, SEEK_END) == 0 ) {
+    result.resize(size_t(ftell(file)));
+    if( fseek(file, 0, SEEK_SET) != 0  ||
+        fread(result.data(), 1, result.size(), file) != result.size() ) {
+      result.clear();
+    }
+  }
+  fclose(file);
+
+  return result;
+}
+
+// NOTE: Sums of widely differing magnitude, so the order of addition matters.
+void fill(rt::PartialImage *partial, uint32_t seed)
+{
+  const auto random = [&]() -> uint32_t {
+    seed = seed*1664525 + 1013904223;
+    return seed >> 8;
+  };
+
+  for(rt::size_t y = 0; y < partial->height(); y++) {
+    for(rt::size_t x = 0; x < partial->width(); x++) {
+      rt::Color sum;
+      for(int c = 0; c < 3; c++) {
+        const rt::real_t scale = rt::real_t(1 << (random() % 24))*0x1p-12f;
+        sum(c) = rt::real_t(random() % 1000)*scale;
+      }
+      partial->add(x, y, sum, 1 + random() % 16);
+    }
+  }
+}
+
+int main(int /*argc*/, char ** /*argv*/)
+{
+  constexpr rt::size_t  width = 7;
+  constexpr rt::size_t height = 5;
+  constexpr rt::size_t     n = 5;
+
+  std::vector<rt::PartialImage> partials(n);
+  for(rt::size_t i = 0; i < n; i++) {
+    if( !partials[i].resize(width, height) ) {
+      fprintf(stderr, "ERROR: Unable to resize partial!\n");
+      return EXIT_FAILURE;
+    }
+    fill(&partials[i], uint32_t(i + 1));
+  }
+
+  std::vector<rt::size_t> order(n);
+  std::iota(order.begin(), order.end(), 0);
+
+  std::vector<unsigned char> expected;
+  int numPermutations = 0;
+  do {
+    std::vector<const rt::PartialImage*> inputs;
+    for(const rt::size_t i : order) {
+      inputs.push_back(&partials[i]);
+    }
+
+    rt::PartialImage result;
+    if( !rt::PartialImage::merge(&result, inputs) ) {
+      fprintf(stderr, "ERROR: Unable to merge partials!\n");
+      return EXIT_FAILURE;
+    }
+
+    const std::vector<unsigned char> actual = bytes(result);
+    if( actual.empty() ) {
+      fprintf(stderr, "ERROR: Unable to write partial!\n");
+      return EXIT_FAILURE;
+    }
+
+    if( expected.empty() ) {
+      expected = actual;
+    } else if( actual != expected ) {
+      fprintf(stderr, "ERROR: Merge of permutation %d differs!\n", numPermutations);
+      return EXIT_FAILURE;
+    }
+
+    numPermutations++;
+  } while( std::next_permutation(order.begin(), order.end()) );
+
+  printf("merged %d permutations of %d partials\n", numPermutations, int(n));
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,125 @@
+#include <cstdio>
+#include <cstdlib>
+
+#include <memory>
+
+#include "rt/Base/Registry.h"
+#include "rt/Material/MaterialRegistry.h"
+#include "rt/Material/MatteMaterial.h"
+#include "rt/Texture/FlatTexture.h"
+
+#define CHECK(cond)                             \
+  if( !(cond) ) {                               \
+    fprintf(stderr, "ERROR: %s!\n", #cond);     \
+    return false;                               \
+  }
+
+// NOTE: The hash is given explicitly, to provoke collisions.
+struct Value {
+  int        value{0};
+  rt::size_t hashValue{0};
+
+  rt::size_t hash() const
+  {
+    return hashValue;
+  }
+
+  bool isEqual(const Value& other) const
+  {
+    return value == other.value;
+  }
+
+  static std::unique_ptr<Value> create(const int value, const rt::size_t hashValue)
+  {
+    return std::make_unique<Value>(Value{value, hashValue});
+  }
+};
+
+bool testDeduplication()
+{
+  rt::Registry<Value> registry;
+
+  CHECK(!registry.add(std::unique_ptr<Value>()));
+
+  auto a = Value::create(1, 10);
+  const Value *pa = a.get();
+  const auto refA = registry.add(a);
+  CHECK(refA.get() == pa  &&  !a);
+
+  // NOTE: An equal resource is dropped in favor of the registered one.
+  auto b = Value::create(1, 10);
+  const auto refB = registry.add(b);
+  CHECK(refB == refA  &&  !b);
+
+  // NOTE: Colliding hashes are told apart by isEqual().
+  const auto refC = registry.add(Value::create(2, 10));
+  const auto refD = registry.add(Value::create(2, 10));
+  CHECK(refC != refA  &&  refD == refC);
+
+  const auto refE = registry.add(Value::create(3, 20));
+  CHECK(refE != refA  &&  refE != refC);
+
+  CHECK(registry.size() == 3);
+
+  registry.clear();
+  CHECK(registry.size() == 0);
+  CHECK(refA->value == 1);
+
+  return true;
+}
+
+bool testExpiry()
+{
+  rt::Registry<Value> registry;
+
+  auto refA = registry.add(Value::create(1, 10));
+  auto refB = registry.add(Value::create(1, 10));
+  const auto refC = registry.add(Value::create(2, 10));
+  CHECK(registry.size() == 2);
+
+  // NOTE: A resource is registered as long as any reference remains.
+  refA.reset();
+  CHECK(registry.size() == 2);
+  refB.reset();
+  CHECK(registry.size() == 1);
+
+  // NOTE: An expired resource is replaced by the next equal one.
+  auto d = Value::create(1, 10);
+  const Value *pd = d.get();
+  const auto refD = registry.add(d);
+  CHECK(refD.get() == pd);
+  CHECK(registry.add(Value::create(2, 10)) == refC);
+  CHECK(registry.size() == 2);
+
+  return true;
+}
+
+bool testMaterials()
+{
+  const rt::MaterialRegistryPtr registry = rt::MaterialRegistry::create();
+
+  const auto matte = [&](const rt::Color& color) -> rt::MaterialRef {
+    rt::MaterialPtr material = rt::MatteMaterial::create();
+    MATTE(material)->setTexture(registry->add(rt::FlatTexture::create(color)));
+    return registry->add(material);
+  };
+
+  const auto red1 = matte(rt::Color(1, 0, 0));
+  const auto red2 = matte(rt::Color(1, 0, 0));
+  const auto blue = matte(rt::Color(0, 0, 1));
+  CHECK(red1  &&  red1 == red2  &&  blue != red1);
+  CHECK(registry->numMaterials() == 2  &&  registry->numTextures() == 2);
+
+  return true;
+}
+
+int main(int /*argc*/, char ** /*argv*/)
+{
+  if( !testDeduplication()  ||  !testExpiry()  ||  !testMaterials() ) {
+    return EXIT_FAILURE;
+  }
+
+  printf("registry OK\n");
+
+  return EXIT_SUCCESS;
+}
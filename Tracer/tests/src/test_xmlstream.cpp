@@ -0,0 +1,136 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include <filesystem>
+#include <string>
+
+#include <tinyxml2.h>
+
+#include "rt/Loader/SceneLoaderStream.h"
+
+#define CHECK(cond)                                                 \
+  if( !(cond) ) {                                                   \
+    fprintf(stderr, "ERROR: %s (padding %d)!\n", #cond, padding);  \
+    return false;                                                   \
+  }
+
+bool isName(const char *name, const char *expected)
+{
+  return name != nullptr  &&  std::strcmp(name, expected) == 0;
+}
+
+/*
+ * NOTE:
+ * The padding moves the interesting text across the boundary of the stream's
+ * 64KiB chunks, so that every token straddles it once.
+ */
+std::string document(const int padding)
+{
+  std::string xml;
+  xml += "<?xml version=\"1.0\"?>\n";
+  xml += "<!-- Before the root: <Fake/> -->\n";
+  xml += "<Tracer>\n";
+  xml += "  <!-- " + std::string(size_t(padding), 'x') + " -->\n";
+  xml += "  <!-- <Comment attr=\"a\"> </Tracer> > -->\n";
+  xml += "  <Text><![CDATA[ <Object/> </Text> ]]></Text>\n";
+  xml += "  <Group name=\"a>b\" other='/>'>\n";
+  xml += "    <!-- <Child id=\"0\"/> -->\n";
+  xml += "    <Child id=\"1\"/>\n";
+  xml += "    <Child id=\"2\"><![CDATA[</Group>]]></Child>\n";
+  xml += "    <Child id=\"3\"/>\n";
+  xml += "  </Group>\n";
+  xml += "  <Last/>\n";
+  xml += "</Tracer>\n";
+  return xml;
+}
+
+bool test(const char *filename, const int padding)
+{
+  {
+    const std::string xml = document(padding);
+    FILE *file = fopen(filename, "wb");
+    if( file == nullptr ) {
+      return false;
+    }
+    const bool ok = fwrite(xml.data(), 1, xml.size(), file) == xml.size();
+    fclose(file);
+    CHECK(ok);
+  }
+
+  // NOTE: The lines of the whole DOM serve as reference.
+  tinyxml2::XMLDocument reference;
+  CHECK(reference.LoadFile(filename) == tinyxml2::XML_SUCCESS);
+  const tinyxml2::XMLElement *refText  = reference.RootElement()->FirstChildElement("Text");
+  const tinyxml2::XMLElement *refGroup = reference.RootElement()->FirstChildElement("Group");
+
+  rt::priv::XMLStream stream;
+  CHECK(stream.open(filename));
+  CHECK(isName(stream.rootName(), "Tracer"));
+
+  // (1) CDATA containing markup /////////////////////////////////////////////
+
+  CHECK(isName(stream.nextName(), "Text"));
+  tinyxml2::XMLDocument textDoc;
+  rt::priv::XMLRange range;
+  const tinyxml2::XMLElement *text = stream.read(&textDoc, &range);
+  CHECK(text != nullptr  &&  isName(text->GetText(), " <Object/> </Text> "));
+  CHECK(rt::priv::XMLStream::lineNum(text, range) == refText->GetLineNum());
+
+  tinyxml2::XMLDocument againDoc;
+  const tinyxml2::XMLElement *again = rt::priv::XMLStream::read(&againDoc, filename, range);
+  CHECK(again != nullptr  &&  isName(again->GetText(), " <Object/> </Text> "));
+
+  // (2) Nested level with comments & quoted '>' /////////////////////////////
+
+  CHECK(isName(stream.nextName(), "Group"));
+  CHECK(stream.enter());
+
+  const tinyxml2::XMLElement *refChild = refGroup->FirstChildElement("Child");
+  for(int id = 1; id <= 2; id++) {
+    CHECK(isName(stream.nextName(), "Child"));
+    tinyxml2::XMLDocument childDoc;
+    const tinyxml2::XMLElement *child = stream.read(&childDoc, &range);
+    CHECK(child != nullptr  &&  child->IntAttribute("id") == id);
+    CHECK(rt::priv::XMLStream::lineNum(child, range) == refChild->GetLineNum());
+    refChild = refChild->NextSiblingElement("Child");
+  }
+
+  // NOTE: The remaining child is skipped.
+  CHECK(stream.leave());
+
+  // (3) End of root /////////////////////////////////////////////////////////
+
+  CHECK(isName(stream.nextName(), "Last"));
+  tinyxml2::XMLDocument lastDoc;
+  CHECK(stream.read(&lastDoc) != nullptr);
+  CHECK(stream.nextName() == nullptr);
+  CHECK(stream.leave());
+  CHECK(!stream.isError());
+
+  return true;
+}
+
+int main(int /*argc*/, char ** /*argv*/)
+{
+  const std::string filename =
+      (std::filesystem::temp_directory_path()/"test_xmlstream.xml").string();
+
+  // NOTE: The boundary then falls anywhere within the text following the padding.
+  constexpr int first = 64*1024 - 400;
+  constexpr int  last = 64*1024;
+
+  bool ok = true;
+  for(int padding = first; ok  &&  padding <= last; padding++) {
+    ok = test(filename.data(), padding);
+  }
+  std::filesystem::remove(filename);
+
+  if( !ok ) {
+    return EXIT_FAILURE;
+  }
+
+  printf("streamed %d documents\n", last - first + 1);
+
+  return EXIT_SUCCESS;
+}